@@ -1,8 +1,10 @@
 #include "Common/d3dApp.h"
 #include "Common/MathHelper.h"
 #include "Common/UploadBuffer.h"
+#include "DDSStreamBackend.h"
 #include "RenderTexture.h"
 #include "MyApp.h"
+#include "Toolkit.h"
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 using namespace DirectX::PackedVector;
@@ -13,8 +15,9 @@ public:
 	CustomTexture(ID3D12Device* device,
 		UINT width, UINT height,
 		DXGI_FORMAT format,
-		D3D12_RESOURCE_FLAGS flag = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS)
-		:RenderTexture(device, width, height, format, flag)
+		D3D12_RESOURCE_FLAGS flag = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+		UINT mipLevels = 1)
+		:RenderTexture(device, width, height, format, flag, mipLevels)
 	{};
 
 	virtual void BuildDescriptors()override;
@@ -45,13 +48,32 @@ public:
 	virtual void Update(const GameTimer& gt)override;
 	virtual void Draw(const GameTimer& gt)override;
 	virtual void OnResize()override;
+	virtual void OnKeyboardInput(const GameTimer& gt)override;
 private:
 	void DrawBlurToRenderTex(const GameTimer& gt, ID3D12Resource* input);
+	void DrawGaussianBlur();
+	void DrawDualKawaseBlur();
+
+	// K: separable Gaussian / dual Kawase pyramid. J / L: narrower / wider blur, by sigma or by levels
+	bool mDualKawase = false;
+	UINT mKawaseLevels = 4;
+	std::unique_ptr<CustomTexture> mPyramid = nullptr;
+	UINT mKawaseSrvOffset = 0;
+	UINT mKawaseUavOffset = 0;
+
+	float mBlurSigma = 2.5f;
+	std::vector<float> mBlurWeights;
+	std::unique_ptr<UploadBuffer<float>> mBlurWeightsBuffer = nullptr;
 
 	std::unique_ptr<CustomTexture> renderTex = nullptr;
 	std::unique_ptr<CustomTexture> renderTexOut = nullptr;
 
-	std::unordered_map<std::string, std::unique_ptr<Texture>> mTextures;
+	// teapot512.dds, streamed by how far the quad is. The streamer goes first on destruction,
+	// its workers read through the backend
+	std::unique_ptr<DDSStreamBackend> mStreamBackend = nullptr;
+	std::unique_ptr<TextureStreamer> mStreamer = nullptr;
+	std::uint32_t mTeapot = TextureStreamer::InvalidId;
+	float mQuadUVDensity = 1.0f;
 	void LoadTextures();
 
 	ComPtr<ID3D12DescriptorHeap> mSrvUavDescriptorHeap = nullptr;
@@ -59,6 +81,11 @@ private:
 	CD3DX12_GPU_DESCRIPTOR_HANDLE mBlurGpuUav;
 	CD3DX12_CPU_DESCRIPTOR_HANDLE mBlurCpuSrv;
 	CD3DX12_CPU_DESCRIPTOR_HANDLE mBlurCpuUav;
+	// vertical pass: renderTexOut -> renderTex
+	CD3DX12_GPU_DESCRIPTOR_HANDLE mBlurVertGpuSrv;
+	CD3DX12_GPU_DESCRIPTOR_HANDLE mBlurVertGpuUav;
+	CD3DX12_CPU_DESCRIPTOR_HANDLE mBlurVertCpuSrv;
+	CD3DX12_CPU_DESCRIPTOR_HANDLE mBlurVertCpuUav;
 	void BuildDescriptorHeaps();
 
 	std::unique_ptr<UploadBuffer<ObjectConstants>> ObjectCB = nullptr;
@@ -119,6 +146,13 @@ bool BlurApp::Initialize()
 		md3dDevice.Get(),
 		mClientWidth, mClientHeight,
 		DXGI_FORMAT_R8G8B8A8_UNORM);
+	//half the screen and below, in float so the levels don't band
+	mPyramid = std::make_unique<CustomTexture>(
+		md3dDevice.Get(),
+		MathHelper::Max(mClientWidth / 2, 1), MathHelper::Max(mClientHeight / 2, 1),
+		DXGI_FORMAT_R16G16B16A16_FLOAT,
+		D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+		Toolkit::MaxKawaseLevels);
 
 	mCbvSrvUavDescriptorSize = md3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr);
@@ -154,6 +188,18 @@ void BlurApp::Update(const GameTimer& gt)
 	XMStoreFloat4x4(&objConstants.world, XMMatrixTranspose(world));
 	XMStoreFloat4x4(&objConstants.viewProj, XMMatrixTranspose(viewProj));
 	currObjectCB->CopyData(0, objConstants);
+
+	// the quad's center decides the teapot's mip
+	const XMVECTOR quadCenter = XMVector3TransformCoord(XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f), world);
+	const float distance = XMVectorGetX(XMVector3Length(quadCenter - XMLoadFloat3(&mEyePos)));
+	mStreamer->SetProjection(proj, (float)mClientHeight);
+	mStreamer->Request(mTeapot, mQuadUVDensity, distance);
+	mStreamer->Update();
+
+	mBlurWeights = Toolkit::CalcGaussWeights(mBlurSigma);
+	for (std::size_t i = 0; i < mBlurWeights.size(); i++) {
+		mBlurWeightsBuffer->CopyData((int)i, mBlurWeights[i]);
+	}
 }
 
 void BlurApp::Draw(const GameTimer& gt)
@@ -161,6 +207,8 @@ void BlurApp::Draw(const GameTimer& gt)
 	mDirectCmdListAlloc->Reset();
 
 	mCommandList->Reset(mDirectCmdListAlloc.Get(), mPSOs["default"].Get());
+	// the previous frame was flushed, its upload buffer and SRV are free
+	mStreamBackend->Record(mCommandList.Get());
 	mCommandList->RSSetViewports(1, &mScreenViewport);
 	mCommandList->RSSetScissorRects(1, &mScissorRect);
 
@@ -202,13 +250,13 @@ void BlurApp::Draw(const GameTimer& gt)
 
 	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
 		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_DEST));
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(renderTexOut->Output(),
-		D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_COPY_SOURCE));
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(renderTex->Output(),
+		D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE));
 
-	mCommandList->CopyResource(CurrentBackBuffer(), renderTexOut->Output());
+	mCommandList->CopyResource(CurrentBackBuffer(), renderTex->Output());
 
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(renderTexOut->Output(),
-		D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_GENERIC_READ));
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(renderTex->Output(),
+		D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COMMON));
 	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
 		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PRESENT));
 
@@ -233,6 +281,39 @@ void BlurApp::OnResize()
 	if (renderTexOut != nullptr) {
 		renderTexOut->OnResize(mClientWidth, mClientHeight);
 	}
+	if (mPyramid != nullptr) {
+		mPyramid->OnResize(MathHelper::Max(mClientWidth / 2, 1), MathHelper::Max(mClientHeight / 2, 1));
+	}
+}
+
+void BlurApp::OnKeyboardInput(const GameTimer& gt)
+{
+	MyApp::OnKeyboardInput(gt);
+
+	if (GetAsyncKeyState('K') & 1) {
+		mDualKawase = !mDualKawase;
+	}
+
+	if (mDualKawase) {
+		// every level doubles the radius
+		if ((GetAsyncKeyState('J') & 1) && mKawaseLevels > 1) {
+			mKawaseLevels--;
+		}
+		if ((GetAsyncKeyState('L') & 1) && mKawaseLevels < Toolkit::MaxKawaseLevels) {
+			mKawaseLevels++;
+		}
+		return;
+	}
+
+	// CalcGaussWeights uses a radius of 2 sigma, the shader caches up to Toolkit::MaxBlurRadius
+	const float dt = gt.DeltaTime();
+	if (GetAsyncKeyState('J') & 0x8000) {
+		mBlurSigma -= 2.0f * dt;
+	}
+	if (GetAsyncKeyState('L') & 0x8000) {
+		mBlurSigma += 2.0f * dt;
+	}
+	mBlurSigma = MathHelper::Clamp(mBlurSigma, 0.5f, Toolkit::MaxBlurRadius / 2.0f);
 }
 
 void BlurApp::DrawBlurToRenderTex(const GameTimer& gt, ID3D12Resource* input)
@@ -261,19 +342,6 @@ void BlurApp::DrawBlurToRenderTex(const GameTimer& gt, ID3D12Resource* input)
 		D3D12_RESOURCE_STATE_COPY_DEST,
 		D3D12_RESOURCE_STATE_GENERIC_READ
 	));
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(
-		renderTexOut->Output(),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		D3D12_RESOURCE_STATE_UNORDERED_ACCESS
-	));
-
-	//render use compute shader
-	mCommandList->SetPipelineState(mPSOs["blur"].Get());
-	mCommandList->SetComputeRootSignature(mRootSignatureBlur.Get());
-
-	mCommandList->SetComputeRootDescriptorTable(0, mBlurGpuSrv);
-	mCommandList->SetComputeRootDescriptorTable(1, mBlurGpuUav);
-
 	{
 		//If Window resize, Resource must be recreate.
 		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
@@ -290,50 +358,160 @@ void BlurApp::DrawBlurToRenderTex(const GameTimer& gt, ID3D12Resource* input)
 
 		md3dDevice->CreateShaderResourceView(renderTex->Output(), &srvDesc, mBlurCpuSrv);
 		md3dDevice->CreateUnorderedAccessView(renderTexOut->Output(), nullptr, &uavDesc, mBlurCpuUav);
+		md3dDevice->CreateShaderResourceView(renderTexOut->Output(), &srvDesc, mBlurVertCpuSrv);
+		md3dDevice->CreateUnorderedAccessView(renderTex->Output(), nullptr, &uavDesc, mBlurVertCpuUav);
 	}
 
+	//render use compute shader, the result ends up in renderTex as UAV
+	mCommandList->SetComputeRootSignature(mRootSignatureBlur.Get());
+	if (mDualKawase)
+		DrawDualKawaseBlur();
+	else
+		DrawGaussianBlur();
+}
+
+void BlurApp::DrawGaussianBlur()
+{
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(
+		renderTexOut->Output(),
+		D3D12_RESOURCE_STATE_COMMON,
+		D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+	));
+
+	//rows then columns
+	mCommandList->SetComputeRoot32BitConstant(2, (UINT)(mBlurWeights.size() / 2), 0);
+	mCommandList->SetComputeRootShaderResourceView(3, mBlurWeightsBuffer->Resource()->GetGPUVirtualAddress());
+
+	//renderTex -> renderTexOut
+	mCommandList->SetPipelineState(mPSOs["blurHorz"].Get());
+	mCommandList->SetComputeRootDescriptorTable(0, mBlurGpuSrv);
+	mCommandList->SetComputeRootDescriptorTable(1, mBlurGpuUav);
 
 	UINT numGroupX = (UINT)ceilf(mClientWidth / 256.0f);
 	mCommandList->Dispatch(numGroupX, mClientHeight, 1);
 
 	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(renderTexOut->Output(),
 		D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_GENERIC_READ));
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(renderTex->Output(),
+		D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_UNORDERED_ACCESS));
+
+	//renderTexOut -> renderTex
+	mCommandList->SetPipelineState(mPSOs["blurVert"].Get());
+	mCommandList->SetComputeRootDescriptorTable(0, mBlurVertGpuSrv);
+	mCommandList->SetComputeRootDescriptorTable(1, mBlurVertGpuUav);
+
+	UINT numGroupY = (UINT)ceilf(mClientHeight / 256.0f);
+	mCommandList->Dispatch(mClientWidth, numGroupY, 1);
+
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(renderTexOut->Output(),
+		D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_COMMON));
+}
+
+void BlurApp::DrawDualKawaseBlur()
+{
+	ID3D12Resource* pyramid = mPyramid->Output();
+	const UINT mipLevels = mPyramid->MipLevels();
+	const UINT levels = MathHelper::Min(mKawaseLevels, mipLevels);
+
+	auto srvCpu = [&](UINT mip) {
+		return CD3DX12_CPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetCPUDescriptorHandleForHeapStart(), mKawaseSrvOffset + mip, mCbvSrvUavDescriptorSize);
+	};
+	auto srvGpu = [&](UINT mip) {
+		return CD3DX12_GPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetGPUDescriptorHandleForHeapStart(), mKawaseSrvOffset + mip, mCbvSrvUavDescriptorSize);
+	};
+	auto uavCpu = [&](UINT mip) {
+		return CD3DX12_CPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetCPUDescriptorHandleForHeapStart(), mKawaseUavOffset + mip, mCbvSrvUavDescriptorSize);
+	};
+	auto uavGpu = [&](UINT mip) {
+		return CD3DX12_GPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetGPUDescriptorHandleForHeapStart(), mKawaseUavOffset + mip, mCbvSrvUavDescriptorSize);
+	};
+
+	{
+		//one view per level, recreated with the pyramid as the others
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		srvDesc.Format = mPyramid->Format();
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Texture2D.MipLevels = 1;
+
+		D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+		uavDesc.Format = mPyramid->Format();
+		uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+
+		for (UINT mip = 0; mip < levels; mip++) {
+			srvDesc.Texture2D.MostDetailedMip = mip;
+			uavDesc.Texture2D.MipSlice = mip;
+			md3dDevice->CreateShaderResourceView(pyramid, &srvDesc, srvCpu(mip));
+			md3dDevice->CreateUnorderedAccessView(pyramid, nullptr, &uavDesc, uavCpu(mip));
+		}
+	}
+
+	auto dispatch = [&](UINT width, UINT height) {
+		mCommandList->Dispatch((width + 7) / 8, (height + 7) / 8, 1);
+	};
+	auto mipWidth = [&](UINT mip) { return MathHelper::Max((UINT)mClientWidth >> (mip + 1), 1u); };
+	auto mipHeight = [&](UINT mip) { return MathHelper::Max((UINT)mClientHeight >> (mip + 1), 1u); };
+	auto transition = [&](UINT mip, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after) {
+		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(pyramid, before, after,
+			D3D12CalcSubresource(mip, 0, 0, mipLevels, 1)));
+	};
+
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(pyramid,
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS));
+
+	//renderTex -> mip 0 -> ... -> mip levels - 1
+	mCommandList->SetPipelineState(mPSOs["kawaseDown"].Get());
+	for (UINT mip = 0; mip < levels; mip++) {
+		if (mip > 0)
+			transition(mip - 1, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_GENERIC_READ);
+		mCommandList->SetComputeRootDescriptorTable(0, mip == 0 ? mBlurGpuSrv : srvGpu(mip - 1));
+		mCommandList->SetComputeRootDescriptorTable(1, uavGpu(mip));
+		dispatch(mipWidth(mip), mipHeight(mip));
+	}
+
+	//mip levels - 1 -> ... -> mip 0 -> renderTex, each level overwritten once it was read
+	mCommandList->SetPipelineState(mPSOs["kawaseUp"].Get());
+	for (UINT mip = levels - 1; mip > 0; mip--) {
+		transition(mip, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_GENERIC_READ);
+		transition(mip - 1, D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+		mCommandList->SetComputeRootDescriptorTable(0, srvGpu(mip));
+		mCommandList->SetComputeRootDescriptorTable(1, uavGpu(mip - 1));
+		dispatch(mipWidth(mip - 1), mipHeight(mip - 1));
+	}
+	transition(0, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_GENERIC_READ);
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(renderTex->Output(),
+		D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_UNORDERED_ACCESS));
+	mCommandList->SetComputeRootDescriptorTable(0, srvGpu(0));
+	mCommandList->SetComputeRootDescriptorTable(1, mBlurVertGpuUav);
+	dispatch(mClientWidth, mClientHeight);
+
+	//the levels used are read last, the rest is still UAV
+	for (UINT mip = 0; mip < mipLevels; mip++) {
+		transition(mip, mip < levels ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+			D3D12_RESOURCE_STATE_COMMON);
+	}
 }
 
 void BlurApp::LoadTextures()
 {
-	auto tex = std::make_unique<Texture>();
-	tex->Name = "teapot512";
-	tex->Filename = L"..\\resources\\teapot512.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), tex->Filename.c_str(),
-		tex->Resource, tex->UploadHeap));
-
-	mTextures[tex->Name] = std::move(tex);
+	// only the tail is read here, the finer mips follow the quad's distance from Update()
+	mStreamBackend = std::make_unique<DDSStreamBackend>(md3dDevice.Get());
+	mStreamer = std::make_unique<TextureStreamer>(*mStreamBackend, TextureStreamer::Options());
+	ThrowIfFailed(mStreamBackend->Add(*mStreamer, L"..\\resources\\teapot512.dds", mTeapot));
 }
 
 void BlurApp::BuildDescriptorHeaps()
 {
 	{
 		D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-		srvHeapDesc.NumDescriptors = 1 + 2;
+		srvHeapDesc.NumDescriptors = 1 + 4 + 2 * Toolkit::MaxKawaseLevels;
 		srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
 		srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
 		md3dDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSrvUavDescriptorHeap));
 
 
 		CD3DX12_CPU_DESCRIPTOR_HANDLE hDescriptor(mSrvUavDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
-		auto tex = mTextures["teapot512"]->Resource;
-
-		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-		srvDesc.Format = tex->GetDesc().Format;
-		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-		srvDesc.Texture2D.MostDetailedMip = 0;
-		srvDesc.Texture2D.MipLevels = tex->GetDesc().MipLevels;
-		srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
-
-		md3dDevice->CreateShaderResourceView(tex.Get(), &srvDesc, hDescriptor);
+		mStreamBackend->SetDescriptor(mTeapot, hDescriptor);
 	}
 
 	{
@@ -346,12 +524,26 @@ void BlurApp::BuildDescriptorHeaps()
 			= CD3DX12_GPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetGPUDescriptorHandleForHeapStart(), 1, mCbvSrvUavDescriptorSize);
 		mBlurGpuUav
 			= CD3DX12_GPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetGPUDescriptorHandleForHeapStart(), 2, mCbvSrvUavDescriptorSize);
+
+		mBlurVertCpuSrv
+			= CD3DX12_CPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetCPUDescriptorHandleForHeapStart(), 3, mCbvSrvUavDescriptorSize);
+		mBlurVertCpuUav
+			= CD3DX12_CPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetCPUDescriptorHandleForHeapStart(), 4, mCbvSrvUavDescriptorSize);
+
+		mBlurVertGpuSrv
+			= CD3DX12_GPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetGPUDescriptorHandleForHeapStart(), 3, mCbvSrvUavDescriptorSize);
+		mBlurVertGpuUav
+			= CD3DX12_GPU_DESCRIPTOR_HANDLE(mSrvUavDescriptorHeap->GetGPUDescriptorHandleForHeapStart(), 4, mCbvSrvUavDescriptorSize);
+
+		mKawaseSrvOffset = 5;
+		mKawaseUavOffset = mKawaseSrvOffset + Toolkit::MaxKawaseLevels;
 	}
 }
 
 void BlurApp::BuildBuffers()
 {
 	ObjectCB = std::make_unique<UploadBuffer<ObjectConstants>>(md3dDevice.Get(), 1, 1);
+	mBlurWeightsBuffer = std::make_unique<UploadBuffer<float>>(md3dDevice.Get(), 2 * Toolkit::MaxBlurRadius + 1, false);
 }
 
 void BlurApp::BuildRootSignature()
@@ -393,14 +585,18 @@ void BlurApp::BuildRootSignature()
 		CD3DX12_DESCRIPTOR_RANGE uavTable;
 		uavTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 1, 0);
 
-		CD3DX12_ROOT_PARAMETER slotRootParameter[2];
+		CD3DX12_ROOT_PARAMETER slotRootParameter[4];
 		slotRootParameter[0].InitAsDescriptorTable(1, &srvTable);
 		slotRootParameter[1].InitAsDescriptorTable(1, &uavTable);
+		slotRootParameter[2].InitAsConstants(1, 0);
+		slotRootParameter[3].InitAsShaderResourceView(1);
+
+		auto staticSamplers = GetStaticSamplers();
 
 		CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(
 			sizeof(slotRootParameter) / sizeof(CD3DX12_ROOT_PARAMETER),
 			slotRootParameter,
-			0, nullptr,
+			(UINT)staticSamplers.size(), staticSamplers.data(),
 			D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
 		ComPtr<ID3DBlob> serializedRootSig = nullptr;
@@ -426,7 +622,10 @@ void BlurApp::BuildShaderAndInputLayout()
 	mShaders["blurVS"] = d3dUtil::LoadBinary(L"..\\Shaders\\Blur\\blur_vs.cso");
 	mShaders["blurPS"] = d3dUtil::LoadBinary(L"..\\Shaders\\Blur\\blur_ps.cso");
 
-	mShaders["blurCS"] = d3dUtil::LoadBinary(L"..\\Shaders\\Blur\\blur_cs.cso");
+	mShaders["blurHorzCS"] = d3dUtil::CompileShader(L"..\\Shaders\\Blur\\blur_cs.hlsl", nullptr, "HorzBlurCS", "cs_5_1");
+	mShaders["blurVertCS"] = d3dUtil::CompileShader(L"..\\Shaders\\Blur\\blur_cs.hlsl", nullptr, "VertBlurCS", "cs_5_1");
+	mShaders["kawaseDownCS"] = d3dUtil::CompileShader(L"..\\Shaders\\Blur\\kawase_cs.hlsl", nullptr, "DownCS", "cs_5_1");
+	mShaders["kawaseUpCS"] = d3dUtil::CompileShader(L"..\\Shaders\\Blur\\kawase_cs.hlsl", nullptr, "UpCS", "cs_5_1");
 
 	mInputLayout =
 	{
@@ -451,6 +650,10 @@ void BlurApp::BuildObject()
 		2,1,0
 	};
 
+	const std::vector<std::uint32_t> indices32(indices.begin(), indices.end());
+	mQuadUVDensity = TextureStreamer::UVDensity(&vertices[0].pos, sizeof(Vertex),
+		&vertices[0].TexC, sizeof(Vertex), indices32.data(), indices32.size());
+
 	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
 	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint16_t);
 
@@ -460,6 +663,7 @@ void BlurApp::BuildObject()
 	CopyMemory(mBoxGeo->VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
 	D3DCreateBlob(ibByteSize, &mBoxGeo->IndexBufferCPU);
 	CopyMemory(mBoxGeo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+	mBoxGeo->TrackCpuMemory();
 
 	mBoxGeo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
 		mCommandList.Get(), vertices.data(), vbByteSize, mBoxGeo->VertexBufferUploader);
@@ -512,9 +716,27 @@ void BlurApp::BuildPSOs()
 	ZeroMemory(&blurPsoDesc, sizeof(D3D12_COMPUTE_PIPELINE_STATE_DESC));
 	blurPsoDesc.pRootSignature = mRootSignatureBlur.Get();
 	blurPsoDesc.CS = {
-		reinterpret_cast<BYTE*>(mShaders["blurCS"]->GetBufferPointer()),
-		mShaders["blurCS"]->GetBufferSize()
+		reinterpret_cast<BYTE*>(mShaders["blurHorzCS"]->GetBufferPointer()),
+		mShaders["blurHorzCS"]->GetBufferSize()
 	};
 	blurPsoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
-	md3dDevice->CreateComputePipelineState(&blurPsoDesc, IID_PPV_ARGS(&mPSOs["blur"]));
+	md3dDevice->CreateComputePipelineState(&blurPsoDesc, IID_PPV_ARGS(&mPSOs["blurHorz"]));
+
+	blurPsoDesc.CS = {
+		reinterpret_cast<BYTE*>(mShaders["blurVertCS"]->GetBufferPointer()),
+		mShaders["blurVertCS"]->GetBufferSize()
+	};
+	md3dDevice->CreateComputePipelineState(&blurPsoDesc, IID_PPV_ARGS(&mPSOs["blurVert"]));
+
+	blurPsoDesc.CS = {
+		reinterpret_cast<BYTE*>(mShaders["kawaseDownCS"]->GetBufferPointer()),
+		mShaders["kawaseDownCS"]->GetBufferSize()
+	};
+	md3dDevice->CreateComputePipelineState(&blurPsoDesc, IID_PPV_ARGS(&mPSOs["kawaseDown"]));
+
+	blurPsoDesc.CS = {
+		reinterpret_cast<BYTE*>(mShaders["kawaseUpCS"]->GetBufferPointer()),
+		mShaders["kawaseUpCS"]->GetBufferSize()
+	};
+	md3dDevice->CreateComputePipelineState(&blurPsoDesc, IID_PPV_ARGS(&mPSOs["kawaseUp"]));
 }
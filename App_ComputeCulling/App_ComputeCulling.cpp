@@ -4,6 +4,8 @@
 #include "MyApp.h"
 #include "Model.h"
 #include "Toolkit.h"
+#include "SceneDatabase.h"
+#include "LodSelector.h"
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 using namespace DirectX::PackedVector;
@@ -17,26 +19,6 @@ struct Vertex
 	XMFLOAT4 color;
 };
 
-struct RenderItem
-{
-	RenderItem() = default;
-
-	XMFLOAT4X4 World = MathHelper::Identity4x4();
-
-	int NumFramesDirty = gNumFrame;
-
-	UINT ObjCBIndex = -1;
-
-	MeshGeometry* Geo = nullptr;
-	BoundingBox BoundingBox;
-
-	D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-
-	UINT IndexCount = 0;
-	UINT StartIndexLocation = 0;
-	int BaseVertexLocation = 0;
-};
-
 struct ObjectConstants
 {
 	DirectX::XMFLOAT4X4 World = MathHelper::Identity4x4();
@@ -159,11 +141,18 @@ private:
 	std::unordered_map<std::string, std::unique_ptr<Model>> mModels;
 	void LoadModels();
 
-	std::vector<std::unique_ptr<RenderItem>> mAllRenderitems;
-	std::vector<RenderItem*> mOpaqueRenderitems;
-	std::vector<RenderItem*> mCpuCullingRenderitems;
+	// All the render items are opaque, SceneDatabase::DrawArgs::Geometry indexes mGeometries.
+	SceneDatabase mScene{ gNumFrame };
+	std::vector<MeshGeometry*> mGeometries;
+	FrameVector<std::uint32_t> mCpuCullingItems;
 	void BuildRenderItems();
 
+	// SceneDatabase::DrawArgs::LodChain indexes mLodChains. Only the CPU paths switch levels,
+	// the indirect commands built for the compute shader keep full detail.
+	std::vector<const SubmeshGeometry*> mLodChains;
+	LodSelector mLodSelector;
+	void SelectLods(const std::uint32_t* items, size_t count);
+
 	std::vector<std::unique_ptr<FrameResource>> mFrameResources;
 	int mCurrFrameResourceIndex = 0;
 	FrameResource* mCurrFrameResource = nullptr;
@@ -180,7 +169,8 @@ private:
 	std::unordered_map<std::string, ComPtr<ID3D12PipelineState>> mPSOs;
 	void BuildPSOs();
 
-	void DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& ritems);
+	// items: indices into mScene, nullptr draws all of them.
+	void DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::uint32_t* items, size_t count);
 
 	static inline UINT AlignForUavCounter(UINT bufferSize)
 	{
@@ -225,6 +215,7 @@ bool ComputeCull::Initialize()
 	mCamera.SetLens(45.0f, (float)mClientWidth / mClientHeight, 1, 3000);
 
 	BoundingFrustum::CreateFromMatrix(mCamFrustum, mCamera.GetProj());
+	mLodSelector.SetProjection(mCamera.GetProj(), (float)mClientHeight);
 
 	mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr);
 
@@ -285,37 +276,32 @@ void ComputeCull::Update(const GameTimer& gt)
 		currPassCB->CopyData(0, passInfo);
 	}
 
+	// the list of the last frame lives in the other arena, replacing it does not touch its memory
+	LinearArena& arena = mFrameArena.Current();
+	mCpuCullingItems = FrameVector<std::uint32_t>(arena);
+
 	if (mRenderState == 1) {
 		//CPU Culling
-		mCpuCullingRenderitems.clear();
+		mCpuCullingItems.resize(mScene.Size());
 
 		XMMATRIX view = mCamera.GetView();
 		XMMATRIX invView = XMMatrixInverse(&XMMatrixDeterminant(view), view);
 
-		for (int i = 0; i < mOpaqueRenderitems.size(); i++) {
-
-			XMMATRIX world = XMLoadFloat4x4(&mOpaqueRenderitems[i]->World);
-			XMMATRIX invWorld = XMMatrixInverse(&XMMatrixDeterminant(world), world);
-			XMMATRIX viewToLocal = XMMatrixMultiply(invView, invWorld);
-			BoundingFrustum localSpaceFrustum;
-			mCamFrustum.Transform(localSpaceFrustum, viewToLocal);
-
-			if (localSpaceFrustum.Contains(mOpaqueRenderitems[i]->BoundingBox) != DirectX::DISJOINT) {
-				mCpuCullingRenderitems.push_back(mOpaqueRenderitems[i]);
-			}
-		}
+		mCpuCullingItems.resize(mScene.Cull(mCamFrustum, invView, mCpuCullingItems.data()));
+		SelectLods(mCpuCullingItems.data(), mCpuCullingItems.size());
+	}
+	if (mRenderState == 2) {
+		SelectLods(nullptr, mScene.Size());
 	}
 
-	std::wostringstream outs;
-	std::string text;
-	if (mRenderState == 0) { text = "Culling using CS."; }
-	if (mRenderState == 1) { 
-		text = (std::string)"Culling using CPU.    " + std::to_string(mCpuCullingRenderitems.size()) +
-			" objects visible out of " + std::to_string(mOpaqueRenderitems.size());
+	const wchar_t* text = L"";
+	if (mRenderState == 0) { text = L"Culling using CS."; }
+	if (mRenderState == 1) {
+		text = arena.FormatW(L"Culling using CPU.    %zu objects visible out of %zu",
+			mCpuCullingItems.size(), (size_t)mScene.Size());
 	}
-	if (mRenderState == 2) { text = "No Culling."; }
-	outs << L"Compute Culling: " <<L"    " << text.c_str();
-	mMainWndCaption = outs.str();
+	if (mRenderState == 2) { text = L"No Culling."; }
+	mMainWndCaption.assign(arena.FormatW(L"Compute Culling:     %ls", text));
 }
 
 void ComputeCull::Draw(const GameTimer& gt)
@@ -388,13 +374,14 @@ void ComputeCull::Draw(const GameTimer& gt)
 
 		if (mRenderState == 0) {
 
-			for (size_t i = 0; i < mOpaqueRenderitems.size(); ++i)
+			const SceneDatabase::DrawArgs* draws = mScene.Draws();
+			for (UINT i = 0; i < mScene.Size(); ++i)
 			{
-				auto ri = mOpaqueRenderitems[i];
+				auto geo = mGeometries[draws[i].Geometry];
 
-				mCommandList->IASetVertexBuffers(0, 1, &ri->Geo->VertexBufferView());
-				mCommandList->IASetIndexBuffer(&ri->Geo->IndexBufferView());
-				mCommandList->IASetPrimitiveTopology(ri->PrimitiveType);
+				mCommandList->IASetVertexBuffers(0, 1, &geo->VertexBufferView());
+				mCommandList->IASetIndexBuffer(&geo->IndexBufferView());
+				mCommandList->IASetPrimitiveTopology((D3D12_PRIMITIVE_TOPOLOGY)draws[i].PrimitiveType);
 			}
 
 			mCommandList->ExecuteIndirect(
@@ -407,12 +394,12 @@ void ComputeCull::Draw(const GameTimer& gt)
 		}
 
 		else if (mRenderState == 1) {
-			DrawRenderItems(mCommandList.Get(), mCpuCullingRenderitems);
+			DrawRenderItems(mCommandList.Get(), mCpuCullingItems.data(), mCpuCullingItems.size());
 		}
 
 		else if (mRenderState == 2) {
 
-			DrawRenderItems(mCommandList.Get(), mOpaqueRenderitems);
+			DrawRenderItems(mCommandList.Get(), nullptr, mScene.Size());
 
 			//for (size_t i = 0; i < mOpaqueRenderitems.size(); ++i)
 			//{
@@ -468,6 +455,7 @@ void ComputeCull::OnResize()
 	MyApp::OnResize();
 
 	BoundingFrustum::CreateFromMatrix(mCamFrustum, mCamera.GetProj());
+	mLodSelector.SetProjection(mCamera.GetProj(), (float)mClientHeight);
 }
 
 void ComputeCull::BuildFrameResources()
@@ -566,21 +554,33 @@ void ComputeCull::BuildShadersAndInputLayout()
 	mInputLayout = {
 		{"POSITION",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0} ,
 		{"NORMAL",0,DXGI_FORMAT_R32G32B32_FLOAT,0,sizeof(XMFLOAT3),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
-		{"TANGENTU",0,DXGI_FORMAT_R32G32B32_FLOAT,0,sizeof(XMFLOAT3) * 2,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
-		{"TEXC",0,DXGI_FORMAT_R32G32_FLOAT,0,sizeof(XMFLOAT3) * 3,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0}
+		{"TANGENTU",0,DXGI_FORMAT_R32G32B32A32_FLOAT,0,sizeof(XMFLOAT3) * 2,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"TEXC",0,DXGI_FORMAT_R32G32_FLOAT,0,sizeof(XMFLOAT3) * 2 + sizeof(XMFLOAT4),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0}
 	};
 }
 
 void ComputeCull::LoadModels()
 {
-	std::unique_ptr<Model> pacman = std::make_unique<Model>("pacman", "../resources/pacman/Pacman.stl", md3dDevice.Get(), mCommandList.Get());
+	std::unique_ptr<Model> pacman = std::make_unique<Model>("pacman", "../resources/pacman/Pacman.stl", md3dDevice.Get(), mCommandList.Get(), 4);
 
 	mModels[pacman->Geo()->Name] = std::move(pacman);
 }
 
 void ComputeCull::BuildRenderItems()
 {
-	int objCBIndex = 0;
+	mGeometries.push_back(const_cast<MeshGeometry*>(mModels["pacman"]->Geo()));
+	mScene.Reserve(gNumObjects * (UINT)mGeometries[0]->DrawArgs.size());
+
+	// one chain per submesh, shared by all instances
+	std::unordered_map<std::string, std::uint32_t> lodChains;
+	for (auto& drawArg : mModels["pacman"]->Geo()->DrawArgs) {
+		lodChains[drawArg.first] = SceneDatabase::NoLodChain;
+		if (!drawArg.second.Lods.empty()) {
+			lodChains[drawArg.first] = (std::uint32_t)mLodChains.size();
+			mLodChains.push_back(&drawArg.second);
+		}
+	}
+
 	float r = 0;
 	int len = std::cbrt(gNumObjects / 8);
 	int step = 800;
@@ -593,30 +593,28 @@ void ComputeCull::BuildRenderItems()
 				XMFLOAT3 color(r, 0, 0); r += 1.0 / gNumObjects;
 
 				for (auto& drawArg : mModels["pacman"]->Geo()->DrawArgs) {
-					auto renderItem = std::make_unique<RenderItem>();
-					XMStoreFloat4x4(&renderItem->World, worldMatrix);
-					renderItem->ObjCBIndex = objCBIndex++;
-					renderItem->Geo = const_cast<MeshGeometry*>(mModels["pacman"]->Geo());
-					renderItem->BoundingBox = drawArg.second.Bounds;
-					renderItem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-					renderItem->IndexCount = drawArg.second.IndexCount;
-					renderItem->StartIndexLocation = drawArg.second.StartIndexLocation;
-					renderItem->BaseVertexLocation = drawArg.second.BaseVertexLocation;
-					mAllRenderitems.push_back(std::move(renderItem));
+					XMFLOAT4X4 world;
+					XMMATRIX submeshTransform = XMLoadFloat4x4(&mModels["pacman"]->SubmeshTransform(drawArg.first));
+					XMStoreFloat4x4(&world, submeshTransform * worldMatrix);
+
+					SceneDatabase::DrawArgs draw;
+					draw.Geometry = 0;
+					draw.PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+					draw.IndexCount = drawArg.second.IndexCount;
+					draw.StartIndexLocation = drawArg.second.StartIndexLocation;
+					draw.BaseVertexLocation = drawArg.second.BaseVertexLocation;
+					draw.LodChain = lodChains[drawArg.first];
+					mScene.Add(world, drawArg.second.Bounds, draw);
 				}
 			}
 		}
 	}
-
-
-	// All the render items are opaque.
-	for (auto& e : mAllRenderitems) mOpaqueRenderitems.push_back(e.get());
 }
 
 void ComputeCull::BuildDescriptorHeaps()
 {
 	{
-		UINT objCount = (UINT)mOpaqueRenderitems.size();
+		UINT objCount = mScene.Size();
 		UINT frameCount = gNumFrame;
 
 		UINT numDescriptors = objCount * gNumFrame + frameCount;
@@ -645,23 +643,20 @@ void ComputeCull::BuildBuffers()
 		//Store Per Object CB
 		for (int i = 0; i < mFrameResources.size(); i++) {
 			auto currObjectCB = mFrameResources[i]->ObjectCB.get();
-			for (auto& e : mAllRenderitems)
-			{
-				// Only update the cbuffer data if the constants have changed.  
-				// This needs to be tracked per frame resource.
-				if (e->NumFramesDirty > 0)
+			const XMFLOAT4X4* worlds = mScene.Worlds();
+			const std::uint32_t* objCBIndices = mScene.ObjCBIndices();
+
+			// Only update the cbuffer data if the constants have changed.  
+			// This needs to be tracked per frame resource, ForEachDirty counts it down.
+			mScene.ForEachDirty([&](std::uint32_t item)
 				{
-					XMMATRIX world = XMLoadFloat4x4(&e->World);
+					XMMATRIX world = XMLoadFloat4x4(&worlds[item]);
 
 					ObjectConstants objConstants;
 					XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
 
-					currObjectCB->CopyData(e->ObjCBIndex, objConstants);
-
-					// Next FrameResource need to be updated too.
-					e->NumFramesDirty--;
-				}
-			}
+					currObjectCB->CopyData(objCBIndices[item], objConstants);
+				});
 		}
 	}
 
@@ -752,21 +747,20 @@ void ComputeCull::BuildCommands()
 		commands.resize(gNumObjects * gNumFrame);
 		UINT commandIndex = 0;
 
-		for (UINT i = 0; i < min(gNumObjects, mOpaqueRenderitems.size()); i++)
+		const SceneDatabase::DrawArgs* draws = mScene.Draws();
+		for (UINT i = 0; i < min((UINT)gNumObjects, mScene.Size()); i++)
 		{
 			D3D12_GPU_VIRTUAL_ADDRESS cbvPerObjGpuAddress =
 				mFrameResources[frame]->ObjectCB->Resource()->GetGPUVirtualAddress() + i * objCBByteSize;
 			D3D12_GPU_VIRTUAL_ADDRESS cbvPerPassGpuAddress =
 				mFrameResources[frame]->PassCB->Resource()->GetGPUVirtualAddress() + frame * passCBByteSize;
 
-			auto ri = mOpaqueRenderitems[i];
-
 			commands[commandIndex].cbvPerObj = cbvPerObjGpuAddress;
 			commands[commandIndex].cbvPerPass = cbvPerPassGpuAddress;
-			commands[commandIndex].drawArguments.BaseVertexLocation = ri->BaseVertexLocation;
-			commands[commandIndex].drawArguments.IndexCountPerInstance = ri->IndexCount;
+			commands[commandIndex].drawArguments.BaseVertexLocation = draws[i].BaseVertexLocation;
+			commands[commandIndex].drawArguments.IndexCountPerInstance = draws[i].IndexCount;
 			commands[commandIndex].drawArguments.InstanceCount = 1;
-			commands[commandIndex].drawArguments.StartIndexLocation = ri->StartIndexLocation;
+			commands[commandIndex].drawArguments.StartIndexLocation = draws[i].StartIndexLocation;
 			commands[commandIndex].drawArguments.StartInstanceLocation = 0;
 
 			commandIndex++;
@@ -781,17 +775,20 @@ void ComputeCull::BuildCommands()
 
 void ComputeCull::BuildObjectsCullInfo()
 {
+	const XMFLOAT4X4* worlds = mScene.Worlds();
+	const BoundingBox* bounds = mScene.LocalBounds();
+
 	for (int frame = 0; frame < gNumFrame; frame++) {
-		for (int i = 0; i < min(mOpaqueRenderitems.size(), gNumObjects); i++) {
+		for (UINT i = 0; i < min(mScene.Size(), (UINT)gNumObjects); i++) {
 			CullObjectInfo objInfo;
 
-			XMMATRIX worldMatrix = XMLoadFloat4x4(&mOpaqueRenderitems[i]->World);
+			XMMATRIX worldMatrix = XMLoadFloat4x4(&worlds[i]);
 			XMStoreFloat4x4(&objInfo.World, XMMatrixTranspose(worldMatrix));
 
-			auto float3 = mOpaqueRenderitems[i]->BoundingBox.Center;
+			auto float3 = bounds[i].Center;
 			objInfo.boxCenter = XMFLOAT4(float3.x, float3.y, float3.z, 1.0f);
 
-			float3 = mOpaqueRenderitems[i]->BoundingBox.Extents;
+			float3 = bounds[i].Extents;
 			objInfo.boxLen = XMFLOAT4(float3.x, float3.y, float3.z, 1.0f);
 
 			mFrameResources[frame]->CullObjectBuffer->CopyData(i, objInfo);
@@ -846,7 +843,7 @@ void ComputeCull::BuildPSOs()
 	}
 }
 
-void ComputeCull::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& ritems)
+void ComputeCull::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::uint32_t* items, size_t count)
 {
 	UINT objCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(ObjectConstants));
 	UINT passCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(PassConstants));
@@ -858,20 +855,57 @@ void ComputeCull::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std:
 		mCurrFrameResource->PassCB->Resource()->GetGPUVirtualAddress() +
 		(mCurrFrameResourceIndex * passCBByteSize));
 
+	const SceneDatabase::DrawArgs* draws = mScene.Draws();
+	const std::uint32_t* objCBIndices = mScene.ObjCBIndices();
+	const std::uint8_t* lodLevels = mScene.LodLevels();
+
 	// For each render item...
-	for (size_t i = 0; i < ritems.size(); ++i)
+	for (size_t i = 0; i < count; ++i)
 	{
-		auto ri = ritems[i];
+		std::uint32_t item = items != nullptr ? items[i] : (std::uint32_t)i;
+		const SceneDatabase::DrawArgs& draw = draws[item];
+		auto geo = mGeometries[draw.Geometry];
 
-		cmdList->IASetVertexBuffers(0, 1, &ri->Geo->VertexBufferView());
-		cmdList->IASetIndexBuffer(&ri->Geo->IndexBufferView());
-		cmdList->IASetPrimitiveTopology(ri->PrimitiveType);
+		cmdList->IASetVertexBuffers(0, 1, &geo->VertexBufferView());
+		cmdList->IASetIndexBuffer(&geo->IndexBufferView());
+		cmdList->IASetPrimitiveTopology((D3D12_PRIMITIVE_TOPOLOGY)draw.PrimitiveType);
 
 		cmdList->SetGraphicsRootConstantBufferView(
 			(UINT)GraphicsRootParameters::CbvPerObj,
 			mCurrFrameResource->ObjectCB->Resource()->GetGPUVirtualAddress() + 
-			(ri->ObjCBIndex * objCBByteSize));
+			(objCBIndices[item] * objCBByteSize));
+
+		UINT indexCount = draw.IndexCount;
+		UINT startIndexLocation = draw.StartIndexLocation;
+		if (draw.LodChain != SceneDatabase::NoLodChain) {
+			const SubmeshLod& lod = mLodChains[draw.LodChain]->Lods[lodLevels[item]];
+			indexCount = lod.IndexCount;
+			startIndexLocation = lod.StartIndexLocation;
+		}
+
+		cmdList->DrawIndexedInstanced(indexCount, 1, startIndexLocation, draw.BaseVertexLocation, 0);
+	}
+}
+
+void ComputeCull::SelectLods(const std::uint32_t* items, size_t count)
+{
+	XMVECTOR eye = mCamera.GetPosition();
+
+	const BoundingBox* bounds = mScene.WorldBounds();
+	const SceneDatabase::DrawArgs* draws = mScene.Draws();
+	std::uint8_t* lodLevels = mScene.LodLevels();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::uint32_t item = items != nullptr ? items[i] : (std::uint32_t)i;
+		if (draws[item].LodChain == SceneDatabase::NoLodChain)
+			continue;
+
+		const auto& lods = mLodChains[draws[item].LodChain]->Lods;
+		float radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&bounds[item].Extents)));
+		float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&bounds[item].Center) - eye));
 
-		cmdList->DrawIndexedInstanced(ri->IndexCount, 1, ri->StartIndexLocation, ri->BaseVertexLocation, 0);
+		lodLevels[item] = (std::uint8_t)mLodSelector.Select(&lods[0].Error, (std::uint32_t)lods.size(), sizeof(SubmeshLod),
+			mLodSelector.ProjectedSize(radius, distance), lodLevels[item]);
 	}
 }
@@ -2,6 +2,7 @@
 #include "Common/MathHelper.h"
 #include "Common/UploadBuffer.h"
 #include "MyApp.h"
+#include "Culling.h"
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 using namespace DirectX::PackedVector;
@@ -126,33 +127,30 @@ void CullingApp::Update(const GameTimer& gt)
 	mObjectCB->CopyData(0, objConstants);
 
 	// Culling
-	mInstanceDrawNum = 0;
-
 	XMMATRIX view = mCamera.GetView();
 	XMMATRIX invView = XMMatrixInverse(&XMMatrixDeterminant(view), view);
 
+	// Visible instances are packed on the frame arena and reach the upload buffer in one copy.
+	FrameVector<InstanceData> visible(mFrameArena.Current());
+	visible.reserve(mInstanceData.size());
+
 	auto& e = mBoxGeo->DrawArgs["object"];
 	for (int i = 0; i < mInstanceData.size(); i++) {
 
 		XMMATRIX world = XMLoadFloat4x4(&mInstanceData[i].World);
-		XMMATRIX invWorld = XMMatrixInverse(&XMMatrixDeterminant(world), world);
-		XMMATRIX viewToLocal = XMMatrixMultiply(invView, invWorld);
-		BoundingFrustum localSpaceFrustum;
-		mCamFrustum.Transform(localSpaceFrustum, viewToLocal);
 
-		if (localSpaceFrustum.Contains(e.Bounds) != DirectX::DISJOINT) {
+		if (Culling::IsVisible(mCamFrustum, invView, world, e.Bounds)) {
 			auto data = mInstanceData[i];
 			XMStoreFloat4x4(&data.World, XMMatrixTranspose(world));
-			mInstanceBuffer->CopyData(mInstanceDrawNum++, data);
+			visible.push_back(data);
 		}
 	}
 
-	std::wostringstream outs;
-	outs.precision(6);
-	outs << L"Instancing and Culling Demo" <<
-		L"    " << mInstanceDrawNum <<
-		L" objects visible out of " << mInstanceData.size();
-	mMainWndCaption = outs.str();
+	mInstanceDrawNum = (int)visible.size();
+	mInstanceBuffer->CopyRange(0, visible.data(), mInstanceDrawNum);
+
+	mMainWndCaption.assign(mFrameArena.Current().FormatW(L"Instancing and Culling Demo    %d objects visible out of %zu",
+		mInstanceDrawNum, mInstanceData.size()));
 }
 
 void CullingApp::Draw(const GameTimer& gt)
@@ -328,6 +326,7 @@ void CullingApp::BuildObject()
 	CopyMemory(mBoxGeo->VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
 	D3DCreateBlob(ibByteSize, &mBoxGeo->IndexBufferCPU);
 	CopyMemory(mBoxGeo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+	mBoxGeo->TrackCpuMemory();
 
 	mBoxGeo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
 		mCommandList.Get(), vertices.data(), vbByteSize, mBoxGeo->VertexBufferUploader);
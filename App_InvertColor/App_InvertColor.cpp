@@ -616,6 +616,7 @@ void InvertColor::BuildShapeGeometry()
 
 		D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU);
 		CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+		geo->TrackCpuMemory();
 
 		geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
 			mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
@@ -658,6 +659,7 @@ void InvertColor::BuildShapeGeometry()
 		CopyMemory(presentGeo->VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
 		ThrowIfFailed(D3DCreateBlob(ibByteSize, &presentGeo->IndexBufferCPU));
 		CopyMemory(presentGeo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+		presentGeo->TrackCpuMemory();
 
 		presentGeo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
 			mCommandList.Get(), vertices.data(), vbByteSize, presentGeo->VertexBufferUploader);
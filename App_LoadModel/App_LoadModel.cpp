@@ -32,11 +32,18 @@ struct RenderItem
 	UINT IndexCount = 0;
 	UINT StartIndexLocation = 0;
 	int BaseVertexLocation = 0;
+
+	// The packed positions are relative to the submesh bounds.
+	BoundingBox Bounds;
 };
 
 struct ObjectConstants
 {
 	DirectX::XMFLOAT4X4 World = MathHelper::Identity4x4();
+	XMFLOAT3 BoundsCenter = { 0.0f,0.0f,0.0f };
+	float Pad0 = 0.0f;
+	XMFLOAT3 BoundsExtents = { 1.0f,1.0f,1.0f };
+	float Pad1 = 0.0f;
 };
 
 struct PassConstants
@@ -194,6 +201,8 @@ void LoadModel::Update(const GameTimer& gt)
 
 			ObjectConstants objConstants;
 			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
+			objConstants.BoundsCenter = e->Bounds.Center;
+			objConstants.BoundsExtents = e->Bounds.Extents;
 
 			currObjectCB->CopyData(e->ObjCBIndex, objConstants);
 
@@ -317,17 +326,12 @@ void LoadModel::BuildShadersAndInputLayout()
 	mShaders["standardVS"] = d3dUtil::CompileShader(L"..\\Shaders\\LoadModel\\shader.hlsl", nullptr, "VS", "vs_5_1");
 	mShaders["opaquePS"] = d3dUtil::CompileShader(L"..\\Shaders\\LoadModel\\shader.hlsl", nullptr, "PS", "ps_5_1");
 
-	mInputLayout = {
-		{"POSITION",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0} ,
-		{"NORMAL",0,DXGI_FORMAT_R32G32B32_FLOAT,0,sizeof(XMFLOAT3),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
-		{"TANGENTU",0,DXGI_FORMAT_R32G32B32_FLOAT,0,sizeof(XMFLOAT3) * 2,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
-		{"TEXC",0,DXGI_FORMAT_R32G32_FLOAT,0,sizeof(XMFLOAT3) * 3,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0}
-	};
+	mInputLayout = Model::InputLayout(Model::VertexFormat::Packed);
 }
 
 void LoadModel::LoadModels()
 {
-	std::unique_ptr<Model> pacman = std::make_unique<Model>("pacman", "../resources/pacman/Pacman.stl", md3dDevice.Get(), mCommandList.Get());
+	std::unique_ptr<Model> pacman = std::make_unique<Model>("pacman", "../resources/pacman/Pacman.stl", md3dDevice.Get(), mCommandList.Get(), 1, Model::VertexFormat::Packed);
 
 	mModels[pacman->Geo()->Name] = std::move(pacman);
 }
@@ -337,13 +341,15 @@ void LoadModel::BuildRenderItems()
 	int objCBIndex = 0;
 	for (auto& drawArg : mModels["pacman"]->Geo()->DrawArgs) {
 		auto renderItem = std::make_unique<RenderItem>();
-		XMStoreFloat4x4(&renderItem->World, XMMatrixRotationRollPitchYaw(XMConvertToRadians(90), 0.0f, 0.0f));
+		XMMATRIX submeshTransform = XMLoadFloat4x4(&mModels["pacman"]->SubmeshTransform(drawArg.first));
+		XMStoreFloat4x4(&renderItem->World, submeshTransform * XMMatrixRotationRollPitchYaw(XMConvertToRadians(90), 0.0f, 0.0f));
 		renderItem->ObjCBIndex = objCBIndex++;
 		renderItem->Geo = const_cast<MeshGeometry*>(mModels["pacman"]->Geo());
 		renderItem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 		renderItem->IndexCount = drawArg.second.IndexCount;
 		renderItem->StartIndexLocation = drawArg.second.StartIndexLocation;
 		renderItem->BaseVertexLocation = drawArg.second.BaseVertexLocation;
+		renderItem->Bounds = drawArg.second.Bounds;
 		mAllRenderitems.push_back(std::move(renderItem));
 	}
 
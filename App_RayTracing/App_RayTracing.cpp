@@ -344,7 +344,8 @@ void RayTracing::BuildRenderItems()
 	int objCBIndex = 0;
 	for (auto& drawArg : mModels["pacman"]->Geo()->DrawArgs) {
 		auto renderItem = std::make_unique<RenderItem>();
-		XMStoreFloat4x4(&renderItem->World, XMMatrixRotationRollPitchYaw(XMConvertToRadians(90), 0.0f, 0.0f));
+		XMMATRIX submeshTransform = XMLoadFloat4x4(&mModels["pacman"]->SubmeshTransform(drawArg.first));
+		XMStoreFloat4x4(&renderItem->World, submeshTransform * XMMatrixRotationRollPitchYaw(XMConvertToRadians(90), 0.0f, 0.0f));
 		renderItem->ObjCBIndex = objCBIndex++;
 		renderItem->Geo = const_cast<MeshGeometry*>(mModels["pacman"]->Geo());
 		renderItem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
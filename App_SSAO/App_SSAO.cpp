@@ -6,13 +6,18 @@
 #include "RenderTexture.h"
 #include "DebugViewer.h"
 #include "Toolkit.h"
+#include "BlueNoise.h"
+#include "SsaoReference.h"
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 using namespace DirectX::PackedVector;
 
 const int gNumFrameResources = 1;
 const int gNumGBuffer = 3;
-const int gNumRandVec = 14;
+const int gNumRandVec = 8;
+const int gRandomVectorMapSize = 64;
+// SSAO map and its blur at half the resolution of the G-buffer
+const bool gSsaoHalfResolution = false;
 
 struct Vertex
 {
@@ -61,12 +66,14 @@ struct SsaoPassConstants
 	float SurfaceEpsilon;
 	float OcclusionFadeStart;
 	float OcclusionFadeEnd;
+	DirectX::XMFLOAT2 NoiseScale;
 };
 
 struct BlurPassConstants
 {
 	XMFLOAT4X4 Proj;
 	float BlurRadius;
+	int GbufferStep;
 };
 
 struct FrameResource
@@ -213,7 +220,7 @@ public:
 	{
 		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-		srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		srvDesc.Format = Format();
 		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 		srvDesc.Texture2D.MostDetailedMip = 0;
 		srvDesc.Texture2D.MipLevels = 1;
@@ -222,7 +229,7 @@ public:
 		md3dDevice->CreateShaderResourceView(mRenderTex.Get(), &srvDesc, mhCpuSrv);
 
 		D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
-		uavDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		uavDesc.Format = Format();
 		uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
 		uavDesc.Texture2D.MipSlice = 0;
 		md3dDevice->CreateUnorderedAccessView(mRenderTex.Get(), nullptr, &uavDesc, mhCpuUav);
@@ -277,7 +284,10 @@ private:
 	// gbuffer[1]: z
 	// gbuffer[2]: color
 	std::unique_ptr<SsaoMap> mSsaoMap;
+	std::unique_ptr<UAVTex> mSsaoMapBlurTemp;
 	std::unique_ptr<UAVTex> mSsaoMapBlur;
+	UINT mSsaoMapWidth = 0;
+	UINT mSsaoMapHeight = 0;
 
 	ComPtr<ID3D12RootSignature> mRootSignatureGbuffer = nullptr;
 	ComPtr<ID3D12RootSignature> mRootSignatureSsaoMap = nullptr;
@@ -316,6 +326,8 @@ private:
 	UINT mZBufferBlurOffset = 0;
 	UINT mSsaoMapBlurOffset = 0;
 	UINT mOutputTexBlurOffset = 0;
+	UINT mBlurTempSrvOffset = 0;
+	UINT mBlurTempUavOffset = 0;
 	UINT mPresentColorTexOffset = 0;
 	UINT mPresentSsaoMapOffset = 0;
 	ComPtr<ID3D12DescriptorHeap> mHeapGbuffer = nullptr;
@@ -332,7 +344,7 @@ private:
 	std::unordered_map<std::string, ComPtr<ID3D12PipelineState>> mPSOs;
 	void BuildPSOs();
 
-	XMFLOAT4 mOffsetVectors[14];
+	XMFLOAT4 mOffsetVectors[gNumRandVec];
 	void BuildOffsetVectors();
 
 	std::unique_ptr<RandomVectorMap> mRandomVectorMap;
@@ -415,14 +427,21 @@ bool SSAO::Initialize()
 	std::unique_ptr<RenderTexture>zBuffer =
 		std::make_unique<ZBuffer>(md3dDevice.Get(), mClientWidth, mClientHeight);
 
+	mSsaoMapWidth = gSsaoHalfResolution ? MathHelper::Max(mClientWidth / 2, 1) : mClientWidth;
+	mSsaoMapHeight = gSsaoHalfResolution ? MathHelper::Max(mClientHeight / 2, 1) : mClientHeight;
+
 	std::unique_ptr<SsaoMap>ssaoMap =
-		std::make_unique<SsaoMap>(md3dDevice.Get(), mClientWidth, mClientHeight);
+		std::make_unique<SsaoMap>(md3dDevice.Get(), mSsaoMapWidth, mSsaoMapHeight);
 
 	std::unique_ptr<RandomVectorMap>randomVectorMap =
-		std::make_unique<RandomVectorMap>(md3dDevice.Get(), 256, 256);
+		std::make_unique<RandomVectorMap>(md3dDevice.Get(), gRandomVectorMapSize, gRandomVectorMapSize);
+
+	// rows blurred, before the columns
+	std::unique_ptr<UAVTex>ssaoMapBlurTemp =
+		std::make_unique<UAVTex>(md3dDevice.Get(), mSsaoMapWidth, mSsaoMapHeight, DXGI_FORMAT_R16_FLOAT);
 
 	std::unique_ptr<UAVTex>ssaoMapBlur =
-		std::make_unique<UAVTex>(md3dDevice.Get(), mClientWidth, mClientHeight);
+		std::make_unique<UAVTex>(md3dDevice.Get(), mSsaoMapWidth, mSsaoMapHeight);
 
 	std::unique_ptr<ScreenColor>screenColor =
 		std::make_unique<ScreenColor>(md3dDevice.Get(), mClientWidth, mClientHeight);
@@ -432,6 +451,7 @@ bool SSAO::Initialize()
 	mGbuffer[2] = std::move(screenColor);
 	mSsaoMap = std::move(ssaoMap);
 	mRandomVectorMap = std::move(randomVectorMap);
+	mSsaoMapBlurTemp = std::move(ssaoMapBlurTemp);
 	mSsaoMapBlur = std::move(ssaoMapBlur);
 
 	mDebugViewerNormal = std::make_unique<DebugViewer>(md3dDevice, mCommandList, mBackBufferFormat, mCbvSrvUavDescriptorSize, gNumFrameResources);
@@ -458,7 +478,8 @@ bool SSAO::Initialize()
 	mDebugViewerScreenColor->SetTexSrv(mGbuffer[2]->Output(), mGbuffer[2]->SrvFormat());
 	mDebugViewerScreenColor->SetPosition(DebugViewer::Position::Bottom3);
 
-	mBlurWeights = Toolkit::CalcGaussWeights(2.5f);
+	mBlurWeights = Toolkit::CalcGaussWeights(1.5f);
+	assert(mBlurWeights.size() <= 2 * SsaoReference::MaxBlurRadius + 1);
 
 	mCamera.SetPosition(XMFLOAT3(0, 5, -50));
 
@@ -550,7 +571,10 @@ void SSAO::Update(const GameTimer& gt)
 		XMMATRIX invProj = XMMatrixInverse(&XMMatrixDeterminant(proj), proj);
 		XMStoreFloat4x4(&mSsaoPassCB.InvProj, XMMatrixTranspose(invProj));
 
-		std::copy(&mOffsetVectors[0], &mOffsetVectors[14], &mSsaoPassCB.OffsetVectors[0]);
+		std::copy(&mOffsetVectors[0], &mOffsetVectors[gNumRandVec], &mSsaoPassCB.OffsetVectors[0]);
+
+		// one noise texel per pixel of the SSAO map
+		mSsaoPassCB.NoiseScale = XMFLOAT2((float)mSsaoMapWidth / gRandomVectorMapSize, (float)mSsaoMapHeight / gRandomVectorMapSize);
 
 		mSsaoPassCB.OcclusionRadius = 0.5f;
 		mSsaoPassCB.OcclusionFadeStart = 0.2f;
@@ -565,6 +589,7 @@ void SSAO::Update(const GameTimer& gt)
 	// Update Blur Pass CB
 	{
 		mBlurPassCB.BlurRadius = floor((mBlurWeights.size()) / 2);
+		mBlurPassCB.GbufferStep = gSsaoHalfResolution ? 2 : 1;
 		XMStoreFloat4x4(&mBlurPassCB.Proj, XMMatrixTranspose(proj));
 
 		auto currPassCB = mCurrFrameResource->BlurPassCB.get();
@@ -652,9 +677,9 @@ void SSAO::Draw(const GameTimer& gt)
 
 
 		mCommandList->ClearRenderTargetView(mSsaoMap->Rtv(), Colors::Black, 0, nullptr);
-		mCommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 
-		mCommandList->OMSetRenderTargets(1, &mSsaoMap->Rtv(), true, &DepthStencilView());
+		// no depth: the main depth buffer has the size of the screen, the SSAO map may not
+		mCommandList->OMSetRenderTargets(1, &mSsaoMap->Rtv(), true, nullptr);
 
 		ID3D12DescriptorHeap* descriptorHeaps[] = { mHeapSsaoMap.Get() };
 		mCommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
@@ -703,11 +728,11 @@ void SSAO::Draw(const GameTimer& gt)
 			D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_GENERIC_READ));
 		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mGbuffer[2]->Output(),
 			D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_GENERIC_READ));
+		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mSsaoMapBlurTemp->Output(),
+			D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS));
 		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mSsaoMapBlur->Output(),
 			D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS));
 
-		mCommandList->SetPipelineState(mPSOs["blur"].Get());
-
 		ID3D12DescriptorHeap* descriptorHeaps[] = { mHeapBlur.Get() };
 		mCommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
@@ -723,23 +748,46 @@ void SSAO::Draw(const GameTimer& gt)
 		gbufferSrvHandle.Offset(gbufferSrvIndex, mCbvSrvUavDescriptorSize);
 		mCommandList->SetComputeRootDescriptorTable(1, gbufferSrvHandle);
 
+		auto blurWeightsBuffer = mBlurWeightsBuffer->Resource();
+		mCommandList->SetComputeRootShaderResourceView(4, blurWeightsBuffer->GetGPUVirtualAddress());
+
+		// rows: ssao map -> temp
+		mCommandList->SetPipelineState(mPSOs["blurHorz"].Get());
+
 		int ssaoMapSrvIndex = mSsaoMapBlurOffset + mCurrFrameResourceIndex;
 		auto ssaoMapSrvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mHeapBlur->GetGPUDescriptorHandleForHeapStart());
 		ssaoMapSrvHandle.Offset(ssaoMapSrvIndex, mCbvSrvUavDescriptorSize);
 		mCommandList->SetComputeRootDescriptorTable(2, ssaoMapSrvHandle);
 
+		int blurTempUavIndex = mBlurTempUavOffset + mCurrFrameResourceIndex;
+		auto blurTempUavHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mHeapBlur->GetGPUDescriptorHandleForHeapStart());
+		blurTempUavHandle.Offset(blurTempUavIndex, mCbvSrvUavDescriptorSize);
+		mCommandList->SetComputeRootDescriptorTable(3, blurTempUavHandle);
+
+		UINT numGroupX = (UINT)ceilf(mSsaoMapWidth / 256.0f);
+		mCommandList->Dispatch(numGroupX, mSsaoMapHeight, 1);
+
+		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mSsaoMapBlurTemp->Output(),
+			D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_GENERIC_READ));
+
+		// columns: temp -> blurred ssao map
+		mCommandList->SetPipelineState(mPSOs["blurVert"].Get());
+
+		int blurTempSrvIndex = mBlurTempSrvOffset + mCurrFrameResourceIndex;
+		auto blurTempSrvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mHeapBlur->GetGPUDescriptorHandleForHeapStart());
+		blurTempSrvHandle.Offset(blurTempSrvIndex, mCbvSrvUavDescriptorSize);
+		mCommandList->SetComputeRootDescriptorTable(2, blurTempSrvHandle);
+
 		int blurOutUavIndex = mOutputTexBlurOffset + mCurrFrameResourceIndex;
 		auto blurOutUavHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mHeapBlur->GetGPUDescriptorHandleForHeapStart());
 		blurOutUavHandle.Offset(blurOutUavIndex, mCbvSrvUavDescriptorSize);
 		mCommandList->SetComputeRootDescriptorTable(3, blurOutUavHandle);
 
-		auto blurWeightsBuffer = mBlurWeightsBuffer->Resource();
-		mCommandList->SetComputeRootShaderResourceView(4, blurWeightsBuffer->GetGPUVirtualAddress());
-
-		UINT numGroupX = (UINT)ceilf(mClientWidth / 256.0f);
-		mCommandList->Dispatch(numGroupX, mClientHeight, 1);
-
+		UINT numGroupY = (UINT)ceilf(mSsaoMapHeight / 256.0f);
+		mCommandList->Dispatch(mSsaoMapWidth, numGroupY, 1);
 
+		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mSsaoMapBlurTemp->Output(),
+			D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_COMMON));
 		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mSsaoMapBlur->Output(),
 			D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON));
 		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mGbuffer[0]->Output(),
@@ -1068,13 +1116,14 @@ void SSAO::BuildShadersAndInputLayout()
 	mShaders["presentVS"] = d3dUtil::CompileShader(L"..\\Shaders\\SSAO\\present.hlsl", nullptr, "VS", "vs_5_1");
 	mShaders["presentPS"] = d3dUtil::CompileShader(L"..\\Shaders\\SSAO\\present.hlsl", nullptr, "PS", "ps_5_1");
 
-	mShaders["blurCS"] = d3dUtil::CompileShader(L"..\\Shaders\\SSAO\\blur_cs.hlsl", nullptr, "CS", "cs_5_1");
+	mShaders["blurHorzCS"] = d3dUtil::CompileShader(L"..\\Shaders\\SSAO\\blur_cs.hlsl", nullptr, "HorzBlurCS", "cs_5_1");
+	mShaders["blurVertCS"] = d3dUtil::CompileShader(L"..\\Shaders\\SSAO\\blur_cs.hlsl", nullptr, "VertBlurCS", "cs_5_1");
 
 	mInputLayout = {
 		{"POSITION",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0} ,
 		{"NORMAL",0,DXGI_FORMAT_R32G32B32_FLOAT,0,sizeof(XMFLOAT3),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
-		{"TANGENTU",0,DXGI_FORMAT_R32G32B32_FLOAT,0,sizeof(XMFLOAT3) * 2,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
-		{"TEXC",0,DXGI_FORMAT_R32G32_FLOAT,0,sizeof(XMFLOAT3) * 3,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0}
+		{"TANGENTU",0,DXGI_FORMAT_R32G32B32A32_FLOAT,0,sizeof(XMFLOAT3) * 2,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"TEXC",0,DXGI_FORMAT_R32G32_FLOAT,0,sizeof(XMFLOAT3) * 2 + sizeof(XMFLOAT4),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0}
 	};
 }
 
@@ -1242,8 +1291,14 @@ void SSAO::BuildDescriptorHeaps()
 		mOutputTexBlurOffset = mSsaoMapBlurOffset + numSsaoMap;
 		UINT numOutputtex = 1 * gNumFrameResources;
 
+		mBlurTempSrvOffset = mOutputTexBlurOffset + numOutputtex;
+		UINT numBlurTempSrv = 1 * gNumFrameResources;
+
+		mBlurTempUavOffset = mBlurTempSrvOffset + numBlurTempSrv;
+		UINT numBlurTempUav = 1 * gNumFrameResources;
+
 		D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
-		heapDesc.NumDescriptors = numBlurPassCbv + numNormalBuffer + numZBuffer + numSsaoMap + numOutputtex;
+		heapDesc.NumDescriptors = numBlurPassCbv + numNormalBuffer + numZBuffer + numSsaoMap + numOutputtex + numBlurTempSrv + numBlurTempUav;
 		heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
 		heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
 		heapDesc.NodeMask = 0;
@@ -1402,6 +1457,13 @@ void SSAO::BuildBuffers()
 				CD3DX12_CPU_DESCRIPTOR_HANDLE(),
 				CD3DX12_CPU_DESCRIPTOR_HANDLE(rtvCpuStart, mSsaoMapRtvOffset + frameIndex, mRtvDescriptorSize));
 
+			mSsaoMapBlurTemp->RenderTexture::BuildDescriptors(
+				CD3DX12_CPU_DESCRIPTOR_HANDLE(blurSrvCpuStart, mBlurTempSrvOffset + frameIndex, mCbvSrvUavDescriptorSize),
+				CD3DX12_GPU_DESCRIPTOR_HANDLE(blurSrvGpuStart, mBlurTempSrvOffset + frameIndex, mCbvSrvUavDescriptorSize),
+				CD3DX12_CPU_DESCRIPTOR_HANDLE(),
+				CD3DX12_CPU_DESCRIPTOR_HANDLE(),
+				CD3DX12_CPU_DESCRIPTOR_HANDLE(blurUavCpuStart, mBlurTempUavOffset + frameIndex, mCbvSrvUavDescriptorSize));
+
 			mSsaoMapBlur->RenderTexture::BuildDescriptors(
 				CD3DX12_CPU_DESCRIPTOR_HANDLE(presentSrvCpuStart, mPresentSsaoMapOffset + frameIndex, mCbvSrvUavDescriptorSize),
 				CD3DX12_GPU_DESCRIPTOR_HANDLE(presentSrvGpuStart, mPresentSsaoMapOffset + frameIndex, mCbvSrvUavDescriptorSize),
@@ -1467,6 +1529,9 @@ void SSAO::BuildPSOs()
 		ssaoMapPsoDesc.NumRenderTargets = 1;
 		ssaoMapPsoDesc.RTVFormats[0] = mSsaoMap->Format();
 		ssaoMapPsoDesc.RTVFormats[1] = DXGI_FORMAT_UNKNOWN;
+		ssaoMapPsoDesc.DepthStencilState.DepthEnable = false;
+		ssaoMapPsoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+		ssaoMapPsoDesc.DSVFormat = DXGI_FORMAT_UNKNOWN;
 
 		md3dDevice->CreateGraphicsPipelineState(&ssaoMapPsoDesc, IID_PPV_ARGS(&mPSOs["ssaoMap"]));
 	}
@@ -1499,69 +1564,54 @@ void SSAO::BuildPSOs()
 		ZeroMemory(&blurPsoDesc, sizeof(D3D12_COMPUTE_PIPELINE_STATE_DESC));
 		blurPsoDesc.pRootSignature = mRootSignatureBlur.Get();
 		blurPsoDesc.CS = {
-			reinterpret_cast<BYTE*>(mShaders["blurCS"]->GetBufferPointer()),
-			mShaders["blurCS"]->GetBufferSize()
+			reinterpret_cast<BYTE*>(mShaders["blurHorzCS"]->GetBufferPointer()),
+			mShaders["blurHorzCS"]->GetBufferSize()
 		};
 		blurPsoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
-		md3dDevice->CreateComputePipelineState(&blurPsoDesc, IID_PPV_ARGS(&mPSOs["blur"]));
+		md3dDevice->CreateComputePipelineState(&blurPsoDesc, IID_PPV_ARGS(&mPSOs["blurHorz"]));
+
+		blurPsoDesc.CS = {
+			reinterpret_cast<BYTE*>(mShaders["blurVertCS"]->GetBufferPointer()),
+			mShaders["blurVertCS"]->GetBufferSize()
+		};
+		md3dDevice->CreateComputePipelineState(&blurPsoDesc, IID_PPV_ARGS(&mPSOs["blurVert"]));
 	}
 	
 }
 
 void SSAO::BuildOffsetVectors()
 {
-	// 8 cube corners
-	mOffsetVectors[0] = XMFLOAT4(+1.0f, +1.0f, +1.0f, 0.0f);
-	mOffsetVectors[1] = XMFLOAT4(-1.0f, -1.0f, -1.0f, 0.0f);
-
-	mOffsetVectors[2] = XMFLOAT4(-1.0f, +1.0f, +1.0f, 0.0f);
-	mOffsetVectors[3] = XMFLOAT4(+1.0f, -1.0f, -1.0f, 0.0f);
-
-	mOffsetVectors[4] = XMFLOAT4(+1.0f, +1.0f, -1.0f, 0.0f);
-	mOffsetVectors[5] = XMFLOAT4(-1.0f, -1.0f, +1.0f, 0.0f);
-
-	mOffsetVectors[6] = XMFLOAT4(-1.0f, +1.0f, -1.0f, 0.0f);
-	mOffsetVectors[7] = XMFLOAT4(+1.0f, -1.0f, +1.0f, 0.0f);
-
-	// 6 centers of cube faces
-	mOffsetVectors[8] = XMFLOAT4(-1.0f, 0.0f, 0.0f, 0.0f);
-	mOffsetVectors[9] = XMFLOAT4(+1.0f, 0.0f, 0.0f, 0.0f);
-
-	mOffsetVectors[10] = XMFLOAT4(0.0f, -1.0f, 0.0f, 0.0f);
-	mOffsetVectors[11] = XMFLOAT4(0.0f, +1.0f, 0.0f, 0.0f);
-
-	mOffsetVectors[12] = XMFLOAT4(0.0f, 0.0f, -1.0f, 0.0f);
-	mOffsetVectors[13] = XMFLOAT4(0.0f, 0.0f, +1.0f, 0.0f);
-
-	for (int i = 0; i < 14; ++i)
-	{
-		// Create random lengths in [0.25, 1.0).
-		float s = MathHelper::RandF(0.25f, 1.0f);
-
-		XMVECTOR v = s * XMVector4Normalize(XMLoadFloat4(&mOffsetVectors[i]));
-
-		XMStoreFloat4(&mOffsetVectors[i], v);
-	}
+	// low discrepancy offsets in the hemisphere around +z, the shader turns them to the normal
+	std::vector<XMFLOAT4> kernel;
+	BlueNoise::HemisphereKernel(gNumRandVec, 0.25f, kernel);
+	std::copy(kernel.begin(), kernel.end(), mOffsetVectors);
 }
 
 void SSAO::GenRandomVectorMap()
 {
-	XMCOLOR initData[256 * 256];
-	for (int i = 0; i < 256; ++i)
-	{
-		for (int j = 0; j < 256; ++j)
-		{
-			// Random vector in [0,1).
-			XMFLOAT3 v(MathHelper::RandF(), MathHelper::RandF(), MathHelper::RandF());
-
-			initData[i * 256 + j] = XMCOLOR(v.x, v.y, v.z, 0.0f);
-		}
+	// Blue noise ranks turned into rotation angles around the normal, neighbouring pixels get
+	// angles far apart. Generated once and kept next to the executable.
+	const UINT size = gRandomVectorMapSize;
+
+	// the working directory is wherever the app was started from, the executable's is fixed
+	std::string cachePath = "bluenoise_64.bin";
+	char modulePath[MAX_PATH] = {};
+	const DWORD length = GetModuleFileNameA(nullptr, modulePath, MAX_PATH);
+	if (length > 0 && length < MAX_PATH) {
+		const std::string exe(modulePath, length);
+		cachePath = exe.substr(0, exe.find_last_of("\\/") + 1) + cachePath;
 	}
 
+	std::vector<std::uint16_t> ranks;
+	BlueNoise::LoadOrGenerate(cachePath, size, 1, ranks);
+
+	std::vector<std::uint32_t> initData;
+	SsaoReference::RotationNoise(ranks, initData);
+
 	D3D12_SUBRESOURCE_DATA subResourceData = {};
-	subResourceData.pData = initData;
-	subResourceData.RowPitch = 256 * sizeof(XMCOLOR);
-	subResourceData.SlicePitch = subResourceData.RowPitch * 256;
+	subResourceData.pData = initData.data();
+	subResourceData.RowPitch = size * sizeof(std::uint32_t);
+	subResourceData.SlicePitch = subResourceData.RowPitch * size;
 
 	//
 	// In order to copy CPU memory data into our default buffer, we need to create
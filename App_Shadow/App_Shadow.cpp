@@ -1,6 +1,8 @@
 #include "Common/MathHelper.h"
 #include "Common/UploadBuffer.h"
 #include "Common/GeometryGenerator.h"
+#include "CascadedShadows.h"
+#include "DirtyRanges.h"
 #include "MyApp.h"
 #include "RenderTexture.h"
 using Microsoft::WRL::ComPtr;
@@ -22,8 +24,6 @@ struct RenderItem
 
 	XMFLOAT4X4 World = MathHelper::Identity4x4();
 
-	int NumFramesDirty = gNumFrameResources;
-
 	UINT ObjCBIndex = -1;
 
 	MeshGeometry* Geo = nullptr;
@@ -33,6 +33,9 @@ struct RenderItem
 	UINT IndexCount = 0;
 	UINT StartIndexLocation = 0;
 	int BaseVertexLocation = 0;
+
+	// bounds of the submesh, in world space once BuildObjects() is done
+	BoundingBox Bounds;
 };
 
 struct ObjectConstants
@@ -46,6 +49,7 @@ struct PassConstants
 	DirectX::XMFLOAT4X4 Proj = MathHelper::Identity4x4();
 	int lightCount;
 	XMFLOAT3 eyePos;
+	XMFLOAT4 cascadeSplits;	// view depth where each cascade ends
 };
 
 struct FrameResource
@@ -117,7 +121,6 @@ public:
 	virtual bool Initialize()override;
 	virtual void Update(const GameTimer& gt)override;
 	virtual void Draw(const GameTimer& gt)override;
-	virtual void OnResize()override;
 	virtual void OnKeyboardInput(const GameTimer& gt)override;
 private:
 	enum class DefaultPSO : int
@@ -134,10 +137,19 @@ private:
 	std::unique_ptr<UploadBuffer<Light>> mLightBuffer = nullptr;
 	std::unique_ptr<UploadBuffer<XMFLOAT4X4>> mLightShadowTransformBuffer = nullptr;
 	std::vector<Light>mLights;
-	std::vector<XMFLOAT4X4>mLightShadowTransforms;
+	FrameVector<XMFLOAT4X4>mLightShadowTransforms;
+
+	// Every light gets mCascadeCount cascades, mCascadeTilesPerRow x mCascadeTilesPerRow tiles of one
+	// mShadowMapSize x mShadowMapSize map, the first cascade in the top left.
+	static const int mCascadeCount = 4;
+	static const int mCascadeTilesPerRow = 2;
+	static const UINT mShadowMapSize = 4096;
+	float mShadowDistance = 60.0f;
+	float mCascadeLambda = 0.5f;
+	CascadedShadows::Cascade mCascades[mCascadeCount];
+	BoundingBox mSceneBounds;
+	std::vector<RenderItem*> mCascadeCasters;
 
-	float mShadowMapWidth = 30;
-	float mShadowMapHeight = 30;
 	std::unique_ptr<ShadowMap> mShadowMap;
 	std::unique_ptr<UploadBuffer<ShadowMapUse>> mShadowMapUseBuffer = nullptr;
 	void GenShadowMap(int lightIndex);
@@ -160,6 +172,9 @@ private:
 	std::vector<RenderItem*> mOpaqueRenderitems;
 	void BuildObjects();
 
+	// Object constants live here and only the changed ranges reach each frame resource.
+	std::unique_ptr<ConstantBufferMirror<ObjectConstants>> mObjectConstants = nullptr;
+
 	std::vector<std::unique_ptr<FrameResource>> mFrameResources;
 	int mCurrFrameResourceIndex = 0;
 	FrameResource* mCurrFrameResource = nullptr;
@@ -218,7 +233,7 @@ bool Shadow::Initialize()
 
 	mShadowMap = std::make_unique<ShadowMap>(
 		md3dDevice.Get(),
-		3840, 2160,
+		mShadowMapSize, mShadowMapSize,
 		DXGI_FORMAT_R24G8_TYPELESS, // Format must match Flag
 		D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
 
@@ -260,24 +275,9 @@ void Shadow::Update(const GameTimer& gt)
 	//:todo
 
 	//Update Per Object CB
+	// Only the constants this frame resource hasn't received yet are copied.
 	auto currObjectCB = mCurrFrameResource->ObjectCB.get();
-	for (auto& e : mAllRenderitems)
-	{
-		// Only update the cbuffer data if the constants have changed.  
-		// This needs to be tracked per frame resource.
-		if (e->NumFramesDirty > 0)
-		{
-			XMMATRIX world = XMLoadFloat4x4(&e->World);
-
-			ObjectConstants objConstants;
-			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
-
-			currObjectCB->CopyData(e->ObjCBIndex, objConstants);
-
-			// Next FrameResource need to be updated too.
-			e->NumFramesDirty--;
-		}
-	}
+	mObjectConstants->Upload(mCurrFrameResourceIndex, currObjectCB->MappedData(), currObjectCB->ElementByteSize());
 
 	//Update Main Pass Constant Buffer
 	XMMATRIX view = XMLoadFloat4x4(&mView);
@@ -303,7 +303,8 @@ void Shadow::Draw(const GameTimer& gt)
 	ThrowIfFailed(cmdListAlloc->Reset());
 
 	{
-		mLightShadowTransforms.clear();
+		mLightShadowTransforms = FrameVector<XMFLOAT4X4>(mFrameArena.Current());
+		mLightShadowTransforms.reserve(mMaxLightNum * mCascadeCount);
 
 		GenShadowMap(0);
 		
@@ -381,31 +382,17 @@ void Shadow::Draw(const GameTimer& gt)
 	mCommandQueue->Signal(mFence.Get(), mCurrentFence);
 }
 
-void Shadow::OnResize()
-{
-	MyApp::OnResize();
-
-	if (mShadowMap != nullptr) {
-		mShadowMap->OnResize(mClientWidth, mClientHeight);
-	}
-}
-
 void Shadow::OnKeyboardInput(const GameTimer& gt)
 {
 	MyApp::OnKeyboardInput(gt);
 
+	// J/L: split scheme from uniform (0) to logarithmic (1)
 	const float dt = gt.DeltaTime();
-	if (GetAsyncKeyState('I') & 0x8000) {
-		mShadowMapHeight -= 20.0f * dt;
-	}
-	if (GetAsyncKeyState('K') & 0x8000) {
-		mShadowMapHeight += 20.0f * dt;
-	}
 	if (GetAsyncKeyState('J') & 0x8000) {
-		mShadowMapWidth -= 20.0f * dt;
+		mCascadeLambda = MathHelper::Clamp(mCascadeLambda - 0.5f * dt, 0.0f, 1.0f);
 	}
 	if (GetAsyncKeyState('L') & 0x8000) {
-		mShadowMapWidth += 20.0f * dt;
+		mCascadeLambda = MathHelper::Clamp(mCascadeLambda + 0.5f * dt, 0.0f, 1.0f);
 	}
 }
 
@@ -424,46 +411,46 @@ void Shadow::BuildFrameResources()
 
 void Shadow::GenShadowMap(int lightIndex)
 {
-	// Update Eye Pos to Light
 	auto light = mLights[lightIndex];
+	const UINT tileSize = mShadowMapSize / mCascadeTilesPerRow;
 
-	Camera lightCam = mCamera;
-	lightCam.SetPosition(light.Position);
-	lightCam.LookAt(light.Position, light.Direction, XMFLOAT3(0, 1, 0));
-	lightCam.UpdateViewMatrix();
-	XMMATRIX view = lightCam.GetView();
+	CascadedShadows::Build(mCamera, XMLoadFloat3(&light.Direction), mShadowDistance,
+		mCascadeCount, mCascadeLambda, tileSize, mSceneBounds, mCascades);
 
-	auto orthoProj = XMMatrixOrthographicLH(mShadowMapWidth, mShadowMapHeight, 1.0f, 100.0f);
+	static_assert(mCascadeCount == 4, "cascadeSplits holds four cascades");
+	mMainPassCB.cascadeSplits = XMFLOAT4(
+		mCascades[0].SplitFar, mCascades[1].SplitFar, mCascades[2].SplitFar, mCascades[3].SplitFar);
 
-	{
-		// transform to texture space
-		XMMATRIX T(
-			0.5f, 0.0f, 0.0f, 0.0f,
-			0.0f, -0.5f, 0.0f, 0.0f,
-			0.0f, 0.0f, 1.0f, 0.0f,
-			0.5f, 0.5f, 0.0f, 1.0f);
-
-		XMFLOAT4X4 tmp;
-		auto shadowTransform = view * orthoProj * T;
-		XMStoreFloat4x4(&tmp, XMMatrixTranspose(shadowTransform));
-		mLightShadowTransforms.push_back(tmp);
-	}
-	// Update Finish
+	for (int i = 0; i < mCascadeCount; i++) {
+		XMMATRIX view = XMLoadFloat4x4(&mCascades[i].View);
+		XMMATRIX proj = XMLoadFloat4x4(&mCascades[i].Proj);
+
+		{
+			// transform to texture space, into the cascade's tile
+			const float scale = 0.5f / mCascadeTilesPerRow;
+			const int column = i % mCascadeTilesPerRow, row = i / mCascadeTilesPerRow;
+			XMMATRIX T(
+				scale, 0.0f, 0.0f, 0.0f,
+				0.0f, -scale, 0.0f, 0.0f,
+				0.0f, 0.0f, 1.0f, 0.0f,
+				scale * (2 * column + 1), scale * (2 * row + 1), 0.0f, 1.0f);
+
+			XMFLOAT4X4 tmp;
+			auto shadowTransform = view * proj * T;
+			XMStoreFloat4x4(&tmp, XMMatrixTranspose(shadowTransform));
+			mLightShadowTransforms.push_back(tmp);
+		}
 
-	{
 		ShadowMapUse data;
-		XMStoreFloat4x4(&data.view,XMMatrixTranspose(view));
-		XMStoreFloat4x4(&data.proj, XMMatrixTranspose(orthoProj));
-		mShadowMapUseBuffer->CopyData(0, data);
+		XMStoreFloat4x4(&data.view, XMMatrixTranspose(view));
+		XMStoreFloat4x4(&data.proj, XMMatrixTranspose(proj));
+		mShadowMapUseBuffer->CopyData(i, data);
 	}
 
 	auto cmdListAlloc = mCurrFrameResource->CmdListAlloc;
 
 	mCommandList->Reset(cmdListAlloc.Get(), mPSOs["shadowMap"].Get());
 
-	mCommandList->RSSetViewports(1, &mShadowMap->Viewport());
-	mCommandList->RSSetScissorRects(1, &mShadowMap->ScissorRect());
-
 	mCommandList->ResourceBarrier(
 		1, &CD3DX12_RESOURCE_BARRIER::Transition(
 			mShadowMap->Output(),
@@ -478,7 +465,7 @@ void Shadow::GenShadowMap(int lightIndex)
 	ID3D12DescriptorHeap* descriptorHeaps[] = { mCbvHeap.Get() };
 	mCommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
-	mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+	mCommandList->SetGraphicsRootSignature(mShadowMapRootSignature.Get());
 
 	int passCbvIndex = mPassCbvOffset + mCurrFrameResourceIndex;
 	auto passCbvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mCbvHeap->GetGPUDescriptorHandleForHeapStart());
@@ -487,33 +474,25 @@ void Shadow::GenShadowMap(int lightIndex)
 
 	mCommandList->SetGraphicsRootShaderResourceView(2, mShadowMapUseBuffer->Resource()->GetGPUVirtualAddress());
 
-	DrawRenderItems(mCommandList.Get(), mOpaqueRenderitems);
-
-	// copy to shadow map
-	//mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
-	//	D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE));
-	//mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mShadowMap->Output(),
-	//	D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
-
-	//mCommandList->CopyResource(mShadowMap->Output(), CurrentBackBuffer());
+	for (int i = 0; i < mCascadeCount; i++) {
+		const int column = i % mCascadeTilesPerRow, row = i / mCascadeTilesPerRow;
+		D3D12_VIEWPORT viewport = { (float)(column * tileSize), (float)(row * tileSize), (float)tileSize, (float)tileSize, 0.0f, 1.0f };
+		D3D12_RECT scissorRect = { (LONG)(column * tileSize), (LONG)(row * tileSize), (LONG)((column + 1) * tileSize), (LONG)((row + 1) * tileSize) };
+		mCommandList->RSSetViewports(1, &viewport);
+		mCommandList->RSSetScissorRects(1, &scissorRect);
+		mCommandList->SetGraphicsRoot32BitConstant(3, i, 0);
+
+		// only what can throw a shadow into this cascade
+		mCascadeCasters.clear();
+		for (auto ri : mOpaqueRenderitems) {
+			if (CascadedShadows::IsCaster(mCascades[i], ri->Bounds))
+				mCascadeCasters.push_back(ri);
+		}
+		DrawRenderItems(mCommandList.Get(), mCascadeCasters);
+	}
 
-	//mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
-	//	D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_PRESENT));
 	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mShadowMap->Output(),
 		D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_COMMON));
-
-
-	//mCommandList->Close();
-
-	//ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
-	//mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-
-	//ThrowIfFailed(mSwapChain->Present(0, 0));
-	//mCurrBackBuffer = (mCurrBackBuffer + 1) % SwapChainBufferCount;
-
-	//mCurrFrameResource->Fence = ++mCurrentFence;
-
-	//mCommandQueue->Signal(mFence.Get(), mCurrentFence);
 }
 
 void Shadow::DrawShadowMapToScreen()
@@ -599,10 +578,11 @@ void Shadow::BuildRootSignature()
 		cbvTable[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
 		cbvTable[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 4, 1);
 
-		CD3DX12_ROOT_PARAMETER slotRootParameter[3];
+		CD3DX12_ROOT_PARAMETER slotRootParameter[4];
 		slotRootParameter[0].InitAsDescriptorTable(1, &cbvTable[0]);
 		slotRootParameter[1].InitAsDescriptorTable(1, &cbvTable[1]);
 		slotRootParameter[2].InitAsShaderResourceView(0);
+		slotRootParameter[3].InitAsConstants(1, 0, 1); // cascade index
 
 		CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(
 			sizeof(slotRootParameter) / sizeof(CD3DX12_ROOT_PARAMETER), slotRootParameter, 0, nullptr,
@@ -680,21 +660,25 @@ void Shadow::BuildShapeGeometry()
 	boxSubmesh.IndexCount = (UINT)box.Indices32.size();
 	boxSubmesh.StartIndexLocation = boxIndexOffset;
 	boxSubmesh.BaseVertexLocation = boxVertexOffset;
+	BoundingBox::CreateFromPoints(boxSubmesh.Bounds, box.Vertices.size(), &box.Vertices[0].Position, sizeof(GeometryGenerator::Vertex));
 
 	SubmeshGeometry gridSubmesh;
 	gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
 	gridSubmesh.StartIndexLocation = gridIndexOffset;
 	gridSubmesh.BaseVertexLocation = gridVertexOffset;
+	BoundingBox::CreateFromPoints(gridSubmesh.Bounds, grid.Vertices.size(), &grid.Vertices[0].Position, sizeof(GeometryGenerator::Vertex));
 
 	SubmeshGeometry sphereSubmesh;
 	sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
 	sphereSubmesh.StartIndexLocation = sphereIndexOffset;
 	sphereSubmesh.BaseVertexLocation = sphereVertexOffset;
+	BoundingBox::CreateFromPoints(sphereSubmesh.Bounds, sphere.Vertices.size(), &sphere.Vertices[0].Position, sizeof(GeometryGenerator::Vertex));
 
 	SubmeshGeometry cylinderSubmesh;
 	cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
 	cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
 	cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
+	BoundingBox::CreateFromPoints(cylinderSubmesh.Bounds, cylinder.Vertices.size(), &cylinder.Vertices[0].Position, sizeof(GeometryGenerator::Vertex));
 
 	//
 	// Extract the vertex elements we are interested in and pack the
@@ -755,6 +739,7 @@ void Shadow::BuildShapeGeometry()
 
 	D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU);
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+	geo->TrackCpuMemory();
 
 	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
 		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
@@ -799,6 +784,7 @@ void Shadow::BuildShapeGeometry()
 		CopyMemory(shadowMapGeo->VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
 		D3DCreateBlob(ibByteSize, &shadowMapGeo->IndexBufferCPU);
 		CopyMemory(shadowMapGeo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+		shadowMapGeo->TrackCpuMemory();
 
 		shadowMapGeo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
 			mCommandList.Get(), vertices.data(), vbByteSize, shadowMapGeo->VertexBufferUploader);
@@ -831,6 +817,7 @@ void Shadow::BuildObjects()
 	boxRitem->IndexCount = boxRitem->Geo->DrawArgs["box"].IndexCount;
 	boxRitem->StartIndexLocation = boxRitem->Geo->DrawArgs["box"].StartIndexLocation;
 	boxRitem->BaseVertexLocation = boxRitem->Geo->DrawArgs["box"].BaseVertexLocation;
+	boxRitem->Bounds = boxRitem->Geo->DrawArgs["box"].Bounds;
 	mAllRenderitems.push_back(std::move(boxRitem));
 
 	auto gridRitem = std::make_unique<RenderItem>();
@@ -841,6 +828,7 @@ void Shadow::BuildObjects()
 	gridRitem->IndexCount = gridRitem->Geo->DrawArgs["grid"].IndexCount;
 	gridRitem->StartIndexLocation = gridRitem->Geo->DrawArgs["grid"].StartIndexLocation;
 	gridRitem->BaseVertexLocation = gridRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
+	gridRitem->Bounds = gridRitem->Geo->DrawArgs["grid"].Bounds;
 	mAllRenderitems.push_back(std::move(gridRitem));
 
 	UINT objCBIndex = 2;
@@ -864,6 +852,7 @@ void Shadow::BuildObjects()
 		leftCylRitem->IndexCount = leftCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
 		leftCylRitem->StartIndexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
 		leftCylRitem->BaseVertexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+		leftCylRitem->Bounds = leftCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
 		XMStoreFloat4x4(&rightCylRitem->World, leftCylWorld);
 		rightCylRitem->ObjCBIndex = objCBIndex++;
@@ -872,6 +861,7 @@ void Shadow::BuildObjects()
 		rightCylRitem->IndexCount = rightCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
 		rightCylRitem->StartIndexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
 		rightCylRitem->BaseVertexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+		rightCylRitem->Bounds = rightCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
 		XMStoreFloat4x4(&leftSphereRitem->World, leftSphereWorld);
 		leftSphereRitem->ObjCBIndex = objCBIndex++;
@@ -880,6 +870,7 @@ void Shadow::BuildObjects()
 		leftSphereRitem->IndexCount = leftSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
 		leftSphereRitem->StartIndexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
 		leftSphereRitem->BaseVertexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+		leftSphereRitem->Bounds = leftSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
 		XMStoreFloat4x4(&rightSphereRitem->World, rightSphereWorld);
 		rightSphereRitem->ObjCBIndex = objCBIndex++;
@@ -888,6 +879,7 @@ void Shadow::BuildObjects()
 		rightSphereRitem->IndexCount = rightSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
 		rightSphereRitem->StartIndexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
 		rightSphereRitem->BaseVertexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+		rightSphereRitem->Bounds = rightSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
 		mAllRenderitems.push_back(std::move(leftCylRitem));
 		mAllRenderitems.push_back(std::move(rightCylRitem));
@@ -898,6 +890,23 @@ void Shadow::BuildObjects()
 	// All the render items are opaque.
 	for (auto& e : mAllRenderitems) mOpaqueRenderitems.push_back(e.get());
 
+	// world space bounds, the cascades are fitted around all of them and cull with each
+	for (auto& e : mAllRenderitems) {
+		BoundingBox local = e->Bounds;
+		local.Transform(e->Bounds, XMLoadFloat4x4(&e->World));
+	}
+	mSceneBounds = mAllRenderitems[0]->Bounds;
+	for (auto& e : mAllRenderitems) BoundingBox::CreateMerged(mSceneBounds, mSceneBounds, e->Bounds);
+
+	mObjectConstants = std::make_unique<ConstantBufferMirror<ObjectConstants>>(
+		(UINT)mAllRenderitems.size(), gNumFrameResources, true);
+	for (auto& e : mAllRenderitems)
+	{
+		ObjectConstants objConstants;
+		XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(XMLoadFloat4x4(&e->World)));
+		mObjectConstants->Set(e->ObjCBIndex, objConstants);
+	}
+
 	// Light
 	{
 		Light dirLight;
@@ -1010,8 +1019,8 @@ void Shadow::BuildBuffers()
 
 	{
 		mLightBuffer = std::make_unique<UploadBuffer<Light>>(md3dDevice.Get(), mMaxLightNum, false);
-		mLightShadowTransformBuffer = std::make_unique<UploadBuffer<XMFLOAT4X4>>(md3dDevice.Get(), mMaxLightNum, false);
-		mShadowMapUseBuffer = std::make_unique<UploadBuffer<ShadowMapUse>>(md3dDevice.Get(), 1, false);
+		mLightShadowTransformBuffer = std::make_unique<UploadBuffer<XMFLOAT4X4>>(md3dDevice.Get(), mMaxLightNum * mCascadeCount, false);
+		mShadowMapUseBuffer = std::make_unique<UploadBuffer<ShadowMapUse>>(md3dDevice.Get(), mCascadeCount, false);
 	}
 }
 
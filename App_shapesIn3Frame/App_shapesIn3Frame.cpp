@@ -1,6 +1,7 @@
 #include "Common/MathHelper.h"
 #include "Common/UploadBuffer.h"
 #include "Common/GeometryGenerator.h"
+#include "DirtyRanges.h"
 #include "MyApp.h"
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
@@ -20,8 +21,6 @@ struct RenderItem
 
 	XMFLOAT4X4 World = MathHelper::Identity4x4();
 
-	int NumFramesDirty = gNumFrameResources;
-
 	UINT ObjCBIndex = -1;
 
 	MeshGeometry* Geo = nullptr;
@@ -91,6 +90,9 @@ private:
 	std::vector<RenderItem*> mOpaqueRenderitems;
 	void BuildRenderItems();
 
+	// Object constants live here and only the changed ranges reach each frame resource.
+	std::unique_ptr<ConstantBufferMirror<ObjectConstants>> mObjectConstants = nullptr;
+
 	std::vector<std::unique_ptr<FrameResource>> mFrameResources;
 	int mCurrFrameResourceIndex = 0;
 	FrameResource* mCurrFrameResource = nullptr;
@@ -182,24 +184,9 @@ void shapesIn3Frame::Update(const GameTimer& gt)
 	//:todo
 
 	//Update Per Object CB
+	// Only the constants this frame resource hasn't received yet are copied.
 	auto currObjectCB = mCurrFrameResource->ObjectCB.get();
-	for (auto& e : mAllRenderitems)
-	{
-		// Only update the cbuffer data if the constants have changed.  
-		// This needs to be tracked per frame resource.
-		if (e->NumFramesDirty > 0)
-		{
-			XMMATRIX world = XMLoadFloat4x4(&e->World);
-
-			ObjectConstants objConstants;
-			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
-
-			currObjectCB->CopyData(e->ObjCBIndex, objConstants);
-
-			// Next FrameResource need to be updated too.
-			e->NumFramesDirty--;
-		}
-	}
+	mObjectConstants->Upload(mCurrFrameResourceIndex, currObjectCB->MappedData(), currObjectCB->ElementByteSize());
 
 	//Update Main Pass Constant Buffer
 	XMMATRIX view = XMLoadFloat4x4(&mView);
@@ -425,6 +412,7 @@ void shapesIn3Frame::BuildShapeGeometry()
 
 	D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU);
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+	geo->TrackCpuMemory();
 
 	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
 		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
@@ -521,6 +509,15 @@ void shapesIn3Frame::BuildRenderItems()
 
 	// All the render items are opaque.
 	for (auto& e : mAllRenderitems) mOpaqueRenderitems.push_back(e.get());
+
+	mObjectConstants = std::make_unique<ConstantBufferMirror<ObjectConstants>>(
+		(UINT)mAllRenderitems.size(), gNumFrameResources, true);
+	for (auto& e : mAllRenderitems)
+	{
+		ObjectConstants objConstants;
+		XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(XMLoadFloat4x4(&e->World)));
+		mObjectConstants->Set(e->ObjCBIndex, objConstants);
+	}
 }
 
 void shapesIn3Frame::BuildDescriptorHeaps()
@@ -0,0 +1,204 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <list>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "Allocators.h"
+
+using namespace DirectX;
+
+// Every heap allocation of the benchmark binary goes through here so the frames can report allocs/frame.
+namespace
+{
+	std::atomic<std::size_t> gHeapAllocations{ 0 };
+
+	struct RenderItem
+	{
+		XMFLOAT4X4 World;
+	};
+
+	const int gNumItems = 8 * 10 * 10 * 10;
+
+	// alignment: 0 for the plain forms, the align_val_t of the aligned ones
+	void* CountedAllocate(std::size_t size, std::size_t alignment) noexcept
+	{
+		gHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+		size = size ? size : 1;
+		if (alignment <= alignof(std::max_align_t))
+			return std::malloc(size);
+#ifdef _WIN32
+		return _aligned_malloc(size, alignment);
+#else
+		void* p = nullptr;
+		return posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+#endif
+	}
+
+	void* CountedNew(std::size_t size, std::size_t alignment)
+	{
+		if (void* p = CountedAllocate(size, alignment))
+			return p;
+		throw std::bad_alloc();
+	}
+
+	// posix_memalign() memory goes back through free() like the rest
+	void CountedFree(void* p, [[maybe_unused]] std::size_t alignment) noexcept
+	{
+#ifdef _WIN32
+		if (alignment > alignof(std::max_align_t)) {
+			_aligned_free(p);
+			return;
+		}
+#endif
+		std::free(p);
+	}
+}
+
+void* operator new(std::size_t size) { return CountedNew(size, 0); }
+void* operator new[](std::size_t size) { return CountedNew(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return CountedNew(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return CountedNew(size, (std::size_t)alignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, (std::size_t)alignment); }
+
+void operator delete(void* p) noexcept { CountedFree(p, 0); }
+void operator delete[](void* p) noexcept { CountedFree(p, 0); }
+void operator delete(void* p, std::size_t) noexcept { CountedFree(p, 0); }
+void operator delete[](void* p, std::size_t) noexcept { CountedFree(p, 0); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { CountedFree(p, 0); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { CountedFree(p, 0); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { CountedFree(p, (std::size_t)alignment); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { CountedFree(p, (std::size_t)alignment); }
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { CountedFree(p, (std::size_t)alignment); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { CountedFree(p, (std::size_t)alignment); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(p, (std::size_t)alignment); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(p, (std::size_t)alignment); }
+
+// The transient work of one ComputeCull/Shadow frame as it was written before FrameArena:
+// culling list reused with clear(), caption built with std::string and std::wostringstream,
+// light transforms in a std::vector.
+static void BM_FrameHeap(benchmark::State& state)
+{
+	std::vector<RenderItem> items(gNumItems);
+	std::vector<RenderItem*> opaque;
+	for (auto& item : items)
+		opaque.push_back(&item);
+
+	std::vector<RenderItem*> visible;
+	std::vector<XMFLOAT4X4> lightShadowTransforms;
+	std::wstring caption;
+
+	std::size_t allocations = gHeapAllocations.load();
+	for (auto _ : state) {
+		visible.clear();
+		for (size_t i = 0; i < opaque.size(); i += 2)
+			visible.push_back(opaque[i]);
+
+		std::wostringstream outs;
+		std::string text = (std::string)"Culling using CPU.    " + std::to_string(visible.size()) +
+			" objects visible out of " + std::to_string(opaque.size());
+		outs << L"Compute Culling: " << L"    " << text.c_str();
+		caption = outs.str();
+
+		lightShadowTransforms.clear();
+		lightShadowTransforms.push_back(items[0].World);
+
+		benchmark::DoNotOptimize(caption.data());
+		benchmark::DoNotOptimize(lightShadowTransforms.data());
+	}
+	allocations = gHeapAllocations.load() - allocations;
+
+	state.counters["allocs/frame"] = benchmark::Counter((double)allocations / state.iterations());
+}
+BENCHMARK(BM_FrameHeap)->Unit(benchmark::kMicrosecond);
+
+// Same frame on top of FrameArena, the way the apps do it now.
+static void BM_FrameArena(benchmark::State& state)
+{
+	std::vector<RenderItem> items(gNumItems);
+	std::vector<RenderItem*> opaque;
+	for (auto& item : items)
+		opaque.push_back(&item);
+
+	FrameArena frameArena;
+	FrameVector<RenderItem*> visible;
+	FrameVector<XMFLOAT4X4> lightShadowTransforms;
+	std::wstring caption;
+
+	std::size_t allocations = gHeapAllocations.load();
+	for (auto _ : state) {
+		frameArena.BeginFrame();
+		LinearArena& arena = frameArena.Current();
+
+		visible = FrameVector<RenderItem*>(arena);
+		visible.reserve(opaque.size());
+		for (size_t i = 0; i < opaque.size(); i += 2)
+			visible.push_back(opaque[i]);
+
+		const wchar_t* text = arena.FormatW(L"Culling using CPU.    %zu objects visible out of %zu",
+			visible.size(), opaque.size());
+		caption.assign(arena.FormatW(L"Compute Culling:     %ls", text));
+
+		lightShadowTransforms = FrameVector<XMFLOAT4X4>(arena);
+		lightShadowTransforms.reserve(1);
+		lightShadowTransforms.push_back(items[0].World);
+
+		benchmark::DoNotOptimize(caption.data());
+		benchmark::DoNotOptimize(lightShadowTransforms.data());
+	}
+	allocations = gHeapAllocations.load() - allocations;
+
+	state.counters["allocs/frame"] = benchmark::Counter((double)allocations / state.iterations());
+	state.counters["arena_bytes"] = (double)frameArena.Current().HighWater();
+}
+BENCHMARK(BM_FrameArena)->Unit(benchmark::kMicrosecond);
+
+// Node container churn, std::allocator against FixedPool.
+static void BM_ListHeap(benchmark::State& state)
+{
+	const int count = (int)state.range(0);
+
+	std::size_t allocations = gHeapAllocations.load();
+	for (auto _ : state) {
+		std::list<int> nodes;
+		for (int i = 0; i < count; ++i)
+			nodes.push_back(i);
+		benchmark::DoNotOptimize(nodes.back());
+	}
+	allocations = gHeapAllocations.load() - allocations;
+
+	state.counters["allocs/iter"] = benchmark::Counter((double)allocations / state.iterations());
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ListHeap)->Arg(256)->Arg(4096);
+
+static void BM_ListPool(benchmark::State& state)
+{
+	const int count = (int)state.range(0);
+	// a list node is two links and the value
+	FixedPool pool(4 * sizeof(void*), 1024);
+
+	std::size_t allocations = gHeapAllocations.load();
+	for (auto _ : state) {
+		std::list<int, PoolAllocator<int>> nodes{ PoolAllocator<int>(pool) };
+		for (int i = 0; i < count; ++i)
+			nodes.push_back(i);
+		benchmark::DoNotOptimize(nodes.back());
+	}
+	allocations = gHeapAllocations.load() - allocations;
+
+	state.counters["allocs/iter"] = benchmark::Counter((double)allocations / state.iterations());
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ListPool)->Arg(256)->Arg(4096);
@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+
+#include "BenchAtlas.h"
+
+// 1000 small textures into 2048x2048 pages. fill is the texture area over the area of the pages,
+// the last page counted only up to its lowest texture.
+static void BM_PackAtlas(benchmark::State& state)
+{
+	AtlasPacker::Options options;
+	options.Heuristic = state.range(0) ? AtlasPacker::Method::MaxRects : AtlasPacker::Method::Skyline;
+	options.Gutter = (std::uint32_t)state.range(1);
+	options.SafeMips = (std::uint32_t)state.range(2);
+
+	const std::vector<AtlasPacker::Size> sizes = MakeAtlasSizes(1000);
+	std::vector<AtlasPacker::Placement> placements;
+	std::uint32_t pageCount = 0;
+	for (auto _ : state) {
+		pageCount = AtlasPacker::Pack(sizes, options, placements);
+		benchmark::DoNotOptimize(placements.data());
+	}
+
+	double textureArea = 0.0;
+	std::uint32_t lastBottom = 0;
+	for (std::size_t i = 0; i < placements.size(); ++i) {
+		textureArea += (double)sizes[i].Width * sizes[i].Height;
+		if (placements[i].Page == pageCount - 1)
+			lastBottom = std::max(lastBottom, placements[i].Y + placements[i].Height + options.Gutter);
+	}
+	const double pageArea = (double)options.PageSize * options.PageSize;
+	state.counters["pages"] = pageCount;
+	state.counters["fill"] = textureArea / ((pageCount - 1) * pageArea + (double)lastBottom * options.PageSize);
+}
+BENCHMARK(BM_PackAtlas)->ArgNames({ "maxrects", "gutter", "safeMips" })
+	->Args({ 0, 0, 0 })->Args({ 1, 0, 0 })
+	->Args({ 0, 4, 2 })->Args({ 1, 4, 2 })
+	->Args({ 1, 8, 3 })
+	->Unit(benchmark::kMillisecond);
@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "BenchBC.h"
+
+namespace
+{
+	const std::uint32_t gImageSize = 1024;
+}
+
+// One 1024x1024 level. Reports throughput and the PSNR of the decoded blocks.
+static void BM_EncodeBC(benchmark::State& state)
+{
+	const BCEncoder::Format format = (BCEncoder::Format)state.range(0);
+	BCEncoder::Options options;
+	options.Level = (BCEncoder::Quality)state.range(1);
+	options.ThreadCount = (unsigned)state.range(2);
+
+	const std::vector<std::uint8_t> image = MakeBCImage(gImageSize, format == BCEncoder::Format::BC5);
+	std::vector<std::uint8_t> blocks(BCEncoder::SurfaceSize(gImageSize, gImageSize, format));
+
+	for (auto _ : state) {
+		BCEncoder::Encode(image.data(), (size_t)gImageSize * 4, gImageSize, gImageSize, format, options, blocks.data());
+		benchmark::ClobberMemory();
+	}
+
+	std::vector<std::uint8_t> decoded(image.size());
+	BCEncoder::Decode(blocks.data(), gImageSize, gImageSize, format, decoded.data(), (size_t)gImageSize * 4);
+	state.counters["PSNR"] = BCPSNR(image, decoded, format);
+	state.counters["Mpixels"] = benchmark::Counter(gImageSize * gImageSize / 1e6, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_EncodeBC)->ArgNames({ "format", "quality", "threads" })
+	->Args({ 0, 0, 0 })->Args({ 0, 1, 0 })->Args({ 0, 2, 0 })
+	->Args({ 1, 1, 0 })
+	->Args({ 2, 0, 0 })->Args({ 2, 1, 0 })->Args({ 2, 2, 0 })
+	->Args({ 3, 0, 0 })->Args({ 3, 1, 1 })->Args({ 3, 1, 0 })->Args({ 3, 2, 0 })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "AtlasPacker.h"
+
+// Typical small per-object textures: mostly powers of two from 16 to 256, some odd sizes.
+inline std::vector<AtlasPacker::Size> MakeAtlasSizes(std::uint32_t count)
+{
+	const std::uint32_t sides[] = { 16, 32, 32, 64, 64, 64, 128, 128, 256, 24, 48, 100, 200 };
+	std::vector<AtlasPacker::Size> sizes(count);
+	std::uint32_t state = 7;
+	for (auto& size : sizes) {
+		state = state * 1664525u + 1013904223u;
+		size.Width = sides[(state >> 8) % 13];
+		state = state * 1664525u + 1013904223u;
+		size.Height = (state >> 28) < 10 ? size.Width : sides[(state >> 8) % 13];
+	}
+	return sizes;
+}
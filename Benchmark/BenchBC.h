@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "BCEncoder.h"
+
+// Photo-like color: smooth gradients, texel noise and hard edges between patches, alpha a ramp
+// with cut outs. Normal maps are tangent space normals wobbling around +z.
+inline std::vector<std::uint8_t> MakeBCImage(std::uint32_t size, bool normalMap)
+{
+	std::vector<std::uint8_t> image((size_t)size * size * 4);
+	std::uint32_t state = 1;
+	for (std::uint32_t y = 0; y < size; ++y) {
+		for (std::uint32_t x = 0; x < size; ++x) {
+			state = state * 1664525u + 1013904223u;
+			std::uint8_t* pixel = &image[((size_t)y * size + x) * 4];
+			float u = std::sin(x * 0.02f) * std::cos(y * 0.017f), v = std::cos(x * 0.011f + y * 0.013f);
+			if (normalMap) {
+				u += ((state >> 24) / 255.0f - 0.5f) * 0.2f;
+				v += ((state >> 16 & 255) / 255.0f - 0.5f) * 0.2f;
+				float nz = 1.0f / std::sqrt(1.0f + u * u * 0.25f + v * v * 0.25f);
+				pixel[0] = (std::uint8_t)std::lround((u * 0.5f * nz * 0.5f + 0.5f) * 255.0f);
+				pixel[1] = (std::uint8_t)std::lround((v * 0.5f * nz * 0.5f + 0.5f) * 255.0f);
+				pixel[2] = (std::uint8_t)std::lround((nz * 0.5f + 0.5f) * 255.0f);
+				pixel[3] = 255;
+			}
+			else {
+				const std::uint32_t patch = (x / 48 * 7 + y / 40 * 13) % 5;
+				const int noise = (int)(state >> 29) - 4;
+				pixel[0] = (std::uint8_t)std::min(255, std::max(0, (int)(100 + 60 * u) + (int)patch * 20 + noise));
+				pixel[1] = (std::uint8_t)std::min(255, std::max(0, (int)(120 + 80 * v) - (int)patch * 10 + noise));
+				pixel[2] = (std::uint8_t)std::min(255, std::max(0, (int)(80 + 40 * u * v) + (int)patch * 30 + noise));
+				pixel[3] = (x / 64 + y / 64) % 7 == 0 ? 0 : (std::uint8_t)(x * 255 / size);
+			}
+		}
+	}
+	return image;
+}
+
+// Over the channels the format keeps: rgb of the pixels BC1 doesn't cut out, rg for BC5.
+inline double BCPSNR(const std::vector<std::uint8_t>& image, const std::vector<std::uint8_t>& decoded, BCEncoder::Format format)
+{
+	const bool cutOut = format == BCEncoder::Format::BC1;
+	const int channels = format == BCEncoder::Format::BC5 ? 2 : cutOut ? 3 : 4;
+	double sum = 0.0;
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < image.size(); i += 4) {
+		if (cutOut && image[i + 3] < 128)
+			continue;
+		for (int c = 0; c < channels; ++c) {
+			double d = (double)image[i + c] - decoded[i + c];
+			sum += d * d;
+		}
+		count += channels;
+	}
+	const double mse = count > 0 ? sum / count : 0.0;
+	return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
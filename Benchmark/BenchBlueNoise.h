@@ -0,0 +1,43 @@
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+// Mean power of the frequencies within size / 8 of DC of the pattern that keeps half the pixels,
+// relative to white noise (1). Two passes of a plain DFT, the sizes here are small.
+inline double LowFrequencyPower(const std::vector<std::uint16_t>& ranks, std::uint32_t size)
+{
+	const std::uint32_t count = size * size;
+	std::vector<std::complex<double>> data(count), rows(count);
+	for (std::uint32_t i = 0; i < count; ++i)
+		data[i] = ranks[i] < count / 2 ? 1.0 : -1.0;
+
+	std::vector<std::complex<double>> twiddle(size);
+	for (std::uint32_t k = 0; k < size; ++k)
+		twiddle[k] = std::polar(1.0, -2.0 * 3.14159265358979323846 * k / size);
+
+	for (std::uint32_t y = 0; y < size; ++y)
+		for (std::uint32_t u = 0; u < size; ++u) {
+			std::complex<double> sum = 0.0;
+			for (std::uint32_t x = 0; x < size; ++x)
+				sum += data[y * size + x] * twiddle[(u * x) % size];
+			rows[y * size + u] = sum;
+		}
+
+	const int limit = (int)size / 8;
+	double power = 0.0;
+	std::uint32_t bins = 0;
+	for (int v = -limit; v <= limit; ++v)
+		for (int u = -limit; u <= limit; ++u) {
+			if ((u == 0 && v == 0) || u * u + v * v > limit * limit)
+				continue;
+			const std::uint32_t uu = (u + size) % size, vv = (v + size) % size;
+			std::complex<double> sum = 0.0;
+			for (std::uint32_t y = 0; y < size; ++y)
+				sum += rows[y * size + uu] * twiddle[(vv * y) % size];
+			power += std::norm(sum);
+			bins++;
+		}
+	return power / bins / count;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Smooth gradients with a hashed grain on top, RGBA8, tightly packed.
+inline std::vector<std::uint8_t> MakeBlurImage(std::uint32_t width, std::uint32_t height)
+{
+	std::vector<std::uint8_t> image((std::size_t)width * height * 4);
+	for (std::uint32_t y = 0; y < height; ++y) {
+		for (std::uint32_t x = 0; x < width; ++x) {
+			std::uint32_t h = (x * 73856093u) ^ (y * 19349663u);
+			h = (h ^ (h >> 13)) * 0x5bd1e995u;
+			std::uint8_t* pixel = &image[((std::size_t)y * width + x) * 4];
+			pixel[0] = (std::uint8_t)(x * 255 / width / 2 + (h & 127));
+			pixel[1] = (std::uint8_t)(y * 255 / height / 2 + (h >> 8 & 127));
+			pixel[2] = (std::uint8_t)((x + y) % 64 < 32 ? 200 : 40);
+			pixel[3] = 255;
+		}
+	}
+	return image;
+}
+
+// The same two passes one channel at a time in double, for comparison.
+inline std::vector<std::uint8_t> ScalarBlur(const std::vector<std::uint8_t>& image, std::uint32_t width, std::uint32_t height, const std::vector<float>& weights)
+{
+	const int radius = (int)weights.size() / 2;
+	auto clamp = [](int v, int size) { return v < 0 ? 0 : (v >= size ? size - 1 : v); };
+	auto store = [](double v) { return (std::uint8_t)std::lround(std::min(std::max(v, 0.0), 1.0) * 255.0); };
+
+	std::vector<std::uint8_t> rows(image.size()), result(image.size());
+	for (int y = 0; y < (int)height; ++y)
+		for (int x = 0; x < (int)width; ++x)
+			for (int c = 0; c < 4; ++c) {
+				double sum = 0.0;
+				for (int k = -radius; k <= radius; ++k)
+					sum += weights[k + radius] * image[((std::size_t)y * width + clamp(x + k, width)) * 4 + c] / 255.0;
+				rows[((std::size_t)y * width + x) * 4 + c] = store(sum);
+			}
+	for (int y = 0; y < (int)height; ++y)
+		for (int x = 0; x < (int)width; ++x)
+			for (int c = 0; c < 4; ++c) {
+				double sum = 0.0;
+				for (int k = -radius; k <= radius; ++k)
+					sum += weights[k + radius] * rows[((std::size_t)clamp(y + k, height) * width + x) * 4 + c] / 255.0;
+				result[((std::size_t)y * width + x) * 4 + c] = store(sum);
+			}
+	return result;
+}
+
+// The width of a blur, measured on a vertical step from black to white: the rows turn into the
+// integral of the blur kernel, so the differences of a row are the kernel and their spread its sigma.
+inline double EffectiveSigma(const std::function<void(const std::uint8_t*, std::uint8_t*, std::uint32_t, std::uint32_t)>& blur)
+{
+	const std::uint32_t width = 1024, height = 64;
+	std::vector<std::uint8_t> step((std::size_t)width * height * 4), blurred(step.size());
+	for (std::uint32_t y = 0; y < height; ++y)
+		for (std::uint32_t x = width / 2; x < width; ++x)
+			std::fill_n(&step[((std::size_t)y * width + x) * 4], 4, (std::uint8_t)255);
+	blur(step.data(), blurred.data(), width, height);
+
+	const std::uint8_t* row = &blurred[(std::size_t)height / 2 * width * 4];
+	double total = 0.0, mean = 0.0, variance = 0.0;
+	for (std::uint32_t x = 0; x + 1 < width; ++x) {
+		const double d = row[(x + 1) * 4] - row[x * 4];
+		total += d;
+		mean += d * (x + 0.5);
+	}
+	mean /= total;
+	for (std::uint32_t x = 0; x + 1 < width; ++x)
+		variance += (row[(x + 1) * 4] - row[x * 4]) * (x + 0.5 - mean) * (x + 0.5 - mean);
+	return std::sqrt(variance / total);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchScene.h"
+#include "ModelImporter.h"
+#include "VertexQuantizer.h"
+
+// What a cooked mesh would hold: the merged buffers in both vertex formats.
+struct CookedMesh
+{
+	std::vector<GeometryGenerator::Vertex> Vertices;
+	std::vector<PackedVertex> PackedVertices;
+	std::vector<std::uint32_t> Indices;
+
+	// Indices over the unique positions, numbered by first use, as after welding and reordering.
+	std::vector<std::uint32_t> WeldedIndices;
+};
+
+inline CookedMesh CookMesh(const char* file)
+{
+	ModelImporter importer(ResourcePath(file));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+
+	CookedMesh mesh;
+	importer.Merge(indices, submeshes);
+	mesh.Vertices = importer.Vertices();
+
+	mesh.PackedVertices.resize(mesh.Vertices.size());
+	for (size_t i = 0; i < submeshes.size(); ++i) {
+		size_t first = (size_t)submeshes[i].BaseVertexLocation;
+		size_t last = i + 1 < submeshes.size() ? (size_t)submeshes[i + 1].BaseVertexLocation : mesh.Vertices.size();
+		VertexQuantizer::Encode(mesh.Vertices.data() + first, last - first, submeshes[i].Bounds, mesh.PackedVertices.data() + first);
+	}
+
+	// indices relative to the merged buffer, so submeshes don't restart at 0
+	for (const auto& submesh : submeshes) {
+		for (std::uint32_t i = 0; i < submesh.IndexCount; ++i)
+			mesh.Indices.push_back(indices[submesh.StartIndexLocation + i] + (std::uint32_t)submesh.BaseVertexLocation);
+	}
+
+	std::unordered_map<std::string, std::uint32_t> ids;
+	for (std::uint32_t index : mesh.Indices) {
+		std::string key(reinterpret_cast<const char*>(&mesh.Vertices[index].Position), sizeof(DirectX::XMFLOAT3));
+		auto inserted = ids.emplace(key, (std::uint32_t)ids.size());
+		mesh.WeldedIndices.push_back(inserted.first->second);
+	}
+	return mesh;
+}
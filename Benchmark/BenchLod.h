@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "Common/GeometryGenerator.h"
+
+inline DirectX::XMVECTOR XM_CALLCONV ClosestPointOnTriangle(DirectX::FXMVECTOR p, DirectX::FXMVECTOR a, DirectX::FXMVECTOR b, DirectX::GXMVECTOR c)
+{
+	using namespace DirectX;
+
+	// Real-Time Collision Detection 5.1.5
+	XMVECTOR ab = b - a, ac = c - a, ap = p - a;
+	float d1 = XMVectorGetX(XMVector3Dot(ab, ap)), d2 = XMVectorGetX(XMVector3Dot(ac, ap));
+	if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+	XMVECTOR bp = p - b;
+	float d3 = XMVectorGetX(XMVector3Dot(ab, bp)), d4 = XMVectorGetX(XMVector3Dot(ac, bp));
+	if (d3 >= 0.0f && d4 <= d3) return b;
+
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+	XMVECTOR cp = p - c;
+	float d5 = XMVectorGetX(XMVector3Dot(ab, cp)), d6 = XMVectorGetX(XMVector3Dot(ac, cp));
+	if (d6 >= 0.0f && d5 <= d6) return c;
+
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	float denom = 1.0f / (va + vb + vc);
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Largest distance from the original vertices to the simplified surface, brute force.
+inline float MaxDeviation(const GeometryGenerator::MeshData& mesh, const std::vector<std::uint32_t>& simplified)
+{
+	using namespace DirectX;
+
+	float maxDistance = 0.0f;
+	for (const auto& vertex : mesh.Vertices) {
+		XMVECTOR p = XMLoadFloat3(&vertex.Position);
+		float best = FLT_MAX;
+		for (size_t t = 0; t + 2 < simplified.size(); t += 3) {
+			XMVECTOR q = ClosestPointOnTriangle(p,
+				XMLoadFloat3(&mesh.Vertices[simplified[t]].Position),
+				XMLoadFloat3(&mesh.Vertices[simplified[t + 1]].Position),
+				XMLoadFloat3(&mesh.Vertices[simplified[t + 2]].Position));
+			best = std::min(best, XMVectorGetX(XMVector3LengthSq(p - q)));
+		}
+		maxDistance = std::max(maxDistance, std::sqrt(best));
+	}
+	return maxDistance;
+}
+
+inline float Radius(const GeometryGenerator::MeshData& mesh)
+{
+	using namespace DirectX;
+
+	XMVECTOR minPos = XMVectorReplicate(FLT_MAX), maxPos = XMVectorReplicate(-FLT_MAX);
+	for (const auto& vertex : mesh.Vertices) {
+		XMVECTOR p = XMLoadFloat3(&vertex.Position);
+		minPos = XMVectorMin(minPos, p);
+		maxPos = XMVectorMax(maxPos, p);
+	}
+	return 0.5f * XMVectorGetX(XMVector3Length(maxPos - minPos));
+}
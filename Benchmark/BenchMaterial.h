@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "TextureCache.h"
+
+const int gDistinctFiles = 32;
+const size_t gFileBytes = 1 << 20;
+
+// gDistinctFiles files of random looking bytes, each also saved under a second name.
+// Written once to the temp directory.
+inline const std::string& TextureDirectory()
+{
+	static const std::string directory = []()
+	{
+		std::filesystem::path path = std::filesystem::temp_directory_path() / "renderer_bench_textures";
+		std::filesystem::create_directories(path);
+
+		std::vector<std::uint8_t> data(gFileBytes);
+		std::uint32_t state = 1;
+		for (int file = 0; file < gDistinctFiles; ++file) {
+			for (auto& byte : data) {
+				state = state * 1664525u + 1013904223u;
+				byte = (std::uint8_t)(state >> 24);
+			}
+			for (const char* prefix : { "texture", "copy" }) {
+				std::string name = (path / (prefix + std::to_string(file) + ".bin")).string();
+				FILE* out = std::fopen(name.c_str(), "wb");
+				if (out == nullptr)
+					continue;
+				std::fwrite(data.data(), 1, data.size(), out);
+				std::fclose(out);
+			}
+		}
+		return path.generic_string();
+	}();
+	return directory;
+}
+
+// Stands in for an image decoder, touches every byte once.
+inline bool ChecksumDecoder(TextureCache::Image& image)
+{
+	std::uint32_t sum = 0;
+	for (std::uint8_t byte : image.File)
+		sum = sum * 31 + byte;
+	image.Width = image.Height = 1;
+	image.Pixels.assign((const std::uint8_t*)&sum, (const std::uint8_t*)&sum + sizeof(sum));
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+enum MipImage
+{
+	MipColor,
+	MipSRGB,
+	MipNormalMap
+};
+
+// Smooth gradients with some texel noise, or tangent space normals wobbling around +z.
+inline std::vector<std::uint8_t> MakeMipImage(std::uint32_t size, MipImage mode)
+{
+	std::vector<std::uint8_t> image((size_t)size * size * 4);
+	std::uint32_t state = 1;
+	for (std::uint32_t y = 0; y < size; ++y) {
+		for (std::uint32_t x = 0; x < size; ++x) {
+			state = state * 1664525u + 1013904223u;
+			std::uint8_t* pixel = &image[((size_t)y * size + x) * 4];
+			float u = std::sin(x * 0.01f) * std::cos(y * 0.013f), v = std::cos(x * 0.007f + y * 0.011f);
+			if (mode == MipNormalMap) {
+				float nz = 1.0f / std::sqrt(1.0f + u * u * 0.25f + v * v * 0.25f);
+				pixel[0] = (std::uint8_t)std::lround((u * 0.5f * nz * 0.5f + 0.5f) * 255.0f);
+				pixel[1] = (std::uint8_t)std::lround((v * 0.5f * nz * 0.5f + 0.5f) * 255.0f);
+				pixel[2] = (std::uint8_t)std::lround((nz * 0.5f + 0.5f) * 255.0f);
+				pixel[3] = 255;
+			}
+			else {
+				pixel[0] = (std::uint8_t)(96 + 64 * u + (state >> 28));
+				pixel[1] = (std::uint8_t)(128 + 96 * v);
+				pixel[2] = (std::uint8_t)(state >> 24);
+				pixel[3] = 255;
+			}
+		}
+	}
+	return image;
+}
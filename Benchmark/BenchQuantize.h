@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <DirectXCollision.h>
+
+#include "VertexQuantizer.h"
+
+// One vertex range quantized over one box, as Model::ProcessGeo splits the merged buffer.
+struct QuantizeRange
+{
+	size_t First = 0;
+	size_t Count = 0;
+	DirectX::BoundingBox Bounds;
+};
+
+inline void EncodeRanges(const std::vector<GeometryGenerator::Vertex>& vertices, const std::vector<QuantizeRange>& ranges, std::vector<PackedVertex>& packed)
+{
+	for (const auto& range : ranges)
+		VertexQuantizer::Encode(vertices.data() + range.First, range.Count, range.Bounds, packed.data() + range.First);
+}
+
+// The largest round trip errors: position relative to the bounds size, normal in degrees,
+// texture coordinate absolute.
+struct QuantizeErrors
+{
+	float Position = 0.0f;
+	float Normal = 0.0f;
+	float TexC = 0.0f;
+};
+
+inline QuantizeErrors MeasureErrors(
+	const std::vector<GeometryGenerator::Vertex>& vertices,
+	const std::vector<QuantizeRange>& ranges,
+	const std::vector<PackedVertex>& packed)
+{
+	using namespace DirectX;
+
+	QuantizeErrors errors;
+	for (const auto& range : ranges) {
+		XMVECTOR size = XMVectorMax(XMLoadFloat3(&range.Bounds.Extents) * 2.0f, XMVectorReplicate(1e-6f));
+		for (size_t i = range.First; i < range.First + range.Count; ++i) {
+			GeometryGenerator::Vertex decoded = VertexQuantizer::Decode(packed[i], range.Bounds);
+
+			XMVECTOR offset = XMVectorAbs(XMLoadFloat3(&decoded.Position) - XMLoadFloat3(&vertices[i].Position)) / size;
+			errors.Position = std::max(errors.Position, std::max(XMVectorGetX(offset), std::max(XMVectorGetY(offset), XMVectorGetZ(offset))));
+
+			XMVECTOR normal = XMLoadFloat3(&vertices[i].Normal);
+			float length = XMVectorGetX(XMVector3Length(normal));
+			if (length > 0.0f) {
+				float cosAngle = XMVectorGetX(XMVector3Dot(XMLoadFloat3(&decoded.Normal), normal)) / length;
+				errors.Normal = std::max(errors.Normal, XMConvertToDegrees(std::acos(std::min(cosAngle, 1.0f))));
+			}
+
+			errors.TexC = std::max(errors.TexC, std::max(
+				std::fabs(decoded.TexC.x - vertices[i].TexC.x), std::fabs(decoded.TexC.y - vertices[i].TexC.y)));
+		}
+	}
+	return errors;
+}
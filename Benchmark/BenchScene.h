@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+// Path into resources/, the root is baked in by CMake.
+inline std::string ResourcePath(const std::string& file)
+{
+	return std::string(RESOURCES_DIR) + file;
+}
+
+// A fixed camera looking down +z, standing in for Camera so the numbers don't depend on input.
+struct BenchCamera
+{
+	DirectX::XMFLOAT4X4 View;
+	DirectX::XMFLOAT4X4 InvView;
+	DirectX::BoundingFrustum Frustum;
+
+	BenchCamera(DirectX::XMFLOAT3 position, float fovY, float aspect, float zn, float zf)
+	{
+		using namespace DirectX;
+
+		XMMATRIX view = XMMatrixLookToLH(
+			XMLoadFloat3(&position),
+			XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f),
+			XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMVECTOR det = XMMatrixDeterminant(view);
+		XMStoreFloat4x4(&View, view);
+		XMStoreFloat4x4(&InvView, XMMatrixInverse(&det, view));
+
+		BoundingFrustum::CreateFromMatrix(Frustum, XMMatrixPerspectiveFovLH(fovY, aspect, zn, zf));
+	}
+};
+
+// Instance grid built the same way as CullingApp::BuildObject and ComputeCull::BuildRenderItems.
+inline std::vector<DirectX::XMFLOAT4X4> BuildInstanceGrid(int count, float step, bool rotateUp)
+{
+	using namespace DirectX;
+
+	std::vector<XMFLOAT4X4> worlds;
+	int len = (int)std::cbrt(count / 8);
+	for (int x = -len; x < len; x++) {
+		for (int y = -len; y < len; y++) {
+			for (int z = -len; z < len; z++) {
+				XMMATRIX worldMatrix = XMMatrixTranslation(x * step, y * step, z * step);
+				if (rotateUp) {
+					worldMatrix *= XMMatrixRotationRollPitchYaw(XMConvertToRadians(90), 0.0f, 0.0f);
+				}
+				XMFLOAT4X4 world;
+				XMStoreFloat4x4(&world, worldMatrix);
+				worlds.push_back(world);
+			}
+		}
+	}
+	return worlds;
+}
+
+// Turns every item of a grid about its own center by a different angle, so its world space box
+// is looser than its oriented one.
+inline void RotateInstances(std::vector<DirectX::XMFLOAT4X4>& worlds)
+{
+	using namespace DirectX;
+
+	for (size_t i = 0; i < worlds.size(); ++i) {
+		XMMATRIX rotation = XMMatrixRotationRollPitchYaw(0.37f * i, 0.61f * i, 0.0f);
+		XMStoreFloat4x4(&worlds[i], rotation * XMLoadFloat4x4(&worlds[i]));
+	}
+}
+
+// Same layout as UploadBuffer, with host memory standing in for the mapped upload heap.
+template<typename T>
+class StagingBuffer
+{
+public:
+	StagingBuffer(size_t elementCount, bool isConstantBuffer)
+	{
+		mElementByteSize = sizeof(T);
+		if (isConstantBuffer)
+			mElementByteSize = (sizeof(T) + 255) & ~255;
+
+		mMappedData.resize(mElementByteSize * elementCount);
+	}
+
+	void CopyData(size_t elementIndex, const T& data)
+	{
+		std::memcpy(&mMappedData[elementIndex * mElementByteSize], &data, sizeof(T));
+	}
+
+	const std::uint8_t* Data()const
+	{
+		return mMappedData.data();
+	}
+
+	std::uint8_t* MappedData()
+	{
+		return mMappedData.data();
+	}
+
+	std::uint32_t ElementByteSize()const
+	{
+		return (std::uint32_t)mElementByteSize;
+	}
+
+private:
+	std::vector<std::uint8_t> mMappedData;
+	size_t mElementByteSize = 0;
+};
+
+struct ObjectConstants
+{
+	DirectX::XMFLOAT4X4 World;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include "CascadedShadows.h"
+
+struct ShadowView
+{
+	DirectX::XMFLOAT3 Position;
+	DirectX::XMFLOAT3 Target;
+	float Aspect;
+};
+
+// App_Shadow's start, looking down at the ground, along the light, against it, and a wide window.
+const ShadowView ShadowViews[] = {
+	{ { 0.0f, 5.0f, -10.0f }, { 0.0f, 0.0f, 0.0f }, 16.0f / 9.0f },
+	{ { 3.0f, 40.0f, -1.0f }, { 3.0f, 0.0f, 0.0f }, 16.0f / 9.0f },
+	{ { 20.0f, 20.0f, 20.0f }, { 0.0f, 0.0f, 0.0f }, 4.0f / 3.0f },
+	{ { -20.0f, 2.0f, -20.0f }, { 0.0f, 8.0f, 0.0f }, 16.0f / 9.0f },
+	{ { 0.0f, 2.0f, 0.0f }, { 10.0f, 1.0f, 3.0f }, 32.0f / 9.0f },
+};
+
+// App_Shadow's light and one straight down, where the light's up vector has to change.
+const DirectX::XMFLOAT3 ShadowLights[] = { { -1.0f, -1.0f, -1.0f }, { 0.0f, -1.0f, 0.0f } };
+
+inline Camera MakeShadowCamera(const ShadowView& view)
+{
+	Camera camera;
+	camera.SetLens(0.25f * DirectX::XM_PI, view.Aspect, 1.0f, 1000.0f);
+	camera.LookAt(view.Position, view.Target, DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f));
+	camera.UpdateViewMatrix();
+	return camera;
+}
+
+struct ShadowBox
+{
+	DirectX::XMFLOAT3 Min;
+	DirectX::XMFLOAT3 Max;
+};
+
+// Boxes standing on a 400 x 400 ground around the origin, up to 12 units high.
+inline std::vector<ShadowBox> MakeShadowBoxes(std::uint32_t count)
+{
+	std::vector<ShadowBox> boxes(count);
+	std::uint32_t state = 12345;
+	auto next = [&]() {
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) / 16777216.0f;
+	};
+	for (ShadowBox& box : boxes) {
+		const float x = 400.0f * next() - 200.0f, z = 400.0f * next() - 200.0f;
+		const float size = 0.5f + 2.5f * next(), height = 0.5f + 11.5f * next();
+		box.Min = DirectX::XMFLOAT3(x - size, 0.0f, z - size);
+		box.Max = DirectX::XMFLOAT3(x + size, height, z + size);
+	}
+	return boxes;
+}
+
+inline DirectX::BoundingBox ToBounds(const ShadowBox& box)
+{
+	return DirectX::BoundingBox(
+		DirectX::XMFLOAT3(0.5f * (box.Min.x + box.Max.x), 0.5f * (box.Min.y + box.Max.y), 0.5f * (box.Min.z + box.Max.z)),
+		DirectX::XMFLOAT3(0.5f * (box.Max.x - box.Min.x), 0.5f * (box.Max.y - box.Min.y), 0.5f * (box.Max.z - box.Min.z)));
+}
+
+inline DirectX::BoundingBox ShadowSceneBounds(const std::vector<ShadowBox>& boxes)
+{
+	ShadowBox scene = boxes.front();
+	for (const ShadowBox& box : boxes) {
+		scene.Min = DirectX::XMFLOAT3(std::min(scene.Min.x, box.Min.x), std::min(scene.Min.y, box.Min.y), std::min(scene.Min.z, box.Min.z));
+		scene.Max = DirectX::XMFLOAT3(std::max(scene.Max.x, box.Max.x), std::max(scene.Max.y, box.Max.y), std::max(scene.Max.z, box.Max.z));
+	}
+	return ToBounds(scene);
+}
+
+// Whether the ray from origin along direction hits the box at a positive distance.
+inline bool RayHits(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, const ShadowBox& box)
+{
+	const float o[3] = { origin.x, origin.y, origin.z }, d[3] = { direction.x, direction.y, direction.z };
+	const float lo[3] = { box.Min.x, box.Min.y, box.Min.z }, hi[3] = { box.Max.x, box.Max.y, box.Max.z };
+	float enter = 0.0f, leave = INFINITY;
+	for (int i = 0; i < 3; ++i) {
+		if (d[i] == 0.0f) {
+			if (o[i] < lo[i] || o[i] > hi[i])
+				return false;
+			continue;
+		}
+		float t0 = (lo[i] - o[i]) / d[i], t1 = (hi[i] - o[i]) / d[i];
+		if (t0 > t1)
+			std::swap(t0, t1);
+		enter = std::max(enter, t0);
+		leave = std::min(leave, t1);
+	}
+	return enter <= leave;
+}
+
+// A world space point to the cascade's NDC.
+inline DirectX::XMFLOAT3 ToCascadeNdc(const CascadedShadows::Cascade& cascade, const DirectX::XMFLOAT3& point)
+{
+	using namespace DirectX;
+
+	const XMMATRIX viewProj = XMMatrixMultiply(XMLoadFloat4x4(&cascade.View), XMLoadFloat4x4(&cascade.Proj));
+	XMFLOAT3 ndc;
+	XMStoreFloat3(&ndc, XMVector3TransformCoord(XMLoadFloat3(&point), viewProj));
+	return ndc;
+}
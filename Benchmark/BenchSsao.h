@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "BlueNoise.h"
+#include "SsaoReference.h"
+#include "Toolkit.h"
+
+enum class SsaoSurface : std::uint8_t
+{
+	Sky,
+	OpenFloor,		// floor more than 3 units from every sphere
+	Crease,			// floor within 0.4 of where a sphere touches it
+	Other
+};
+
+struct SsaoScene
+{
+	SsaoReference::GBuffer GBuffer;
+	std::vector<SsaoSurface> Surfaces;
+	DirectX::XMFLOAT4X4 Proj;
+};
+
+struct SsaoSphere
+{
+	DirectX::XMFLOAT3 Center;
+	float Radius;
+};
+
+// Spheres resting on a floor in front of a wall with sky above, ray cast in view space with the camera of
+// App_SSAO (fov pi / 4, near 1, far 1000).
+inline SsaoScene MakeSsaoScene(std::uint32_t width, std::uint32_t height)
+{
+	using namespace DirectX;
+
+	const float floorY = -2.0f, wallZ = 24.0f, wallTop = 4.0f;
+	const SsaoSphere spheres[] = {
+		{ { 0.0f, floorY + 1.0f, 9.0f }, 1.0f },
+		{ { -2.5f, floorY + 0.75f, 11.0f }, 0.75f },
+		{ { 3.0f, floorY + 1.5f, 14.0f }, 1.5f },
+	};
+
+	SsaoScene scene;
+	XMStoreFloat4x4(&scene.Proj, XMMatrixPerspectiveFovLH(0.25f * XM_PI, (float)width / height, 1.0f, 1000.0f));
+	SsaoReference::GBuffer& g = scene.GBuffer;
+	g.Width = width;
+	g.Height = height;
+	g.Normals.resize((std::size_t)width * height);
+	g.Depths.resize((std::size_t)width * height);
+	scene.Surfaces.resize((std::size_t)width * height);
+
+	for (std::uint32_t y = 0; y < height; ++y) {
+		for (std::uint32_t x = 0; x < width; ++x) {
+			const std::size_t index = (std::size_t)y * width + x;
+			// the ray through the pixel center, z = 1
+			const XMFLOAT3 d(
+				(2.0f * (x + 0.5f) / width - 1.0f) / scene.Proj._11,
+				(1.0f - 2.0f * (y + 0.5f) / height) / scene.Proj._22,
+				1.0f);
+
+			float t = INFINITY;
+			XMFLOAT3 normal(0.0f, 0.0f, -1.0f);
+			SsaoSurface surface = SsaoSurface::Sky;
+			if (d.y * wallZ < wallTop) {
+				t = wallZ;
+				surface = SsaoSurface::Other;
+			}
+			if (d.y < 0.0f && floorY / d.y < t) {
+				t = floorY / d.y;
+				normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+				surface = SsaoSurface::OpenFloor;
+			}
+			for (const SsaoSphere& s : spheres) {
+				const float b = d.x * s.Center.x + d.y * s.Center.y + d.z * s.Center.z;
+				const float dd = d.x * d.x + d.y * d.y + d.z * d.z;
+				const float c = s.Center.x * s.Center.x + s.Center.y * s.Center.y + s.Center.z * s.Center.z - s.Radius * s.Radius;
+				const float discriminant = b * b - dd * c;
+				if (discriminant < 0.0f)
+					continue;
+				const float hit = (b - std::sqrt(discriminant)) / dd;
+				if (hit > 0.0f && hit < t) {
+					t = hit;
+					normal = XMFLOAT3((d.x * t - s.Center.x) / s.Radius, (d.y * t - s.Center.y) / s.Radius, (d.z * t - s.Center.z) / s.Radius);
+					surface = SsaoSurface::Other;
+				}
+			}
+
+			if (surface == SsaoSurface::OpenFloor) {
+				const float px = d.x * t, pz = d.z * t;
+				for (const SsaoSphere& s : spheres) {
+					const float distance = std::sqrt((px - s.Center.x) * (px - s.Center.x) + (pz - s.Center.z) * (pz - s.Center.z));
+					if (distance < 0.4f)
+						surface = SsaoSurface::Crease;
+					else if (distance < 3.0f && surface == SsaoSurface::OpenFloor)
+						surface = SsaoSurface::Other;
+				}
+			}
+
+			g.Normals[index] = normal;
+			g.Depths[index] = surface == SsaoSurface::Sky ? 1.0f : scene.Proj._33 + scene.Proj._43 / t;
+			scene.Surfaces[index] = surface;
+		}
+	}
+	return scene;
+}
+
+inline SsaoReference::Constants MakeSsaoConstants(const SsaoScene& scene, std::uint32_t sampleCount, std::uint32_t downsample)
+{
+	SsaoReference::Constants constants;
+	constants.Proj = scene.Proj;
+	constants.Downsample = downsample;
+	BlueNoise::HemisphereKernel(sampleCount, 0.25f, constants.OffsetVectors);
+
+	std::vector<std::uint16_t> ranks;
+	BlueNoise::Generate(64, 1, ranks);
+	constants.NoiseSize = 64;
+	SsaoReference::RotationNoise(ranks, constants.Noise);
+
+	constants.BlurWeights = Toolkit::CalcGaussWeights(1.5f);
+	return constants;
+}
+
+// The surfaces under the pixels of a map downsample times smaller, as the blur reads the G-buffer.
+inline std::vector<SsaoSurface> MapSurfaces(const SsaoScene& scene, std::uint32_t downsample)
+{
+	const SsaoReference::GBuffer& g = scene.GBuffer;
+	const std::uint32_t width = std::max(g.Width / downsample, 1u), height = std::max(g.Height / downsample, 1u);
+	std::vector<SsaoSurface> surfaces((std::size_t)width * height);
+	for (std::uint32_t y = 0; y < height; ++y)
+		for (std::uint32_t x = 0; x < width; ++x)
+			surfaces[(std::size_t)y * width + x] = scene.Surfaces[
+				(std::size_t)std::min(y * downsample + downsample / 2, g.Height - 1) * g.Width + std::min(x * downsample + downsample / 2, g.Width - 1)];
+	return surfaces;
+}
+
+inline double SurfaceMean(const std::vector<float>& values, const std::vector<SsaoSurface>& surfaces, SsaoSurface surface)
+{
+	double sum = 0.0;
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < values.size(); ++i) {
+		if (surfaces[i] == surface) {
+			sum += values[i];
+			count++;
+		}
+	}
+	return count ? sum / count : 0.0;
+}
+
+// Variance of the values over one kind of surface around their mean.
+inline double SurfaceVariance(const std::vector<float>& values, const std::vector<SsaoSurface>& surfaces, SsaoSurface surface)
+{
+	const double mean = SurfaceMean(values, surfaces, surface);
+	double sum = 0.0;
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < values.size(); ++i) {
+		if (surfaces[i] == surface) {
+			sum += (values[i] - mean) * (values[i] - mean);
+			count++;
+		}
+	}
+	return count ? sum / count : 0.0;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "TextureStreamer.h"
+
+const std::uint32_t gStreamTextures = 256;
+const std::uint32_t gStreamTextureSize = 1024;
+const std::uint32_t gStreamGrid = 64;			// gStreamGrid^2 items, 4 units apart
+const float gStreamSpacing = 4.0f;
+const float gStreamViewDistance = 80.0f;
+const int gStreamFrames = 300;
+
+// Keeps the mips in memory and checks the streamer's calls: uploads coarse to fine with no gap,
+// evictions only of resident mips. Every call goes into a running hash.
+class StreamBackend : public TextureStreamer::Backend
+{
+public:
+	bool Read(std::uint32_t texture, std::uint32_t mip, std::vector<std::uint8_t>& data) override
+	{
+		std::size_t bytes = std::max(1u, (gStreamTextureSize >> mip) / 4) * std::max(1u, (gStreamTextureSize >> mip) / 4) * 8;
+		data.assign(bytes, (std::uint8_t)(texture + mip));
+		return true;
+	}
+
+	void Upload(std::uint32_t texture, std::uint32_t mip, const std::vector<std::uint8_t>& data) override
+	{
+		Grow(texture);
+		const std::uint32_t expected = mResident[texture] == NotLoaded ? MipCount() - 1 : mResident[texture] - 1;
+		if (mip != expected || data.empty() || data[0] != (std::uint8_t)(texture + mip))
+			mErrors++;
+		mResident[texture] = mip;
+		Record(1, texture, mip);
+	}
+
+	void Evict(std::uint32_t texture, std::uint32_t mip) override
+	{
+		Grow(texture);
+		if (mResident[texture] == NotLoaded || mip <= mResident[texture])
+			mErrors++;
+		mResident[texture] = mip;
+		Record(2, texture, mip);
+	}
+
+	std::uint64_t Hash()const { return mHash; }
+	std::uint32_t Errors()const { return mErrors; }
+
+private:
+	static constexpr std::uint32_t NotLoaded = UINT32_MAX;
+
+	static std::uint32_t MipCount() { return (std::uint32_t)std::log2((double)gStreamTextureSize) + 1; }
+
+	void Grow(std::uint32_t texture)
+	{
+		if (texture >= mResident.size())
+			mResident.resize(texture + 1, NotLoaded);
+	}
+
+	void Record(std::uint64_t kind, std::uint32_t texture, std::uint32_t mip)
+	{
+		mHash = (mHash ^ (kind << 48 | (std::uint64_t)texture << 8 | mip)) * 1099511628211ull;
+	}
+
+	std::vector<std::uint32_t> mResident;
+	std::uint64_t mHash = 14695981039346656037ull;
+	std::uint32_t mErrors = 0;
+};
+
+struct StreamRun
+{
+	std::uint64_t Hash = 0;
+	std::uint32_t Errors = 0;
+	std::size_t PeakBytes = 0;
+	std::size_t OverBudget = 0;			// most bytes over the budget beyond the tails
+	TextureStreamer::Stats Stats;
+	std::uint32_t Unconverged = 0;		// visible textures short of their desired mip at the end
+};
+
+// A camera flying over a grid of quads, each showing one of the textures. The requests come from
+// the quads in range in front of it. The camera stops for the last 30 frames. update runs once a
+// frame after the requests, it calls Update() on the streamer.
+inline StreamRun StreamFlight(const TextureStreamer::Options& options, const std::function<void(TextureStreamer&)>& update)
+{
+	using namespace DirectX;
+
+	StreamBackend backend;
+	TextureStreamer streamer(backend, options);
+	streamer.SetProjection(XMMatrixPerspectiveFovLH(0.25f * XM_PI, 16.0f / 9.0f, 1.0f, 1000.0f), 1080.0f);
+
+	for (std::uint32_t i = 0; i < gStreamTextures; ++i)
+		streamer.Register(DDSFormat::BC1_UNORM, gStreamTextureSize, gStreamTextureSize, 11);
+	const std::size_t tailBytes = streamer.GetStats().ResidentBytes;
+
+	// one texture across every quad
+	const float uvDensity = 1.0f / gStreamSpacing;
+
+	StreamRun run;
+	std::vector<std::uint32_t> visible;
+	for (int frame = 0; frame < gStreamFrames; ++frame) {
+		const float t = std::min(frame, gStreamFrames - 30) * 0.01f;
+		const XMFLOAT3 eye(128.0f + 100.0f * std::cos(t), 3.0f, 128.0f + 100.0f * std::sin(t));
+		const XMFLOAT3 forward(-std::sin(t), 0.0f, std::cos(t));
+
+		visible.clear();
+		for (std::uint32_t z = 0; z < gStreamGrid; ++z) {
+			for (std::uint32_t x = 0; x < gStreamGrid; ++x) {
+				const float dx = x * gStreamSpacing - eye.x, dz = z * gStreamSpacing - eye.z;
+				const float distance = std::sqrt(dx * dx + eye.y * eye.y + dz * dz);
+				if (distance > gStreamViewDistance || dx * forward.x + dz * forward.z < 0.0f)
+					continue;
+
+				const std::uint32_t texture = (x * 7 + z * 13) % gStreamTextures;
+				streamer.Request(texture, uvDensity, distance);
+				visible.push_back(texture);
+			}
+		}
+
+		update(streamer);
+
+		const std::size_t bytes = streamer.GetStats().ResidentBytes;
+		run.PeakBytes = std::max(run.PeakBytes, bytes);
+		if (bytes > options.Budget + tailBytes)
+			run.OverBudget = std::max(run.OverBudget, bytes - options.Budget - tailBytes);
+	}
+
+	// the last requests were taken by the last Update(), the reads they caused are still in flight
+	streamer.Flush();
+	for (std::uint32_t texture : visible) {
+		if (streamer.ResidentMip(texture) > streamer.DesiredMip(texture))
+			run.Unconverged++;
+	}
+
+	run.Hash = backend.Hash();
+	run.Errors = backend.Errors();
+	run.Stats = streamer.GetStats();
+	return run;
+}
@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "BenchBlueNoise.h"
+#include "BlueNoise.h"
+
+// Void and cluster dither arrays of the given size. lowFreq is the power of the 50% pattern near
+// DC against white noise, it should stay far below 1.
+static void BM_GenerateBlueNoise(benchmark::State& state)
+{
+	const std::uint32_t size = (std::uint32_t)state.range(0);
+	std::vector<std::uint16_t> ranks;
+	for (auto _ : state) {
+		BlueNoise::Generate(size, 1, ranks);
+		benchmark::DoNotOptimize(ranks.data());
+	}
+
+	state.counters["lowFreq"] = LowFrequencyPower(ranks, size);
+}
+BENCHMARK(BM_GenerateBlueNoise)->ArgName("size")->Arg(32)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond);
+
+// The SSAO kernel.
+static void BM_HemisphereKernel(benchmark::State& state)
+{
+	std::vector<DirectX::XMFLOAT4> kernel;
+	for (auto _ : state) {
+		BlueNoise::HemisphereKernel((std::uint32_t)state.range(0), 0.25f, kernel);
+		benchmark::DoNotOptimize(kernel.data());
+	}
+}
+BENCHMARK(BM_HemisphereKernel)->ArgName("count")->Arg(8)->Arg(16);
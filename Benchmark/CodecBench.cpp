@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchCodec.h"
+#include "MeshCodec.h"
+
+namespace
+{
+	void DecodeIndices(benchmark::State& state, const std::vector<std::uint32_t>& indices)
+	{
+		std::vector<std::uint8_t> encoded = MeshCodec::EncodeIndices(indices.data(), indices.size());
+		std::vector<std::uint32_t> decoded(indices.size());
+
+		for (auto _ : state) {
+			MeshCodec::DecodeIndices(encoded.data(), encoded.size(), decoded.data(), decoded.size());
+			benchmark::DoNotOptimize(decoded.data());
+		}
+
+		// against the 16 bit index buffer Model uploads
+		state.counters["bytes/tri"] = (double)encoded.size() / (indices.size() / 3);
+		state.counters["ratio"] = (double)encoded.size() / (indices.size() * sizeof(std::uint16_t));
+		state.SetBytesProcessed(state.iterations() * indices.size() * sizeof(std::uint32_t));
+	}
+
+	template<typename Vertex>
+	void DecodeVertices(benchmark::State& state, const std::vector<Vertex>& vertices)
+	{
+		std::vector<std::uint8_t> encoded = MeshCodec::EncodeVertices(vertices.data(), vertices.size(), sizeof(Vertex));
+		std::vector<Vertex> decoded(vertices.size());
+
+		for (auto _ : state) {
+			MeshCodec::DecodeVertices(encoded.data(), encoded.size(), decoded.data(), decoded.size(), sizeof(Vertex));
+			benchmark::DoNotOptimize(decoded.data());
+		}
+
+		state.counters["bytes/vertex"] = (double)encoded.size() / vertices.size();
+		state.counters["ratio"] = (double)encoded.size() / (vertices.size() * sizeof(Vertex));
+		state.SetBytesProcessed(state.iterations() * vertices.size() * sizeof(Vertex));
+	}
+}
+
+// Index buffer as imported, and welded by position.
+static void BM_DecodeIndices(benchmark::State& state, const char* file)
+{
+	CookedMesh mesh = CookMesh(file);
+	DecodeIndices(state, state.range(0) ? mesh.WeldedIndices : mesh.Indices);
+}
+BENCHMARK_CAPTURE(BM_DecodeIndices, pacman_stl, "pacman/Pacman.stl")->ArgName("welded")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DecodeIndices, box_fbx, "box/Box.fbx")->ArgName("welded")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+// GeometryGenerator::Vertex and PackedVertex (VertexFormat::Packed) streams.
+static void BM_DecodeVertices(benchmark::State& state, const char* file)
+{
+	CookedMesh mesh = CookMesh(file);
+	if (state.range(0))
+		DecodeVertices(state, mesh.PackedVertices);
+	else
+		DecodeVertices(state, mesh.Vertices);
+}
+BENCHMARK_CAPTURE(BM_DecodeVertices, pacman_stl, "pacman/Pacman.stl")->ArgName("packed")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DecodeVertices, box_stl, "box/box.stl")->ArgName("packed")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DecodeVertices, box_fbx, "box/Box.fbx")->ArgName("packed")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+// Cooking cost for both streams of the packed mesh.
+static void BM_EncodeMesh(benchmark::State& state, const char* file)
+{
+	CookedMesh mesh = CookMesh(file);
+	size_t encodedBytes = 0;
+
+	for (auto _ : state) {
+		std::vector<std::uint8_t> vertices = MeshCodec::EncodeVertices(mesh.PackedVertices.data(), mesh.PackedVertices.size(), sizeof(PackedVertex));
+		std::vector<std::uint8_t> indices = MeshCodec::EncodeIndices(mesh.Indices.data(), mesh.Indices.size());
+		encodedBytes = vertices.size() + indices.size();
+		benchmark::DoNotOptimize(encodedBytes);
+	}
+
+	const size_t rawBytes = mesh.Vertices.size() * sizeof(GeometryGenerator::Vertex) + mesh.Indices.size() * sizeof(std::uint16_t);
+	state.counters["raw KB"] = rawBytes / 1024.0;
+	state.counters["cooked KB"] = encodedBytes / 1024.0;
+	state.SetBytesProcessed(state.iterations() * (mesh.PackedVertices.size() * sizeof(PackedVertex) + mesh.Indices.size() * sizeof(std::uint32_t)));
+}
+BENCHMARK_CAPTURE(BM_EncodeMesh, pacman_stl, "pacman/Pacman.stl")->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_EncodeMesh, box_fbx, "box/Box.fbx")->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstring>
+
+#include "BenchScene.h"
+#include "Culling.h"
+#include "ModelImporter.h"
+#include "SceneDatabase.h"
+
+using namespace DirectX;
+
+namespace
+{
+	struct InstanceData
+	{
+		XMFLOAT4X4 World;
+		XMFLOAT3 Color;
+	};
+}
+
+// CullingApp::Update: 27000 unit boxes 200 apart, visible instances are copied into the instance buffer.
+static void BM_CullingApp(benchmark::State& state)
+{
+	BenchCamera camera(XMFLOAT3(0.0f, 0.0f, -5.0f), 0.25f * XM_PI, 800.0f / 600.0f, 1.0f, 1000.0f);
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(8 * 200 * 20, 200.0f, false);
+	BoundingBox bounds(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+	XMMATRIX invView = XMLoadFloat4x4(&camera.InvView);
+	std::vector<InstanceData> instanceBuffer(worlds.size());
+
+	int visible = 0;
+	for (auto _ : state) {
+		visible = 0;
+		for (size_t i = 0; i < worlds.size(); i++) {
+			XMMATRIX world = XMLoadFloat4x4(&worlds[i]);
+
+			if (Culling::IsVisible(camera.Frustum, invView, world, bounds)) {
+				InstanceData data;
+				XMStoreFloat4x4(&data.World, XMMatrixTranspose(world));
+				data.Color = XMFLOAT3(0.0f, 0.0f, 0.0f);
+				std::memcpy(&instanceBuffer[visible++], &data, sizeof(InstanceData));
+			}
+		}
+		benchmark::DoNotOptimize(instanceBuffer.data());
+	}
+
+	state.counters["objects"] = (double)worlds.size();
+	state.counters["visible"] = visible;
+	state.SetItemsProcessed(state.iterations() * worlds.size());
+}
+BENCHMARK(BM_CullingApp)->Unit(benchmark::kMicrosecond);
+
+// ComputeCull::Update with mRenderState == 1: 8000 Pacman render items 800 apart.
+static void BM_ComputeCullCpu(benchmark::State& state)
+{
+	ModelImporter pacman(ResourcePath("pacman/Pacman.stl"));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+	pacman.Merge(indices, submeshes);
+
+	// ComputeCull passes 45 to SetLens, which takes radians. Kept as is so the visible count matches the app.
+	BenchCamera camera(XMFLOAT3(0.0f, 5.0f, -50.0f), 45.0f, 800.0f / 600.0f, 1.0f, 3000.0f);
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(8 * 10 * 10 * 10, 800.0f, true);
+
+	SceneDatabase scene(1);
+	scene.Reserve((std::uint32_t)(worlds.size() * submeshes.size()));
+	for (size_t i = 0; i < worlds.size(); i++) {
+		for (auto& submesh : submeshes) {
+			SceneDatabase::DrawArgs draw;
+			draw.IndexCount = submesh.IndexCount;
+			draw.StartIndexLocation = submesh.StartIndexLocation;
+			draw.BaseVertexLocation = submesh.BaseVertexLocation;
+			scene.Add(worlds[i], submesh.Bounds, draw);
+		}
+	}
+
+	XMMATRIX invView = XMLoadFloat4x4(&camera.InvView);
+	std::vector<std::uint32_t> visibleItems(scene.Size());
+	std::uint32_t visible = 0;
+
+	for (auto _ : state) {
+		visible = scene.Cull(camera.Frustum, invView, visibleItems.data());
+		benchmark::DoNotOptimize(visibleItems.data());
+	}
+
+	state.counters["objects"] = (double)scene.Size();
+	state.counters["visible"] = (double)visible;
+	state.SetItemsProcessed(state.iterations() * scene.Size());
+}
+BENCHMARK(BM_ComputeCullCpu)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <vector>
+
+#include "BenchScene.h"
+#include "DDSParser.h"
+#include "MappedFile.h"
+
+namespace
+{
+	bool ReadFile(const std::string& path, std::vector<std::uint8_t>& data)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+			return false;
+		data.resize((size_t)file.tellg());
+		file.seekg(0);
+		return (bool)file.read((char*)data.data(), data.size());
+	}
+}
+
+// Header validation and subresource layout only, the file stays mapped.
+static void BM_ParseDDS(benchmark::State& state)
+{
+	MappedFile file(ResourcePath("teapot512.dds"));
+	if (!file.IsOpen()) {
+		state.SkipWithError("teapot512.dds not found");
+		return;
+	}
+
+	DDSTexture texture;
+	for (auto _ : state) {
+		DDSParser::Parse(file.Data(), file.Size(), texture);
+		benchmark::DoNotOptimize(texture.Subresources.data());
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseDDS);
+
+// Opening the file as well: mapped and parsed in place against read into a buffer first.
+static void BM_LoadDDS(benchmark::State& state)
+{
+	const bool mapped = state.range(0) != 0;
+	const std::string path = ResourcePath("teapot512.dds");
+
+	DDSTexture texture;
+	size_t bytes = 0;
+	for (auto _ : state) {
+		if (mapped) {
+			MappedFile file(path);
+			DDSParser::Parse(file.Data(), file.Size(), texture);
+			bytes = file.Size();
+		}
+		else {
+			std::vector<std::uint8_t> data;
+			ReadFile(path, data);
+			DDSParser::Parse(data.data(), data.size(), texture);
+			bytes = data.size();
+		}
+		benchmark::DoNotOptimize(texture.Data);
+	}
+
+	state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_LoadDDS)->ArgName("mapped")->Arg(0)->Arg(1);
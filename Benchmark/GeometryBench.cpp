@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include "Common/GeometryGenerator.h"
+
+static void BM_CreateSphere(benchmark::State& state)
+{
+	GeometryGenerator geoGen;
+	std::uint32_t slices = (std::uint32_t)state.range(0);
+
+	size_t vertexCount = 0;
+	for (auto _ : state) {
+		GeometryGenerator::MeshData sphere = geoGen.CreateSphere(1.0f, slices, slices);
+		vertexCount = sphere.Vertices.size();
+		benchmark::DoNotOptimize(sphere.Vertices.data());
+	}
+
+	state.counters["vertices"] = (double)vertexCount;
+	state.SetItemsProcessed(state.iterations() * vertexCount);
+}
+BENCHMARK(BM_CreateSphere)->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+static void BM_CreateGeosphere(benchmark::State& state)
+{
+	GeometryGenerator geoGen;
+	std::uint32_t subdivisions = (std::uint32_t)state.range(0);
+
+	size_t vertexCount = 0;
+	for (auto _ : state) {
+		GeometryGenerator::MeshData geosphere = geoGen.CreateGeosphere(1.0f, subdivisions);
+		vertexCount = geosphere.Vertices.size();
+		benchmark::DoNotOptimize(geosphere.Vertices.data());
+	}
+
+	state.counters["vertices"] = (double)vertexCount;
+	state.SetItemsProcessed(state.iterations() * vertexCount);
+}
+// CreateGeosphere clamps the subdivision count to 6.
+BENCHMARK(BM_CreateGeosphere)->DenseRange(3, 6)->Unit(benchmark::kMillisecond);
+
+static void BM_CreateCylinder(benchmark::State& state)
+{
+	GeometryGenerator geoGen;
+	std::uint32_t slices = (std::uint32_t)state.range(0);
+
+	size_t vertexCount = 0;
+	for (auto _ : state) {
+		GeometryGenerator::MeshData cylinder = geoGen.CreateCylinder(1.0f, 0.5f, 3.0f, slices, slices);
+		vertexCount = cylinder.Vertices.size();
+		benchmark::DoNotOptimize(cylinder.Vertices.data());
+	}
+
+	state.counters["vertices"] = (double)vertexCount;
+	state.SetItemsProcessed(state.iterations() * vertexCount);
+}
+BENCHMARK(BM_CreateCylinder)->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+static void BM_CreateGrid(benchmark::State& state)
+{
+	GeometryGenerator geoGen;
+	std::uint32_t n = (std::uint32_t)state.range(0);
+
+	size_t vertexCount = 0;
+	for (auto _ : state) {
+		GeometryGenerator::MeshData grid = geoGen.CreateGrid(100.0f, 100.0f, n, n);
+		vertexCount = grid.Vertices.size();
+		benchmark::DoNotOptimize(grid.Vertices.data());
+	}
+
+	state.counters["vertices"] = (double)vertexCount;
+	state.SetItemsProcessed(state.iterations() * vertexCount);
+}
+BENCHMARK(BM_CreateGrid)->Arg(256)->Arg(1024)->Arg(2048)->Unit(benchmark::kMillisecond);
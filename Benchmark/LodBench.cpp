@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "BenchLod.h"
+#include "BenchScene.h"
+#include "LodSelector.h"
+#include "MeshSimplifier.h"
+#include "ModelImporter.h"
+
+using namespace DirectX;
+
+// Simplifies every Pacman submesh to the given per mille of its triangles.
+// Reports the triangle ratio reached, the simplifier's error and the measured deviation, both relative to the radius.
+static void BM_SimplifyPacman(benchmark::State& state)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<GeometryGenerator::MeshData> meshes;
+	for (std::uint32_t i = 0; i < importer.MeshCount(); ++i)
+		meshes.push_back(importer.Mesh(i));
+	const double fraction = state.range(0) / 1000.0;
+
+	std::vector<std::vector<std::uint32_t>> results(meshes.size());
+	std::vector<float> errors(meshes.size());
+	for (auto _ : state) {
+		for (size_t i = 0; i < meshes.size(); ++i) {
+			size_t target = (size_t)(meshes[i].Indices32.size() * fraction);
+			errors[i] = MeshSimplifier::Simplify(meshes[i].Vertices, meshes[i].Indices32, target, FLT_MAX, results[i]);
+		}
+		benchmark::DoNotOptimize(results.data());
+	}
+
+	size_t sourceIndices = 0, resultIndices = 0;
+	float relativeError = 0.0f, relativeDeviation = 0.0f;
+	for (size_t i = 0; i < meshes.size(); ++i) {
+		float radius = Radius(meshes[i]);
+		sourceIndices += meshes[i].Indices32.size();
+		resultIndices += results[i].size();
+		relativeError = std::max(relativeError, errors[i] / radius);
+		relativeDeviation = std::max(relativeDeviation, MaxDeviation(meshes[i], results[i]) / radius);
+	}
+
+	state.counters["triangles"] = (double)resultIndices / sourceIndices;
+	state.counters["error"] = relativeError;
+	state.counters["deviation"] = relativeDeviation;
+}
+BENCHMARK(BM_SimplifyPacman)->Arg(500)->Arg(250)->Arg(125)->Unit(benchmark::kMillisecond);
+
+// The LOD chain as Model builds it. levels: LODs per submesh, last/first: indices of the coarsest
+// level of the first submesh over its full mesh.
+static void BM_GeneratePacmanLods(benchmark::State& state)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+
+	for (auto _ : state) {
+		importer.GenerateLods(4);
+		importer.Merge(indices, submeshes);
+		benchmark::DoNotOptimize(indices.data());
+	}
+
+	size_t levels = 0;
+	for (const auto& submesh : submeshes)
+		levels += submesh.Lods.size();
+
+	state.counters["levels"] = (double)levels / submeshes.size();
+	state.counters["last/first"] = (double)submeshes[0].Lods.back().IndexCount / submeshes[0].Lods[0].IndexCount;
+}
+BENCHMARK(BM_GeneratePacmanLods)->Unit(benchmark::kMillisecond);
+
+// Selection for the ComputeCull grid while the camera sways back and forth. The counter shows
+// how many level switches per item and frame happen, with and without hysteresis.
+static void BM_LodSelect(benchmark::State& state)
+{
+	const bool hysteresis = state.range(0) != 0;
+
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(8 * 10 * 10 * 10, 800.0f, true);
+	const float radius = 30.0f;
+	const float errors[] = { 0.0f, 0.016f, 0.025f, 0.038f };
+
+	LodSelector selector(1.0f, hysteresis ? 0.25f : 0.0f);
+	selector.SetProjection(XMMatrixPerspectiveFovLH(0.25f * XM_PI, 16.0f / 9.0f, 1.0f, 3000.0f), 1080.0f);
+
+	std::vector<std::uint32_t> levels(worlds.size(), 0);
+	size_t frame = 0, switches = 0;
+	for (auto _ : state) {
+		XMVECTOR eye = XMVectorSet(0.0f, 5.0f, -50.0f + 20.0f * std::sin(frame * 0.5f), 1.0f);
+		for (size_t i = 0; i < worlds.size(); ++i) {
+			XMVECTOR center = XMVectorSet(worlds[i]._41, worlds[i]._42, worlds[i]._43, 1.0f);
+			float distance = XMVectorGetX(XMVector3Length(center - eye));
+
+			std::uint32_t level = selector.Select(errors, 4, sizeof(float), selector.ProjectedSize(radius, distance), levels[i]);
+			switches += level != levels[i];
+			levels[i] = level;
+		}
+		benchmark::DoNotOptimize(levels.data());
+		frame++;
+	}
+
+	state.counters["switches/item/frame"] = (double)switches / (state.iterations() * worlds.size());
+	state.SetItemsProcessed(state.iterations() * worlds.size());
+}
+BENCHMARK(BM_LodSelect)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include <set>
+
+#include "BenchMaterial.h"
+#include "BenchScene.h"
+#include "ModelImporter.h"
+
+// The box FBX references its wood texture by a path from the exporting machine,
+// the importer has to find it next to the model.
+static void BM_ImportBoxMaterials(benchmark::State& state)
+{
+	TextureCache cache;
+	size_t materials = 0;
+
+	for (auto _ : state) {
+		cache.Clear();
+		ModelImporter importer(ResourcePath("box/Box.fbx"), 0, &cache);
+		cache.LoadPending();
+		materials = importer.Materials().size();
+	}
+
+	state.counters["materials"] = (double)materials;
+	state.counters["textures"] = (double)cache.Size();
+}
+BENCHMARK(BM_ImportBoxMaterials)->Unit(benchmark::kMillisecond);
+
+// Every file requested under two spellings of its path, and every file's contents twice
+// under different names: half the requests hit by path, half the loaded files by content.
+static void BM_TextureCacheLoad(benchmark::State& state)
+{
+	const std::string& directory = TextureDirectory();
+	const unsigned threads = (unsigned)state.range(0);
+
+	TextureCache cache;
+	for (auto _ : state) {
+		state.PauseTiming();
+		cache.Clear();
+		for (int file = 0; file < gDistinctFiles; ++file) {
+			for (const char* prefix : { "texture", "copy" }) {
+				std::string name = prefix + std::to_string(file) + ".bin";
+				cache.Request(directory, name);
+				cache.Request(directory + "/sub/..", "./" + name);
+			}
+		}
+		state.ResumeTiming();
+
+		cache.LoadPending(ChecksumDecoder, threads);
+	}
+
+	std::set<std::uint32_t> unique;
+	for (std::uint32_t id = 0; id < cache.Size(); ++id)
+		unique.insert(cache.Resolve(id));
+
+	state.counters["unique"] = (double)unique.size();
+	state.SetBytesProcessed(state.iterations() * 2 * gDistinctFiles * gFileBytes);
+}
+BENCHMARK(BM_TextureCacheLoad)->ArgName("threads")->Arg(1)->Arg(4)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
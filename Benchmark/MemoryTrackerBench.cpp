@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+
+#include "MemoryTracker.h"
+
+// Cost of a tracked allocate/free pair.
+static void BM_TrackedAllocation(benchmark::State& state)
+{
+	auto& tracker = MemoryTracker::Get();
+	tracker.Reset();
+
+	const size_t bytes = (size_t)state.range(0);
+	for (auto _ : state) {
+		TrackedAllocation allocation(MemoryTracker::Category::MeshGeometryCpu, bytes);
+		benchmark::DoNotOptimize(allocation.Bytes());
+	}
+}
+BENCHMARK(BM_TrackedAllocation)->Arg(64)->Arg(1 << 20);
+
+// Per-frame bookkeeping with a budget that is crossed every frame.
+static void BM_TrackerFrame(benchmark::State& state)
+{
+	auto& tracker = MemoryTracker::Get();
+	tracker.Reset();
+
+	size_t alerts = 0;
+	tracker.SetBudget(MemoryTracker::Category::UploadBuffer, 1024);
+	tracker.SetBudgetCallback([&alerts](MemoryTracker::Category, const MemoryTracker::Stats&) { ++alerts; });
+
+	const int allocationsPerFrame = (int)state.range(0);
+	for (auto _ : state) {
+		tracker.BeginFrame();
+		for (int i = 0; i < allocationsPerFrame; ++i)
+			tracker.Allocate(MemoryTracker::Category::UploadBuffer, 256);
+		for (int i = 0; i < allocationsPerFrame; ++i)
+			tracker.Free(MemoryTracker::Category::UploadBuffer, 256);
+	}
+
+	state.counters["alerts/frame"] = (double)alerts / state.iterations();
+
+	tracker.SetBudgetCallback(nullptr);
+	tracker.Reset();
+}
+BENCHMARK(BM_TrackerFrame)->Arg(16)->Arg(256);
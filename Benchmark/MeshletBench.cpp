@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+
+#include "BenchScene.h"
+#include "Meshlets.h"
+#include "ModelImporter.h"
+#include "SceneDatabase.h"
+
+using namespace DirectX;
+
+// Splits every Pacman submesh into meshlets, counters show how full they get and how many have a usable cone.
+static void BM_BuildMeshlets(benchmark::State& state)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<GeometryGenerator::MeshData> meshes;
+	for (std::uint32_t i = 0; i < importer.MeshCount(); ++i)
+		meshes.push_back(importer.Mesh(i));
+
+	std::vector<MeshletData> meshlets(meshes.size());
+	for (auto _ : state) {
+		for (size_t i = 0; i < meshes.size(); ++i)
+			MeshletBuilder::Build(meshes[i].Vertices, meshes[i].Indices32, meshlets[i]);
+		benchmark::DoNotOptimize(meshlets.data());
+	}
+
+	size_t count = 0, vertices = 0, triangles = 0, cones = 0;
+	for (size_t i = 0; i < meshes.size(); ++i) {
+		count += meshlets[i].Meshlets.size();
+		for (const auto& meshlet : meshlets[i].Meshlets) {
+			vertices += meshlet.VertexCount;
+			triangles += meshlet.PrimitiveCount;
+		}
+		for (const auto& bounds : meshlets[i].Bounds)
+			cones += bounds.ConeCutoff < 1.0f;
+	}
+
+	state.counters["meshlets"] = (double)count;
+	state.counters["verts/meshlet"] = (double)vertices / count;
+	state.counters["tris/meshlet"] = (double)triangles / count;
+	state.counters["cones"] = (double)cones / count;
+}
+BENCHMARK(BM_BuildMeshlets)->Unit(benchmark::kMillisecond);
+
+// The ComputeCull scene culled per object as the app does, then per meshlet for the visible objects.
+// Counters give the share of meshlets removed by each test and the triangles left relative to object culling.
+static void BM_MeshletCull(benchmark::State& state)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+	importer.Merge(indices, submeshes);
+
+	std::vector<GeometryGenerator::MeshData> meshes;
+	for (std::uint32_t i = 0; i < importer.MeshCount(); ++i)
+		meshes.push_back(importer.Mesh(i));
+	std::vector<MeshletData> meshlets(meshes.size());
+	size_t maxMeshlets = 0;
+	for (size_t i = 0; i < meshes.size(); ++i) {
+		MeshletBuilder::Build(meshes[i].Vertices, meshes[i].Indices32, meshlets[i]);
+		maxMeshlets = std::max(maxMeshlets, meshlets[i].Meshlets.size());
+	}
+
+	// same camera as BM_ComputeCullCpu
+	BenchCamera camera(XMFLOAT3(0.0f, 5.0f, -50.0f), 45.0f, 800.0f / 600.0f, 1.0f, 3000.0f);
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(8 * 10 * 10 * 10, 800.0f, true);
+
+	SceneDatabase scene(1);
+	scene.Reserve((std::uint32_t)(worlds.size() * submeshes.size()));
+	for (size_t i = 0; i < worlds.size(); i++) {
+		for (std::uint32_t s = 0; s < submeshes.size(); ++s) {
+			SceneDatabase::DrawArgs draw;
+			draw.Geometry = s;
+			draw.IndexCount = submeshes[s].IndexCount;
+			scene.Add(worlds[i], submeshes[s].Bounds, draw);
+		}
+	}
+
+	XMMATRIX invView = XMLoadFloat4x4(&camera.InvView);
+	MeshletCuller culler;
+	culler.SetView(camera.Frustum, invView);
+
+	std::vector<std::uint32_t> visibleItems(scene.Size());
+	std::vector<std::uint32_t> visibleMeshlets(maxMeshlets);
+	MeshletCuller::Stats stats;
+	size_t objectTriangles = 0, meshletTriangles = 0;
+
+	for (auto _ : state) {
+		stats = MeshletCuller::Stats();
+		objectTriangles = meshletTriangles = 0;
+
+		std::uint32_t visible = scene.Cull(camera.Frustum, invView, visibleItems.data());
+		for (std::uint32_t v = 0; v < visible; ++v) {
+			std::uint32_t item = visibleItems[v];
+			const SceneDatabase::DrawArgs& draw = scene.Draws()[item];
+			const MeshletData& data = meshlets[draw.Geometry];
+			objectTriangles += draw.IndexCount / 3;
+
+			std::uint32_t count = culler.Cull(XMLoadFloat4x4(&scene.Worlds()[item]), data, visibleMeshlets.data(), &stats);
+			for (std::uint32_t m = 0; m < count; ++m)
+				meshletTriangles += data.Meshlets[visibleMeshlets[m]].PrimitiveCount;
+		}
+		benchmark::DoNotOptimize(visibleMeshlets.data());
+	}
+
+	state.counters["meshlets"] = (double)stats.Tested;
+	state.counters["frustum culled"] = stats.Tested ? (double)stats.FrustumCulled / stats.Tested : 0.0;
+	state.counters["cone culled"] = stats.Tested ? (double)stats.ConeCulled / stats.Tested : 0.0;
+	state.counters["tris vs object cull"] = objectTriangles ? (double)meshletTriangles / objectTriangles : 0.0;
+	state.SetItemsProcessed(state.iterations() * stats.Tested);
+}
+BENCHMARK(BM_MeshletCull)->Unit(benchmark::kMicrosecond);
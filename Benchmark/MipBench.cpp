@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "BenchMip.h"
+#include "MipGenerator.h"
+
+namespace
+{
+	const std::uint32_t gImageSize = 2048;
+}
+
+// Full chain of a 2048x2048 RGBA8 image into a D3D12 upload layout. The Mpixels rate counts the source image.
+static void BM_GenerateMips(benchmark::State& state)
+{
+	const MipImage mode = (MipImage)state.range(1);
+	MipGenerator::Options options;
+	options.Kernel = state.range(0) ? MipGenerator::Filter::Kaiser : MipGenerator::Filter::Box;
+	options.SRGB = mode == MipSRGB;
+	options.NormalMap = mode == MipNormalMap;
+	options.ThreadCount = (unsigned)state.range(2);
+
+	const std::vector<std::uint8_t> image = MakeMipImage(gImageSize, mode);
+	std::vector<MipGenerator::Level> levels;
+	std::vector<std::uint8_t> chain(MipGenerator::Layout(gImageSize, gImageSize, options, levels));
+
+	for (auto _ : state) {
+		MipGenerator::Generate(image.data(), (size_t)gImageSize * 4, levels, options, chain.data());
+		benchmark::ClobberMemory();
+	}
+
+	state.counters["Mpixels"] = benchmark::Counter(gImageSize * gImageSize / 1e6, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_GenerateMips)->ArgNames({ "kaiser", "mode", "threads" })
+	->Args({ 0, MipColor, 1 })->Args({ 0, MipColor, 0 })
+	->Args({ 1, MipColor, 1 })->Args({ 1, MipColor, 0 })
+	->Args({ 1, MipSRGB, 0 })->Args({ 1, MipNormalMap, 0 })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
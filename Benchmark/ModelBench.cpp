@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+
+#include "BenchScene.h"
+#include "ModelImporter.h"
+
+namespace
+{
+	// An OBJ with 64 separate sphere objects, standing in for a multi-mesh scene file.
+	// Written once to the temp directory, assimp turns every object into its own mesh.
+	const char* MultiMeshPath()
+	{
+		static const std::string path = []()
+		{
+			std::string file = (std::filesystem::temp_directory_path() / "renderer_bench_multimesh.obj").string();
+
+			GeometryGenerator geoGen;
+			GeometryGenerator::MeshData sphere = geoGen.CreateSphere(1.0f, 32, 32);
+
+			FILE* out = std::fopen(file.c_str(), "w");
+			if (out == nullptr)
+				return file;
+
+			size_t base = 1;
+			for (int object = 0; object < 64; ++object) {
+				std::fprintf(out, "o sphere%d\n", object);
+				for (const auto& v : sphere.Vertices)
+					std::fprintf(out, "v %f %f %f\n", v.Position.x + object * 3.0f, v.Position.y, v.Position.z);
+				for (const auto& v : sphere.Vertices)
+					std::fprintf(out, "vn %f %f %f\n", v.Normal.x, v.Normal.y, v.Normal.z);
+				for (const auto& v : sphere.Vertices)
+					std::fprintf(out, "vt %f %f\n", v.TexC.x, v.TexC.y);
+				for (size_t i = 0; i + 2 < sphere.Indices32.size(); i += 3) {
+					size_t a = base + sphere.Indices32[i], b = base + sphere.Indices32[i + 1], c = base + sphere.Indices32[i + 2];
+					std::fprintf(out, "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", a, a, a, b, b, b, c, c, c);
+				}
+				base += sphere.Vertices.size();
+			}
+			std::fclose(out);
+			return file;
+		}();
+		return path.c_str();
+	}
+}
+
+// CPU part of Model: assimp import plus the merge done before upload.
+// The argument is the thread count for mesh conversion and merge, 0 uses every hardware thread.
+static void BM_ModelImport(benchmark::State& state, const char* file)
+{
+	size_t vertexCount = 0;
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+
+	for (auto _ : state) {
+		ModelImporter importer(ResourcePath(file), (unsigned)state.range(0));
+		importer.Merge(indices, submeshes);
+		vertexCount = importer.Vertices().size();
+		benchmark::DoNotOptimize(indices.data());
+	}
+
+	state.counters["meshes"] = (double)submeshes.size();
+	state.counters["vertices"] = (double)vertexCount;
+	state.counters["indices"] = (double)indices.size();
+	state.SetBytesProcessed(state.iterations() * vertexCount * sizeof(GeometryGenerator::Vertex));
+}
+BENCHMARK_CAPTURE(BM_ModelImport, pacman_stl, "pacman/Pacman.stl")->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ModelImport, box_stl, "box/box.stl")->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ModelImport, box_fbx, "box/Box.fbx")->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+// The generated 64 mesh file, where converting the meshes in parallel pays off.
+static void BM_ModelImportMultiMesh(benchmark::State& state)
+{
+	size_t vertexCount = 0;
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+	const char* path = MultiMeshPath();
+
+	for (auto _ : state) {
+		ModelImporter importer(path, (unsigned)state.range(0));
+		importer.Merge(indices, submeshes);
+		vertexCount = importer.Vertices().size();
+		benchmark::DoNotOptimize(indices.data());
+	}
+
+	state.counters["meshes"] = (double)submeshes.size();
+	state.counters["vertices"] = (double)vertexCount;
+	state.SetBytesProcessed(state.iterations() * vertexCount * sizeof(GeometryGenerator::Vertex));
+}
+BENCHMARK(BM_ModelImportMultiMesh)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Arg(0)->Unit(benchmark::kMillisecond);
+
+// Merge only, the file is read once outside the loop. The vertices are merged by the import
+// already, this is the index buffer and the submeshes.
+static void BM_ModelMerge(benchmark::State& state, const char* file)
+{
+	ModelImporter importer(ResourcePath(file), (unsigned)state.range(0));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+
+	for (auto _ : state) {
+		importer.Merge(indices, submeshes);
+		benchmark::DoNotOptimize(indices.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * indices.size() * sizeof(std::uint16_t));
+}
+BENCHMARK_CAPTURE(BM_ModelMerge, pacman_stl, "pacman/Pacman.stl")->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ModelMerge, box_fbx, "box/Box.fbx")->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
+
+static void BM_ModelMergeMultiMesh(benchmark::State& state)
+{
+	ModelImporter importer(MultiMeshPath(), (unsigned)state.range(0));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+
+	for (auto _ : state) {
+		importer.Merge(indices, submeshes);
+		benchmark::DoNotOptimize(indices.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * indices.size() * sizeof(std::uint16_t));
+}
+BENCHMARK(BM_ModelMergeMultiMesh)->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
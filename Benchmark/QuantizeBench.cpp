@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchQuantize.h"
+#include "BenchScene.h"
+#include "ModelImporter.h"
+
+using namespace DirectX;
+
+namespace
+{
+	// Memory counters and the largest round trip errors.
+	void Report(
+		benchmark::State& state,
+		const std::vector<GeometryGenerator::Vertex>& vertices,
+		const std::vector<QuantizeRange>& ranges,
+		const std::vector<PackedVertex>& packed)
+	{
+		const QuantizeErrors errors = MeasureErrors(vertices, ranges, packed);
+		const double fullBytes = (double)vertices.size() * sizeof(GeometryGenerator::Vertex);
+		const double packedBytes = (double)packed.size() * sizeof(PackedVertex);
+		state.counters["vertices"] = (double)vertices.size();
+		state.counters["full KB"] = fullBytes / 1024.0;
+		state.counters["packed KB"] = packedBytes / 1024.0;
+		state.counters["saved"] = 1.0 - packedBytes / fullBytes;
+		state.counters["position error"] = errors.Position;
+		state.counters["normal error deg"] = errors.Normal;
+		state.counters["texc error"] = errors.TexC;
+		state.SetItemsProcessed(state.iterations() * vertices.size());
+		state.SetBytesProcessed(state.iterations() * (std::int64_t)fullBytes);
+	}
+}
+
+// Model(..., VertexFormat::Packed) for Pacman: every submesh over its own bounds.
+static void BM_QuantizePacman(benchmark::State& state)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+	importer.Merge(indices, submeshes);
+	const std::vector<GeometryGenerator::Vertex>& vertices = importer.Vertices();
+
+	std::vector<QuantizeRange> ranges(submeshes.size());
+	for (size_t i = 0; i < submeshes.size(); ++i) {
+		ranges[i].First = (size_t)submeshes[i].BaseVertexLocation;
+		ranges[i].Count = (i + 1 < submeshes.size() ? (size_t)submeshes[i + 1].BaseVertexLocation : vertices.size()) - ranges[i].First;
+		ranges[i].Bounds = submeshes[i].Bounds;
+	}
+
+	std::vector<PackedVertex> packed(vertices.size());
+	for (auto _ : state) {
+		EncodeRanges(vertices, ranges, packed);
+		benchmark::DoNotOptimize(packed.data());
+	}
+
+	Report(state, vertices, ranges, packed);
+}
+BENCHMARK(BM_QuantizePacman)->Unit(benchmark::kMicrosecond);
+
+// Encode throughput on a large generated mesh with real texture coordinates and tangents.
+static void BM_QuantizeSphere(benchmark::State& state)
+{
+	GeometryGenerator geoGen;
+	std::uint32_t slices = (std::uint32_t)state.range(0);
+	GeometryGenerator::MeshData sphere = geoGen.CreateSphere(1.0f, slices, slices);
+
+	std::vector<QuantizeRange> ranges(1);
+	ranges[0].Count = sphere.Vertices.size();
+	BoundingBox::CreateFromPoints(ranges[0].Bounds, sphere.Vertices.size(), &sphere.Vertices[0].Position, sizeof(GeometryGenerator::Vertex));
+
+	std::vector<PackedVertex> packed(sphere.Vertices.size());
+	for (auto _ : state) {
+		EncodeRanges(sphere.Vertices, ranges, packed);
+		benchmark::DoNotOptimize(packed.data());
+	}
+
+	Report(state, sphere.Vertices, ranges, packed);
+}
+BENCHMARK(BM_QuantizeSphere)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
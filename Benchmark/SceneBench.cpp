@@ -0,0 +1,189 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+
+#include "BenchScene.h"
+#include "Common/MathHelper.h"
+#include "Culling.h"
+#include "SceneDatabase.h"
+
+using namespace DirectX;
+
+// The same scene stored the way the apps used to (one heap allocated RenderItem per object,
+// walked through a vector of pointers) and in SceneDatabase columns.
+namespace
+{
+	struct RenderItem
+	{
+		XMFLOAT4X4 World;
+		int NumFramesDirty = 1;
+		std::uint32_t ObjCBIndex = 0;
+		void* Geo = nullptr;
+		DirectX::BoundingBox BoundingBox;
+		std::uint32_t PrimitiveType = 0;
+		std::uint32_t IndexCount = 0;
+		std::uint32_t StartIndexLocation = 0;
+		int BaseVertexLocation = 0;
+	};
+
+	struct BenchSceneData
+	{
+		BenchCamera Camera{ XMFLOAT3(0.0f, 0.0f, -5.0f), 0.25f * XM_PI, 800.0f / 600.0f, 1.0f, 1000.0f };
+
+		std::vector<std::unique_ptr<RenderItem>> AllRenderitems;
+		std::vector<RenderItem*> OpaqueRenderitems;
+
+		SceneDatabase Scene{ 1 };
+		std::vector<SceneDatabase::Handle> Handles;
+
+		explicit BenchSceneData(int count, bool rotated = false)
+		{
+			std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(count, 10.0f, false);
+			if (rotated)
+				RotateInstances(worlds);
+			BoundingBox bounds(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+			Scene.Reserve((std::uint32_t)worlds.size());
+			for (size_t i = 0; i < worlds.size(); i++) {
+				auto ri = std::make_unique<RenderItem>();
+				ri->World = worlds[i];
+				ri->ObjCBIndex = (std::uint32_t)i;
+				ri->BoundingBox = bounds;
+				ri->IndexCount = 36;
+				OpaqueRenderitems.push_back(ri.get());
+				AllRenderitems.push_back(std::move(ri));
+
+				SceneDatabase::DrawArgs draw;
+				draw.IndexCount = 36;
+				Handles.push_back(Scene.Add(worlds[i], bounds, draw));
+			}
+		}
+	};
+
+	const int gSceneSizes[] = { 8 * 10 * 10 * 10, 100 * 100 * 100 };
+}
+
+// Culling loop of ComputeCull before SceneDatabase. rotated: every item turned by its own angle.
+static void BM_SceneCullAoS(benchmark::State& state)
+{
+	BenchSceneData data((int)state.range(0), state.range(1) != 0);
+	XMMATRIX invView = XMLoadFloat4x4(&data.Camera.InvView);
+
+	std::vector<RenderItem*> visible;
+	visible.reserve(data.OpaqueRenderitems.size());
+
+	for (auto _ : state) {
+		visible.clear();
+		for (RenderItem* ri : data.OpaqueRenderitems) {
+			XMMATRIX world = XMLoadFloat4x4(&ri->World);
+			if (Culling::IsVisible(data.Camera.Frustum, invView, world, ri->BoundingBox))
+				visible.push_back(ri);
+		}
+		benchmark::DoNotOptimize(visible.data());
+	}
+
+	state.counters["visible"] = (double)visible.size();
+	state.SetItemsProcessed(state.iterations() * data.OpaqueRenderitems.size());
+}
+BENCHMARK(BM_SceneCullAoS)->ArgNames({ "items", "rotated" })
+	->Args({ gSceneSizes[0], 0 })->Args({ gSceneSizes[1], 0 })->Args({ gSceneSizes[1], 1 })->Unit(benchmark::kMillisecond);
+
+// The same test as BM_SceneCullAoS and the same items kept, the oriented test only runs for the
+// items whose world box crosses a plane.
+static void BM_SceneCullSoA(benchmark::State& state)
+{
+	BenchSceneData data((int)state.range(0), state.range(1) != 0);
+	XMMATRIX invView = XMLoadFloat4x4(&data.Camera.InvView);
+
+	std::vector<std::uint32_t> visible(data.Scene.Size());
+	std::uint32_t count = 0;
+
+	for (auto _ : state) {
+		count = data.Scene.Cull(data.Camera.Frustum, invView, visible.data());
+		benchmark::DoNotOptimize(visible.data());
+	}
+
+	state.counters["visible"] = (double)count;
+	state.SetItemsProcessed(state.iterations() * data.Scene.Size());
+}
+BENCHMARK(BM_SceneCullSoA)->ArgNames({ "items", "rotated" })
+	->Args({ gSceneSizes[0], 0 })->Args({ gSceneSizes[1], 0 })->Args({ gSceneSizes[1], 1 })->Unit(benchmark::kMillisecond);
+
+// Object CB update with 1% of the objects moving each frame.
+static void BM_SceneObjectCBAoS(benchmark::State& state)
+{
+	BenchSceneData data((int)state.range(0));
+	StagingBuffer<ObjectConstants> objectCB(data.OpaqueRenderitems.size(), false);
+	XMFLOAT4X4 moved = MathHelper::Identity4x4();
+
+	size_t frame = 0;
+	for (auto _ : state) {
+		for (size_t i = frame++ % 100; i < data.AllRenderitems.size(); i += 100) {
+			data.AllRenderitems[i]->World = moved;
+			data.AllRenderitems[i]->NumFramesDirty = 1;
+		}
+
+		for (auto& e : data.AllRenderitems) {
+			if (e->NumFramesDirty > 0) {
+				XMMATRIX world = XMLoadFloat4x4(&e->World);
+
+				ObjectConstants objConstants;
+				XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
+				objectCB.CopyData(e->ObjCBIndex, objConstants);
+
+				e->NumFramesDirty--;
+			}
+		}
+		benchmark::DoNotOptimize(objectCB.Data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * data.AllRenderitems.size());
+}
+BENCHMARK(BM_SceneObjectCBAoS)->Arg(gSceneSizes[0])->Arg(gSceneSizes[1])->Unit(benchmark::kMicrosecond);
+
+static void BM_SceneObjectCBSoA(benchmark::State& state)
+{
+	BenchSceneData data((int)state.range(0));
+	StagingBuffer<ObjectConstants> objectCB(data.Scene.Size(), false);
+	XMFLOAT4X4 moved = MathHelper::Identity4x4();
+
+	const XMFLOAT4X4* worlds = data.Scene.Worlds();
+	const std::uint32_t* objCBIndices = data.Scene.ObjCBIndices();
+
+	size_t frame = 0;
+	for (auto _ : state) {
+		for (size_t i = frame++ % 100; i < data.Handles.size(); i += 100)
+			data.Scene.SetWorld(data.Handles[i], moved);
+
+		data.Scene.ForEachDirty([&](std::uint32_t item)
+			{
+				XMMATRIX world = XMLoadFloat4x4(&worlds[item]);
+
+				ObjectConstants objConstants;
+				XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
+				objectCB.CopyData(objCBIndices[item], objConstants);
+			});
+		benchmark::DoNotOptimize(objectCB.Data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * data.Scene.Size());
+}
+BENCHMARK(BM_SceneObjectCBSoA)->Arg(gSceneSizes[0])->Arg(gSceneSizes[1])->Unit(benchmark::kMicrosecond);
+
+// Handle churn: remove and re-add 1% of the items.
+static void BM_SceneAddRemove(benchmark::State& state)
+{
+	BenchSceneData data((int)state.range(0));
+	BoundingBox bounds(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+	XMFLOAT4X4 world = MathHelper::Identity4x4();
+
+	size_t frame = 0;
+	for (auto _ : state) {
+		for (size_t i = frame++ % 100; i < data.Handles.size(); i += 100) {
+			data.Scene.Remove(data.Handles[i]);
+			data.Handles[i] = data.Scene.Add(world, bounds, SceneDatabase::DrawArgs());
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * (data.Handles.size() / 100));
+}
+BENCHMARK(BM_SceneAddRemove)->Arg(gSceneSizes[1])->Unit(benchmark::kMicrosecond);
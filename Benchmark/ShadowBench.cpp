@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+#include "BenchShadow.h"
+
+using namespace DirectX;
+
+namespace
+{
+	const std::uint32_t Resolution = 2048;
+	const float ShadowDistance = 120.0f;
+}
+
+// CascadedShadows::Build for every camera and light of BenchShadow.h. texel0: world units per
+// texel of the nearest cascade, gain: how many times smaller that is than the texel of a single
+// map over the same distance.
+static void BM_CascadeBuild(benchmark::State& state)
+{
+	const int count = (int)state.range(0);
+	const float lambda = state.range(1) / 100.0f;
+	const BoundingBox scene = ShadowSceneBounds(MakeShadowBoxes(1024));
+
+	std::vector<Camera> cameras;
+	for (const ShadowView& view : ShadowViews)
+		cameras.push_back(MakeShadowCamera(view));
+
+	CascadedShadows::Cascade cascades[CascadedShadows::MaxCascades];
+	for (auto _ : state) {
+		for (const Camera& camera : cameras)
+			for (const XMFLOAT3& light : ShadowLights) {
+				CascadedShadows::Build(camera, XMLoadFloat3(&light), ShadowDistance, count, lambda, Resolution, scene, cascades);
+				benchmark::DoNotOptimize(cascades);
+			}
+	}
+
+	CascadedShadows::Cascade single;
+	CascadedShadows::Build(cameras[0], XMLoadFloat3(&ShadowLights[0]), ShadowDistance, count, lambda, Resolution, scene, cascades);
+	CascadedShadows::Fit(cameras[0], XMLoadFloat3(&ShadowLights[0]), cameras[0].GetNearZ(), ShadowDistance, Resolution, scene, single);
+	state.counters["texel0"] = cascades[0].TexelSize;
+	state.counters["gain"] = single.TexelSize / cascades[0].TexelSize;
+}
+BENCHMARK(BM_CascadeBuild)->ArgNames({ "cascades", "lambda%" })
+	->Args({ 1, 50 })->Args({ 4, 0 })->Args({ 4, 50 })->Args({ 4, 80 })->Args({ 4, 100 });
+
+// CascadedShadows::IsCaster for every box and cascade with App_Shadow's camera and light, four
+// cascades. kept: fraction of the boxes drawn, averaged over the cascades.
+static void BM_CascadeCasters(benchmark::State& state)
+{
+	const int count = 4;
+	const std::vector<ShadowBox> boxes = MakeShadowBoxes((std::uint32_t)state.range(0));
+	std::vector<BoundingBox> bounds;
+	for (const ShadowBox& box : boxes)
+		bounds.push_back(ToBounds(box));
+	const Camera camera = MakeShadowCamera(ShadowViews[0]);
+	CascadedShadows::Cascade cascades[count];
+	CascadedShadows::Build(camera, XMLoadFloat3(&ShadowLights[0]), ShadowDistance, count, 0.5f, Resolution, ShadowSceneBounds(boxes), cascades);
+
+	std::vector<std::uint8_t> kept(count * boxes.size());
+	for (auto _ : state) {
+		for (int i = 0; i < count; ++i)
+			for (std::size_t b = 0; b < bounds.size(); ++b)
+				kept[i * bounds.size() + b] = CascadedShadows::IsCaster(cascades[i], bounds[b]);
+		benchmark::DoNotOptimize(kept.data());
+	}
+
+	std::size_t keptCount = 0;
+	for (std::uint8_t k : kept)
+		keptCount += k;
+	state.counters["kept"] = (double)keptCount / kept.size();
+	state.counters["boxes"] = benchmark::Counter((double)count * boxes.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_CascadeCasters)->ArgName("boxes")->Arg(1024)->Arg(65536);
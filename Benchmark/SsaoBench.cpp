@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BenchSsao.h"
+#include "DDSWriter.h"
+
+namespace
+{
+	// With RENDERER_SSAO_IMAGES set to a directory, the maps are written there as R8 DDS files.
+	void WriteImage(const char* name, const std::vector<float>& values, std::uint32_t width, std::uint32_t height)
+	{
+		const char* directory = std::getenv("RENDERER_SSAO_IMAGES");
+		if (!directory)
+			return;
+
+		std::vector<std::uint8_t> pixels(values.size()), file;
+		for (std::size_t i = 0; i < values.size(); ++i)
+			pixels[i] = (std::uint8_t)std::lround(values[i] * 255.0f);
+		if (DDSWriter::Write(DDSFormat::R8_UNORM, width, height, 1, pixels.data(), pixels.size(), file))
+			std::ofstream(std::string(directory) + "/" + name, std::ios::binary).write((const char*)file.data(), file.size());
+	}
+}
+
+// ssaoMap.hlsl on the CPU for a 1280x720 G-buffer, at full or half resolution. Threads 0: one per
+// hardware thread. open: mean of the open floor, about 1, crease: mean where the spheres touch it.
+static void BM_SsaoOcclusion(benchmark::State& state)
+{
+	const SsaoScene scene = MakeSsaoScene(1280, 720);
+	const std::uint32_t downsample = (std::uint32_t)state.range(2);
+	const SsaoReference::Constants constants = MakeSsaoConstants(scene, (std::uint32_t)state.range(0), downsample);
+	const std::uint32_t width = SsaoReference::MapWidth(scene.GBuffer, constants), height = SsaoReference::MapHeight(scene.GBuffer, constants);
+	const std::vector<SsaoSurface> surfaces = MapSurfaces(scene, downsample);
+
+	std::vector<float> ssaoMap;
+	for (auto _ : state) {
+		SsaoReference::Occlusion(scene.GBuffer, constants, ssaoMap, (unsigned)state.range(1));
+		benchmark::DoNotOptimize(ssaoMap.data());
+	}
+
+	state.counters["open"] = SurfaceMean(ssaoMap, surfaces, SsaoSurface::OpenFloor);
+	state.counters["crease"] = SurfaceMean(ssaoMap, surfaces, SsaoSurface::Crease);
+	state.counters["Mpixels"] = benchmark::Counter((double)width * height / 1e6, benchmark::Counter::kIsIterationInvariantRate);
+
+	WriteImage(downsample > 1 ? "ssao_map_half.dds" : "ssao_map.dds", ssaoMap, width, height);
+}
+BENCHMARK(BM_SsaoOcclusion)->ArgNames({ "samples", "threads", "downsample" })
+	->Args({ 8, 1, 1 })->Args({ 14, 1, 1 })->Args({ 8, 0, 1 })->Args({ 14, 0, 1 })->Args({ 8, 1, 2 })->Args({ 8, 0, 2 })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// blur_cs.hlsl on the CPU, both passes, for a 1280x720 G-buffer at full or half resolution.
+// noiseBefore/After: variance of the surfaces other than the floor before and after the blur.
+static void BM_SsaoBlur(benchmark::State& state)
+{
+	const SsaoScene scene = MakeSsaoScene(1280, 720);
+	const std::uint32_t downsample = (std::uint32_t)state.range(1);
+	const SsaoReference::Constants constants = MakeSsaoConstants(scene, 8, downsample);
+	const std::uint32_t width = SsaoReference::MapWidth(scene.GBuffer, constants), height = SsaoReference::MapHeight(scene.GBuffer, constants);
+	const std::vector<SsaoSurface> surfaces = MapSurfaces(scene, downsample);
+	std::vector<float> ssaoMap, blurred;
+	SsaoReference::Occlusion(scene.GBuffer, constants, ssaoMap);
+
+	for (auto _ : state) {
+		SsaoReference::Blur(scene.GBuffer, constants, ssaoMap, blurred, (unsigned)state.range(0));
+		benchmark::DoNotOptimize(blurred.data());
+	}
+
+	state.counters["noiseBefore"] = SurfaceVariance(ssaoMap, surfaces, SsaoSurface::Other);
+	state.counters["noiseAfter"] = SurfaceVariance(blurred, surfaces, SsaoSurface::Other);
+	state.counters["Mpixels"] = benchmark::Counter((double)width * height / 1e6, benchmark::Counter::kIsIterationInvariantRate);
+
+	WriteImage(downsample > 1 ? "ssao_blurred_half.dds" : "ssao_blurred.dds", blurred, width, height);
+}
+BENCHMARK(BM_SsaoBlur)->ArgNames({ "threads", "downsample" })
+	->Args({ 1, 1 })->Args({ 0, 1 })->Args({ 1, 2 })->Args({ 0, 2 })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,30 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchStream.h"
+
+// 300 frames of a flight over 4096 quads with 256 BC1 1024x1024 textures (about 170 MB fully resident),
+// against a budget in MB (0: unlimited). Time is Update() per frame with two worker threads reading.
+static void BM_StreamTextures(benchmark::State& state)
+{
+	TextureStreamer::Options options;
+	options.Budget = state.range(0) > 0 ? (std::size_t)state.range(0) << 20 : SIZE_MAX / 2;
+
+	StreamRun run;
+	for (auto _ : state) {
+		state.PauseTiming();
+		run = StreamFlight(options, [&state](TextureStreamer& streamer) {
+			state.ResumeTiming();
+			streamer.Update();
+			state.PauseTiming();
+		});
+		state.ResumeTiming();
+	}
+
+	state.counters["loads"] = (double)run.Stats.Loads;
+	state.counters["evictions"] = (double)run.Stats.Evictions;
+	state.counters["peakMB"] = run.PeakBytes / double(1 << 20);
+	state.counters["starved"] = run.Stats.Starved;
+	state.counters["updates"] = benchmark::Counter(gStreamFrames, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_StreamTextures)->ArgName("budgetMB")->Arg(0)->Arg(64)->Arg(16)
+	->Unit(benchmark::kMillisecond);
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+
+#include "Common/GeometryGenerator.h"
+#include "TangentSpace.h"
+
+using namespace DirectX;
+
+namespace
+{
+	float XM_CALLCONV AngleBetween(FXMVECTOR a, FXMVECTOR b)
+	{
+		return XMConvertToDegrees(XMVectorGetX(XMVector3AngleBetweenVectors(a, b)));
+	}
+
+	// Sphere with about 1M triangles, slices == stacks.
+	GeometryGenerator::MeshData MillionTriangleSphere()
+	{
+		GeometryGenerator geoGen;
+		return geoGen.CreateSphere(1.0f, 708, 708);
+	}
+
+	size_t TriangleCount(const GeometryGenerator::MeshData& mesh)
+	{
+		return mesh.Indices32.size() / 3;
+	}
+}
+
+// Normals rebuilt from the faces of a sphere, compared with the analytic ones.
+static void BM_GenerateNormals(benchmark::State& state)
+{
+	const GeometryGenerator::MeshData reference = MillionTriangleSphere();
+	GeometryGenerator::MeshData mesh = reference;
+
+	for (auto _ : state) {
+		TangentSpace::GenerateNormals(mesh);
+		benchmark::DoNotOptimize(mesh.Vertices.data());
+	}
+
+	float maxAngle = 0.0f;
+	for (size_t i = 0; i < mesh.Vertices.size(); ++i)
+		maxAngle = std::max(maxAngle, AngleBetween(XMLoadFloat3(&mesh.Vertices[i].Normal), XMLoadFloat3(&reference.Vertices[i].Normal)));
+
+	state.counters["max angle"] = maxAngle;
+	state.counters["Mtris"] = TriangleCount(mesh) / 1e6;
+	state.SetItemsProcessed(state.iterations() * TriangleCount(mesh));
+}
+BENCHMARK(BM_GenerateNormals)->Unit(benchmark::kMillisecond);
+
+// Tangents of a sphere against GeometryGenerator's dP/du, away from the poles where u is undefined.
+static void BM_GenerateTangents(benchmark::State& state)
+{
+	const GeometryGenerator::MeshData reference = MillionTriangleSphere();
+	GeometryGenerator::MeshData mesh;
+
+	// every run starts from the unsplit sphere
+	for (auto _ : state) {
+		state.PauseTiming();
+		mesh = reference;
+		state.ResumeTiming();
+		TangentSpace::GenerateTangents(mesh);
+		benchmark::DoNotOptimize(mesh.Vertices.data());
+	}
+
+	float maxAngle = 0.0f;
+	for (size_t i = 0; i < reference.Vertices.size(); ++i) {
+		if (std::fabs(mesh.Vertices[i].Position.y) < 0.99f)
+			maxAngle = std::max(maxAngle, AngleBetween(XMLoadFloat4(&mesh.Vertices[i].TangentU), XMLoadFloat4(&reference.Vertices[i].TangentU)));
+	}
+
+	state.counters["max angle"] = maxAngle;
+	state.counters["Mtris"] = TriangleCount(mesh) / 1e6;
+	state.SetItemsProcessed(state.iterations() * TriangleCount(mesh));
+}
+BENCHMARK(BM_GenerateTangents)->Unit(benchmark::kMillisecond);
+
+// A box without texture coordinates: no UV direction anywhere, every tangent takes the fallback.
+static void BM_GenerateTangentsNoUVs(benchmark::State& state)
+{
+	GeometryGenerator geoGen;
+	GeometryGenerator::MeshData mesh = geoGen.CreateBox(1.0f, 2.0f, 3.0f, 6);
+	for (auto& vertex : mesh.Vertices)
+		vertex.TexC = XMFLOAT2(0.0f, 0.0f);
+
+	for (auto _ : state) {
+		TangentSpace::GenerateTangents(mesh);
+		benchmark::DoNotOptimize(mesh.Vertices.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * TriangleCount(mesh));
+}
+BENCHMARK(BM_GenerateTangentsNoUVs)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <vector>
+
+#include "BenchBlur.h"
+#include "Toolkit.h"
+
+static void BM_CalcGaussWeights(benchmark::State& state)
+{
+	// range is sigma * 10
+	float sigma = state.range(0) / 10.0f;
+
+	size_t weightCount = 0;
+	for (auto _ : state) {
+		std::vector<float> weights = Toolkit::CalcGaussWeights(sigma);
+		weightCount = weights.size();
+		benchmark::DoNotOptimize(weights.data());
+	}
+
+	state.counters["weights"] = (double)weightCount;
+}
+BENCHMARK(BM_CalcGaussWeights)->Arg(10)->Arg(25)->Arg(50)->Arg(100);
+
+// Shaders/Blur/blur_cs.hlsl on the CPU at 1280x720, range(0) is sigma * 10. sigma is the measured
+// width of the blur, maxError the largest step away from a plain scalar blur.
+static void BM_GaussianBlur(benchmark::State& state)
+{
+	const std::uint32_t width = 1280, height = 720;
+	const std::vector<float> weights = Toolkit::CalcGaussWeights(state.range(0) / 10.0f);
+	const std::vector<std::uint8_t> image = MakeBlurImage(width, height);
+	std::vector<std::uint8_t> blurred(image.size());
+
+	for (auto _ : state) {
+		Toolkit::GaussianBlur(image.data(), width * 4, width, height, weights, blurred.data(), width * 4, (unsigned)state.range(1));
+		benchmark::DoNotOptimize(blurred.data());
+	}
+
+	const std::vector<std::uint8_t> expected = ScalarBlur(image, width, height, weights);
+	int maxError = 0;
+	for (std::size_t i = 0; i < blurred.size(); ++i)
+		maxError = std::max(maxError, std::abs((int)blurred[i] - (int)expected[i]));
+	state.counters["maxError"] = maxError;
+	state.counters["sigma"] = EffectiveSigma([&](const std::uint8_t* in, std::uint8_t* out, std::uint32_t w, std::uint32_t h) {
+		Toolkit::GaussianBlur(in, w * 4, w, h, weights, out, w * 4);
+	});
+	state.counters["Mpixels"] = benchmark::Counter((double)width * height / 1e6, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_GaussianBlur)->ArgNames({ "sigma10", "threads" })
+	->Args({ 10, 1 })->Args({ 25, 1 })->Args({ 80, 1 })->Args({ 25, 0 })->Args({ 80, 0 })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// The pyramid blur of Shaders/Blur/kawase_cs.hlsl on the CPU at 1280x720. sigma is its measured
+// width, against BM_GaussianBlur: it should about double with each level while the time barely grows.
+static void BM_DualKawaseBlur(benchmark::State& state)
+{
+	const std::uint32_t width = 1280, height = 720;
+	const std::uint32_t levels = (std::uint32_t)state.range(0);
+	const std::vector<std::uint8_t> image = MakeBlurImage(width, height);
+	std::vector<std::uint8_t> blurred(image.size());
+
+	for (auto _ : state) {
+		Toolkit::DualKawaseBlur(image.data(), width * 4, width, height, levels, blurred.data(), width * 4, (unsigned)state.range(1));
+		benchmark::DoNotOptimize(blurred.data());
+	}
+
+	state.counters["sigma"] = EffectiveSigma([&](const std::uint8_t* in, std::uint8_t* out, std::uint32_t w, std::uint32_t h) {
+		Toolkit::DualKawaseBlur(in, w * 4, w, h, levels, out, w * 4);
+	});
+	state.counters["Mpixels"] = benchmark::Counter((double)width * height / 1e6, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_DualKawaseBlur)->ArgNames({ "levels", "threads" })
+	->Args({ 1, 1 })->Args({ 2, 1 })->Args({ 3, 1 })->Args({ 4, 1 })->Args({ 5, 1 })->Args({ 6, 1 })->Args({ 4, 0 })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
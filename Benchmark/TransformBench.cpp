@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+
+#include "TransformHierarchy.h"
+
+using namespace DirectX;
+
+namespace
+{
+	const int gNumNodes = 100000;
+
+	// Complete 4-ary tree in breadth first order, every node slightly offset and rotated from its parent.
+	void BuildTree(TransformHierarchy& hierarchy, int count)
+	{
+		hierarchy.Reserve(count);
+		for (int i = 0; i < count; ++i) {
+			XMFLOAT4X4 local;
+			XMStoreFloat4x4(&local, XMMatrixRotationY(0.01f * (i % 7)) * XMMatrixTranslation(1.0f, 0.5f, 0.0f));
+			hierarchy.AddNode(i == 0 ? TransformHierarchy::InvalidNode : (std::uint32_t)(i - 1) / 4, local);
+		}
+		hierarchy.Update();
+	}
+
+	// Nodes touched each frame, picked up front so the random numbers stay out of the timing.
+	std::vector<std::vector<std::uint32_t>> PickNodes(int count, double fraction, int frames)
+	{
+		std::mt19937 rng(1234);
+		std::uniform_int_distribution<std::uint32_t> dist(0, count - 1);
+
+		std::vector<std::vector<std::uint32_t>> picks(frames);
+		for (auto& frame : picks) {
+			frame.resize((size_t)std::ceil(count * fraction));
+			for (auto& node : frame)
+				node = dist(rng);
+		}
+		return picks;
+	}
+}
+
+// 1% (or the given per mille) of the nodes get a new local matrix every frame.
+static void BM_TransformUpdate(benchmark::State& state)
+{
+	TransformHierarchy hierarchy;
+	BuildTree(hierarchy, gNumNodes);
+
+	const double fraction = state.range(0) / 1000.0;
+	auto picks = PickNodes(gNumNodes, fraction, 64);
+
+	size_t frame = 0, updated = 0;
+	for (auto _ : state) {
+		auto& nodes = picks[frame++ % picks.size()];
+		for (std::uint32_t node : nodes) {
+			XMFLOAT4X4 local = hierarchy.Local(node);
+			local._41 += 0.001f;
+			hierarchy.SetLocal(node, local);
+		}
+
+		updated += hierarchy.Update();
+		benchmark::DoNotOptimize(&hierarchy.World(gNumNodes - 1));
+	}
+
+	state.counters["updated/frame"] = (double)updated / state.iterations();
+	state.SetItemsProcessed(state.iterations() * gNumNodes);
+}
+BENCHMARK(BM_TransformUpdate)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// Baseline without dirty tracking: every world matrix is rebuilt every frame.
+static void BM_TransformFullRecompute(benchmark::State& state)
+{
+	TransformHierarchy hierarchy;
+	BuildTree(hierarchy, gNumNodes);
+
+	std::vector<XMFLOAT4X4> worlds(gNumNodes);
+	for (auto _ : state) {
+		for (std::uint32_t i = 0; i < (std::uint32_t)gNumNodes; ++i) {
+			XMMATRIX local = XMLoadFloat4x4(&hierarchy.Local(i));
+			std::uint32_t parent = hierarchy.Parent(i);
+			if (parent == TransformHierarchy::InvalidNode)
+				XMStoreFloat4x4(&worlds[i], local);
+			else
+				XMStoreFloat4x4(&worlds[i], XMMatrixMultiply(local, XMLoadFloat4x4(&worlds[parent])));
+		}
+		benchmark::DoNotOptimize(worlds.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * gNumNodes);
+}
+BENCHMARK(BM_TransformFullRecompute)->Unit(benchmark::kMicrosecond);
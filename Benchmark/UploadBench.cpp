@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+
+#include "BenchScene.h"
+#include "DirtyRanges.h"
+#include "ModelImporter.h"
+
+using namespace DirectX;
+
+// Per object constant buffer fill, as in ComputeCull::BuildBuffers and shapesIn3Frame::Update.
+static void BM_ObjectCBUpload(benchmark::State& state)
+{
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid((int)state.range(0), 800.0f, true);
+	StagingBuffer<ObjectConstants> objectCB(worlds.size(), true);
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < worlds.size(); i++) {
+			XMMATRIX world = XMLoadFloat4x4(&worlds[i]);
+
+			ObjectConstants objConstants;
+			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
+			objectCB.CopyData(i, objConstants);
+		}
+		benchmark::DoNotOptimize(objectCB.Data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * worlds.size());
+	state.SetBytesProcessed(state.iterations() * worlds.size() * sizeof(ObjectConstants));
+}
+BENCHMARK(BM_ObjectCBUpload)->Arg(8 * 10 * 10 * 10)->Arg(8 * 200 * 20)->Unit(benchmark::kMicrosecond);
+
+namespace
+{
+	const int gNumDirtyObjects = 100000;
+	const int gNumFrameResources = 3;
+
+	// Objects moved each frame, picked up front so the random numbers stay out of the timing.
+	std::vector<std::vector<std::uint32_t>> PickDirty(int count, double fraction, int frames)
+	{
+		std::mt19937 rng(4321);
+		std::uniform_int_distribution<std::uint32_t> dist(0, count - 1);
+
+		std::vector<std::vector<std::uint32_t>> picks(frames);
+		for (auto& frame : picks) {
+			frame.resize((size_t)std::ceil(count * fraction));
+			for (auto& index : frame)
+				index = dist(rng);
+		}
+		return picks;
+	}
+
+	// Per object state as in shapesIn3Frame before the dirty ranges.
+	struct DirtyItem
+	{
+		XMFLOAT4X4 World;
+		int NumFramesDirty = gNumFrameResources;
+		std::uint32_t ObjCBIndex = 0;
+	};
+}
+
+// Old path: every frame walks all render items and copies the ones with NumFramesDirty > 0.
+static void BM_ObjectCBDirtyWalk(benchmark::State& state)
+{
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(gNumDirtyObjects, 800.0f, true);
+	auto picks = PickDirty((int)worlds.size(), state.range(0) / 1000.0, 64);
+
+	std::vector<std::unique_ptr<DirtyItem>> items;
+	for (size_t i = 0; i < worlds.size(); i++) {
+		auto item = std::make_unique<DirtyItem>();
+		item->World = worlds[i];
+		item->ObjCBIndex = (std::uint32_t)i;
+		items.push_back(std::move(item));
+	}
+
+	std::vector<StagingBuffer<ObjectConstants>> frameCBs;
+	for (int f = 0; f < gNumFrameResources; f++)
+		frameCBs.emplace_back(worlds.size(), true);
+
+	size_t frame = 0;
+	for (auto _ : state) {
+		for (std::uint32_t index : picks[frame % picks.size()]) {
+			items[index]->World._41 += 0.001f;
+			items[index]->NumFramesDirty = gNumFrameResources;
+		}
+
+		auto& currObjectCB = frameCBs[frame % gNumFrameResources];
+		for (auto& e : items) {
+			if (e->NumFramesDirty > 0) {
+				ObjectConstants objConstants;
+				XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(XMLoadFloat4x4(&e->World)));
+				currObjectCB.CopyData(e->ObjCBIndex, objConstants);
+				e->NumFramesDirty--;
+			}
+		}
+		benchmark::DoNotOptimize(currObjectCB.Data());
+		frame++;
+	}
+
+	state.SetItemsProcessed(state.iterations() * worlds.size());
+}
+BENCHMARK(BM_ObjectCBDirtyWalk)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// New path: constants live in a ConstantBufferMirror and only the dirty ranges are copied.
+static void BM_ObjectCBDirtyRanges(benchmark::State& state)
+{
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(gNumDirtyObjects, 800.0f, true);
+	auto picks = PickDirty((int)worlds.size(), state.range(0) / 1000.0, 64);
+
+	ConstantBufferMirror<ObjectConstants> mirror((std::uint32_t)worlds.size(), gNumFrameResources, true);
+	for (size_t i = 0; i < worlds.size(); i++) {
+		ObjectConstants objConstants;
+		XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(XMLoadFloat4x4(&worlds[i])));
+		mirror.Set((std::uint32_t)i, objConstants);
+	}
+
+	std::vector<StagingBuffer<ObjectConstants>> frameCBs;
+	for (int f = 0; f < gNumFrameResources; f++)
+		frameCBs.emplace_back(worlds.size(), true);
+
+	size_t frame = 0, bytes = 0;
+	for (auto _ : state) {
+		for (std::uint32_t index : picks[frame % picks.size()]) {
+			worlds[index]._41 += 0.001f;
+			ObjectConstants objConstants;
+			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(XMLoadFloat4x4(&worlds[index])));
+			mirror.Set(index, objConstants);
+		}
+
+		auto& currObjectCB = frameCBs[frame % gNumFrameResources];
+		bytes += mirror.Upload((int)(frame % gNumFrameResources), currObjectCB.MappedData(), currObjectCB.ElementByteSize());
+		benchmark::DoNotOptimize(currObjectCB.Data());
+		frame++;
+	}
+
+	state.counters["bytes/frame"] = (double)bytes / state.iterations();
+	state.SetItemsProcessed(state.iterations() * worlds.size());
+}
+BENCHMARK(BM_ObjectCBDirtyRanges)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// Model::ProcessGeo copies the merged vertices/indices into the CPU blobs and then into the upload heap.
+static void BM_ModelGeoStaging(benchmark::State& state)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+	importer.Merge(indices, submeshes);
+	const std::vector<GeometryGenerator::Vertex>& vertices = importer.Vertices();
+
+	const size_t vbByteSize = vertices.size() * sizeof(GeometryGenerator::Vertex);
+	const size_t ibByteSize = indices.size() * sizeof(std::uint16_t);
+	std::vector<std::uint8_t> blob(vbByteSize + ibByteSize);
+	std::vector<std::uint8_t> uploadHeap(vbByteSize + ibByteSize);
+
+	for (auto _ : state) {
+		std::memcpy(blob.data(), vertices.data(), vbByteSize);
+		std::memcpy(blob.data() + vbByteSize, indices.data(), ibByteSize);
+		std::memcpy(uploadHeap.data(), blob.data(), blob.size());
+		benchmark::DoNotOptimize(uploadHeap.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * 2 * (vbByteSize + ibByteSize));
+}
+BENCHMARK(BM_ModelGeoStaging)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BCEncoder.h"
+#include "DDSWriter.h"
+#include "ImageDecoder.h"
+#include "MipGenerator.h"
+
+// Offline texture cook: an image to a block compressed DDS with a full mip chain, see README.md.
+namespace
+{
+	struct Settings
+	{
+		std::string Input;
+		std::string Output;
+		BCEncoder::Format Format = BCEncoder::Format::BC7;
+		BCEncoder::Quality Quality = BCEncoder::Quality::Normal;
+		bool SRGB = false;
+		bool Mips = true;
+		unsigned ThreadCount = 0;
+	};
+
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: texture_cooker <input> <output.dds> [options]\n"
+			"  --format bc1|bc3|bc5|bc7    default bc7, bc5 is for normal maps\n"
+			"  --quality fast|normal|high  default normal\n"
+			"  --srgb                      color stored as sRGB: mips filtered in linear space\n"
+			"  --no-mips                   only the first level\n"
+			"  --threads n                 default one per hardware thread\n");
+	}
+
+	bool ParseArguments(int argc, char** argv, Settings& settings)
+	{
+		std::vector<std::string> files;
+		for (int i = 1; i < argc; ++i) {
+			std::string arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (arg == "--format" && hasValue) {
+				std::string value = argv[++i];
+				if (value == "bc1")
+					settings.Format = BCEncoder::Format::BC1;
+				else if (value == "bc3")
+					settings.Format = BCEncoder::Format::BC3;
+				else if (value == "bc5")
+					settings.Format = BCEncoder::Format::BC5;
+				else if (value == "bc7")
+					settings.Format = BCEncoder::Format::BC7;
+				else
+					return false;
+			}
+			else if (arg == "--quality" && hasValue) {
+				std::string value = argv[++i];
+				if (value == "fast")
+					settings.Quality = BCEncoder::Quality::Fast;
+				else if (value == "normal")
+					settings.Quality = BCEncoder::Quality::Normal;
+				else if (value == "high")
+					settings.Quality = BCEncoder::Quality::High;
+				else
+					return false;
+			}
+			else if (arg == "--threads" && hasValue)
+				settings.ThreadCount = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+			else if (arg == "--srgb")
+				settings.SRGB = true;
+			else if (arg == "--no-mips")
+				settings.Mips = false;
+			else if (arg.compare(0, 2, "--") == 0)
+				return false;
+			else
+				files.push_back(arg);
+		}
+
+		if (files.size() != 2)
+			return false;
+		settings.Input = files[0];
+		settings.Output = files[1];
+		return true;
+	}
+
+	DDSFormat FormatOf(BCEncoder::Format format, bool srgb)
+	{
+		switch (format) {
+		case BCEncoder::Format::BC1: return srgb ? DDSFormat::BC1_UNORM_SRGB : DDSFormat::BC1_UNORM;
+		case BCEncoder::Format::BC3: return srgb ? DDSFormat::BC3_UNORM_SRGB : DDSFormat::BC3_UNORM;
+		case BCEncoder::Format::BC5: return DDSFormat::BC5_UNORM;
+		case BCEncoder::Format::BC7: return srgb ? DDSFormat::BC7_UNORM_SRGB : DDSFormat::BC7_UNORM;
+		}
+		return DDSFormat::UNKNOWN;
+	}
+
+	// D3D12 wants the first level of a block compressed texture in whole blocks.
+	std::uint32_t BlockAligned(std::uint32_t size)
+	{
+		return std::max(4u, (size + 2) / 4 * 4);
+	}
+
+	bool ReadFile(const std::string& path, std::vector<std::uint8_t>& data)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+			return false;
+
+		std::streamoff size = file.tellg();
+		if (size < 0)
+			return false;
+
+		data.resize((size_t)size);
+		file.seekg(0);
+		return (bool)file.read((char*)data.data(), size);
+	}
+
+	bool WriteFile(const std::string& path, const std::vector<std::uint8_t>& data)
+	{
+		std::ofstream file(path, std::ios::binary);
+		return file && file.write((const char*)data.data(), data.size());
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Settings settings;
+	if (!ParseArguments(argc, argv, settings)) {
+		PrintUsage();
+		return 1;
+	}
+
+	TextureCache::Image image;
+	image.Path = settings.Input;
+	if (!ReadFile(settings.Input, image.File)) {
+		std::fprintf(stderr, "can't read %s\n", settings.Input.c_str());
+		return 1;
+	}
+	if (!ImageDecoder::Decode(image)) {
+		std::fprintf(stderr, "can't decode %s\n", settings.Input.c_str());
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const bool normalMap = settings.Format == BCEncoder::Format::BC5;
+
+	MipGenerator::Options mipOptions;
+	mipOptions.SRGB = settings.SRGB;
+	mipOptions.NormalMap = normalMap;
+	mipOptions.ThreadCount = settings.ThreadCount;
+	mipOptions.RowAlignment = 1;
+	mipOptions.PlacementAlignment = 1;
+
+	std::uint32_t width = image.Width, height = image.Height;
+	std::vector<std::uint8_t> pixels;
+	if (width % 4 != 0 || height % 4 != 0) {
+		width = BlockAligned(image.Width);
+		height = BlockAligned(image.Height);
+		pixels.resize((size_t)width * height * 4);
+		MipGenerator::Resize(image.Pixels.data(), (size_t)image.Width * 4, image.Width, image.Height,
+			pixels.data(), (size_t)width * 4, width, height, mipOptions);
+	}
+	else {
+		pixels.swap(image.Pixels);
+	}
+
+	std::vector<MipGenerator::Level> levels;
+	std::vector<std::uint8_t> chain(MipGenerator::Layout(width, height, mipOptions, levels));
+	if (!settings.Mips)
+		levels.resize(1);
+	MipGenerator::Generate(pixels.data(), (size_t)width * 4, levels, mipOptions, chain.data());
+
+	BCEncoder::Options encodeOptions;
+	encodeOptions.Level = settings.Quality;
+	encodeOptions.ThreadCount = settings.ThreadCount;
+
+	std::vector<std::uint8_t> blocks;
+	for (const MipGenerator::Level& level : levels) {
+		const std::size_t offset = blocks.size();
+		blocks.resize(offset + BCEncoder::SurfaceSize(level.Width, level.Height, settings.Format));
+		BCEncoder::Encode(chain.data() + level.Offset, level.RowPitch, level.Width, level.Height,
+			settings.Format, encodeOptions, blocks.data() + offset);
+	}
+
+	std::vector<std::uint8_t> file;
+	const DDSFormat format = FormatOf(settings.Format, settings.SRGB && !normalMap);
+	if (!DDSWriter::Write(format, width, height, (std::uint32_t)levels.size(), blocks.data(), blocks.size(), file)) {
+		std::fprintf(stderr, "can't build the DDS file\n");
+		return 1;
+	}
+	if (!WriteFile(settings.Output, file)) {
+		std::fprintf(stderr, "can't write %s\n", settings.Output.c_str());
+		return 1;
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%s: %ux%u", settings.Output.c_str(), width, height);
+	if (width != image.Width || height != image.Height)
+		std::printf(" (from %ux%u)", image.Width, image.Height);
+	std::printf(", %zu mips, %zu bytes, %.2f s\n", levels.size(), file.size(), seconds);
+	return 0;
+}
@@ -0,0 +1,37 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "DDSParser.h"
+
+namespace
+{
+	// Every accepted file has to describe subresources inside the buffer. Reading their first
+	// and last byte lets AddressSanitizer catch the ones that don't.
+	void Touch(const DDSTexture& texture)
+	{
+		volatile std::uint8_t sink = 0;
+		for (const auto& subresource : texture.Subresources) {
+			if (subresource.RowPitch * subresource.RowCount != subresource.SlicePitch)
+				__builtin_trap();
+
+			std::size_t bytes = subresource.SlicePitch * subresource.Depth;
+			if (bytes == 0)
+				continue;
+			sink = sink ^ texture.Data[subresource.Offset];
+			sink = sink ^ texture.Data[subresource.Offset + bytes - 1];
+		}
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+	DDSTexture texture;
+	if (DDSParser::Parse(data, size, texture) == DDSResult::Ok)
+		Touch(texture);
+
+	// the mip skipping path
+	if (DDSParser::Parse(data, size, texture, 16) == DDSResult::Ok)
+		Touch(texture);
+
+	return 0;
+}
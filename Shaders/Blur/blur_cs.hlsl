@@ -1,30 +1,63 @@
 Texture2D    gTex : register(t0);
 RWTexture2D<float4> gOutput : register(u0);
+//gTex: the scene for the horizontal pass, the rows blurred for the vertical one
+
+cbuffer cbBlur : register(b0)
+{
+	int gBlurRadius;
+}
+
+//Toolkit::CalcGaussWeights(sigma), 2 * gBlurRadius + 1 of them
+StructuredBuffer<float> gWeights : register(t1);
 
 #define N 256
+#define MaxBlurRadius 16
+#define CacheSize (N + 2 * MaxBlurRadius)
+
+//N texels of a row (column) and gBlurRadius on either side, each read from gTex once
+groupshared float4 gCache[CacheSize];
+
+//past the edge: the edge texel
+void Cache(int index, int2 coord)
+{
+	coord = clamp(coord, 0, int2(gTex.Length.xy) - 1);
+	gCache[index] = gTex[coord];
+}
+
+//direction: (1, 0) for rows, (0, 1) for columns; t: index of the thread along it
+void Blur(int t, int2 coord, int2 direction)
+{
+	int radius = min(gBlurRadius, MaxBlurRadius);
+
+	if (t < radius)
+		Cache(t, coord - radius * direction);
+	if (t >= N - radius)
+		Cache(t + 2 * radius, coord + radius * direction);
+	Cache(t + radius, coord);
+
+	GroupMemoryBarrierWithGroupSync();
+
+	if (any(coord >= int2(gTex.Length.xy)))
+		return;
+
+	float4 color = float4(0, 0, 0, 0);
+	for (int i = 0; i <= 2 * radius; i++) {
+		color += gWeights[i] * gCache[t + i];
+	}
+
+	gOutput[coord] = color;
+}
 
 [numthreads(N, 1, 1)]
-void CS(int3 groupThreadID : SV_GroupThreadID,
+void HorzBlurCS(int3 groupThreadID : SV_GroupThreadID,
 	int3 dispatchThreadID : SV_DispatchThreadID)
 {
-	int dispatch_x = dispatchThreadID.x;
-	int dispatch_y = dispatchThreadID.y;
-	//float4 color = gTex[int2(dispatch_x, dispatch_y)];
-    float4 color = float4(0, 0, 0, 1);
-
-	int x = groupThreadID.x;
-	int y = groupThreadID.y;
-
-	int blurNum = 10;
-	int totBlur = 0;
-	for (int i = -blurNum; i < blurNum; i++) {
-		//if (x + i >= N || x + i < 0)continue;
-		if (dispatch_x + i <= gTex.Length.x - 1 && dispatch_x + i > 0) {
-			totBlur++;
-			color += gTex[int2(dispatch_x + i, dispatch_y)];
-		}
-	}
-	color /= totBlur;
+	Blur(groupThreadID.x, dispatchThreadID.xy, int2(1, 0));
+}
 
-	gOutput[int2(dispatch_x, dispatch_y)] = color;
+[numthreads(1, N, 1)]
+void VertBlurCS(int3 groupThreadID : SV_GroupThreadID,
+	int3 dispatchThreadID : SV_DispatchThreadID)
+{
+	Blur(groupThreadID.y, dispatchThreadID.xy, int2(0, 1));
 }
\ No newline at end of file
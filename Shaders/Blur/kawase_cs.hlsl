@@ -0,0 +1,60 @@
+Texture2D    gInput : register(t0);
+RWTexture2D<float4> gOutput : register(u0);
+//gInput / gOutput: one mip of the pyramid each, or the scene at either end
+
+SamplerState gSamLinearClamp : register(s3);
+
+#define N 8
+
+//offsets in texels of gInput, around the center of the output texel
+float4 Sample(float2 uv, float2 offset)
+{
+	uint width, height;
+	gInput.GetDimensions(width, height);
+	return gInput.SampleLevel(gSamLinearClamp, uv + offset / float2(width, height), 0);
+}
+
+bool OutputTexel(int2 coord, out float2 uv)
+{
+	uint width, height;
+	gOutput.GetDimensions(width, height);
+	uv = (coord + 0.5f) / float2(width, height);
+	return all(coord < int2(width, height));
+}
+
+//half size: the center and the four diagonal corners, each bilinear tap a 2x2 average
+[numthreads(N, N, 1)]
+void DownCS(int3 dispatchThreadID : SV_DispatchThreadID)
+{
+	float2 uv;
+	if (!OutputTexel(dispatchThreadID.xy, uv))
+		return;
+
+	float4 color = Sample(uv, float2(0, 0)) * 4;
+	color += Sample(uv, float2(-1, -1));
+	color += Sample(uv, float2(1, -1));
+	color += Sample(uv, float2(-1, 1));
+	color += Sample(uv, float2(1, 1));
+
+	gOutput[dispatchThreadID.xy] = color / 8;
+}
+
+//double size: a ring of eight taps, the diagonal ones counting twice
+[numthreads(N, N, 1)]
+void UpCS(int3 dispatchThreadID : SV_DispatchThreadID)
+{
+	float2 uv;
+	if (!OutputTexel(dispatchThreadID.xy, uv))
+		return;
+
+	float4 color = Sample(uv, float2(-1, 0));
+	color += Sample(uv, float2(1, 0));
+	color += Sample(uv, float2(0, -1));
+	color += Sample(uv, float2(0, 1));
+	color += Sample(uv, float2(-0.5f, -0.5f)) * 2;
+	color += Sample(uv, float2(0.5f, -0.5f)) * 2;
+	color += Sample(uv, float2(-0.5f, 0.5f)) * 2;
+	color += Sample(uv, float2(0.5f, 0.5f)) * 2;
+
+	gOutput[dispatchThreadID.xy] = color / 12;
+}
\ No newline at end of file
@@ -26,4 +26,34 @@ float4x4 inverse(float4x4 m)
     ans[3][3] = 1;
 
     return ans;
+}
+
+// PackedVertex (base/VertexQuantizer.h) decoding. The input assembler already turns
+// R16G16B16A16_UNORM into [0, 1] and R16G16_SNORM into [-1, 1].
+
+// Position quantized over the submesh bounds.
+float3 DecodePosition(float3 unorm, float3 boundsCenter, float3 boundsExtents)
+{
+    return boundsCenter + (unorm * 2.0f - 1.0f) * boundsExtents;
+}
+
+// Octahedral unit vector (normal, tangent).
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy += n.xy >= 0.0f ? -t : t;
+    return normalize(n);
+}
+
+// Tangent handedness, kept in the w of the quantized position: 1 for mirrored UVs.
+float DecodeHandedness(float positionW)
+{
+    return positionW > 0.5f ? -1.0f : 1.0f;
+}
+
+// Bitangent of a vertex, tangent.w is the handedness from TangentSpace::GenerateTangents.
+float3 Bitangent(float3 normal, float4 tangent)
+{
+    return cross(normal, tangent.xyz) * tangent.w;
 }
\ No newline at end of file
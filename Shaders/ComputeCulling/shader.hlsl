@@ -10,7 +10,7 @@ cbuffer cbPerPass : register(b1){
 struct VertexIn{
     float3 posLocal : POSITION;
     float3 normal : NORMAL;
-    float3 tangentU : TANGENTU;
+    float4 tangentU : TANGENTU;
     float2 TexC : TEXC;
 };
 
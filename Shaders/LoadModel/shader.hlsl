@@ -1,5 +1,11 @@
+#include "../Common/common.hlsl"
+
 cbuffer cbPerObject : register(b0){
     float4x4 gWorld;
+    float3 gBoundsCenter;
+    float gPad0;
+    float3 gBoundsExtents;
+    float gPad1;
 };
 
 cbuffer cbPerPass : register(b1){
@@ -7,10 +13,11 @@ cbuffer cbPerPass : register(b1){
     float4x4 gProj;
 };
 
+// PackedVertex, see Model::InputLayout(Model::VertexFormat::Packed).
 struct VertexIn{
-    float3 posLocal : POSITION;
-    float3 normal : NORMAL;
-    float3 tangentU : TANGENTU;
+    float4 posQuantized : POSITION;   // w: DecodeHandedness()
+    float2 normalOct : NORMAL;
+    float2 tangentOct : TANGENTU;
     float2 TexC : TEXC;
 };
 
@@ -23,11 +30,14 @@ VertexOut VS(VertexIn vin)
 {
     VertexOut vout;
 
-    vout.posProj = mul(float4(vin.posLocal,1.0f),gWorld);
+    float3 posLocal = DecodePosition(vin.posQuantized.xyz, gBoundsCenter, gBoundsExtents);
+    float3 normal = DecodeOctahedral(vin.normalOct);
+
+    vout.posProj = mul(float4(posLocal,1.0f),gWorld);
     vout.posProj = mul(vout.posProj,gView);
     vout.posProj = mul(vout.posProj,gProj);
 
-    vout.color = mul(float4(vin.normal, 1), gWorld);
+    vout.color = mul(float4(normal, 1), gWorld);
 
     return vout;
 };
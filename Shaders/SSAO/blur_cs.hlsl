@@ -1,16 +1,27 @@
 Texture2D gGbuffer[3] : register(t0);
-Texture2D gSsaoMap : register(t3);
+Texture2D gInput : register(t3);
 RWTexture2D<float4> gOutput : register(u0);
+//Gbuffer[0]:normal
+//Gbuffer[1]:z
+//gInput: ģʱΪSSAO Map, ģʱΪģĽ
 
 cbuffer cbPerPass : register(b0)
 {
     float4x4 gProj;
     float gBlurRadius;
+    int gGbufferStep; //SSAO MapΪֱʱΪ2, ÿضӦG-Buffer(2x+1, 2y+1)
 }
 
 StructuredBuffer<float> gBlurWeights : register(t4);
 
 #define N 256
+#define MaxBlurRadius 8
+#define CacheSize (N + 2 * MaxBlurRadius)
+
+//˫ģҪÿֻ߳һ: һ()NԼgBlurRadius
+groupshared float gCacheAo[CacheSize];
+groupshared float gCacheDepth[CacheSize];
+groupshared float3 gCacheNormal[CacheSize];
 
 float NdcDepthToViewDepth(float zNdc)
 {
@@ -18,53 +29,88 @@ float NdcDepthToViewDepth(float zNdc)
     return zView;
 }
 
-[numthreads(N, 1, 1)]
-void CS(int3 groupThreadID : SV_GroupThreadID,
-	int3 dispatchThreadID : SV_DispatchThreadID)
+int2 TextureSize(Texture2D tex)
+{
+    uint width, height;
+    tex.GetDimensions(width, height);
+    return int2(width, height);
+}
+
+int2 GbufferCoord(int2 coord)
 {
-	int dispatch_x = dispatchThreadID.x;
-	int dispatch_y = dispatchThreadID.y;
-    float4 color = float4(0, 0, 0, 1);
+    return min(coord * gGbufferStep + gGbufferStep / 2, TextureSize(gGbuffer[0]) - 1);
+}
 
-	int x = groupThreadID.x;
-	int y = groupThreadID.y;
+//ͼĲȡԵ
+void Cache(int index, int2 coord)
+{
+    coord = clamp(coord, 0, TextureSize(gInput) - 1);
+    int2 g = GbufferCoord(coord);
+    
+    gCacheAo[index] = gInput[coord].r;
+    gCacheDepth[index] = NdcDepthToViewDepth(gGbuffer[1][g].r);
+    gCacheNormal[index] = gGbuffer[0][g].xyz;
+}
 
-    float3 centerNormal = gGbuffer[0][int2(dispatch_x, dispatch_y)].xyz;
-    float centerDepth = NdcDepthToViewDepth(gGbuffer[1][int2(dispatch_x, dispatch_y)].r);
+//direction: (1, 0), (0, 1); t: ߳ڸ÷ϵ
+void Blur(int t, int2 coord, int2 direction)
+{
+    int radius = min((int)gBlurRadius, MaxBlurRadius);
+    
+    if (t < radius)
+        Cache(t, coord - radius * direction);
+    if (t >= N - radius)
+        Cache(t + 2 * radius, coord + radius * direction);
+    Cache(t + radius, coord);
     
-    if (gGbuffer[1][int2(dispatch_x, dispatch_y)].r < 1.0f)
-    {   
-        float totWeight = 0;
-        for (int i = -gBlurRadius; i < gBlurRadius; i++)
+    GroupMemoryBarrierWithGroupSync();
+    
+    if (any(coord >= TextureSize(gInput)))
+        return;
+    
+    int center = t + radius;
+    float ao = gCacheAo[center];
+    
+    //زģ
+    if (gGbuffer[1][GbufferCoord(coord)].r < 1.0f)
+    {
+        float3 centerNormal = gCacheNormal[center];
+        float centerDepth = gCacheDepth[center];
+        
+        float totWeight = gBlurWeights[radius];
+        ao *= totWeight;
+        
+        for (int i = -radius; i <= radius; i++)
         {
-            for (int j = -gBlurRadius; j < gBlurRadius; j++)
-            {
-                if (dispatch_x + i <= gSsaoMap.Length.x - 1 && dispatch_x + i > 0
-                    && dispatch_y + j <= gSsaoMap.Length.y - 1 && dispatch_y + j > 0)
-                {
-                    int2 tex = int2(dispatch_x + i, dispatch_y + j);
-            
-                    float3 neighborNormal = gGbuffer[0][tex].xyz;
-                    float neighborDepth = NdcDepthToViewDepth(gGbuffer[1][tex].r);
+            if (i == 0)
+                continue;
             
-                    if (dot(neighborNormal, centerNormal) >= 0.8f &&
-		                abs(neighborDepth - centerDepth) <= 0.2f)
-                    {
-                        float weight = gBlurWeights[i + gBlurRadius];
-                        color += gSsaoMap[tex] * weight;
-                        totWeight += weight;
-                    }
-                }               
+            int k = center + i;
+            if (dot(gCacheNormal[k], centerNormal) >= 0.8f &&
+                abs(gCacheDepth[k] - centerDepth) <= 0.2f)
+            {
+                float weight = gBlurWeights[i + radius];
+                ao += gCacheAo[k] * weight;
+                totWeight += weight;
             }
-	    }
-
-        color /= totWeight;
-    }
-	
-    if (gGbuffer[1][int2(dispatch_x, dispatch_y)].r == 1.0f)
-    {
-        color = gSsaoMap[int2(dispatch_x, dispatch_y)];
+        }
+        
+        ao /= totWeight;
     }
     
-	gOutput[int2(dispatch_x, dispatch_y)] = color;
+    gOutput[coord] = float4(ao, ao, ao, 1.0f);
+}
+
+[numthreads(N, 1, 1)]
+void HorzBlurCS(int3 groupThreadID : SV_GroupThreadID,
+	int3 dispatchThreadID : SV_DispatchThreadID)
+{
+    Blur(groupThreadID.x, dispatchThreadID.xy, int2(1, 0));
+}
+
+[numthreads(1, N, 1)]
+void VertBlurCS(int3 groupThreadID : SV_GroupThreadID,
+	int3 dispatchThreadID : SV_DispatchThreadID)
+{
+    Blur(groupThreadID.y, dispatchThreadID.xy, int2(0, 1));
 }
\ No newline at end of file
@@ -16,7 +16,7 @@ struct VertexIn
 {
     float3 posLocal : POSITION;
     float3 normal : NORMAL;
-    float3 tangentU : TANGENTU;
+    float4 tangentU : TANGENTU;
     float2 TexC : TEXC;
 };
 
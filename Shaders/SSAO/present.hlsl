@@ -46,7 +46,8 @@ VertexOut VS(uint vid : SV_VertexID)
 float4 PS(VertexOut pin) : SV_TARGET
 {
     float4 color = float4(gColor.Sample(gSamPointWrap, pin.uv));
-    float ssao = gSsaoMap.Sample(gSamPointWrap, pin.uv).r;
+    // bilinear: the SSAO map may be half the size of the screen
+    float ssao = gSsaoMap.Sample(gSamLinearClamp, pin.uv).r;
     if (ssao < 1.0f)
     {
         color *= ssao;
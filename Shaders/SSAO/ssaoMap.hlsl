@@ -5,11 +5,12 @@ cbuffer cbPerPass : register(b1)
     float4x4 gProj;
     float4x4 gProjTex;
     float4x4 gInvProj;
-    float4 gOffsetVectors[14];
+    float4 gOffsetVectors[8];
     float gOcclusionRadius;
     float gSurfaceEpsilon;
     float gOcclusionFadeStart;
     float gOcclusionFadeEnd;
+    float2 gNoiseScale;
 };
 
 Texture2D gGbuffer[3] : register(t0);
@@ -25,7 +26,7 @@ SamplerState gSamAnisotropicWrap : register(s4);
 SamplerState gSamAnisotropicClamp : register(s5);
 SamplerState gSamDepthMap : register(s6);
 
-static const int gNumOffsetVec = 14;
+static const int gNumOffsetVec = 8;
 
 static const float2 gTexCoords[6] =
 {
@@ -86,18 +87,26 @@ float PS(VertexOut pin) : SV_TARGET
     pz = NdcDepthToViewDepth(pz);
     float3 p = (pz / pin.posVNear.z) * pin.posVNear;
     
-    //ȡ[0,1]ӳ[-1,1]
-    float3 randVec = 2.0f * gRandomVectorMap.SampleLevel(gSamLinearWrap, 4.0f * pin.texC, 0.0f).rgb - 1.0f;
+    //ͼÿضӦһ, rgΪƷתĽǶ(cos, sin), [0,1]ӳ[-1,1]
+    float2 rotation = 2.0f * gRandomVectorMap.SampleLevel(gSamPointWrap, gNoiseScale * pin.texC, 0.0f).rg - 1.0f;
+    
+    //ɷ߹(Duff et al. 2017, ޷֧κηȶ), ٰǶת
+    float sz = n.z >= 0.0f ? 1.0f : -1.0f;
+    float a = -1.0f / (sz + n.z);
+    float bxy = n.x * n.y * a;
+    float3 t0 = float3(1.0f + sz * n.x * n.x * a, sz * bxy, -sz * n.x);
+    float3 b0 = float3(bxy, sz + n.y * n.y * a, -n.y);
+    float3 t = rotation.x * t0 + rotation.y * b0;
+    float3 b = cross(n, t);
     
     float occlusionSum = 0.0f;
     
     for (int i = 0; i < gNumOffsetVec; i++)
     {
-        float3 offset = reflect(gOffsetVectors[i].xyz, randVec);
-        
-        float flip = sign(dot(offset, n));
+        //ڷڵİ, Ҫת
+        float3 offset = gOffsetVectors[i].x * t + gOffsetVectors[i].y * b + gOffsetVectors[i].z * n;
         
-        float3 q = p + flip * gOcclusionRadius * offset;
+        float3 q = p + gOcclusionRadius * offset;
         
         //qͶӰNDC(Ӧͼuv)
         float4 projQ = mul(float4(q, 1.0f), gProjTex);
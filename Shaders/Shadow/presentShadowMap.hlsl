@@ -7,6 +7,7 @@ cbuffer cbPerPass : register(b1){
     float4x4 gProj;
     int gLightCount;
     float3 gEyePos;
+    float4 gCascadeSplits; // view depth where each cascade ends
 };
 
 struct Light
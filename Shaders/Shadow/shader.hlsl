@@ -7,6 +7,7 @@ cbuffer cbPerPass : register(b1){
     float4x4 gProj;
     int gLightCount;
     float3 gEyePos;
+    float4 gCascadeSplits; // view depth where each cascade ends
 };
 
 struct Light
@@ -25,9 +26,13 @@ struct Vertex
     float3 normal;
     float3 pos;
     float4 posOnLight;
+    float viewDepth;
 };
 
+#define CASCADE_COUNT 4
+
 StructuredBuffer<Light> gLights : register(t0, space1);
+// CASCADE_COUNT per light, nearest cascade first
 StructuredBuffer<float4x4> gLightShadowTransform : register(t0, space2);
 
 Texture2D gShadowMap : register(t1);
@@ -101,7 +106,8 @@ float CalcShadow(float4 shadowPosH)
 
 float4 CalculateLight(Vertex v, Light light)
 {
-    float shadowFactor = CalcShadow(v.posOnLight);
+    // past the last cascade nothing is shadowed
+    float shadowFactor = v.viewDepth > gCascadeSplits[CASCADE_COUNT - 1] ? 1.0f : CalcShadow(v.posOnLight);
     
     float3 ambient = v.albedo * float3(0.2, 0.2, 0.2);
     
@@ -126,6 +132,15 @@ float4 CalculateLight(Vertex v, Light light)
 
 float4 PS(VertexOut pin): SV_TARGET
 {
+    // the first cascade that reaches as far as the pixel
+    float viewDepth = mul(float4(pin.posWorld, 1.0f), gView).z;
+    int cascade = 0;
+    [unroll]
+    for (int c = 0; c < CASCADE_COUNT - 1; ++c)
+    {
+        cascade += viewDepth > gCascadeSplits[c] ? 1 : 0;
+    }
+
     float4 color = float4(0, 0, 0, 1);
     for (int i = 0; i < gLightCount; i++)
     {
@@ -133,7 +148,8 @@ float4 PS(VertexOut pin): SV_TARGET
         v.albedo = pin.color;
         v.normal = pin.normal;
         v.pos = pin.posWorld;
-        v.posOnLight = mul(float4(pin.posWorld, 1), gLightShadowTransform[i]);
+        v.posOnLight = mul(float4(pin.posWorld, 1), gLightShadowTransform[i * CASCADE_COUNT + cascade]);
+        v.viewDepth = viewDepth;
         
         color += CalculateLight(v, gLights[i]);        
     }
@@ -9,6 +9,7 @@ cbuffer cbPerPass : register(b1)
     float4x4 gProj;
     int gLightCount;
     float3 gEyePos;
+    float4 gCascadeSplits; // view depth where each cascade ends
 };
 
 
@@ -20,6 +21,12 @@ struct ShadowMapUse
 
 StructuredBuffer<ShadowMapUse> gUseData : register(t0);
 
+// the cascade being drawn, gUseData holds one entry per cascade
+cbuffer cbCascade : register(b0, space1)
+{
+    int gCascadeIndex;
+};
+
 struct Light
 {
     float3 Strength;
@@ -54,8 +61,8 @@ VertexOut VS(VertexIn vin)
     VertexOut vout;
 
     vout.posProj = mul(float4(vin.posLocal, 1.0f), gWorld);
-    vout.posProj = mul(vout.posProj, gUseData[0].view);
-    vout.posProj = mul(vout.posProj, gUseData[0].proj);
+    vout.posProj = mul(vout.posProj, gUseData[gCascadeIndex].view);
+    vout.posProj = mul(vout.posProj, gUseData[gCascadeIndex].proj);
 
     return vout;
 };
@@ -0,0 +1,185 @@
+#include "Allocators.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdarg>
+#include <cstdint>
+#include <cwchar>
+
+LinearArena::LinearArena(std::size_t capacity)
+{
+	AddBlock(std::max<std::size_t>(capacity, 256));
+}
+
+void* LinearArena::Allocate(std::size_t bytes, std::size_t alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+	Block* block = &mBlocks.back();
+	std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block->Data.get());
+	std::size_t aligned = ((base + mOffset + alignment - 1) & ~(std::uintptr_t)(alignment - 1)) - base;
+
+	if (aligned + bytes > block->Size) {
+		// grow geometrically, the next Reset() folds everything into one block
+		AddBlock(std::max(block->Size * 2, bytes + alignment));
+
+		block = &mBlocks.back();
+		base = reinterpret_cast<std::uintptr_t>(block->Data.get());
+		aligned = ((base + alignment - 1) & ~(std::uintptr_t)(alignment - 1)) - base;
+	}
+
+	mUsed += bytes + (aligned - mOffset);
+	mOffset = aligned + bytes;
+	mHighWater = std::max(mHighWater, mUsed);
+
+	return block->Data.get() + aligned;
+}
+
+const wchar_t* LinearArena::FormatW(const wchar_t* format, ...)
+{
+	std::size_t count = 128;
+	for (;;) {
+		wchar_t* buffer = Allocate<wchar_t>(count);
+
+		va_list args;
+		va_start(args, format);
+		int written = std::vswprintf(buffer, count, format, args);
+		va_end(args);
+
+		// vswprintf does not report the needed size, retry with a bigger buffer
+		if (written >= 0 && (std::size_t)written < count)
+			return buffer;
+
+		if (count >= 64 * 1024) {
+			buffer[0] = L'\0';
+			return buffer;
+		}
+		count *= 2;
+	}
+}
+
+void LinearArena::Reset()
+{
+	if (mBlocks.size() > 1) {
+		std::size_t total = mCapacity;
+		mBlocks.clear();
+		mCapacity = 0;
+		AddBlock(total);
+	}
+
+	mOffset = 0;
+	mUsed = 0;
+}
+
+std::size_t LinearArena::Used()const
+{
+	return mUsed;
+}
+
+std::size_t LinearArena::Capacity()const
+{
+	return mCapacity;
+}
+
+std::size_t LinearArena::HighWater()const
+{
+	return mHighWater;
+}
+
+void LinearArena::AddBlock(std::size_t size)
+{
+	Block block;
+	block.Data.reset(new std::byte[size]);
+	block.Size = size;
+	mBlocks.push_back(std::move(block));
+
+	mOffset = 0;
+	mCapacity += size;
+	mMemory.Reset(MemoryTracker::Category::FrameArena, mCapacity);
+}
+
+FrameArena::FrameArena(std::size_t bytesPerFrame, int frameCount)
+{
+	assert(frameCount > 0);
+
+	mArenas.reserve(frameCount);
+	for (int i = 0; i < frameCount; ++i)
+		mArenas.emplace_back(bytesPerFrame);
+}
+
+void FrameArena::BeginFrame()
+{
+	mIndex = (mIndex + 1) % (int)mArenas.size();
+	mArenas[mIndex].Reset();
+}
+
+LinearArena& FrameArena::Current()
+{
+	return mArenas[mIndex];
+}
+
+int FrameArena::FrameCount()const
+{
+	return (int)mArenas.size();
+}
+
+FixedPool::FixedPool(std::size_t elementSize, std::size_t elementsPerChunk) :
+	mElementSize(elementSize),
+	mElementsPerChunk(std::max<std::size_t>(elementsPerChunk, 1))
+{
+	const std::size_t alignment = alignof(std::max_align_t);
+	mStride = (std::max(elementSize, sizeof(FreeNode)) + alignment - 1) & ~(alignment - 1);
+}
+
+void* FixedPool::Allocate()
+{
+	if (mFreeList == nullptr)
+		AddChunk();
+
+	FreeNode* node = mFreeList;
+	mFreeList = node->Next;
+	mLiveCount++;
+
+	return node;
+}
+
+void FixedPool::Free(void* p)
+{
+	if (p == nullptr)
+		return;
+
+	FreeNode* node = static_cast<FreeNode*>(p);
+	node->Next = mFreeList;
+	mFreeList = node;
+	mLiveCount--;
+}
+
+std::size_t FixedPool::ElementSize()const
+{
+	return mElementSize;
+}
+
+std::size_t FixedPool::LiveCount()const
+{
+	return mLiveCount;
+}
+
+std::size_t FixedPool::Capacity()const
+{
+	return mChunks.size() * mElementsPerChunk;
+}
+
+void FixedPool::AddChunk()
+{
+	std::byte* chunk = new std::byte[mStride * mElementsPerChunk];
+	mChunks.emplace_back(chunk);
+
+	// link back to front so the first Allocate() hands out the start of the chunk
+	for (std::size_t i = mElementsPerChunk; i-- > 0;) {
+		FreeNode* node = reinterpret_cast<FreeNode*>(chunk + i * mStride);
+		node->Next = mFreeList;
+		mFreeList = node;
+	}
+
+	mMemory.Reset(MemoryTracker::Category::Pool, mStride * mElementsPerChunk * mChunks.size());
+}
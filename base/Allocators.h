@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "MemoryTracker.h"
+
+// Bump allocator for transient data. Allocate() moves a pointer forward, Reset() drops everything at once.
+// When a block runs out another one is chained, and Reset() merges them so the next frame fits in one block.
+class LinearArena
+{
+public:
+	explicit LinearArena(std::size_t capacity = 64 * 1024);
+
+	LinearArena(const LinearArena& rhs) = delete;
+	LinearArena& operator=(const LinearArena& rhs) = delete;
+	LinearArena(LinearArena&& rhs) noexcept = default;
+	LinearArena& operator=(LinearArena&& rhs) noexcept = default;
+
+	void* Allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+	template<typename T>
+	T* Allocate(std::size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destructed");
+		return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+	}
+
+	// swprintf into arena memory, the string lives until the next Reset().
+	const wchar_t* FormatW(const wchar_t* format, ...);
+
+	void Reset();
+
+	std::size_t Used()const;
+	std::size_t Capacity()const;
+	std::size_t HighWater()const;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> Data;
+		std::size_t Size = 0;
+	};
+
+	void AddBlock(std::size_t size);
+
+	std::vector<Block> mBlocks;
+	std::size_t mOffset = 0;		// in the last block
+	std::size_t mUsed = 0;
+	std::size_t mCapacity = 0;
+	std::size_t mHighWater = 0;
+	TrackedAllocation mMemory;
+};
+
+// One LinearArena per frame in flight. BeginFrame() moves to the next arena and resets it,
+// so anything allocated during the previous frame is still valid.
+class FrameArena
+{
+public:
+	explicit FrameArena(std::size_t bytesPerFrame = 64 * 1024, int frameCount = 2);
+
+	void BeginFrame();
+
+	LinearArena& Current();
+	int FrameCount()const;
+
+private:
+	std::vector<LinearArena> mArenas;
+	int mIndex = 0;
+};
+
+// Fixed-size blocks with an intrusive free list, grows a chunk at a time and never shrinks.
+class FixedPool
+{
+public:
+	FixedPool(std::size_t elementSize, std::size_t elementsPerChunk = 256);
+
+	FixedPool(const FixedPool& rhs) = delete;
+	FixedPool& operator=(const FixedPool& rhs) = delete;
+
+	void* Allocate();
+	void Free(void* p);
+
+	std::size_t ElementSize()const;
+	std::size_t LiveCount()const;
+	std::size_t Capacity()const;
+
+private:
+	struct FreeNode
+	{
+		FreeNode* Next;
+	};
+
+	void AddChunk();
+
+	std::vector<std::unique_ptr<std::byte[]>> mChunks;
+	FreeNode* mFreeList = nullptr;
+	std::size_t mElementSize = 0;
+	std::size_t mStride = 0;
+	std::size_t mElementsPerChunk = 0;
+	std::size_t mLiveCount = 0;
+	TrackedAllocation mMemory;
+};
+
+// STL allocator on top of a LinearArena. deallocate() is a no-op, reserve() up front to avoid
+// leaving dead buffers behind when the container grows.
+template<typename T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	ArenaAllocator() noexcept = default;
+	ArenaAllocator(LinearArena& arena) noexcept : mArena(&arena) {}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& rhs) noexcept : mArena(rhs.Arena()) {}
+
+	T* allocate(std::size_t n)
+	{
+		if (mArena == nullptr)
+			throw std::bad_alloc();
+
+		return static_cast<T*>(mArena->Allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, std::size_t) noexcept {}
+
+	LinearArena* Arena()const noexcept { return mArena; }
+
+private:
+	LinearArena* mArena = nullptr;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept { return lhs.Arena() == rhs.Arena(); }
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept { return lhs.Arena() != rhs.Arena(); }
+
+// STL allocator on top of a FixedPool, meant for node containers (std::list, std::map, ...).
+// Requests that do not fit a pool element go to the heap.
+template<typename T>
+class PoolAllocator
+{
+public:
+	using value_type = T;
+
+	PoolAllocator(FixedPool& pool) noexcept : mPool(&pool) {}
+
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>& rhs) noexcept : mPool(rhs.Pool()) {}
+
+	T* allocate(std::size_t n)
+	{
+		if (FromPool(n))
+			return static_cast<T*>(mPool->Allocate());
+
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		if (FromPool(n))
+			mPool->Free(p);
+		else
+			::operator delete(p);
+	}
+
+	FixedPool* Pool()const noexcept { return mPool; }
+
+private:
+	bool FromPool(std::size_t n)const noexcept
+	{
+		return n == 1 && sizeof(T) <= mPool->ElementSize() && alignof(T) <= alignof(std::max_align_t);
+	}
+
+	FixedPool* mPool = nullptr;
+};
+
+template<typename T, typename U>
+bool operator==(const PoolAllocator<T>& lhs, const PoolAllocator<U>& rhs) noexcept { return lhs.Pool() == rhs.Pool(); }
+
+template<typename T, typename U>
+bool operator!=(const PoolAllocator<T>& lhs, const PoolAllocator<U>& rhs) noexcept { return lhs.Pool() != rhs.Pool(); }
+
+template<typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,311 @@
+#include "AtlasPacker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+using namespace DirectX;
+
+namespace
+{
+	// Packing works in cells of 1 << SafeMips texels.
+	struct Rect
+	{
+		std::uint32_t X, Y, Width, Height;
+	};
+
+	bool Contains(const Rect& a, const Rect& b)
+	{
+		return b.X >= a.X && b.Y >= a.Y && b.X + b.Width <= a.X + a.Width && b.Y + b.Height <= a.Y + a.Height;
+	}
+
+	class Skyline
+	{
+	public:
+		explicit Skyline(std::uint32_t size) :
+			mSize(size),
+			mSegments{ { 0, 0, size } }
+		{
+		}
+
+		bool Insert(std::uint32_t width, std::uint32_t height, Rect& result)
+		{
+			std::uint32_t bestBottom = UINT32_MAX, bestX = 0;
+			std::size_t best = SIZE_MAX;
+			for (std::size_t i = 0; i < mSegments.size(); ++i) {
+				std::uint32_t y;
+				if (!Fits(i, width, height, y))
+					continue;
+				if (y + height < bestBottom || (y + height == bestBottom && mSegments[i].X < bestX)) {
+					bestBottom = y + height;
+					bestX = mSegments[i].X;
+					best = i;
+				}
+			}
+			if (best == SIZE_MAX)
+				return false;
+
+			result = { bestX, bestBottom - height, width, height };
+			Add(best, result);
+			return true;
+		}
+
+	private:
+		struct Segment
+		{
+			std::uint32_t X, Y, Width;
+		};
+
+		// the rectangle rests on the highest segment under it
+		bool Fits(std::size_t index, std::uint32_t width, std::uint32_t height, std::uint32_t& y)const
+		{
+			if (mSegments[index].X + width > mSize)
+				return false;
+
+			y = 0;
+			std::uint32_t covered = 0;
+			for (std::size_t i = index; covered < width; ++i) {
+				y = std::max(y, mSegments[i].Y);
+				if (y + height > mSize)
+					return false;
+				covered += mSegments[i].Width;
+			}
+			return true;
+		}
+
+		void Add(std::size_t index, const Rect& rect)
+		{
+			mSegments.insert(mSegments.begin() + index, { rect.X, rect.Y + rect.Height, rect.Width });
+
+			// cut away what the new segment covers
+			const std::uint32_t end = rect.X + rect.Width;
+			for (std::size_t i = index + 1; i < mSegments.size(); ) {
+				Segment& s = mSegments[i];
+				if (s.X >= end)
+					break;
+				const std::uint32_t cut = std::min(s.Width, end - s.X);
+				s.X += cut;
+				s.Width -= cut;
+				if (s.Width == 0)
+					mSegments.erase(mSegments.begin() + i);
+				else
+					break;
+			}
+
+			for (std::size_t i = 0; i + 1 < mSegments.size(); ) {
+				if (mSegments[i].Y == mSegments[i + 1].Y) {
+					mSegments[i].Width += mSegments[i + 1].Width;
+					mSegments.erase(mSegments.begin() + i + 1);
+				}
+				else {
+					++i;
+				}
+			}
+		}
+
+		std::uint32_t mSize;
+		std::vector<Segment> mSegments;
+	};
+
+	class MaxRects
+	{
+	public:
+		explicit MaxRects(std::uint32_t size) :
+			mFree{ { 0, 0, size, size } }
+		{
+		}
+
+		bool Insert(std::uint32_t width, std::uint32_t height, Rect& result)
+		{
+			std::uint32_t bestShort = UINT32_MAX, bestLong = UINT32_MAX;
+			std::size_t best = SIZE_MAX;
+			for (std::size_t i = 0; i < mFree.size(); ++i) {
+				const Rect& f = mFree[i];
+				if (width > f.Width || height > f.Height)
+					continue;
+				const std::uint32_t dw = f.Width - width, dh = f.Height - height;
+				const std::uint32_t shortSide = std::min(dw, dh), longSide = std::max(dw, dh);
+				if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+					bestShort = shortSide;
+					bestLong = longSide;
+					best = i;
+				}
+			}
+			if (best == SIZE_MAX)
+				return false;
+
+			result = { mFree[best].X, mFree[best].Y, width, height };
+			Split(result);
+			Prune();
+			return true;
+		}
+
+	private:
+		// every free rectangle the placed one overlaps leaves up to four maximal ones around it
+		void Split(const Rect& used)
+		{
+			const std::size_t count = mFree.size();
+			for (std::size_t i = 0; i < count; ++i) {
+				const Rect f = mFree[i];
+				if (used.X >= f.X + f.Width || used.X + used.Width <= f.X ||
+					used.Y >= f.Y + f.Height || used.Y + used.Height <= f.Y)
+					continue;
+
+				if (used.X > f.X)
+					mFree.push_back({ f.X, f.Y, used.X - f.X, f.Height });
+				if (used.X + used.Width < f.X + f.Width)
+					mFree.push_back({ used.X + used.Width, f.Y, f.X + f.Width - used.X - used.Width, f.Height });
+				if (used.Y > f.Y)
+					mFree.push_back({ f.X, f.Y, f.Width, used.Y - f.Y });
+				if (used.Y + used.Height < f.Y + f.Height)
+					mFree.push_back({ f.X, used.Y + used.Height, f.Width, f.Y + f.Height - used.Y - used.Height });
+
+				mFree[i].Width = 0;
+			}
+		}
+
+		void Prune()
+		{
+			mFree.erase(std::remove_if(mFree.begin(), mFree.end(), [](const Rect& r) { return r.Width == 0; }), mFree.end());
+			for (std::size_t i = 0; i < mFree.size(); ++i) {
+				for (std::size_t j = i + 1; j < mFree.size(); ) {
+					if (Contains(mFree[i], mFree[j])) {
+						mFree.erase(mFree.begin() + j);
+					}
+					else if (Contains(mFree[j], mFree[i])) {
+						mFree.erase(mFree.begin() + i);
+						j = i + 1;
+					}
+					else {
+						++j;
+					}
+				}
+			}
+		}
+
+		std::vector<Rect> mFree;
+	};
+
+	std::uint32_t CellCount(std::uint32_t texels, std::uint32_t cell)
+	{
+		return (texels + cell - 1) / cell;
+	}
+}
+
+std::uint32_t AtlasPacker::Pack(const std::vector<Size>& sizes, const Options& options, std::vector<Placement>& placements)
+{
+	const std::uint32_t cell = 1u << options.SafeMips;
+	const std::uint32_t pageCells = options.PageSize / cell;
+
+	placements.assign(sizes.size(), Placement());
+
+	// biggest first, the small ones fill the gaps
+	std::vector<std::uint32_t> order(sizes.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+		const std::uint32_t sideA = std::max(sizes[a].Width, sizes[a].Height), sideB = std::max(sizes[b].Width, sizes[b].Height);
+		if (sideA != sideB)
+			return sideA > sideB;
+		const std::uint64_t areaA = (std::uint64_t)sizes[a].Width * sizes[a].Height, areaB = (std::uint64_t)sizes[b].Width * sizes[b].Height;
+		return areaA != areaB ? areaA > areaB : a < b;
+	});
+
+	std::vector<Skyline> skylines;
+	std::vector<MaxRects> maxRects;
+	std::uint32_t pageCount = 0;
+	for (std::uint32_t index : order) {
+		const Size& size = sizes[index];
+		if (size.Width == 0 || size.Height == 0)
+			continue;
+
+		const std::uint32_t width = CellCount(size.Width + 2 * options.Gutter, cell);
+		const std::uint32_t height = CellCount(size.Height + 2 * options.Gutter, cell);
+		if (width > pageCells || height > pageCells)
+			continue;
+
+		Rect rect = {};
+		std::uint32_t page = 0;
+		for (;; ++page) {
+			if (page == pageCount) {
+				if (options.Heuristic == Method::Skyline)
+					skylines.emplace_back(pageCells);
+				else
+					maxRects.emplace_back(pageCells);
+				pageCount++;
+			}
+			if (options.Heuristic == Method::Skyline ? skylines[page].Insert(width, height, rect) : maxRects[page].Insert(width, height, rect))
+				break;
+		}
+
+		Placement& placement = placements[index];
+		placement.Page = page;
+		placement.X = rect.X * cell + options.Gutter;
+		placement.Y = rect.Y * cell + options.Gutter;
+		placement.Width = size.Width;
+		placement.Height = size.Height;
+		placement.Placed = true;
+	}
+	return pageCount;
+}
+
+void AtlasPacker::Compose(
+	const std::vector<const std::uint8_t*>& textures,
+	const std::vector<Placement>& placements,
+	std::uint32_t page,
+	const Options& options,
+	std::uint8_t* pixels,
+	std::size_t rowPitch)
+{
+	const std::uint32_t cell = 1u << options.SafeMips;
+	for (std::size_t i = 0; i < placements.size(); ++i) {
+		const Placement& p = placements[i];
+		if (!p.Placed || p.Page != page)
+			continue;
+
+		// the whole padded rectangle, clamped into the texture
+		const std::uint32_t left = p.X - options.Gutter, top = p.Y - options.Gutter;
+		const std::uint32_t right = left + CellCount(p.Width + 2 * options.Gutter, cell) * cell;
+		const std::uint32_t bottom = top + CellCount(p.Height + 2 * options.Gutter, cell) * cell;
+		const std::size_t texturePitch = (std::size_t)p.Width * 4;
+
+		for (std::uint32_t y = top; y < bottom; ++y) {
+			const std::uint32_t sy = (std::uint32_t)std::min(std::max((int)y - (int)p.Y, 0), (int)p.Height - 1);
+			const std::uint8_t* source = textures[i] + sy * texturePitch;
+			std::uint8_t* row = pixels + y * rowPitch;
+
+			for (std::uint32_t x = left; x < p.X; ++x)
+				std::memcpy(row + x * 4, source, 4);
+			std::memcpy(row + p.X * 4, source, texturePitch);
+			for (std::uint32_t x = p.X + p.Width; x < right; ++x)
+				std::memcpy(row + x * 4, source + texturePitch - 4, 4);
+		}
+	}
+}
+
+XMFLOAT4 AtlasPacker::ScaleOffset(const Placement& placement, const Options& options)
+{
+	const float size = (float)options.PageSize;
+	return XMFLOAT4(placement.Width / size, placement.Height / size, placement.X / size, placement.Y / size);
+}
+
+XMFLOAT4X4 AtlasPacker::MatTransform(const Placement& placement, const Options& options, const XMFLOAT4X4& matTransform)
+{
+	// row vectors as in the shaders: mul(float4(uv, 0, 1), gMatTransform)
+	const XMFLOAT4 so = ScaleOffset(placement, options);
+	XMMATRIX atlas = XMMatrixScaling(so.x, so.y, 1.0f) * XMMatrixTranslation(so.z, so.w, 0.0f);
+
+	XMFLOAT4X4 result;
+	XMStoreFloat4x4(&result, XMLoadFloat4x4(&matTransform) * atlas);
+	return result;
+}
+
+void AtlasPacker::RemapUVs(const Placement& placement, const Options& options, XMFLOAT2* uvs, std::size_t stride, std::size_t count)
+{
+	const XMFLOAT4 so = ScaleOffset(placement, options);
+	auto* bytes = reinterpret_cast<std::uint8_t*>(uvs);
+	for (std::size_t i = 0; i < count; ++i) {
+		XMFLOAT2& uv = *reinterpret_cast<XMFLOAT2*>(bytes + i * stride);
+		uv.x = uv.x * so.x + so.z;
+		uv.y = uv.y * so.y + so.w;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// Packs many small textures into a few shared pages, so objects that used a texture each can share
+// one descriptor table. Every texture gets a gutter of its own edge texels and is placed on a grid
+// of 2^SafeMips texels, so box filtered mips down to SafeMips never mix two textures.
+class AtlasPacker
+{
+public:
+	enum class Method
+	{
+		Skyline,	// bottom left on the skyline of the placed rectangles: fast, wastes the space under overhangs
+		MaxRects	// best short side fit into the free rectangles: tighter, slower with many textures
+	};
+
+	struct Options
+	{
+		Method Heuristic = Method::MaxRects;
+		std::uint32_t PageSize = 2048;
+
+		// Edge texels repeated around every texture, at the first mip.
+		std::uint32_t Gutter = 4;
+
+		// Mips that stay clean. Positions and padded sizes are multiples of 1 << SafeMips, so keep
+		// Gutter >= 1 << SafeMips for a texel of gutter at the last of them.
+		std::uint32_t SafeMips = 2;
+	};
+
+	struct Placement
+	{
+		std::uint32_t Page = 0;
+		std::uint32_t X = 0;		// of the texture itself, inside its gutter
+		std::uint32_t Y = 0;
+		std::uint32_t Width = 0;
+		std::uint32_t Height = 0;
+		bool Placed = false;		// false when the texture doesn't fit an empty page
+	};
+
+	struct Size
+	{
+		std::uint32_t Width = 0;
+		std::uint32_t Height = 0;
+	};
+
+	// Places every texture, biggest first, into the first page it fits and opens pages as needed.
+	// Returns the page count.
+	static std::uint32_t Pack(const std::vector<Size>& sizes, const Options& options, std::vector<Placement>& placements);
+
+	// Copies the RGBA8 textures placed on page into pixels (PageSize rows of rowPitch bytes) and fills
+	// their gutters. Texels nothing is placed on are left as they are.
+	static void Compose(
+		const std::vector<const std::uint8_t*>& textures,
+		const std::vector<Placement>& placements,
+		std::uint32_t page,
+		const Options& options,
+		std::uint8_t* pixels,
+		std::size_t rowPitch);
+
+	// UV scale in xy, offset in zw: atlas uv = uv * scale + offset.
+	static DirectX::XMFLOAT4 ScaleOffset(const Placement& placement, const Options& options);
+
+	// Material transform that maps a texture's UVs into the atlas after matTransform, for
+	// MaterialConstants::MatTransform. Only for UVs inside [0, 1]: wrapping would leave the texture.
+	static DirectX::XMFLOAT4X4 MatTransform(const Placement& placement, const Options& options, const DirectX::XMFLOAT4X4& matTransform);
+
+	// Bakes the placement into count UVs, stride bytes apart, for meshes that own their texture.
+	static void RemapUVs(const Placement& placement, const Options& options, DirectX::XMFLOAT2* uvs, std::size_t stride, std::size_t count);
+
+private:
+	AtlasPacker() = delete;
+	~AtlasPacker() = delete;
+};
@@ -0,0 +1,769 @@
+#include "BCEncoder.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// below this many blocks threads cost more than they save
+	const std::size_t MinParallelBlocks = 1024;
+
+	// BC7 interpolation weights of 4 bit indices, out of 64
+	const int Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// where BC1 palette entries lie between the endpoints
+	const float FourColorWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+	const float ThreeColorWeights[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+	int RefineIterations(BCEncoder::Quality quality)
+	{
+		return quality == BCEncoder::Quality::Fast ? 0 : quality == BCEncoder::Quality::Normal ? 1 : 8;
+	}
+
+	float Clamp255(float value)
+	{
+		return std::min(255.0f, std::max(0.0f, value));
+	}
+
+	struct BitWriter
+	{
+		std::uint8_t* Block;
+		unsigned Position = 0;
+
+		void Put(std::uint32_t value, unsigned bits)
+		{
+			for (unsigned i = 0; i < bits; ++i, ++Position) {
+				if ((value >> i) & 1)
+					Block[Position >> 3] |= (std::uint8_t)(1 << (Position & 7));
+			}
+		}
+	};
+
+	struct BitReader
+	{
+		const std::uint8_t* Block;
+		unsigned Position = 0;
+
+		std::uint32_t Get(unsigned bits)
+		{
+			std::uint32_t value = 0;
+			for (unsigned i = 0; i < bits; ++i, ++Position)
+				value |= (std::uint32_t)((Block[Position >> 3] >> (Position & 7)) & 1) << i;
+			return value;
+		}
+	};
+
+	// Endpoints from the per channel ranges. Channels falling while the widest one rises get their
+	// range flipped, and both ends are moved in a little: the extremes are rarely worth an endpoint.
+	void FitBoundingBox(const float (*points)[4], int count, int channels, float low[4], float high[4])
+	{
+		float mean[4] = {};
+		for (int c = 0; c < channels; ++c) {
+			low[c] = 255.0f;
+			high[c] = 0.0f;
+			for (int i = 0; i < count; ++i) {
+				low[c] = std::min(low[c], points[i][c]);
+				high[c] = std::max(high[c], points[i][c]);
+				mean[c] += points[i][c] / count;
+			}
+		}
+
+		int widest = 0;
+		for (int c = 1; c < channels; ++c) {
+			if (high[c] - low[c] > high[widest] - low[widest])
+				widest = c;
+		}
+		for (int c = 0; c < channels; ++c) {
+			float covariance = 0.0f;
+			for (int i = 0; i < count; ++i)
+				covariance += (points[i][widest] - mean[widest]) * (points[i][c] - mean[c]);
+			if (covariance < 0.0f)
+				std::swap(low[c], high[c]);
+
+			float inset = (high[c] - low[c]) / 16.0f;
+			low[c] += inset;
+			high[c] -= inset;
+		}
+	}
+
+	// Endpoints at the extremes of the points along their principal axis.
+	void FitPrincipalAxis(const float (*points)[4], int count, int channels, float low[4], float high[4])
+	{
+		float mean[4] = {};
+		for (int i = 0; i < count; ++i) {
+			for (int c = 0; c < channels; ++c)
+				mean[c] += points[i][c] / count;
+		}
+
+		float covariance[4][4] = {};
+		for (int i = 0; i < count; ++i) {
+			for (int r = 0; r < channels; ++r) {
+				for (int c = 0; c < channels; ++c)
+					covariance[r][c] += (points[i][r] - mean[r]) * (points[i][c] - mean[c]);
+			}
+		}
+
+		// power iteration from the row of the channel varying the most
+		int start = 0;
+		for (int c = 1; c < channels; ++c) {
+			if (covariance[c][c] > covariance[start][start])
+				start = c;
+		}
+		float axis[4] = {};
+		for (int c = 0; c < channels; ++c)
+			axis[c] = covariance[start][c];
+
+		for (int iteration = 0; iteration < 8; ++iteration) {
+			float next[4] = {}, largest = 0.0f;
+			for (int r = 0; r < channels; ++r) {
+				for (int c = 0; c < channels; ++c)
+					next[r] += covariance[r][c] * axis[c];
+				largest = std::max(largest, std::abs(next[r]));
+			}
+			if (largest < 1e-6f)
+				break;
+			for (int c = 0; c < channels; ++c)
+				axis[c] = next[c] / largest;
+		}
+
+		float length = 0.0f;
+		for (int c = 0; c < channels; ++c)
+			length += axis[c] * axis[c];
+		length = std::sqrt(length);
+		if (length < 1e-6f) {
+			for (int c = 0; c < channels; ++c)
+				low[c] = high[c] = mean[c];
+			return;
+		}
+
+		float lowest = 0.0f, highest = 0.0f;
+		for (int i = 0; i < count; ++i) {
+			float t = 0.0f;
+			for (int c = 0; c < channels; ++c)
+				t += (points[i][c] - mean[c]) * axis[c] / length;
+			lowest = std::min(lowest, t);
+			highest = std::max(highest, t);
+		}
+		for (int c = 0; c < channels; ++c) {
+			low[c] = Clamp255(mean[c] + lowest * axis[c] / length);
+			high[c] = Clamp255(mean[c] + highest * axis[c] / length);
+		}
+	}
+
+	// Endpoints minimizing the squared error of points interpolated at weights (0 at first, 1 at second).
+	bool FitLeastSquares(const float (*points)[4], const float* weights, int count, int channels, float first[4], float second[4])
+	{
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[4] = {}, bx[4] = {};
+		for (int i = 0; i < count; ++i) {
+			float a = 1.0f - weights[i], b = weights[i];
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (int c = 0; c < channels; ++c) {
+				ax[c] += a * points[i][c];
+				bx[c] += b * points[i][c];
+			}
+		}
+
+		float determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f)
+			return false;
+
+		for (int c = 0; c < channels; ++c) {
+			first[c] = Clamp255((bb * ax[c] - ab * bx[c]) / determinant);
+			second[c] = Clamp255((aa * bx[c] - ab * ax[c]) / determinant);
+		}
+		return true;
+	}
+
+	// ---- BC1 color blocks ----
+
+	std::uint16_t To565(const float color[4])
+	{
+		int r = (int)std::lround(Clamp255(color[0]) * 31.0f / 255.0f);
+		int g = (int)std::lround(Clamp255(color[1]) * 63.0f / 255.0f);
+		int b = (int)std::lround(Clamp255(color[2]) * 31.0f / 255.0f);
+		return (std::uint16_t)(r << 11 | g << 5 | b);
+	}
+
+	void From565(std::uint16_t value, int color[3])
+	{
+		int r = value >> 11, g = (value >> 5) & 63, b = value & 31;
+		color[0] = r << 3 | r >> 2;
+		color[1] = g << 2 | g >> 4;
+		color[2] = b << 3 | b >> 2;
+	}
+
+	void ColorPalette(std::uint16_t color0, std::uint16_t color1, bool fourColors, int palette[4][3])
+	{
+		From565(color0, palette[0]);
+		From565(color1, palette[1]);
+		for (int c = 0; c < 3; ++c) {
+			int a = palette[0][c], b = palette[1][c];
+			if (fourColors) {
+				palette[2][c] = (2 * a + b + 1) / 3;
+				palette[3][c] = (a + 2 * b + 1) / 3;
+			}
+			else {
+				palette[2][c] = (a + b + 1) / 2;
+				palette[3][c] = 0;
+			}
+		}
+	}
+
+	struct ColorBlock
+	{
+		std::uint16_t Color0 = 0;
+		std::uint16_t Color1 = 0;
+		std::uint32_t Indices = 0;
+		int Error = INT_MAX;
+	};
+
+	// Nearest palette entry of every pixel. threeColor is the mode with transparent black as
+	// entry 3, taken by the pixels with alpha below 128.
+	ColorBlock EvaluateColor(const std::uint8_t pixels[64], std::uint16_t color0, std::uint16_t color1, bool threeColor)
+	{
+		// the order of the endpoints selects the mode
+		if (threeColor ? color0 > color1 : color0 < color1)
+			std::swap(color0, color1);
+
+		ColorBlock result;
+		result.Color0 = color0;
+		result.Color1 = color1;
+		result.Error = 0;
+
+		int palette[4][3];
+		ColorPalette(color0, color1, !threeColor, palette);
+		// equal endpoints decode as three colors and transparent black in BC1
+		const int entries = threeColor ? 3 : color0 == color1 ? 1 : 4;
+
+		for (int i = 0; i < 16; ++i) {
+			const std::uint8_t* pixel = pixels + 4 * i;
+			if (threeColor && pixel[3] < 128) {
+				result.Indices |= 3u << (2 * i);
+				continue;
+			}
+
+			int bestIndex = 0, bestError = INT_MAX;
+			for (int entry = 0; entry < entries; ++entry) {
+				int error = 0;
+				for (int c = 0; c < 3; ++c) {
+					int d = pixel[c] - palette[entry][c];
+					error += d * d;
+				}
+				if (error < bestError) {
+					bestError = error;
+					bestIndex = entry;
+				}
+			}
+			result.Indices |= (std::uint32_t)bestIndex << (2 * i);
+			result.Error += bestError;
+		}
+		return result;
+	}
+
+	// Greedy single steps on every endpoint channel while the error drops.
+	ColorBlock SearchColor(const std::uint8_t pixels[64], ColorBlock best, bool threeColor)
+	{
+		const int shifts[3] = { 11, 5, 0 };
+		const int maxima[3] = { 31, 63, 31 };
+
+		for (bool improved = true; improved && best.Error > 0; ) {
+			improved = false;
+			for (int endpoint = 0; endpoint < 2; ++endpoint) {
+				for (int c = 0; c < 3; ++c) {
+					for (int step = -1; step <= 1; step += 2) {
+						std::uint16_t colors[2] = { best.Color0, best.Color1 };
+						int value = ((colors[endpoint] >> shifts[c]) & maxima[c]) + step;
+						if (value < 0 || value > maxima[c])
+							continue;
+						colors[endpoint] = (std::uint16_t)((colors[endpoint] & ~(maxima[c] << shifts[c])) | (value << shifts[c]));
+
+						ColorBlock candidate = EvaluateColor(pixels, colors[0], colors[1], threeColor);
+						if (candidate.Error < best.Error) {
+							best = candidate;
+							improved = true;
+						}
+					}
+				}
+			}
+		}
+		return best;
+	}
+
+	// punchThrough: BC1 alone, where pixels with alpha below 128 can be transparent.
+	void EncodeColor(const std::uint8_t pixels[64], BCEncoder::Quality quality, bool punchThrough, std::uint8_t* block)
+	{
+		auto transparent = [&](int i) { return punchThrough && pixels[4 * i + 3] < 128; };
+
+		float points[16][4];
+		int count = 0;
+		for (int i = 0; i < 16; ++i) {
+			if (transparent(i))
+				continue;
+			for (int c = 0; c < 3; ++c)
+				points[count][c] = pixels[4 * i + c];
+			count++;
+		}
+		const bool threeColor = count < 16;
+
+		ColorBlock best;
+		if (count == 0) {
+			best.Indices = 0xffffffff;
+		}
+		else {
+			float low[4], high[4];
+			if (quality == BCEncoder::Quality::Fast)
+				FitBoundingBox(points, count, 3, low, high);
+			else
+				FitPrincipalAxis(points, count, 3, low, high);
+			best = EvaluateColor(pixels, To565(low), To565(high), threeColor);
+
+			for (int iteration = 0; iteration < RefineIterations(quality) && best.Error > 0; ++iteration) {
+				float weights[16];
+				int n = 0;
+				for (int i = 0; i < 16; ++i) {
+					if (!transparent(i))
+						weights[n++] = (threeColor ? ThreeColorWeights : FourColorWeights)[(best.Indices >> (2 * i)) & 3];
+				}
+
+				float first[4], second[4];
+				if (!FitLeastSquares(points, weights, count, 3, first, second))
+					break;
+				ColorBlock candidate = EvaluateColor(pixels, To565(first), To565(second), threeColor);
+				if (candidate.Error >= best.Error)
+					break;
+				best = candidate;
+			}
+
+			if (quality == BCEncoder::Quality::High)
+				best = SearchColor(pixels, best, threeColor);
+		}
+
+		block[0] = (std::uint8_t)best.Color0;
+		block[1] = (std::uint8_t)(best.Color0 >> 8);
+		block[2] = (std::uint8_t)best.Color1;
+		block[3] = (std::uint8_t)(best.Color1 >> 8);
+		for (int i = 0; i < 4; ++i)
+			block[4 + i] = (std::uint8_t)(best.Indices >> (8 * i));
+	}
+
+	// BC3 color blocks always have four colors, whatever the order of the endpoints.
+	void DecodeColor(const std::uint8_t* block, bool alwaysFourColors, std::uint8_t pixels[64])
+	{
+		std::uint16_t color0 = (std::uint16_t)(block[0] | block[1] << 8);
+		std::uint16_t color1 = (std::uint16_t)(block[2] | block[3] << 8);
+		std::uint32_t indices = (std::uint32_t)block[4] | (std::uint32_t)block[5] << 8 |
+			(std::uint32_t)block[6] << 16 | (std::uint32_t)block[7] << 24;
+
+		const bool fourColors = alwaysFourColors || color0 > color1;
+		int palette[4][3];
+		ColorPalette(color0, color1, fourColors, palette);
+
+		for (int i = 0; i < 16; ++i) {
+			int index = (indices >> (2 * i)) & 3;
+			for (int c = 0; c < 3; ++c)
+				pixels[4 * i + c] = (std::uint8_t)palette[index][c];
+			pixels[4 * i + 3] = !fourColors && index == 3 ? 0 : 255;
+		}
+	}
+
+	// ---- BC4 single channel blocks (BC3 alpha, BC5) ----
+
+	void AlphaPalette(int alpha0, int alpha1, int palette[8])
+	{
+		palette[0] = alpha0;
+		palette[1] = alpha1;
+		if (alpha0 > alpha1) {
+			for (int i = 1; i < 7; ++i)
+				palette[i + 1] = ((7 - i) * alpha0 + i * alpha1 + 3) / 7;
+		}
+		else {
+			for (int i = 1; i < 5; ++i)
+				palette[i + 1] = ((5 - i) * alpha0 + i * alpha1 + 2) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	struct AlphaBlock
+	{
+		int Alpha0 = 0;
+		int Alpha1 = 0;
+		std::uint64_t Indices = 0;
+		int Error = INT_MAX;
+	};
+
+	// Eight values when alpha0 > alpha1, otherwise six and 0 and 255.
+	AlphaBlock EvaluateAlpha(const std::uint8_t values[16], int alpha0, int alpha1)
+	{
+		AlphaBlock result;
+		result.Alpha0 = alpha0;
+		result.Alpha1 = alpha1;
+		result.Error = 0;
+
+		int palette[8];
+		AlphaPalette(alpha0, alpha1, palette);
+		for (int i = 0; i < 16; ++i) {
+			int bestIndex = 0, bestError = INT_MAX;
+			for (int entry = 0; entry < 8; ++entry) {
+				int d = values[i] - palette[entry];
+				if (d * d < bestError) {
+					bestError = d * d;
+					bestIndex = entry;
+				}
+			}
+			result.Indices |= (std::uint64_t)bestIndex << (3 * i);
+			result.Error += bestError;
+		}
+		return result;
+	}
+
+	void EncodeAlpha(const std::uint8_t values[16], BCEncoder::Quality quality, std::uint8_t* block)
+	{
+		int low = 255, high = 0;
+		for (int i = 0; i < 16; ++i) {
+			low = std::min(low, (int)values[i]);
+			high = std::max(high, (int)values[i]);
+		}
+		AlphaBlock best = EvaluateAlpha(values, high, low);
+
+		// six values over the range between the extremes, which 0 and 255 cover
+		if (quality != BCEncoder::Quality::Fast && best.Error > 0) {
+			int innerLow = 255, innerHigh = 0;
+			for (int i = 0; i < 16; ++i) {
+				if (values[i] != 0 && values[i] != 255) {
+					innerLow = std::min(innerLow, (int)values[i]);
+					innerHigh = std::max(innerHigh, (int)values[i]);
+				}
+			}
+			if (innerLow <= innerHigh) {
+				AlphaBlock candidate = EvaluateAlpha(values, innerLow, innerHigh);
+				if (candidate.Error < best.Error)
+					best = candidate;
+			}
+		}
+
+		if (quality == BCEncoder::Quality::High && best.Error > 0) {
+			for (int d0 = -2; d0 <= 2; ++d0) {
+				for (int d1 = -2; d1 <= 2; ++d1) {
+					int alpha0 = high + d0, alpha1 = low + d1;
+					if (alpha0 > 255 || alpha1 < 0 || alpha0 <= alpha1)
+						continue;
+					AlphaBlock candidate = EvaluateAlpha(values, alpha0, alpha1);
+					if (candidate.Error < best.Error)
+						best = candidate;
+				}
+			}
+		}
+
+		block[0] = (std::uint8_t)best.Alpha0;
+		block[1] = (std::uint8_t)best.Alpha1;
+		for (int i = 0; i < 6; ++i)
+			block[2 + i] = (std::uint8_t)(best.Indices >> (8 * i));
+	}
+
+	void DecodeAlpha(const std::uint8_t* block, std::uint8_t pixels[64], int channel)
+	{
+		int palette[8];
+		AlphaPalette(block[0], block[1], palette);
+
+		std::uint64_t indices = 0;
+		for (int i = 0; i < 6; ++i)
+			indices |= (std::uint64_t)block[2 + i] << (8 * i);
+		for (int i = 0; i < 16; ++i)
+			pixels[4 * i + channel] = (std::uint8_t)palette[(indices >> (3 * i)) & 7];
+	}
+
+	// ---- BC7 mode 6: one subset, 7 bit rgba endpoints with a p-bit each, 4 bit indices ----
+
+	struct BC7Block
+	{
+		int Endpoints[2][4] = {};
+		int PBits[2] = {};
+		std::uint8_t Indices[16] = {};
+		int Error = INT_MAX;
+	};
+
+	void BC7Palette(const int endpoints[2][4], const int pBits[2], int palette[16][4])
+	{
+		for (int c = 0; c < 4; ++c) {
+			int e0 = endpoints[0][c] << 1 | pBits[0];
+			int e1 = endpoints[1][c] << 1 | pBits[1];
+			for (int i = 0; i < 16; ++i)
+				palette[i][c] = ((64 - Weights4[i]) * e0 + Weights4[i] * e1 + 32) >> 6;
+		}
+	}
+
+	void EvaluateBC7(const std::uint8_t pixels[64], BC7Block& block)
+	{
+		int palette[16][4];
+		BC7Palette(block.Endpoints, block.PBits, palette);
+
+		block.Error = 0;
+		for (int i = 0; i < 16; ++i) {
+			int bestIndex = 0, bestError = INT_MAX;
+			for (int entry = 0; entry < 16; ++entry) {
+				int error = 0;
+				for (int c = 0; c < 4; ++c) {
+					int d = pixels[4 * i + c] - palette[entry][c];
+					error += d * d;
+				}
+				if (error < bestError) {
+					bestError = error;
+					bestIndex = entry;
+				}
+			}
+			block.Indices[i] = (std::uint8_t)bestIndex;
+			block.Error += bestError;
+		}
+	}
+
+	// 7 bit values closest to color with the p-bit p, returns their squared error.
+	float Quantize7(const float color[4], int p, int quantized[4])
+	{
+		float error = 0.0f;
+		for (int c = 0; c < 4; ++c) {
+			quantized[c] = std::min(127, std::max(0, (int)std::lround((color[c] - p) / 2.0f)));
+			float d = (float)(quantized[c] << 1 | p) - color[c];
+			error += d * d;
+		}
+		return error;
+	}
+
+	// allPBits tries the four p-bit pairs on the block, otherwise each endpoint takes the one it quantizes best with.
+	BC7Block QuantizeBC7(const std::uint8_t pixels[64], const float first[4], const float second[4], bool allPBits)
+	{
+		BC7Block best;
+		if (allPBits) {
+			for (int p0 = 0; p0 < 2; ++p0) {
+				for (int p1 = 0; p1 < 2; ++p1) {
+					BC7Block candidate;
+					Quantize7(first, p0, candidate.Endpoints[0]);
+					Quantize7(second, p1, candidate.Endpoints[1]);
+					candidate.PBits[0] = p0;
+					candidate.PBits[1] = p1;
+					EvaluateBC7(pixels, candidate);
+					if (candidate.Error < best.Error)
+						best = candidate;
+				}
+			}
+			return best;
+		}
+
+		const float* colors[2] = { first, second };
+		for (int e = 0; e < 2; ++e) {
+			int other[4];
+			float error0 = Quantize7(colors[e], 0, best.Endpoints[e]);
+			float error1 = Quantize7(colors[e], 1, other);
+			if (error1 < error0) {
+				std::copy(other, other + 4, best.Endpoints[e]);
+				best.PBits[e] = 1;
+			}
+		}
+		EvaluateBC7(pixels, best);
+		return best;
+	}
+
+	void EncodeBC7(const std::uint8_t pixels[64], BCEncoder::Quality quality, std::uint8_t* block)
+	{
+		float points[16][4];
+		for (int i = 0; i < 16; ++i) {
+			for (int c = 0; c < 4; ++c)
+				points[i][c] = pixels[4 * i + c];
+		}
+
+		float low[4], high[4];
+		if (quality == BCEncoder::Quality::Fast)
+			FitBoundingBox(points, 16, 4, low, high);
+		else
+			FitPrincipalAxis(points, 16, 4, low, high);
+
+		const bool allPBits = quality == BCEncoder::Quality::High;
+		BC7Block best = QuantizeBC7(pixels, low, high, allPBits);
+		for (int iteration = 0; iteration < RefineIterations(quality) && best.Error > 0; ++iteration) {
+			float weights[16];
+			for (int i = 0; i < 16; ++i)
+				weights[i] = Weights4[best.Indices[i]] / 64.0f;
+
+			float first[4], second[4];
+			if (!FitLeastSquares(points, weights, 16, 4, first, second))
+				break;
+			BC7Block candidate = QuantizeBC7(pixels, first, second, allPBits);
+			if (candidate.Error >= best.Error)
+				break;
+			best = candidate;
+		}
+
+		// the index of pixel 0 is stored without its top bit: swap the endpoints when it has one,
+		// the weights are symmetric so the colors stay the same
+		if (best.Indices[0] >= 8) {
+			std::swap(best.Endpoints[0], best.Endpoints[1]);
+			std::swap(best.PBits[0], best.PBits[1]);
+			for (auto& index : best.Indices)
+				index = (std::uint8_t)(15 - index);
+		}
+
+		std::memset(block, 0, 16);
+		BitWriter writer{ block };
+		writer.Put(1 << 6, 7);
+		for (int c = 0; c < 4; ++c) {
+			writer.Put(best.Endpoints[0][c], 7);
+			writer.Put(best.Endpoints[1][c], 7);
+		}
+		writer.Put(best.PBits[0], 1);
+		writer.Put(best.PBits[1], 1);
+		for (int i = 0; i < 16; ++i)
+			writer.Put(best.Indices[i], i == 0 ? 3 : 4);
+	}
+
+	void DecodeBC7(const std::uint8_t* block, std::uint8_t pixels[64])
+	{
+		BitReader reader{ block };
+		int mode = 0;
+		while (mode < 8 && reader.Get(1) == 0)
+			mode++;
+		if (mode != 6) {
+			std::memset(pixels, 0, 64);
+			return;
+		}
+
+		int endpoints[2][4], pBits[2];
+		for (int c = 0; c < 4; ++c) {
+			endpoints[0][c] = (int)reader.Get(7);
+			endpoints[1][c] = (int)reader.Get(7);
+		}
+		pBits[0] = (int)reader.Get(1);
+		pBits[1] = (int)reader.Get(1);
+
+		int palette[16][4];
+		BC7Palette(endpoints, pBits, palette);
+		for (int i = 0; i < 16; ++i) {
+			int index = (int)reader.Get(i == 0 ? 3 : 4);
+			for (int c = 0; c < 4; ++c)
+				pixels[4 * i + c] = (std::uint8_t)palette[index][c];
+		}
+	}
+}
+
+std::size_t BCEncoder::BlockBytes(Format format)
+{
+	return format == Format::BC1 ? 8 : 16;
+}
+
+std::size_t BCEncoder::SurfaceSize(std::uint32_t width, std::uint32_t height, Format format)
+{
+	return (std::size_t)std::max(1u, (width + 3) / 4) * std::max(1u, (height + 3) / 4) * BlockBytes(format);
+}
+
+void BCEncoder::EncodeBlock(const std::uint8_t pixels[64], Format format, Quality quality, std::uint8_t* block)
+{
+	std::uint8_t values[16];
+	switch (format) {
+	case Format::BC1:
+		EncodeColor(pixels, quality, true, block);
+		break;
+
+	case Format::BC3:
+		for (int i = 0; i < 16; ++i)
+			values[i] = pixels[4 * i + 3];
+		EncodeAlpha(values, quality, block);
+		EncodeColor(pixels, quality, false, block + 8);
+		break;
+
+	case Format::BC5:
+		for (int channel = 0; channel < 2; ++channel) {
+			for (int i = 0; i < 16; ++i)
+				values[i] = pixels[4 * i + channel];
+			EncodeAlpha(values, quality, block + 8 * channel);
+		}
+		break;
+
+	case Format::BC7:
+		EncodeBC7(pixels, quality, block);
+		break;
+	}
+}
+
+void BCEncoder::DecodeBlock(const std::uint8_t* block, Format format, std::uint8_t pixels[64])
+{
+	switch (format) {
+	case Format::BC1:
+		DecodeColor(block, false, pixels);
+		break;
+
+	case Format::BC3:
+		DecodeColor(block + 8, true, pixels);
+		DecodeAlpha(block, pixels, 3);
+		break;
+
+	case Format::BC5:
+		DecodeAlpha(block, pixels, 0);
+		DecodeAlpha(block + 8, pixels, 1);
+		for (int i = 0; i < 16; ++i) {
+			pixels[4 * i + 2] = 0;
+			pixels[4 * i + 3] = 255;
+		}
+		break;
+
+	case Format::BC7:
+		DecodeBC7(block, pixels);
+		break;
+	}
+}
+
+void BCEncoder::Encode(
+	const std::uint8_t* pixels,
+	std::size_t rowPitch,
+	std::uint32_t width,
+	std::uint32_t height,
+	Format format,
+	const Options& options,
+	std::uint8_t* blocks)
+{
+	if (width == 0 || height == 0)
+		return;
+
+	const std::uint32_t blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+	const std::size_t blockBytes = BlockBytes(format);
+	const unsigned threadCount = (std::size_t)blocksWide * blocksHigh < MinParallelBlocks ? 1 : options.ThreadCount;
+
+	Parallel::For(blocksHigh, [&](std::size_t row) {
+		std::uint8_t block[64];
+		for (std::uint32_t column = 0; column < blocksWide; ++column) {
+			for (std::uint32_t i = 0; i < 16; ++i) {
+				std::uint32_t x = std::min(column * 4 + (i & 3), width - 1);
+				std::uint32_t y = std::min((std::uint32_t)row * 4 + (i >> 2), height - 1);
+				std::memcpy(block + 4 * i, pixels + y * rowPitch + (std::size_t)x * 4, 4);
+			}
+			EncodeBlock(block, format, options.Level, blocks + (row * blocksWide + column) * blockBytes);
+		}
+	}, threadCount);
+}
+
+void BCEncoder::Decode(
+	const std::uint8_t* blocks,
+	std::uint32_t width,
+	std::uint32_t height,
+	Format format,
+	std::uint8_t* pixels,
+	std::size_t rowPitch)
+{
+	const std::uint32_t blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+	const std::size_t blockBytes = BlockBytes(format);
+
+	std::uint8_t block[64];
+	for (std::uint32_t row = 0; row < blocksHigh; ++row) {
+		for (std::uint32_t column = 0; column < blocksWide; ++column) {
+			DecodeBlock(blocks + ((std::size_t)row * blocksWide + column) * blockBytes, format, block);
+			for (std::uint32_t i = 0; i < 16; ++i) {
+				std::uint32_t x = column * 4 + (i & 3), y = row * 4 + (i >> 2);
+				if (x < width && y < height)
+					std::memcpy(pixels + y * rowPitch + (std::size_t)x * 4, block + 4 * i, 4);
+			}
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Block compression of RGBA8 images for the texture cooker. Every 4x4 block is encoded on its own,
+// rows of blocks go to worker threads.
+class BCEncoder
+{
+public:
+	enum class Format
+	{
+		BC1,	// rgb, 1 bit alpha: 8 bytes per block
+		BC3,	// rgb and separate alpha: 16 bytes
+		BC5,	// red and green, each like BC3's alpha: normal maps
+		BC7		// rgba, mode 6 only: 16 bytes
+	};
+
+	enum class Quality
+	{
+		Fast,		// bounding box endpoints
+		Normal,		// principal axis endpoints and one least squares refinement
+		High		// more refinement and a search around the endpoints
+	};
+
+	struct Options
+	{
+		Quality Level = Quality::Normal;
+
+		// 0: one per hardware thread
+		unsigned ThreadCount = 0;
+	};
+
+	static std::size_t BlockBytes(Format format);
+
+	// Bytes of a width x height surface.
+	static std::size_t SurfaceSize(std::uint32_t width, std::uint32_t height, Format format);
+
+	// Encodes width x height pixels into rows of blocks. Blocks crossing the right or bottom
+	// edge repeat the last column and row.
+	static void Encode(
+		const std::uint8_t* pixels,
+		std::size_t rowPitch,
+		std::uint32_t width,
+		std::uint32_t height,
+		Format format,
+		const Options& options,
+		std::uint8_t* blocks);
+
+	// Back to RGBA8, for quality checks. BC5 gives blue 0 and alpha 255, BC7 blocks in other
+	// modes than 6 come back black.
+	static void Decode(
+		const std::uint8_t* blocks,
+		std::uint32_t width,
+		std::uint32_t height,
+		Format format,
+		std::uint8_t* pixels,
+		std::size_t rowPitch);
+
+	// 16 RGBA8 pixels, row by row.
+	static void EncodeBlock(const std::uint8_t pixels[64], Format format, Quality quality, std::uint8_t* block);
+	static void DecodeBlock(const std::uint8_t* block, Format format, std::uint8_t pixels[64]);
+
+private:
+	BCEncoder() = delete;
+	~BCEncoder() = delete;
+};
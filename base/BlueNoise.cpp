@@ -0,0 +1,212 @@
+#include "BlueNoise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+using namespace DirectX;
+
+namespace
+{
+	// Gaussian energy filter of void and cluster, sigma 1.5 as in the paper. Integer weights keep the
+	// ordering the same on every compiler.
+	const float Sigma = 1.5f;
+	const int Radius = 5;
+
+	const char CacheMagic[4] = { 'B', 'N', 'V', 'C' };
+	const std::uint32_t CacheVersion = 1;
+
+	// Splitmix style generator, only used to seed the initial pattern.
+	std::uint32_t NextRandom(std::uint64_t& state)
+	{
+		state += 0x9E3779B97F4A7C15ull;
+		std::uint64_t z = state;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return (std::uint32_t)((z ^ (z >> 31)) >> 32);
+	}
+
+	std::uint32_t ClampSize(std::uint32_t size)
+	{
+		return std::min(std::max(size, 4u), 256u);
+	}
+
+	float RadicalInverse(std::uint32_t i, std::uint32_t base)
+	{
+		float result = 0.0f, digit = 1.0f / base;
+		for (; i > 0; i /= base, digit /= base)
+			result += (i % base) * digit;
+		return result;
+	}
+
+	class Pattern
+	{
+	public:
+		explicit Pattern(std::uint32_t size) :
+			mSize(size),
+			mRadius(std::min(Radius, (int)size / 2 - 1)),
+			mBits(size * size, 0),
+			mEnergy(size * size, 0)
+		{
+			const int side = 2 * mRadius + 1;
+			mWeights.resize(side * side);
+			for (int dy = -mRadius; dy <= mRadius; ++dy)
+				for (int dx = -mRadius; dx <= mRadius; ++dx)
+					mWeights[(dy + mRadius) * side + dx + mRadius] =
+						(std::int64_t)std::lround(65536.0 * std::exp(-(dx * dx + dy * dy) / (2.0 * Sigma * Sigma)));
+		}
+
+		bool Get(std::uint32_t index)const { return mBits[index] != 0; }
+
+		void Set(std::uint32_t index, bool value)
+		{
+			if (Get(index) == value)
+				return;
+			mBits[index] = value ? 1 : 0;
+
+			// the energy around the pixel, wrapping at the edges
+			const int side = 2 * mRadius + 1, size = (int)mSize;
+			const int x = (int)(index % mSize), y = (int)(index / mSize);
+			const std::int64_t sign = value ? 1 : -1;
+			for (int dy = -mRadius; dy <= mRadius; ++dy) {
+				const int row = (y + dy + size) % size * size;
+				for (int dx = -mRadius; dx <= mRadius; ++dx)
+					mEnergy[row + (x + dx + size) % size] += sign * mWeights[(dy + mRadius) * side + dx + mRadius];
+			}
+		}
+
+		// the set pixel in the densest spot
+		std::uint32_t TightestCluster()const
+		{
+			std::uint32_t best = 0;
+			std::int64_t energy = INT64_MIN;
+			for (std::uint32_t i = 0; i < (std::uint32_t)mBits.size(); ++i) {
+				if (mBits[i] && mEnergy[i] > energy) {
+					energy = mEnergy[i];
+					best = i;
+				}
+			}
+			return best;
+		}
+
+		// the clear pixel furthest from every set one
+		std::uint32_t LargestVoid()const
+		{
+			std::uint32_t best = 0;
+			std::int64_t energy = INT64_MAX;
+			for (std::uint32_t i = 0; i < (std::uint32_t)mBits.size(); ++i) {
+				if (!mBits[i] && mEnergy[i] < energy) {
+					energy = mEnergy[i];
+					best = i;
+				}
+			}
+			return best;
+		}
+
+	private:
+		std::uint32_t mSize;
+		int mRadius;
+		std::vector<std::int64_t> mWeights;
+		std::vector<std::uint8_t> mBits;
+		std::vector<std::int64_t> mEnergy;
+	};
+}
+
+void BlueNoise::Generate(std::uint32_t size, std::uint32_t seed, std::vector<std::uint16_t>& ranks)
+{
+	size = ClampSize(size);
+	const std::uint32_t count = size * size;
+	ranks.assign(count, 0);
+
+	// random initial points, a tenth of the pixels
+	Pattern pattern(size);
+	std::uint64_t state = seed;
+	const std::uint32_t initial = std::max(1u, count / 10);
+	for (std::uint32_t placed = 0; placed < initial; ) {
+		const std::uint32_t index = NextRandom(state) % count;
+		if (!pattern.Get(index)) {
+			pattern.Set(index, true);
+			placed++;
+		}
+	}
+
+	// spread them out: the most crowded point moves to the biggest hole until it would move back
+	for (std::uint32_t iteration = 0; iteration < count; ++iteration) {
+		const std::uint32_t cluster = pattern.TightestCluster();
+		pattern.Set(cluster, false);
+		const std::uint32_t hole = pattern.LargestVoid();
+		pattern.Set(hole, true);
+		if (hole == cluster)
+			break;
+	}
+	const Pattern prototype = pattern;
+
+	// ranks below the initial points: take them away, most crowded first
+	for (std::uint32_t rank = initial; rank-- > 0; ) {
+		const std::uint32_t cluster = pattern.TightestCluster();
+		pattern.Set(cluster, false);
+		ranks[cluster] = (std::uint16_t)rank;
+	}
+
+	// and above: fill the biggest hole left. Past half the pixels this is also the tightest cluster
+	// of the clear ones, the kernel sums to the same everywhere.
+	pattern = prototype;
+	for (std::uint32_t rank = initial; rank < count; ++rank) {
+		const std::uint32_t hole = pattern.LargestVoid();
+		pattern.Set(hole, true);
+		ranks[hole] = (std::uint16_t)rank;
+	}
+}
+
+bool BlueNoise::LoadOrGenerate(const std::string& path, std::uint32_t size, std::uint32_t seed, std::vector<std::uint16_t>& ranks)
+{
+	size = ClampSize(size);
+
+	struct Header
+	{
+		char Magic[4];
+		std::uint32_t Version;
+		std::uint32_t Size;
+		std::uint32_t Seed;
+	};
+
+	{
+		std::ifstream file(path, std::ios::binary);
+		Header header = {};
+		if (file.read((char*)&header, sizeof(header)) &&
+			std::memcmp(header.Magic, CacheMagic, 4) == 0 &&
+			header.Version == CacheVersion && header.Size == size && header.Seed == seed) {
+			ranks.resize((size_t)size * size);
+			if (file.read((char*)ranks.data(), ranks.size() * sizeof(std::uint16_t)))
+				return true;
+		}
+	}
+
+	Generate(size, seed, ranks);
+
+	Header header = { { CacheMagic[0], CacheMagic[1], CacheMagic[2], CacheMagic[3] }, CacheVersion, size, seed };
+	std::ofstream file(path, std::ios::binary);
+	return file.write((const char*)&header, sizeof(header)) &&
+		file.write((const char*)ranks.data(), ranks.size() * sizeof(std::uint16_t));
+}
+
+void BlueNoise::HemisphereKernel(std::uint32_t count, float minLength, std::vector<XMFLOAT4>& kernel)
+{
+	kernel.resize(count);
+	for (std::uint32_t i = 0; i < count; ++i) {
+		// stratified elevation, base 2 azimuth, base 3 length
+		const float u = (i + 0.5f) / count;
+		const float phi = XM_2PI * RadicalInverse(i, 2);
+		const float t = RadicalInverse(i + 1, 3);
+
+		// cosine distributed: uniform on the disk, lifted onto the hemisphere
+		const float r = std::sqrt(u);
+		const float length = minLength + (1.0f - minLength) * t * t;
+		kernel[i] = XMFLOAT4(
+			r * std::cos(phi) * length,
+			r * std::sin(phi) * length,
+			std::sqrt(1.0f - u) * length,
+			0.0f);
+	}
+}
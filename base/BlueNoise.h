@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+// Noise and sample sets for stochastic screen space effects (SSAO), built without rand(), so the
+// same arguments always give the same bits. Blue noise has no low frequencies: what is left after
+// a small blur looks flat, where white noise needs a wide one.
+class BlueNoise
+{
+public:
+	// Void and cluster (Ulichney 93): a size x size array holding every rank in [0, size^2) once.
+	// Thresholding it at any level gives evenly spread points, and it tiles without seams.
+	// size is clamped to [4, 256], the cost grows with size^4.
+	static void Generate(std::uint32_t size, std::uint32_t seed, std::vector<std::uint16_t>& ranks);
+
+	// Generate(), kept in a file at path. Returns false when the file couldn't be written,
+	// ranks are filled either way.
+	static bool LoadOrGenerate(const std::string& path, std::uint32_t size, std::uint32_t seed, std::vector<std::uint16_t>& ranks);
+
+	// count offsets in the unit hemisphere around +z, cosine distributed, with lengths in [minLength, 1]
+	// packed towards the center. A Hammersley set, so even a few samples cover the hemisphere.
+	static void HemisphereKernel(std::uint32_t count, float minLength, std::vector<DirectX::XMFLOAT4>& kernel);
+
+private:
+	BlueNoise() = delete;
+	~BlueNoise() = delete;
+};
@@ -0,0 +1,119 @@
+#include "CascadedShadows.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+void CascadedShadows::SplitDistances(float zn, float zf, int count, float lambda, float* splits)
+{
+	count = std::max(count, 1);
+	splits[0] = zn;
+	for (int i = 1; i < count; ++i) {
+		const float t = (float)i / count;
+		const float logarithmic = zn * std::pow(zf / zn, t);
+		const float uniform = zn + (zf - zn) * t;
+		splits[i] = lambda * logarithmic + (1.0f - lambda) * uniform;
+	}
+	splits[count] = zf;
+}
+
+void CascadedShadows::SliceCorners(const Camera& camera, float zn, float zf, XMFLOAT3 corners[8])
+{
+	const XMVECTOR position = camera.GetPosition();
+	const XMVECTOR right = camera.GetRight(), up = camera.GetUp(), look = camera.GetLook();
+	const float tanY = std::tan(0.5f * camera.GetFovY()), tanX = tanY * camera.GetAspect();
+
+	const float signs[4][2] = { { -1.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, -1.0f }, { -1.0f, -1.0f } };
+	const float depths[2] = { zn, zf };
+	for (int plane = 0; plane < 2; ++plane) {
+		const float z = depths[plane];
+		for (int i = 0; i < 4; ++i) {
+			XMVECTOR corner = XMVectorMultiplyAdd(XMVectorReplicate(z), look, position);
+			corner = XMVectorMultiplyAdd(XMVectorReplicate(signs[i][0] * z * tanX), right, corner);
+			corner = XMVectorMultiplyAdd(XMVectorReplicate(signs[i][1] * z * tanY), up, corner);
+			XMStoreFloat3(&corners[plane * 4 + i], corner);
+		}
+	}
+}
+
+void XM_CALLCONV CascadedShadows::Fit(
+	const Camera& camera,
+	FXMVECTOR lightDirection,
+	float zn,
+	float zf,
+	std::uint32_t resolution,
+	const BoundingBox& sceneBounds,
+	Cascade& cascade)
+{
+	cascade.SplitNear = zn;
+	cascade.SplitFar = zf;
+
+	// The smallest sphere around the slice has its center on the view axis, as far from the near
+	// corners as from the far ones, unless that lies past the far plane.
+	const float tanY = std::tan(0.5f * camera.GetFovY()), tanX = tanY * camera.GetAspect();
+	const float k2 = tanX * tanX + tanY * tanY;
+	const float centerDepth = std::min(0.5f * (zn + zf) * (1.0f + k2), zf);
+	const float radius = std::sqrt(std::max(
+		zf * zf * k2 + (zf - centerDepth) * (zf - centerDepth),
+		zn * zn * k2 + (centerDepth - zn) * (centerDepth - zn)));
+
+	// two texels of margin on either side: the snap below moves the center by up to half a texel,
+	// the 3x3 PCF of a pixel on the sphere reaches another 1.5 texels out
+	resolution = std::max(resolution, 5u);
+	const float texelSize = 2.0f * radius / (resolution - 4);
+	const float halfSize = 0.5f * texelSize * resolution;
+
+	// The light looks from the world origin, a camera move then only shifts the cascade in light space.
+	const XMVECTOR direction = XMVector3Normalize(lightDirection);
+	const XMVECTOR up = std::abs(XMVectorGetY(direction)) > 0.99f ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+	const XMMATRIX view = XMMatrixLookToLH(XMVectorZero(), direction, up);
+
+	const XMVECTOR centerW = XMVectorMultiplyAdd(XMVectorReplicate(centerDepth), camera.GetLook(), camera.GetPosition());
+	XMFLOAT3 center;
+	XMStoreFloat3(&center, XMVector3TransformCoord(centerW, view));
+	center.x = std::floor(center.x / texelSize + 0.5f) * texelSize;
+	center.y = std::floor(center.y / texelSize + 0.5f) * texelSize;
+
+	BoundingBox sceneL;
+	sceneBounds.Transform(sceneL, view);
+	const float nearZ = std::min(center.z - radius, sceneL.Center.z - sceneL.Extents.z);
+	const float farZ = center.z + radius;
+
+	XMStoreFloat4x4(&cascade.View, view);
+	XMStoreFloat4x4(&cascade.Proj, XMMatrixOrthographicOffCenterLH(
+		center.x - halfSize, center.x + halfSize,
+		center.y - halfSize, center.y + halfSize,
+		nearZ, farZ));
+	cascade.Bounds = BoundingBox(
+		XMFLOAT3(center.x, center.y, 0.5f * (nearZ + farZ)),
+		XMFLOAT3(halfSize, halfSize, 0.5f * (farZ - nearZ)));
+	cascade.TexelSize = texelSize;
+}
+
+void XM_CALLCONV CascadedShadows::Build(
+	const Camera& camera,
+	FXMVECTOR lightDirection,
+	float shadowDistance,
+	int count,
+	float lambda,
+	std::uint32_t resolution,
+	const BoundingBox& sceneBounds,
+	Cascade* cascades)
+{
+	count = std::min(std::max(count, 1), MaxCascades);
+	const float zn = camera.GetNearZ();
+	const float zf = std::max(std::min(shadowDistance, camera.GetFarZ()), zn * 2.0f);
+
+	float splits[MaxCascades + 1];
+	SplitDistances(zn, zf, count, lambda, splits);
+	for (int i = 0; i < count; ++i)
+		Fit(camera, lightDirection, splits[i], splits[i + 1], resolution, sceneBounds, cascades[i]);
+}
+
+bool CascadedShadows::IsCaster(const Cascade& cascade, const BoundingBox& worldBounds)
+{
+	BoundingBox bounds;
+	worldBounds.Transform(bounds, XMLoadFloat4x4(&cascade.View));
+	return cascade.Bounds.Intersects(bounds);
+}
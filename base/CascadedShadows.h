@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include "Common/Camera.h"
+
+// Cascaded shadow maps for a directional light: the camera frustum is cut into slices along its
+// view depth and every slice gets an orthographic shadow map fitted around it, so near geometry
+// gets many texels and far geometry few, instead of one box for the whole scene.
+class CascadedShadows
+{
+public:
+	static const int MaxCascades = 4;
+
+	struct Cascade
+	{
+		// view depths of the camera covered by this cascade
+		float SplitNear = 0.0f;
+		float SplitFar = 0.0f;
+
+		DirectX::XMFLOAT4X4 View;	// world to light space, the same for every cascade of a light
+		DirectX::XMFLOAT4X4 Proj;	// light space to the cascade's NDC
+
+		// What Proj keeps, in light space: the sphere around the slice in x and y, and in z
+		// everything from the scene bounds toward the light up to the far side of the sphere.
+		DirectX::BoundingBox Bounds;
+
+		// world units per shadow map texel
+		float TexelSize = 0.0f;
+	};
+
+	// The practical split scheme (Zhang et al. 06): splits[i] blends the logarithmic split, which
+	// keeps the texel to pixel ratio constant, with the uniform one by lambda (1 all logarithmic).
+	// Writes count + 1 view depths, from zn to zf.
+	static void SplitDistances(float zn, float zf, int count, float lambda, float* splits);
+
+	// The corners of the camera frustum between view depths zn and zf in world space, near plane first.
+	// Only reads the camera's position, basis and lens, the view matrix doesn't need to be up to date.
+	static void SliceCorners(const Camera& camera, float zn, float zf, DirectX::XMFLOAT3 corners[8]);
+
+	// Fits a cascade around the slice [zn, zf] of the camera.
+	// The box is the bounding sphere of the slice, which only depends on the lens and the split, so
+	// the size of a texel doesn't change as the camera turns; its center moves in whole texels of a
+	// resolution x resolution map, so a texel keeps covering the same piece of the world while the
+	// camera moves. Nothing shimmers at the shadow edges either way. The box is two texels wider on
+	// every side than the sphere: after the half texel snap, the 1.5 texel PCF footprint of a pixel
+	// on the sphere still stays inside the cascade.
+	// lightDirection: world space, from the light.
+	// sceneBounds: world space bounds of every caster, pulls the near plane toward the light so casters
+	// outside the slice still throw their shadows into it.
+	static void XM_CALLCONV Fit(
+		const Camera& camera,
+		DirectX::FXMVECTOR lightDirection,
+		float zn,
+		float zf,
+		std::uint32_t resolution,
+		const DirectX::BoundingBox& sceneBounds,
+		Cascade& cascade);
+
+	// SplitDistances() and Fit() for count cascades over [camera near, shadowDistance].
+	static void XM_CALLCONV Build(
+		const Camera& camera,
+		DirectX::FXMVECTOR lightDirection,
+		float shadowDistance,
+		int count,
+		float lambda,
+		std::uint32_t resolution,
+		const DirectX::BoundingBox& sceneBounds,
+		Cascade* cascades);
+
+	// Whether an object with these world space bounds can be seen from the light in the cascade.
+	// Everything else can be left out of the cascade's shadow map pass.
+	static bool IsCaster(const Cascade& cascade, const DirectX::BoundingBox& worldBounds);
+
+private:
+	CascadedShadows() = delete;
+	~CascadedShadows() = delete;
+};
@@ -140,9 +140,10 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 			v.TangentU.x = -radius*sinf(phi)*sinf(theta);
 			v.TangentU.y = 0.0f;
 			v.TangentU.z = +radius*sinf(phi)*cosf(theta);
+			v.TangentU.w = 1.0f;
 
-			XMVECTOR T = XMLoadFloat3(&v.TangentU);
-			XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
+			XMVECTOR T = XMLoadFloat4(&v.TangentU);
+			XMStoreFloat4(&v.TangentU, XMVectorSetW(XMVector3Normalize(T), 1.0f));
 
 			XMVECTOR p = XMLoadFloat3(&v.Position);
 			XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
@@ -282,8 +283,8 @@ GeometryGenerator::Vertex GeometryGenerator::MidPoint(const Vertex& v0, const Ve
     XMVECTOR n0 = XMLoadFloat3(&v0.Normal);
     XMVECTOR n1 = XMLoadFloat3(&v1.Normal);
 
-    XMVECTOR tan0 = XMLoadFloat3(&v0.TangentU);
-    XMVECTOR tan1 = XMLoadFloat3(&v1.TangentU);
+    XMVECTOR tan0 = XMLoadFloat4(&v0.TangentU);
+    XMVECTOR tan1 = XMLoadFloat4(&v1.TangentU);
 
     XMVECTOR tex0 = XMLoadFloat2(&v0.TexC);
     XMVECTOR tex1 = XMLoadFloat2(&v1.TexC);
@@ -298,7 +299,7 @@ GeometryGenerator::Vertex GeometryGenerator::MidPoint(const Vertex& v0, const Ve
     Vertex v;
     XMStoreFloat3(&v.Position, pos);
     XMStoreFloat3(&v.Normal, normal);
-    XMStoreFloat3(&v.TangentU, tangent);
+    XMStoreFloat4(&v.TangentU, XMVectorSetW(tangent, v0.TangentU.w));
     XMStoreFloat2(&v.TexC, tex);
 
     return v;
@@ -371,9 +372,10 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uin
 		meshData.Vertices[i].TangentU.x = -radius*sinf(phi)*sinf(theta);
 		meshData.Vertices[i].TangentU.y = 0.0f;
 		meshData.Vertices[i].TangentU.z = +radius*sinf(phi)*cosf(theta);
+		meshData.Vertices[i].TangentU.w = 1.0f;
 
-		XMVECTOR T = XMLoadFloat3(&meshData.Vertices[i].TangentU);
-		XMStoreFloat3(&meshData.Vertices[i].TangentU, XMVector3Normalize(T));
+		XMVECTOR T = XMLoadFloat4(&meshData.Vertices[i].TangentU);
+		XMStoreFloat4(&meshData.Vertices[i].TangentU, XMVectorSetW(XMVector3Normalize(T), 1.0f));
 	}
 
     return meshData;
@@ -434,12 +436,12 @@ GeometryGenerator::MeshData GeometryGenerator::CreateCylinder(float bottomRadius
 			//  dz/dv = (r0-r1)*sin(t)
 
 			// This is unit length.
-			vertex.TangentU = XMFLOAT3(-s, 0.0f, c);
+			vertex.TangentU = XMFLOAT4(-s, 0.0f, c, 1.0f);
 
 			float dr = bottomRadius-topRadius;
 			XMFLOAT3 bitangent(dr*c, -height, dr*s);
 
-			XMVECTOR T = XMLoadFloat3(&vertex.TangentU);
+			XMVECTOR T = XMLoadFloat4(&vertex.TangentU);
 			XMVECTOR B = XMLoadFloat3(&bitangent);
 			XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
 			XMStoreFloat3(&vertex.Normal, N);
@@ -578,7 +580,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float dep
 
 			meshData.Vertices[i*n+j].Position = XMFLOAT3(x, 0.0f, z);
 			meshData.Vertices[i*n+j].Normal   = XMFLOAT3(0.0f, 1.0f, 0.0f);
-			meshData.Vertices[i*n+j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
+			meshData.Vertices[i*n+j].TangentU = XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f);
 
 			// Stretch texture over grid.
 			meshData.Vertices[i*n+j].TexC.x = j*du;
@@ -35,7 +35,7 @@ public:
             const DirectX::XMFLOAT2& uv) :
             Position(p), 
             Normal(n), 
-            TangentU(t), 
+            TangentU(t.x, t.y, t.z, 1.0f), 
             TexC(uv){}
 		Vertex(
 			float px, float py, float pz, 
@@ -44,12 +44,12 @@ public:
 			float u, float v) : 
             Position(px,py,pz), 
             Normal(nx,ny,nz),
-			TangentU(tx, ty, tz), 
+			TangentU(tx, ty, tz, 1.0f), 
             TexC(u,v){}
 
         DirectX::XMFLOAT3 Position;
         DirectX::XMFLOAT3 Normal;
-        DirectX::XMFLOAT3 TangentU;
+        DirectX::XMFLOAT4 TangentU;	// xyz dP/du, w handedness: the bitangent is cross(Normal, xyz) * w
         DirectX::XMFLOAT2 TexC;
 	};
 
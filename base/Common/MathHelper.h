@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include <Windows.h>
+#include <cstdlib>
 #include <DirectXMath.h>
 #include <cstdint>
 
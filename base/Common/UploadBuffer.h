@@ -29,6 +29,8 @@ public:
             nullptr,
             IID_PPV_ARGS(&mUploadBuffer)));
 
+        d3dUtil::TrackResource(mUploadBuffer.Get(), MemoryTracker::Category::UploadBuffer);
+
         ThrowIfFailed(mUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mMappedData)));
 
         // We do not need to unmap until we are done with the resource.  However, we must not write to
@@ -55,6 +57,29 @@ public:
         memcpy(&mMappedData[elementIndex*mElementByteSize], &data, sizeof(T));
     }
 
+    // count elements starting at firstIndex, one memcpy when the elements are tightly packed.
+    void CopyRange(int firstIndex, const T* data, int count)
+    {
+        if(mElementByteSize == sizeof(T))
+        {
+            memcpy(&mMappedData[firstIndex*mElementByteSize], data, sizeof(T)*count);
+            return;
+        }
+
+        for(int i = 0; i < count; ++i)
+            CopyData(firstIndex + i, data[i]);
+    }
+
+    BYTE* MappedData()const
+    {
+        return mMappedData;
+    }
+
+    UINT ElementByteSize()const
+    {
+        return mElementByteSize;
+    }
+
 private:
     Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
     BYTE* mMappedData = nullptr;
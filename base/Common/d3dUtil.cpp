@@ -2,9 +2,60 @@
 #include "d3dUtil.h"
 #include <comdef.h>
 #include <fstream>
+#include <atomic>
 
 using Microsoft::WRL::ComPtr;
 
+namespace
+{
+    // {6B0D2E57-3C1A-4F7B-9E44-0A8B5D3C2F61}
+    const GUID MemoryTrackerGuid = { 0x6b0d2e57, 0x3c1a, 0x4f7b, { 0x9e, 0x44, 0x0a, 0x8b, 0x5d, 0x3c, 0x2f, 0x61 } };
+
+    // Stored as private data of a resource. The resource releases it when it is destroyed,
+    // which gives the tracked bytes back.
+    class TrackedResourceTag : public IUnknown
+    {
+    public:
+        TrackedResourceTag(MemoryTracker::Category category, UINT64 bytes) :
+            mAllocation(category, (size_t)bytes)
+        {
+        }
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+        {
+            if (ppvObject == nullptr)
+                return E_POINTER;
+
+            if (riid == __uuidof(IUnknown))
+            {
+                *ppvObject = static_cast<IUnknown*>(this);
+                AddRef();
+                return S_OK;
+            }
+
+            *ppvObject = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override
+        {
+            return ++mRefCount;
+        }
+
+        ULONG STDMETHODCALLTYPE Release() override
+        {
+            ULONG refCount = --mRefCount;
+            if (refCount == 0)
+                delete this;
+            return refCount;
+        }
+
+    private:
+        std::atomic<ULONG> mRefCount{ 1 };
+        TrackedAllocation mAllocation;
+    };
+}
+
 DxException::DxException(HRESULT hr, const std::wstring& functionName, const std::wstring& filename, int lineNumber) :
     ErrorCode(hr),
     FunctionName(functionName),
@@ -79,6 +130,9 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
 	cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(),
 		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
 
+    TrackResource(defaultBuffer.Get(), MemoryTracker::Category::DefaultBuffer);
+    TrackResource(uploadBuffer.Get(), MemoryTracker::Category::UploadHeap);
+
     // Note: uploadBuffer has to be kept alive after the above function calls because
     // the command list has not been executed yet that performs the actual copy.
     // The caller can Release the uploadBuffer after it knows the copy has been executed.
@@ -87,6 +141,22 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
     return defaultBuffer;
 }
 
+void d3dUtil::TrackResource(ID3D12Resource* resource, MemoryTracker::Category category)
+{
+    if (resource == nullptr)
+        return;
+
+    ComPtr<ID3D12Device> device;
+    ThrowIfFailed(resource->GetDevice(IID_PPV_ARGS(&device)));
+
+    D3D12_RESOURCE_DESC desc = resource->GetDesc();
+    D3D12_RESOURCE_ALLOCATION_INFO allocInfo = device->GetResourceAllocationInfo(0, 1, &desc);
+
+    ComPtr<IUnknown> tag;
+    tag.Attach(new TrackedResourceTag(category, allocInfo.SizeInBytes));
+    ThrowIfFailed(resource->SetPrivateDataInterface(MemoryTrackerGuid, tag.Get()));
+}
+
 ComPtr<ID3DBlob> d3dUtil::CompileShader(
 	const std::wstring& filename,
 	const D3D_SHADER_MACRO* defines,
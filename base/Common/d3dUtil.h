@@ -28,6 +28,7 @@
 #include "d3dx12.h"
 #include "DDSTextureLoader.h"
 #include "MathHelper.h"
+#include "../MemoryTracker.h"
 
 extern const int gNumFrameResources;
 
@@ -121,6 +122,9 @@ public:
         UINT64 byteSize,
         Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer);
 
+    // Registers the resource size with MemoryTracker. It is given back when the resource is destroyed.
+    static void TrackResource(ID3D12Resource* resource, MemoryTracker::Category category);
+
 	static Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(
 		const std::wstring& filename,
 		const D3D_SHADER_MACRO* defines,
@@ -146,6 +150,15 @@ public:
 // geometries are stored in one vertex and index buffer.  It provides the offsets
 // and data needed to draw a subset of geometry stores in the vertex and index 
 // buffers so that we can implement the technique described by Figure 6.3.
+struct SubmeshLod
+{
+	UINT IndexCount = 0;
+	UINT StartIndexLocation = 0;
+
+	// Geometric error relative to the radius of Bounds, see LodSelector.
+	float Error = 0.0f;
+};
+
 struct SubmeshGeometry
 {
 	UINT IndexCount = 0;
@@ -155,6 +168,10 @@ struct SubmeshGeometry
     // Bounding box of the geometry defined by this submesh. 
     // This is used in later chapters of the book.
 	DirectX::BoundingBox Bounds;
+
+	// Coarser index ranges over the same vertices, Lods[0] is the submesh itself.
+	// Empty when the geometry has no LOD chain.
+	std::vector<SubmeshLod> Lods;
 };
 
 struct MeshGeometry
@@ -184,6 +201,9 @@ struct MeshGeometry
 	// the Submeshes individually.
 	std::unordered_map<std::string, SubmeshGeometry> DrawArgs;
 
+	// Size of the system memory copies as reported to MemoryTracker.
+	TrackedAllocation CpuMemory;
+
 	D3D12_VERTEX_BUFFER_VIEW VertexBufferView()const
 	{
 		D3D12_VERTEX_BUFFER_VIEW vbv;
@@ -204,6 +224,18 @@ struct MeshGeometry
 		return ibv;
 	}
 
+	// Call after VertexBufferCPU/IndexBufferCPU are created.
+	void TrackCpuMemory()
+	{
+		size_t bytes = 0;
+		if (VertexBufferCPU != nullptr)
+			bytes += VertexBufferCPU->GetBufferSize();
+		if (IndexBufferCPU != nullptr)
+			bytes += IndexBufferCPU->GetBufferSize();
+
+		CpuMemory.Reset(MemoryTracker::Category::MeshGeometryCpu, bytes);
+	}
+
 	// We can free this memory after we finish upload to the GPU.
 	void DisposeUploaders()
 	{
@@ -250,6 +282,9 @@ struct Material
 	// Index into SRV heap for normal texture.
 	int NormalSrvHeapIndex = -1;
 
+	// Index into SRV heap for specular texture.
+	int SpecularSrvHeapIndex = -1;
+
 	// Dirty flag indicating the material has changed and we need to update the constant buffer.
 	// Because we have a material constant buffer for each FrameResource, we have to apply the
 	// update to each FrameResource.  Thus, when we modify a material we should set 
@@ -0,0 +1,19 @@
+#include "Culling.h"
+
+using namespace DirectX;
+
+bool XM_CALLCONV Culling::IsVisible(
+	const BoundingFrustum& viewFrustum,
+	FXMMATRIX invView,
+	CXMMATRIX world,
+	const BoundingBox& localBounds)
+{
+	XMVECTOR det = XMMatrixDeterminant(world);
+	XMMATRIX invWorld = XMMatrixInverse(&det, world);
+	XMMATRIX viewToLocal = XMMatrixMultiply(invView, invWorld);
+
+	BoundingFrustum localSpaceFrustum;
+	viewFrustum.Transform(localSpaceFrustum, viewToLocal);
+
+	return localSpaceFrustum.Contains(localBounds) != DirectX::DISJOINT;
+}
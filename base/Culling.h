@@ -0,0 +1,20 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+class Culling
+{
+public:
+	// Transform the view space frustum into the object's local space and test its local bounds.
+	// This is the per object test used by the CPU culling paths.
+	static bool XM_CALLCONV IsVisible(
+		const DirectX::BoundingFrustum& viewFrustum,
+		DirectX::FXMMATRIX invView,
+		DirectX::CXMMATRIX world,
+		const DirectX::BoundingBox& localBounds);
+
+private:
+	Culling() = delete;
+	~Culling() = delete;
+};
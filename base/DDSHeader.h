@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk structures and flags of DDS files, see DDS.h of DirectXTex. Shared by DDSParser and DDSWriter.
+namespace DDSHeader
+{
+	// all fields are 32 bit, so there is no padding
+	struct PixelFormat
+	{
+		std::uint32_t Size;
+		std::uint32_t Flags;
+		std::uint32_t FourCC;
+		std::uint32_t RGBBitCount;
+		std::uint32_t RBitMask;
+		std::uint32_t GBitMask;
+		std::uint32_t BBitMask;
+		std::uint32_t ABitMask;
+	};
+
+	struct Header
+	{
+		std::uint32_t Size;
+		std::uint32_t Flags;
+		std::uint32_t Height;
+		std::uint32_t Width;
+		std::uint32_t PitchOrLinearSize;
+		std::uint32_t Depth;
+		std::uint32_t MipMapCount;
+		std::uint32_t Reserved1[11];
+		PixelFormat Format;
+		std::uint32_t Caps;
+		std::uint32_t Caps2;
+		std::uint32_t Caps3;
+		std::uint32_t Caps4;
+		std::uint32_t Reserved2;
+	};
+
+	struct HeaderDXT10
+	{
+		std::uint32_t Format;
+		std::uint32_t ResourceDimension;
+		std::uint32_t MiscFlag;
+		std::uint32_t ArraySize;
+		std::uint32_t MiscFlags2;
+	};
+
+	static_assert(sizeof(PixelFormat) == 32, "DDS_PIXELFORMAT is 32 bytes");
+	static_assert(sizeof(Header) == 124, "DDS_HEADER is 124 bytes");
+	static_assert(sizeof(HeaderDXT10) == 20, "DDS_HEADER_DXT10 is 20 bytes");
+
+	constexpr std::uint32_t FourCC(char a, char b, char c, char d)
+	{
+		return (std::uint32_t)(std::uint8_t)a | ((std::uint32_t)(std::uint8_t)b << 8) |
+			((std::uint32_t)(std::uint8_t)c << 16) | ((std::uint32_t)(std::uint8_t)d << 24);
+	}
+
+	const std::uint32_t Magic = FourCC('D', 'D', 'S', ' ');
+
+	const std::uint32_t PixelFormatFourCC = 0x4;
+	const std::uint32_t PixelFormatRGB = 0x40;
+	const std::uint32_t PixelFormatLuminance = 0x20000;
+	const std::uint32_t PixelFormatAlpha = 0x2;
+
+	const std::uint32_t HeaderFlagsCaps = 0x1;
+	const std::uint32_t HeaderFlagsHeight = 0x2;
+	const std::uint32_t HeaderFlagsWidth = 0x4;
+	const std::uint32_t HeaderFlagsPixelFormat = 0x1000;
+	const std::uint32_t HeaderFlagsMipMapCount = 0x20000;
+	const std::uint32_t HeaderFlagsLinearSize = 0x80000;
+	const std::uint32_t HeaderFlagsVolume = 0x800000;
+
+	const std::uint32_t CapsComplex = 0x8;
+	const std::uint32_t CapsTexture = 0x1000;
+	const std::uint32_t CapsMipMap = 0x400000;
+
+	const std::uint32_t Caps2Cubemap = 0x200;
+	const std::uint32_t Caps2CubemapAllFaces = 0xFC00 | Caps2Cubemap;
+
+	// D3D11_RESOURCE_DIMENSION and D3D11_RESOURCE_MISC_TEXTURECUBE
+	const std::uint32_t Dimension1D = 2;
+	const std::uint32_t Dimension2D = 3;
+	const std::uint32_t Dimension3D = 4;
+	const std::uint32_t MiscTextureCube = 0x4;
+}
@@ -0,0 +1,416 @@
+#include "DDSParser.h"
+#include "DDSHeader.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DDSHeader;
+
+namespace
+{
+	// D3D12_REQ_*
+	const std::uint32_t MaxMipLevels = 15;
+	const std::uint32_t Max1DSize = 16384;
+	const std::uint32_t Max2DSize = 16384;
+	const std::uint32_t Max3DSize = 2048;
+	const std::uint32_t MaxArraySize = 2048;
+
+	DDSFormat FormatOf(const PixelFormat& format)
+	{
+		auto masks = [&](std::uint32_t r, std::uint32_t g, std::uint32_t b, std::uint32_t a)
+		{
+			return format.RBitMask == r && format.GBitMask == g && format.BBitMask == b && format.ABitMask == a;
+		};
+
+		if (format.Flags & PixelFormatRGB) {
+			// sRGB formats only come with the DX10 header
+			switch (format.RGBBitCount) {
+			case 32:
+				if (masks(0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000)) return DDSFormat::R8G8B8A8_UNORM;
+				if (masks(0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000)) return DDSFormat::B8G8R8A8_UNORM;
+				if (masks(0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000)) return DDSFormat::B8G8R8X8_UNORM;
+				// D3DX writes 10:10:10:2 with red and blue swapped
+				if (masks(0x3ff00000, 0x000ffc00, 0x000003ff, 0xc0000000)) return DDSFormat::R10G10B10A2_UNORM;
+				if (masks(0x0000ffff, 0xffff0000, 0x00000000, 0x00000000)) return DDSFormat::R16G16_UNORM;
+				if (masks(0xffffffff, 0x00000000, 0x00000000, 0x00000000)) return DDSFormat::R32_FLOAT;
+				break;
+
+			case 16:
+				if (masks(0x7c00, 0x03e0, 0x001f, 0x8000)) return DDSFormat::B5G5R5A1_UNORM;
+				if (masks(0xf800, 0x07e0, 0x001f, 0x0000)) return DDSFormat::B5G6R5_UNORM;
+				if (masks(0x0f00, 0x00f0, 0x000f, 0xf000)) return DDSFormat::B4G4R4A4_UNORM;
+				break;
+			}
+		}
+		else if (format.Flags & PixelFormatLuminance) {
+			if (format.RGBBitCount == 8 && masks(0x000000ff, 0x00000000, 0x00000000, 0x00000000)) return DDSFormat::R8_UNORM;
+			if (format.RGBBitCount == 16 && masks(0x0000ffff, 0x00000000, 0x00000000, 0x00000000)) return DDSFormat::R16_UNORM;
+			if (format.RGBBitCount == 16 && masks(0x000000ff, 0x00000000, 0x00000000, 0x0000ff00)) return DDSFormat::R8G8_UNORM;
+		}
+		else if (format.Flags & PixelFormatAlpha) {
+			if (format.RGBBitCount == 8) return DDSFormat::A8_UNORM;
+		}
+		else if (format.Flags & PixelFormatFourCC) {
+			switch (format.FourCC) {
+			case FourCC('D', 'X', 'T', '1'): return DDSFormat::BC1_UNORM;
+			// premultiplied alpha has no format of its own, see AlphaMode
+			case FourCC('D', 'X', 'T', '2'):
+			case FourCC('D', 'X', 'T', '3'): return DDSFormat::BC2_UNORM;
+			case FourCC('D', 'X', 'T', '4'):
+			case FourCC('D', 'X', 'T', '5'): return DDSFormat::BC3_UNORM;
+			case FourCC('A', 'T', 'I', '1'):
+			case FourCC('B', 'C', '4', 'U'): return DDSFormat::BC4_UNORM;
+			case FourCC('B', 'C', '4', 'S'): return DDSFormat::BC4_SNORM;
+			case FourCC('A', 'T', 'I', '2'):
+			case FourCC('B', 'C', '5', 'U'): return DDSFormat::BC5_UNORM;
+			case FourCC('B', 'C', '5', 'S'): return DDSFormat::BC5_SNORM;
+			case FourCC('R', 'G', 'B', 'G'): return DDSFormat::R8G8_B8G8_UNORM;
+			case FourCC('G', 'R', 'G', 'B'): return DDSFormat::G8R8_G8B8_UNORM;
+
+			// D3DFORMAT values
+			case 36: return DDSFormat::R16G16B16A16_UNORM;
+			case 110: return DDSFormat::R16G16B16A16_SNORM;
+			case 111: return DDSFormat::R16_FLOAT;
+			case 112: return DDSFormat::R16G16_FLOAT;
+			case 113: return DDSFormat::R16G16B16A16_FLOAT;
+			case 114: return DDSFormat::R32_FLOAT;
+			case 115: return DDSFormat::R32G32_FLOAT;
+			case 116: return DDSFormat::R32G32B32A32_FLOAT;
+			}
+		}
+
+		return DDSFormat::UNKNOWN;
+	}
+
+	std::uint32_t MaxMips(std::uint32_t width, std::uint32_t height, std::uint32_t depth)
+	{
+		std::uint32_t size = std::max(width, std::max(height, depth)), mips = 1;
+		while (size > 1) {
+			size >>= 1;
+			mips++;
+		}
+		return mips;
+	}
+}
+
+DDSResult DDSParser::Parse(const void* data, std::size_t size, DDSTexture& texture, std::uint32_t maxSize)
+{
+	texture = DDSTexture();
+
+	const std::uint8_t* bytes = (const std::uint8_t*)data;
+	if (bytes == nullptr || size < sizeof(std::uint32_t) + sizeof(Header))
+		return DDSResult::NotDDS;
+
+	std::uint32_t magic;
+	std::memcpy(&magic, bytes, sizeof(magic));
+	if (magic != Magic)
+		return DDSResult::NotDDS;
+
+	Header header;
+	std::memcpy(&header, bytes + sizeof(magic), sizeof(header));
+	if (header.Size != sizeof(Header) || header.Format.Size != sizeof(PixelFormat))
+		return DDSResult::BadHeader;
+
+	std::size_t offset = sizeof(magic) + sizeof(header);
+	std::uint32_t width = header.Width, height = header.Height, depth = header.Depth;
+	std::uint32_t arraySize = 1;
+	std::uint32_t mipCount = std::max(header.MipMapCount, 1u);
+
+	if ((header.Format.Flags & PixelFormatFourCC) && header.Format.FourCC == FourCC('D', 'X', '1', '0')) {
+		if (size < offset + sizeof(HeaderDXT10))
+			return DDSResult::NotDDS;
+
+		HeaderDXT10 extension;
+		std::memcpy(&extension, bytes + offset, sizeof(extension));
+		offset += sizeof(extension);
+
+		texture.Format = (DDSFormat)extension.Format;
+		if (BitsPerPixel(texture.Format) == 0)
+			return DDSResult::UnsupportedFormat;
+
+		arraySize = extension.ArraySize;
+		if (arraySize == 0)
+			return DDSResult::BadHeader;
+
+		switch (extension.ResourceDimension) {
+		case Dimension1D:
+			if ((header.Flags & HeaderFlagsHeight) && height != 1)
+				return DDSResult::BadHeader;
+			texture.Type = DDSTexture::Dimension::Texture1D;
+			height = depth = 1;
+			break;
+
+		case Dimension2D:
+			if (extension.MiscFlag & MiscTextureCube) {
+				if (arraySize > MaxArraySize / 6)
+					return DDSResult::UnsupportedDimension;
+				arraySize *= 6;
+				texture.IsCube = true;
+			}
+			texture.Type = DDSTexture::Dimension::Texture2D;
+			depth = 1;
+			break;
+
+		case Dimension3D:
+			if (!(header.Flags & HeaderFlagsVolume))
+				return DDSResult::BadHeader;
+			if (arraySize > 1)
+				return DDSResult::UnsupportedDimension;
+			texture.Type = DDSTexture::Dimension::Texture3D;
+			break;
+
+		default:
+			return DDSResult::UnsupportedDimension;
+		}
+
+		std::uint32_t alphaMode = extension.MiscFlags2 & 0x7;
+		texture.AlphaMode = alphaMode <= 4 ? alphaMode : 0;
+	}
+	else {
+		texture.Format = FormatOf(header.Format);
+		if (texture.Format == DDSFormat::UNKNOWN)
+			return DDSResult::UnsupportedFormat;
+
+		if (header.Flags & HeaderFlagsVolume) {
+			texture.Type = DDSTexture::Dimension::Texture3D;
+		}
+		else {
+			if (header.Caps2 & Caps2Cubemap) {
+				// D3D has no partial cubes
+				if ((header.Caps2 & Caps2CubemapAllFaces) != Caps2CubemapAllFaces)
+					return DDSResult::UnsupportedDimension;
+				arraySize = 6;
+				texture.IsCube = true;
+			}
+			texture.Type = DDSTexture::Dimension::Texture2D;
+			depth = 1;
+		}
+
+		if (header.Format.FourCC == FourCC('D', 'X', 'T', '2') || header.Format.FourCC == FourCC('D', 'X', 'T', '4'))
+			texture.AlphaMode = 2;	// DDS_ALPHA_MODE_PREMULTIPLIED
+	}
+
+	// nothing larger than the hardware allows, which also keeps the byte counts below from overflowing
+	std::uint32_t maxExtent = texture.Type == DDSTexture::Dimension::Texture3D ? Max3DSize :
+		texture.Type == DDSTexture::Dimension::Texture1D ? Max1DSize : Max2DSize;
+	if (width == 0 || height == 0 || depth == 0)
+		return DDSResult::BadHeader;
+	if (width > maxExtent || height > maxExtent || depth > maxExtent || arraySize > MaxArraySize)
+		return DDSResult::UnsupportedDimension;
+	if (mipCount > MaxMipLevels || mipCount > MaxMips(width, height, depth))
+		return DDSResult::BadHeader;
+
+	texture.Data = bytes + offset;
+	texture.DataSize = size - offset;
+	texture.ArraySize = arraySize;
+
+	std::uint32_t skippedMips = 0;
+	std::uint64_t position = 0;
+	texture.Subresources.reserve((size_t)arraySize * mipCount);
+	for (std::uint32_t slice = 0; slice < arraySize; ++slice) {
+		std::uint32_t w = width, h = height, d = depth;
+		for (std::uint32_t mip = 0; mip < mipCount; ++mip) {
+			DDSSubresource subresource;
+			subresource.Width = w;
+			subresource.Height = h;
+			subresource.Depth = d;
+			SurfaceInfo(w, h, texture.Format, subresource.RowPitch, subresource.RowCount, subresource.SlicePitch);
+
+			std::uint64_t bytesNeeded = (std::uint64_t)subresource.SlicePitch * d;
+			if (bytesNeeded > texture.DataSize - position)
+				return DDSResult::Truncated;
+			subresource.Offset = (std::size_t)position;
+			position += bytesNeeded;
+
+			if (mipCount <= 1 || maxSize == 0 || (w <= maxSize && h <= maxSize && d <= maxSize))
+				texture.Subresources.push_back(subresource);
+			else if (slice == 0)
+				skippedMips++;
+
+			w = std::max(w >> 1, 1u);
+			h = std::max(h >> 1, 1u);
+			d = std::max(d >> 1, 1u);
+		}
+	}
+
+	if (skippedMips == mipCount)
+		return DDSResult::UnsupportedDimension;
+
+	const DDSSubresource& first = texture.Subresources[0];
+	texture.Width = first.Width;
+	texture.Height = first.Height;
+	texture.Depth = first.Depth;
+	texture.MipCount = mipCount - skippedMips;
+	return DDSResult::Ok;
+}
+
+const char* DDSParser::ResultName(DDSResult result)
+{
+	switch (result) {
+	case DDSResult::Ok:						return "Ok";
+	case DDSResult::NotDDS:					return "NotDDS";
+	case DDSResult::BadHeader:				return "BadHeader";
+	case DDSResult::UnsupportedFormat:		return "UnsupportedFormat";
+	case DDSResult::UnsupportedDimension:	return "UnsupportedDimension";
+	case DDSResult::Truncated:				return "Truncated";
+	}
+	return "Unknown";
+}
+
+std::uint32_t DDSParser::BitsPerPixel(DDSFormat format)
+{
+	switch (format) {
+	case DDSFormat::R32G32B32A32_TYPELESS:
+	case DDSFormat::R32G32B32A32_FLOAT:
+	case DDSFormat::R32G32B32A32_UINT:
+	case DDSFormat::R32G32B32A32_SINT:
+		return 128;
+
+	case DDSFormat::R32G32B32_TYPELESS:
+	case DDSFormat::R32G32B32_FLOAT:
+	case DDSFormat::R32G32B32_UINT:
+	case DDSFormat::R32G32B32_SINT:
+		return 96;
+
+	case DDSFormat::R16G16B16A16_TYPELESS:
+	case DDSFormat::R16G16B16A16_FLOAT:
+	case DDSFormat::R16G16B16A16_UNORM:
+	case DDSFormat::R16G16B16A16_UINT:
+	case DDSFormat::R16G16B16A16_SNORM:
+	case DDSFormat::R16G16B16A16_SINT:
+	case DDSFormat::R32G32_TYPELESS:
+	case DDSFormat::R32G32_FLOAT:
+	case DDSFormat::R32G32_UINT:
+	case DDSFormat::R32G32_SINT:
+	case DDSFormat::R32G8X24_TYPELESS:
+	case DDSFormat::D32_FLOAT_S8X24_UINT:
+	case DDSFormat::R32_FLOAT_X8X24_TYPELESS:
+	case DDSFormat::X32_TYPELESS_G8X24_UINT:
+		return 64;
+
+	case DDSFormat::R10G10B10A2_TYPELESS:
+	case DDSFormat::R10G10B10A2_UNORM:
+	case DDSFormat::R10G10B10A2_UINT:
+	case DDSFormat::R11G11B10_FLOAT:
+	case DDSFormat::R8G8B8A8_TYPELESS:
+	case DDSFormat::R8G8B8A8_UNORM:
+	case DDSFormat::R8G8B8A8_UNORM_SRGB:
+	case DDSFormat::R8G8B8A8_UINT:
+	case DDSFormat::R8G8B8A8_SNORM:
+	case DDSFormat::R8G8B8A8_SINT:
+	case DDSFormat::R16G16_TYPELESS:
+	case DDSFormat::R16G16_FLOAT:
+	case DDSFormat::R16G16_UNORM:
+	case DDSFormat::R16G16_UINT:
+	case DDSFormat::R16G16_SNORM:
+	case DDSFormat::R16G16_SINT:
+	case DDSFormat::R32_TYPELESS:
+	case DDSFormat::D32_FLOAT:
+	case DDSFormat::R32_FLOAT:
+	case DDSFormat::R32_UINT:
+	case DDSFormat::R32_SINT:
+	case DDSFormat::R24G8_TYPELESS:
+	case DDSFormat::D24_UNORM_S8_UINT:
+	case DDSFormat::R24_UNORM_X8_TYPELESS:
+	case DDSFormat::X24_TYPELESS_G8_UINT:
+	case DDSFormat::R9G9B9E5_SHAREDEXP:
+	case DDSFormat::R8G8_B8G8_UNORM:
+	case DDSFormat::G8R8_G8B8_UNORM:
+	case DDSFormat::B8G8R8A8_UNORM:
+	case DDSFormat::B8G8R8X8_UNORM:
+	case DDSFormat::R10G10B10_XR_BIAS_A2_UNORM:
+	case DDSFormat::B8G8R8A8_TYPELESS:
+	case DDSFormat::B8G8R8A8_UNORM_SRGB:
+	case DDSFormat::B8G8R8X8_TYPELESS:
+	case DDSFormat::B8G8R8X8_UNORM_SRGB:
+		return 32;
+
+	case DDSFormat::R8G8_TYPELESS:
+	case DDSFormat::R8G8_UNORM:
+	case DDSFormat::R8G8_UINT:
+	case DDSFormat::R8G8_SNORM:
+	case DDSFormat::R8G8_SINT:
+	case DDSFormat::R16_TYPELESS:
+	case DDSFormat::R16_FLOAT:
+	case DDSFormat::D16_UNORM:
+	case DDSFormat::R16_UNORM:
+	case DDSFormat::R16_UINT:
+	case DDSFormat::R16_SNORM:
+	case DDSFormat::R16_SINT:
+	case DDSFormat::B5G6R5_UNORM:
+	case DDSFormat::B5G5R5A1_UNORM:
+	case DDSFormat::B4G4R4A4_UNORM:
+		return 16;
+
+	case DDSFormat::R8_TYPELESS:
+	case DDSFormat::R8_UNORM:
+	case DDSFormat::R8_UINT:
+	case DDSFormat::R8_SNORM:
+	case DDSFormat::R8_SINT:
+	case DDSFormat::A8_UNORM:
+		return 8;
+
+	case DDSFormat::R1_UNORM:
+		return 1;
+
+	case DDSFormat::BC1_TYPELESS:
+	case DDSFormat::BC1_UNORM:
+	case DDSFormat::BC1_UNORM_SRGB:
+	case DDSFormat::BC4_TYPELESS:
+	case DDSFormat::BC4_UNORM:
+	case DDSFormat::BC4_SNORM:
+		return 4;
+
+	case DDSFormat::BC2_TYPELESS:
+	case DDSFormat::BC2_UNORM:
+	case DDSFormat::BC2_UNORM_SRGB:
+	case DDSFormat::BC3_TYPELESS:
+	case DDSFormat::BC3_UNORM:
+	case DDSFormat::BC3_UNORM_SRGB:
+	case DDSFormat::BC5_TYPELESS:
+	case DDSFormat::BC5_UNORM:
+	case DDSFormat::BC5_SNORM:
+	case DDSFormat::BC6H_TYPELESS:
+	case DDSFormat::BC6H_UF16:
+	case DDSFormat::BC6H_SF16:
+	case DDSFormat::BC7_TYPELESS:
+	case DDSFormat::BC7_UNORM:
+	case DDSFormat::BC7_UNORM_SRGB:
+		return 8;
+
+	default:
+		return 0;
+	}
+}
+
+bool DDSParser::IsBlockCompressed(DDSFormat format)
+{
+	return (format >= DDSFormat::BC1_TYPELESS && format <= DDSFormat::BC5_SNORM) ||
+		(format >= DDSFormat::BC6H_TYPELESS && format <= DDSFormat::BC7_UNORM_SRGB);
+}
+
+void DDSParser::SurfaceInfo(
+	std::uint32_t width,
+	std::uint32_t height,
+	DDSFormat format,
+	std::size_t& rowPitch,
+	std::uint32_t& rowCount,
+	std::size_t& slicePitch)
+{
+	if (IsBlockCompressed(format)) {
+		// 8 or 16 bytes per 4x4 block
+		std::size_t blockBytes = BitsPerPixel(format) * 2;
+		rowPitch = std::max<std::size_t>(1, ((std::size_t)width + 3) / 4) * blockBytes;
+		rowCount = std::max<std::uint32_t>(1, (height + 3) / 4);
+	}
+	else if (format == DDSFormat::R8G8_B8G8_UNORM || format == DDSFormat::G8R8_G8B8_UNORM) {
+		// two pixels share four bytes
+		rowPitch = (((std::size_t)width + 1) >> 1) * 4;
+		rowCount = height;
+	}
+	else {
+		rowPitch = ((std::size_t)width * BitsPerPixel(format) + 7) / 8;
+		rowCount = height;
+	}
+	slicePitch = rowPitch * rowCount;
+}
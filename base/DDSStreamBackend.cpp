@@ -0,0 +1,256 @@
+#include "DDSStreamBackend.h"
+#include "Common/MathHelper.h"
+
+#include <algorithm>
+#include <cstring>
+
+DDSStreamBackend::DDSStreamBackend(ID3D12Device* device) :
+	mDevice(device)
+{
+}
+
+HRESULT DDSStreamBackend::Add(TextureStreamer& streamer, const wchar_t* fileName, std::uint32_t& id)
+{
+	id = TextureStreamer::InvalidId;
+
+	auto entry = std::make_unique<Entry>();
+	if (!entry->File.Open(fileName))
+		return entry->File.Error() != 0 ? HRESULT_FROM_WIN32(entry->File.Error()) : E_FAIL;
+
+	switch (DDSParser::Parse(entry->File.Data(), entry->File.Size(), entry->Parsed)) {
+	case DDSResult::Ok:
+		break;
+	case DDSResult::UnsupportedFormat:
+	case DDSResult::UnsupportedDimension:
+		return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+	case DDSResult::Truncated:
+		return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+	default:
+		return E_FAIL;
+	}
+
+	// one mip chain, the streamer has no notion of slices
+	const DDSTexture& parsed = entry->Parsed;
+	if (parsed.Type != DDSTexture::Dimension::Texture2D || parsed.ArraySize != 1)
+		return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+	// no texture until the tail arrives, the SRV reads zeros
+	entry->VisibleMip = parsed.MipCount;
+	entry->ResourceMip = parsed.MipCount;
+
+	// the tail may be read inside Register() already, the entry has to be there
+	const std::uint32_t index = (std::uint32_t)mEntries.size();
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mEntries.push_back(std::move(entry));
+	}
+
+	id = streamer.Register(parsed.Format, parsed.Width, parsed.Height, parsed.MipCount);
+	if (id != index) {
+		id = TextureStreamer::InvalidId;
+		return E_FAIL;
+	}
+	return S_OK;
+}
+
+void DDSStreamBackend::SetDescriptor(std::uint32_t texture, D3D12_CPU_DESCRIPTOR_HANDLE descriptor)
+{
+	Entry& entry = GetEntry(texture);
+	entry.Descriptor = descriptor;
+	WriteDescriptor(entry);
+}
+
+void DDSStreamBackend::Record(ID3D12GraphicsCommandList* cmdList)
+{
+	mUploadBuffer = nullptr;
+	mRetired.clear();
+
+	std::vector<Entry*> dirty;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (auto& entry : mEntries) {
+			if (entry->Dirty)
+				dirty.push_back(entry.get());
+		}
+	}
+	for (Entry* entry : dirty) {
+		const std::uint32_t top = TopMip(*entry);
+		if (top != entry->ResourceMip)
+			Resize(*entry, top, cmdList);
+	}
+
+	// mips evicted again before their copy have no place left
+	mPending.erase(std::remove_if(mPending.begin(), mPending.end(), [this](const PendingCopy& copy) {
+		return copy.Mip < GetEntry(copy.Texture).ResourceMip;
+	}), mPending.end());
+
+	if (!mPending.empty()) {
+		// every pending mip in one upload buffer, at its copyable footprint
+		std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(mPending.size());
+		std::vector<UINT> rowCounts(mPending.size());
+		std::vector<UINT64> rowSizes(mPending.size());
+		UINT64 uploadSize = 0;
+		for (std::size_t i = 0; i < mPending.size(); ++i) {
+			const Entry& entry = GetEntry(mPending[i].Texture);
+			const D3D12_RESOURCE_DESC desc = entry.Resource->GetDesc();
+			UINT64 bytes = 0;
+			mDevice->GetCopyableFootprints(&desc, mPending[i].Mip - entry.ResourceMip, 1, uploadSize, &footprints[i], &rowCounts[i], &rowSizes[i], &bytes);
+			const UINT64 alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+			uploadSize = (footprints[i].Offset + bytes + alignment - 1) / alignment * alignment;
+		}
+
+		ThrowIfFailed(mDevice->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(uploadSize),
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(mUploadBuffer.GetAddressOf())));
+		d3dUtil::TrackResource(mUploadBuffer.Get(), MemoryTracker::Category::UploadHeap);
+
+		BYTE* mapped = nullptr;
+		ThrowIfFailed(mUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mapped)));
+		for (std::size_t i = 0; i < mPending.size(); ++i) {
+			const PendingCopy& copy = mPending[i];
+			const std::size_t rowPitch = GetEntry(copy.Texture).Parsed.Subresources[copy.Mip].RowPitch;
+			const std::size_t rowBytes = MathHelper::Min(rowPitch, (std::size_t)rowSizes[i]);
+			for (UINT row = 0; row < rowCounts[i]; ++row) {
+				std::memcpy(mapped + footprints[i].Offset + (UINT64)row * footprints[i].Footprint.RowPitch,
+					copy.Data.data() + row * rowPitch, rowBytes);
+			}
+		}
+		mUploadBuffer->Unmap(0, nullptr);
+
+		for (std::size_t i = 0; i < mPending.size(); ++i) {
+			const Entry& entry = GetEntry(mPending[i].Texture);
+			ID3D12Resource* resource = entry.Resource.Get();
+			const UINT subresource = mPending[i].Mip - entry.ResourceMip;
+			cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(resource,
+				D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_DEST, subresource));
+
+			CD3DX12_TEXTURE_COPY_LOCATION dst(resource, subresource);
+			CD3DX12_TEXTURE_COPY_LOCATION src(mUploadBuffer.Get(), footprints[i]);
+			cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+
+			cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(resource,
+				D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, subresource));
+		}
+		mPending.clear();
+	}
+
+	for (Entry* entry : dirty) {
+		WriteDescriptor(*entry);
+		entry->Dirty = false;
+	}
+}
+
+ID3D12Resource* DDSStreamBackend::Resource(std::uint32_t texture)const
+{
+	return GetEntry(texture).Resource.Get();
+}
+
+bool DDSStreamBackend::Read(std::uint32_t texture, std::uint32_t mip, std::vector<std::uint8_t>& data)
+{
+	const Entry& entry = GetEntry(texture);
+	if (mip >= entry.Parsed.Subresources.size())
+		return false;
+
+	const DDSSubresource& subresource = entry.Parsed.Subresources[mip];
+	const std::uint8_t* bytes = entry.Parsed.Data + subresource.Offset;
+	data.assign(bytes, bytes + subresource.SlicePitch);
+	return true;
+}
+
+void DDSStreamBackend::Upload(std::uint32_t texture, std::uint32_t mip, const std::vector<std::uint8_t>& data)
+{
+	PendingCopy copy;
+	copy.Texture = texture;
+	copy.Mip = mip;
+	copy.Data = data;
+	mPending.push_back(std::move(copy));
+
+	Entry& entry = GetEntry(texture);
+	entry.VisibleMip = MathHelper::Min(entry.VisibleMip, mip);
+	entry.Dirty = true;
+}
+
+void DDSStreamBackend::Evict(std::uint32_t texture, std::uint32_t mip)
+{
+	// the texture shrinks in the next Record(), until then the GPU can still read the old one
+	Entry& entry = GetEntry(texture);
+	entry.VisibleMip = mip;
+	entry.Dirty = true;
+}
+
+DDSStreamBackend::Entry& DDSStreamBackend::GetEntry(std::uint32_t texture)const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return *mEntries.at(texture);
+}
+
+void DDSStreamBackend::Resize(Entry& entry, std::uint32_t top, ID3D12GraphicsCommandList* cmdList)
+{
+	const DDSTexture& parsed = entry.Parsed;
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+	ThrowIfFailed(mDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Tex2D(static_cast<DXGI_FORMAT>(parsed.Format),
+			MathHelper::Max(1u, parsed.Width >> top), MathHelper::Max(1u, parsed.Height >> top), 1, (UINT16)(parsed.MipCount - top)),
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(resource.GetAddressOf())));
+	d3dUtil::TrackResource(resource.Get(), MemoryTracker::Category::Texture);
+
+	// the mips both textures hold, the rest comes with the pending copies
+	if (entry.Resource) {
+		cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(entry.Resource.Get(),
+			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE));
+		for (std::uint32_t mip = MathHelper::Max(top, entry.ResourceMip); mip < parsed.MipCount; ++mip) {
+			CD3DX12_TEXTURE_COPY_LOCATION dst(resource.Get(), mip - top);
+			CD3DX12_TEXTURE_COPY_LOCATION src(entry.Resource.Get(), mip - entry.ResourceMip);
+			cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+		}
+		mRetired.push_back(entry.Resource);
+	}
+	cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(resource.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+	entry.Resource = resource;
+	entry.ResourceMip = top;
+}
+
+void DDSStreamBackend::WriteDescriptor(Entry& entry)
+{
+	if (entry.Descriptor.ptr == 0)
+		return;
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Format = static_cast<DXGI_FORMAT>(entry.Parsed.Format);
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	if (entry.Resource) {
+		srvDesc.Texture2D.MipLevels = entry.Parsed.MipCount - entry.ResourceMip;
+		srvDesc.Texture2D.ResourceMinLODClamp = (float)(entry.VisibleMip - entry.ResourceMip);
+	}
+	else {
+		srvDesc.Texture2D.MipLevels = 1;
+	}
+	mDevice->CreateShaderResourceView(entry.Resource.Get(), &srvDesc, entry.Descriptor);
+}
+
+std::uint32_t DDSStreamBackend::TopMip(const Entry& entry)
+{
+	const DDSTexture& parsed = entry.Parsed;
+	if (entry.VisibleMip >= parsed.MipCount)
+		return entry.ResourceMip;
+
+	// block compressed textures need whole blocks at their top mip, mip 0 is what the file has
+	std::uint32_t top = entry.VisibleMip;
+	if (DDSParser::IsBlockCompressed(parsed.Format)) {
+		while (top > 0 && (MathHelper::Max(1u, parsed.Width >> top) % 4 != 0 || MathHelper::Max(1u, parsed.Height >> top) % 4 != 0))
+			top--;
+	}
+	return top;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Common/d3dUtil.h"
+#include "DDSParser.h"
+#include "MappedFile.h"
+#include "TextureStreamer.h"
+
+// TextureStreamer::Backend for 2D DDS files on D3D12. A mip is read straight out of the mapped
+// file when the streamer asks for it and copied into the texture on the next Record(). Each
+// texture only holds its resident mips: whenever they change, Record() creates a texture for the
+// new range, copies over the mips both have on the GPU and lets the old one go, so an eviction
+// gives its video memory back. Block compressed textures start at a mip of whole 4x4 blocks and
+// may keep a few finer mips than resident, the SRV is clamped to the resident ones.
+// Every texture of the streamer has to come through Add().
+class DDSStreamBackend : public TextureStreamer::Backend
+{
+public:
+	explicit DDSStreamBackend(ID3D12Device* device);
+
+	DDSStreamBackend(const DDSStreamBackend& rhs) = delete;
+	DDSStreamBackend& operator=(const DDSStreamBackend& rhs) = delete;
+
+	// Maps fileName and registers it with streamer, which queues the tail.
+	// id: the streamer's id of the texture.
+	HRESULT Add(TextureStreamer& streamer, const wchar_t* fileName, std::uint32_t& id);
+
+	// Where the SRV of the texture lives. Written right away (a null SRV before the tail arrives)
+	// and again by Record() whenever the resident mips change.
+	void SetDescriptor(std::uint32_t texture, D3D12_CPU_DESCRIPTOR_HANDLE descriptor);
+
+	// Resizes the textures whose resident mips changed, records the copies of the mips uploaded
+	// since the last call and rewrites the SRVs. Call after TextureStreamer::Update() once the GPU
+	// is done with the previous Record(): its upload buffer and the textures it replaced are
+	// released here and the SRVs are changed in place.
+	void Record(ID3D12GraphicsCommandList* cmdList);
+
+	// nullptr before the tail arrives, a different resource after every resize.
+	ID3D12Resource* Resource(std::uint32_t texture)const;
+
+	bool Read(std::uint32_t texture, std::uint32_t mip, std::vector<std::uint8_t>& data) override;
+	void Upload(std::uint32_t texture, std::uint32_t mip, const std::vector<std::uint8_t>& data) override;
+	void Evict(std::uint32_t texture, std::uint32_t mip) override;
+
+private:
+	struct Entry
+	{
+		MappedFile File;
+		DDSTexture Parsed;							// points into File
+		Microsoft::WRL::ComPtr<ID3D12Resource> Resource;	// mips [ResourceMip, MipCount) of the file
+		D3D12_CPU_DESCRIPTOR_HANDLE Descriptor = {};
+		std::uint32_t ResourceMip = 0;				// file mip of the resource's mip 0
+		std::uint32_t VisibleMip = 0;				// finest resident mip, MipCount for none
+		bool Dirty = false;							// resource and SRV to update in Record()
+	};
+
+	struct PendingCopy
+	{
+		std::uint32_t Texture = 0;
+		std::uint32_t Mip = 0;
+		std::vector<std::uint8_t> Data;
+	};
+
+	Entry& GetEntry(std::uint32_t texture)const;
+	void Resize(Entry& entry, std::uint32_t top, ID3D12GraphicsCommandList* cmdList);
+	void WriteDescriptor(Entry& entry);
+	static std::uint32_t TopMip(const Entry& entry);
+
+	ID3D12Device* mDevice = nullptr;
+
+	// Add() grows it while the workers read
+	mutable std::mutex mMutex;
+	std::vector<std::unique_ptr<Entry>> mEntries;
+
+	std::vector<PendingCopy> mPending;
+	Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> mRetired;	// replaced by the last Record()
+};
@@ -0,0 +1,79 @@
+#include "DDSWriter.h"
+#include "DDSHeader.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DDSHeader;
+
+std::size_t DDSWriter::DataSize(DDSFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t mipCount)
+{
+	std::size_t size = 0;
+	for (std::uint32_t mip = 0; mip < mipCount; ++mip) {
+		std::size_t rowPitch, slicePitch;
+		std::uint32_t rowCount;
+		DDSParser::SurfaceInfo(std::max(width >> mip, 1u), std::max(height >> mip, 1u), format, rowPitch, rowCount, slicePitch);
+		size += slicePitch;
+	}
+	return size;
+}
+
+bool DDSWriter::Write(
+	DDSFormat format,
+	std::uint32_t width,
+	std::uint32_t height,
+	std::uint32_t mipCount,
+	const void* data,
+	std::size_t size,
+	std::vector<std::uint8_t>& file)
+{
+	if (DDSParser::BitsPerPixel(format) == 0 || width == 0 || height == 0 || mipCount == 0)
+		return false;
+	if (size != DataSize(format, width, height, mipCount))
+		return false;
+
+	std::size_t rowPitch, slicePitch;
+	std::uint32_t rowCount;
+	DDSParser::SurfaceInfo(width, height, format, rowPitch, rowCount, slicePitch);
+
+	Header header = {};
+	header.Size = sizeof(Header);
+	header.Flags = HeaderFlagsCaps | HeaderFlagsHeight | HeaderFlagsWidth | HeaderFlagsPixelFormat | HeaderFlagsLinearSize;
+	header.Height = height;
+	header.Width = width;
+	header.PitchOrLinearSize = (std::uint32_t)slicePitch;
+	header.Depth = 1;
+	header.MipMapCount = mipCount;
+	header.Format.Size = sizeof(PixelFormat);
+	header.Format.Flags = PixelFormatFourCC;
+	header.Format.FourCC = FourCC('D', 'X', '1', '0');
+	header.Caps = CapsTexture;
+	if (mipCount > 1) {
+		header.Flags |= HeaderFlagsMipMapCount;
+		header.Caps |= CapsComplex | CapsMipMap;
+	}
+
+	HeaderDXT10 extension = {};
+	extension.Format = (std::uint32_t)format;
+	extension.ResourceDimension = Dimension2D;
+	extension.ArraySize = 1;
+
+	file.resize(sizeof(Magic) + sizeof(header) + sizeof(extension) + size);
+	std::uint8_t* out = file.data();
+	std::memcpy(out, &Magic, sizeof(Magic));
+	out += sizeof(Magic);
+	std::memcpy(out, &header, sizeof(header));
+	out += sizeof(header);
+	std::memcpy(out, &extension, sizeof(extension));
+	out += sizeof(extension);
+	if (size > 0)
+		std::memcpy(out, data, size);
+
+	// the limits on sizes and mips are the parser's
+	DDSTexture texture;
+	if (DDSParser::Parse(file.data(), file.size(), texture) != DDSResult::Ok) {
+		file.clear();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DDSParser.h"
+
+// 2D textures as DDS files with the DX10 header, which DDSParser and DDSTextureLoader read back.
+class DDSWriter
+{
+public:
+	// Bytes of mipCount levels of a width x height texture, as DDSParser lays them out.
+	static std::size_t DataSize(DDSFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t mipCount);
+
+	// data holds the levels back to back from the largest one. False when its size doesn't match
+	// DataSize() or the texture is something DDSParser would refuse.
+	static bool Write(
+		DDSFormat format,
+		std::uint32_t width,
+		std::uint32_t height,
+		std::uint32_t mipCount,
+		const void* data,
+		std::size_t size,
+		std::vector<std::uint8_t>& file);
+
+private:
+	DDSWriter() = delete;
+	~DDSWriter() = delete;
+};
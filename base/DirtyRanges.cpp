@@ -0,0 +1,75 @@
+#include "DirtyRanges.h"
+
+#include <algorithm>
+
+DirtyRangeTracker::DirtyRangeTracker(std::uint32_t elementCount, int frameCount) :
+	mPendingFrames(elementCount, 0),
+	mPending(frameCount)
+{
+	assert(frameCount > 0 && frameCount <= 8);
+	mAllFrames = (std::uint8_t)((1u << frameCount) - 1);
+}
+
+void DirtyRangeTracker::MarkDirty(std::uint32_t index)
+{
+	std::uint8_t missing = mAllFrames & ~mPendingFrames[index];
+	if (missing == 0)
+		return;
+
+	mPendingFrames[index] |= missing;
+	for (int f = 0; f < (int)mPending.size(); ++f) {
+		if (missing & (1u << f))
+			mPending[f].push_back(index);
+	}
+}
+
+void DirtyRangeTracker::MarkAllDirty()
+{
+	for (std::uint32_t i = 0; i < (std::uint32_t)mPendingFrames.size(); ++i)
+		MarkDirty(i);
+}
+
+std::uint32_t DirtyRangeTracker::PendingCount(int frameIndex)const
+{
+	return (std::uint32_t)mPending[frameIndex].size();
+}
+
+const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::Collect(int frameIndex)
+{
+	mRanges.clear();
+
+	auto& pending = mPending[frameIndex];
+	if (pending.empty())
+		return mRanges;
+
+	const std::uint8_t bit = (std::uint8_t)(1u << frameIndex);
+	const std::uint32_t elementCount = (std::uint32_t)mPendingFrames.size();
+
+	auto addIndex = [this](std::uint32_t index)
+	{
+		if (!mRanges.empty() && mRanges.back().First + mRanges.back().Count == index)
+			mRanges.back().Count++;
+		else
+			mRanges.push_back({ index, 1 });
+	};
+
+	if (pending.size() * 16 > elementCount) {
+		// dense: walking the flags in order is cheaper than sorting
+		for (std::uint32_t i = 0; i < elementCount; ++i) {
+			if (mPendingFrames[i] & bit) {
+				mPendingFrames[i] &= ~bit;
+				addIndex(i);
+			}
+		}
+	}
+	else {
+		std::sort(pending.begin(), pending.end());
+		for (std::uint32_t index : pending) {
+			mPendingFrames[index] &= ~bit;
+			addIndex(index);
+		}
+	}
+
+	pending.clear();
+	return mRanges;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Remembers which elements changed, separately for every frame resource, and hands them back as
+// sorted runs of adjacent indices. Marking costs one byte test per element, clean elements cost nothing.
+class DirtyRangeTracker
+{
+public:
+	struct Range
+	{
+		std::uint32_t First = 0;
+		std::uint32_t Count = 0;
+	};
+
+	DirtyRangeTracker(std::uint32_t elementCount, int frameCount);
+
+	void MarkDirty(std::uint32_t index);
+	void MarkAllDirty();
+
+	std::uint32_t PendingCount(int frameIndex)const;
+
+	// Ranges still missing from frameIndex. They count as uploaded afterwards.
+	const std::vector<Range>& Collect(int frameIndex);
+
+private:
+	std::vector<std::uint8_t> mPendingFrames;			// bit f: queued for frame resource f
+	std::vector<std::vector<std::uint32_t>> mPending;	// per frame resource, unsorted
+	std::vector<Range> mRanges;
+	std::uint8_t mAllFrames = 0;
+};
+
+// CPU copy of a per object buffer laid out like UploadBuffer<T> (256 byte elements for constant
+// buffers), so dirty ranges go to the mapped memory with one memcpy each.
+template<typename T>
+class ConstantBufferMirror
+{
+public:
+	ConstantBufferMirror(std::uint32_t elementCount, int frameCount, bool isConstantBuffer) :
+		mTracker(elementCount, frameCount)
+	{
+		mElementByteSize = sizeof(T);
+		if (isConstantBuffer)
+			mElementByteSize = (sizeof(T) + 255) & ~255;
+
+		mData.resize((size_t)mElementByteSize * elementCount);
+	}
+
+	void Set(std::uint32_t index, const T& data)
+	{
+		std::memcpy(&mData[(size_t)index * mElementByteSize], &data, sizeof(T));
+		mTracker.MarkDirty(index);
+	}
+
+	const T& Get(std::uint32_t index)const
+	{
+		return *reinterpret_cast<const T*>(&mData[(size_t)index * mElementByteSize]);
+	}
+
+	// Copies what frameIndex hasn't seen yet. Returns the number of bytes written.
+	size_t Upload(int frameIndex, std::uint8_t* mappedData, [[maybe_unused]] std::uint32_t mappedElementByteSize)
+	{
+		assert(mappedElementByteSize == mElementByteSize);
+
+		size_t bytes = 0;
+		for (const auto& range : mTracker.Collect(frameIndex)) {
+			size_t offset = (size_t)range.First * mElementByteSize;
+			size_t size = (size_t)range.Count * mElementByteSize;
+			std::memcpy(mappedData + offset, mData.data() + offset, size);
+			bytes += size;
+		}
+		return bytes;
+	}
+
+	std::uint32_t PendingCount(int frameIndex)const
+	{
+		return mTracker.PendingCount(frameIndex);
+	}
+
+private:
+	std::vector<std::uint8_t> mData;
+	std::uint32_t mElementByteSize = 0;
+	DirtyRangeTracker mTracker;
+};
@@ -0,0 +1,114 @@
+#include "ImageDecoder.h"
+#include "DDSParser.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <wincodec.h>
+#include <wrl/client.h>
+
+#pragma comment(lib, "windowscodecs.lib")
+#endif
+
+namespace
+{
+	// Top level of uncompressed 8 bit RGBA and BGRA files.
+	bool DecodeDDS(TextureCache::Image& image)
+	{
+		DDSTexture texture;
+		if (DDSParser::Parse(image.File.data(), image.File.size(), texture) != DDSResult::Ok ||
+			texture.Type != DDSTexture::Dimension::Texture2D)
+			return false;
+
+		bool bgra = false, opaque = false;
+		switch (texture.Format) {
+		case DDSFormat::R8G8B8A8_UNORM:
+		case DDSFormat::R8G8B8A8_UNORM_SRGB:
+			break;
+		case DDSFormat::B8G8R8A8_UNORM:
+		case DDSFormat::B8G8R8A8_UNORM_SRGB:
+			bgra = true;
+			break;
+		case DDSFormat::B8G8R8X8_UNORM:
+		case DDSFormat::B8G8R8X8_UNORM_SRGB:
+			bgra = opaque = true;
+			break;
+		default:
+			return false;
+		}
+
+		const DDSSubresource& top = texture.Subresources[0];
+		image.Width = top.Width;
+		image.Height = top.Height;
+		image.Pixels.resize((size_t)top.Width * top.Height * 4);
+		for (std::uint32_t y = 0; y < top.Height; ++y) {
+			const std::uint8_t* in = texture.Data + top.Offset + y * top.RowPitch;
+			std::uint8_t* out = &image.Pixels[(size_t)y * top.Width * 4];
+			std::memcpy(out, in, (size_t)top.Width * 4);
+			for (std::uint32_t x = 0; x < top.Width; ++x, out += 4) {
+				if (bgra)
+					std::swap(out[0], out[2]);
+				if (opaque)
+					out[3] = 255;
+			}
+		}
+		return true;
+	}
+
+#ifdef _WIN32
+	// The formats WIC reads (jpg, png, bmp, tga with codecs installed...), from any thread.
+	bool DecodeWithWic(TextureCache::Image& image)
+	{
+		HRESULT init = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+		bool decoded = false;
+		{
+			Microsoft::WRL::ComPtr<IWICImagingFactory> factory;
+			Microsoft::WRL::ComPtr<IWICStream> stream;
+			Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+			Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+			Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+			UINT width = 0, height = 0;
+
+			decoded =
+				SUCCEEDED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory))) &&
+				SUCCEEDED(factory->CreateStream(&stream)) &&
+				SUCCEEDED(stream->InitializeFromMemory(image.File.data(), (DWORD)image.File.size())) &&
+				SUCCEEDED(factory->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &decoder)) &&
+				SUCCEEDED(decoder->GetFrame(0, &frame)) &&
+				SUCCEEDED(factory->CreateFormatConverter(&converter)) &&
+				SUCCEEDED(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA,
+					WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom)) &&
+				SUCCEEDED(converter->GetSize(&width, &height));
+
+			if (decoded) {
+				image.Width = width;
+				image.Height = height;
+				image.Pixels.resize((size_t)width * height * 4);
+				decoded = SUCCEEDED(converter->CopyPixels(nullptr, width * 4, (UINT)image.Pixels.size(), image.Pixels.data()));
+			}
+		}
+		if (SUCCEEDED(init))
+			CoUninitialize();
+		return decoded;
+	}
+#endif
+}
+
+bool ImageDecoder::IsDDS(const std::vector<std::uint8_t>& file)
+{
+	return file.size() >= 4 && std::memcmp(file.data(), "DDS ", 4) == 0;
+}
+
+bool ImageDecoder::Decode(TextureCache::Image& image)
+{
+	if (IsDDS(image.File))
+		return DecodeDDS(image);
+
+#ifdef _WIN32
+	return DecodeWithWic(image);
+#else
+	return false;
+#endif
+}
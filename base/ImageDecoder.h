@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "TextureCache.h"
+
+// Image files to RGBA8 pixels, usable as a TextureCache::Decoder. Uncompressed 8 bit DDS files are
+// read everywhere, every other format goes through WIC on Windows and fails elsewhere.
+class ImageDecoder
+{
+public:
+	// Fills image.Width, Height and Pixels from image.File. Block compressed DDS files have no pixels to give.
+	static bool Decode(TextureCache::Image& image);
+
+	static bool IsDDS(const std::vector<std::uint8_t>& file);
+
+private:
+	ImageDecoder() = delete;
+	~ImageDecoder() = delete;
+};
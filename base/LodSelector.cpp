@@ -0,0 +1,66 @@
+#include "LodSelector.h"
+
+#include <cfloat>
+
+using namespace DirectX;
+
+LodSelector::LodSelector(float pixelError, float hysteresis) :
+	mPixelError(pixelError),
+	mHysteresis(hysteresis)
+{
+}
+
+void XM_CALLCONV LodSelector::SetProjection(FXMMATRIX proj, float viewportHeight)
+{
+	XMFLOAT4X4 p;
+	XMStoreFloat4x4(&p, proj);
+
+	// _22 = 1 / tan(fovY / 2)
+	mScale = p._22 * 0.5f * viewportHeight;
+}
+
+float LodSelector::ProjectedSize(float radius, float distance)const
+{
+	// inside the bounds, always full detail
+	if (distance <= radius)
+		return FLT_MAX;
+
+	return radius * mScale / distance;
+}
+
+std::uint32_t LodSelector::Select(
+	const float* errors,
+	std::uint32_t lodCount,
+	std::size_t errorStride,
+	float projectedSize,
+	std::uint32_t current)const
+{
+	auto error = [&](std::uint32_t level)
+	{
+		const auto* bytes = reinterpret_cast<const std::uint8_t*>(errors) + level * errorStride;
+		return *reinterpret_cast<const float*>(bytes) * projectedSize;
+	};
+
+	if (current >= lodCount)
+		current = lodCount - 1;
+
+	// the coarsest level that is still accurate enough
+	std::uint32_t target = 0;
+	for (std::uint32_t level = lodCount; level-- > 0; ) {
+		if (error(level) <= mPixelError) {
+			target = level;
+			break;
+		}
+	}
+
+	if (target <= current)
+		return target;
+
+	// going coarser needs some margin
+	std::uint32_t coarser = current;
+	for (std::uint32_t level = current + 1; level <= target; ++level) {
+		if (error(level) <= mPixelError * (1.0f - mHysteresis))
+			coarser = level;
+	}
+	return coarser;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <DirectXMath.h>
+
+// Picks a discrete level of detail from how big an object appears on screen.
+// A level is good enough while its error, scaled by the projected radius, stays under pixelError.
+class LodSelector
+{
+public:
+	// hysteresis: a coarser level is only taken once its error is this fraction below pixelError,
+	// so objects sitting on a threshold don't switch back and forth every frame.
+	explicit LodSelector(float pixelError = 1.0f, float hysteresis = 0.25f);
+
+	// proj as returned by Camera::GetProj(). Call again whenever the lens or the viewport changes.
+	void XM_CALLCONV SetProjection(DirectX::FXMMATRIX proj, float viewportHeight);
+
+	// Radius in pixels of a sphere at the given distance from the eye.
+	float ProjectedSize(float radius, float distance)const;
+
+	// errors: error of every level relative to the object radius, ascending, errorStride bytes apart.
+	// current: level the object used last frame.
+	std::uint32_t Select(
+		const float* errors,
+		std::uint32_t lodCount,
+		std::size_t errorStride,
+		float projectedSize,
+		std::uint32_t current)const;
+
+private:
+	float mPixelError;
+	float mHysteresis;
+
+	// proj._22 * viewportHeight / 2, pixels per unit at distance 1
+	float mScale = 1.0f;
+};
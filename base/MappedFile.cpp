@@ -0,0 +1,148 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	Open(path);
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept :
+	mData(std::exchange(rhs.mData, nullptr)),
+	mSize(std::exchange(rhs.mSize, 0)),
+	mOpen(std::exchange(rhs.mOpen, false)),
+	mError(std::exchange(rhs.mError, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+	if (this != &rhs) {
+		Close();
+		mData = std::exchange(rhs.mData, nullptr);
+		mSize = std::exchange(rhs.mSize, 0);
+		mOpen = std::exchange(rhs.mOpen, false);
+		mError = std::exchange(rhs.mError, 0);
+	}
+	return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	// the view keeps the mapping alive, the handles are closed right away
+#ifdef _WIN32
+	// the error is kept before CloseHandle(), which may reset it
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		mError = (int)GetLastError();
+		return false;
+	}
+
+	LARGE_INTEGER size = {};
+	if (!GetFileSizeEx(file, &size) || (unsigned long long)size.QuadPart > SIZE_MAX) {
+		mError = size.QuadPart > 0 ? ERROR_FILE_TOO_LARGE : (int)GetLastError();
+		CloseHandle(file);
+		return false;
+	}
+
+	if (size.QuadPart > 0) {
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping != nullptr) {
+			mData = (const std::uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (mData == nullptr)
+				mError = (int)GetLastError();
+			CloseHandle(mapping);
+		}
+		else {
+			mError = (int)GetLastError();
+		}
+	}
+	CloseHandle(file);
+
+	if (size.QuadPart > 0 && mData == nullptr)
+		return false;
+	mSize = (std::size_t)size.QuadPart;
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		mError = errno;
+		return false;
+	}
+
+	struct stat info;
+	const bool found = fstat(file, &info) == 0;
+	if (!found || !S_ISREG(info.st_mode)) {
+		mError = !found ? errno : S_ISDIR(info.st_mode) ? EISDIR : EINVAL;
+		::close(file);
+		return false;
+	}
+
+	if (info.st_size > 0) {
+		void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (view == MAP_FAILED) {
+			mError = errno;
+			::close(file);
+			return false;
+		}
+		mData = (const std::uint8_t*)view;
+	}
+	::close(file);
+	mSize = (std::size_t)info.st_size;
+#endif
+
+	mOpen = true;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (mData != nullptr) {
+#ifdef _WIN32
+		UnmapViewOfFile(mData);
+#else
+		munmap((void*)mData, mSize);
+#endif
+	}
+	mData = nullptr;
+	mSize = 0;
+	mOpen = false;
+	mError = 0;
+}
+
+bool MappedFile::IsOpen()const
+{
+	return mOpen;
+}
+
+const std::uint8_t* MappedFile::Data()const
+{
+	return mData;
+}
+
+std::size_t MappedFile::Size()const
+{
+	return mSize;
+}
+
+int MappedFile::Error()const
+{
+	return mError;
+}
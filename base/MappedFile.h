@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// Read-only view of a whole file mapped into memory, so parsers can work on it in place.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile& rhs) = delete;
+	MappedFile& operator=(const MappedFile& rhs) = delete;
+	MappedFile(MappedFile&& rhs) noexcept;
+	MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+	// False when the file can't be opened or mapped. An empty file opens with Data() == nullptr.
+	bool Open(const std::filesystem::path& path);
+	void Close();
+
+	bool IsOpen()const;
+	const std::uint8_t* Data()const;
+	std::size_t Size()const;
+
+	// Why the last Open() failed: GetLastError() on Windows, errno elsewhere. 0 after a successful
+	// Open(), the handles closed since may have changed the thread's own value.
+	int Error()const;
+
+private:
+	const std::uint8_t* mData = nullptr;
+	std::size_t mSize = 0;
+	bool mOpen = false;
+	int mError = 0;
+};
@@ -0,0 +1,223 @@
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+	std::string FormatBytes(std::int64_t bytes)
+	{
+		char buffer[32];
+		double value = (double)bytes;
+		if (std::abs(bytes) >= (1ll << 20)) {
+			std::snprintf(buffer, sizeof(buffer), "%.2f MB", value / (1 << 20));
+		}
+		else if (std::abs(bytes) >= (1ll << 10)) {
+			std::snprintf(buffer, sizeof(buffer), "%.2f KB", value / (1 << 10));
+		}
+		else {
+			std::snprintf(buffer, sizeof(buffer), "%lld B", (long long)bytes);
+		}
+		return buffer;
+	}
+}
+
+MemoryTracker& MemoryTracker::Get()
+{
+	static MemoryTracker tracker;
+	return tracker;
+}
+
+const char* MemoryTracker::CategoryName(Category category)
+{
+	switch (category)
+	{
+	case Category::MeshGeometryCpu: return "MeshGeometry CPU";
+	case Category::FrameArena:      return "Frame arena";
+	case Category::Pool:            return "Pool";
+	case Category::TextureCacheCpu: return "TextureCache CPU";
+	case Category::DefaultBuffer:   return "Default buffer";
+	case Category::UploadHeap:      return "Upload heap";
+	case Category::UploadBuffer:    return "UploadBuffer";
+	case Category::RenderTexture:   return "RenderTexture";
+	case Category::Texture:         return "Texture";
+	default:                        return "Unknown";
+	}
+}
+
+bool MemoryTracker::IsGpu(Category category)
+{
+	return category >= Category::DefaultBuffer;
+}
+
+void MemoryTracker::Allocate(Category category, std::size_t bytes)
+{
+	BudgetCallback callback;
+	Stats stats;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		Counter& counter = mCounters[(int)category];
+		counter.Data.Current += (std::int64_t)bytes;
+		counter.Data.Peak = std::max(counter.Data.Peak, counter.Data.Current);
+		counter.Data.AllocationCount++;
+
+		// Only alert when crossing the budget, not on every allocation above it.
+		bool overBudget = counter.Data.Budget > 0 && counter.Data.Current > counter.Data.Budget;
+		if (overBudget && !counter.OverBudget) {
+			callback = mBudgetCallback;
+			stats = counter.Data;
+		}
+		counter.OverBudget = overBudget;
+	}
+
+	if (stats.Budget > 0) {
+		if (callback) {
+			callback(category, stats);
+		}
+		else {
+			std::cerr << "MemoryTracker: " << CategoryName(category) << " over budget, "
+				<< FormatBytes(stats.Current) << " / " << FormatBytes(stats.Budget) << std::endl;
+		}
+	}
+}
+
+void MemoryTracker::Free(Category category, std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	Counter& counter = mCounters[(int)category];
+	counter.Data.Current -= (std::int64_t)bytes;
+	counter.OverBudget = counter.Data.Budget > 0 && counter.Data.Current > counter.Data.Budget;
+}
+
+void MemoryTracker::SetBudget(Category category, std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCounters[(int)category].Data.Budget = (std::int64_t)bytes;
+}
+
+void MemoryTracker::SetBudgetCallback(BudgetCallback callback)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mBudgetCallback = std::move(callback);
+}
+
+void MemoryTracker::BeginFrame()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (auto& counter : mCounters) {
+		counter.Data.FrameDelta = counter.Data.Current - counter.FrameStart;
+		counter.FrameStart = counter.Data.Current;
+	}
+}
+
+MemoryTracker::Stats MemoryTracker::GetStats(Category category)const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mCounters[(int)category].Data;
+}
+
+std::int64_t MemoryTracker::TotalCurrent(bool gpu)const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	std::int64_t total = 0;
+	for (int i = 0; i < (int)Category::Count; i++) {
+		if (IsGpu((Category)i) == gpu) {
+			total += mCounters[i].Data.Current;
+		}
+	}
+	return total;
+}
+
+std::string MemoryTracker::Report()const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	std::string report;
+	char line[256];
+	std::snprintf(line, sizeof(line), "%-4s %-18s %12s %12s %12s %12s\n",
+		"", "Category", "Current", "Peak", "Budget", "Frame delta");
+	report += line;
+
+	std::int64_t totals[2] = { 0, 0 };
+	for (int i = 0; i < (int)Category::Count; i++) {
+		const Stats& stats = mCounters[i].Data;
+		bool gpu = IsGpu((Category)i);
+		totals[gpu] += stats.Current;
+
+		std::snprintf(line, sizeof(line), "%-4s %-18s %12s %12s %12s %12s%s\n",
+			gpu ? "GPU" : "CPU",
+			CategoryName((Category)i),
+			FormatBytes(stats.Current).c_str(),
+			FormatBytes(stats.Peak).c_str(),
+			stats.Budget > 0 ? FormatBytes(stats.Budget).c_str() : "-",
+			FormatBytes(stats.FrameDelta).c_str(),
+			mCounters[i].OverBudget ? "  OVER BUDGET" : "");
+		report += line;
+	}
+
+	std::snprintf(line, sizeof(line), "Total CPU %s, GPU %s\n",
+		FormatBytes(totals[0]).c_str(), FormatBytes(totals[1]).c_str());
+	report += line;
+
+	return report;
+}
+
+void MemoryTracker::Reset()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCounters = {};
+}
+
+TrackedAllocation::TrackedAllocation(MemoryTracker::Category category, std::size_t bytes)
+{
+	Reset(category, bytes);
+}
+
+TrackedAllocation::~TrackedAllocation()
+{
+	Reset();
+}
+
+TrackedAllocation::TrackedAllocation(TrackedAllocation&& rhs) noexcept :
+	mCategory(rhs.mCategory),
+	mBytes(rhs.mBytes)
+{
+	rhs.mCategory = MemoryTracker::Category::Count;
+	rhs.mBytes = 0;
+}
+
+TrackedAllocation& TrackedAllocation::operator=(TrackedAllocation&& rhs) noexcept
+{
+	if (this != &rhs) {
+		Reset();
+		mCategory = rhs.mCategory;
+		mBytes = rhs.mBytes;
+		rhs.mCategory = MemoryTracker::Category::Count;
+		rhs.mBytes = 0;
+	}
+	return *this;
+}
+
+void TrackedAllocation::Reset(MemoryTracker::Category category, std::size_t bytes)
+{
+	Reset();
+	mCategory = category;
+	mBytes = bytes;
+	MemoryTracker::Get().Allocate(mCategory, mBytes);
+}
+
+void TrackedAllocation::Reset()
+{
+	if (mCategory != MemoryTracker::Category::Count) {
+		MemoryTracker::Get().Free(mCategory, mBytes);
+	}
+	mCategory = MemoryTracker::Category::Count;
+	mBytes = 0;
+}
+
+std::size_t TrackedAllocation::Bytes()const
+{
+	return mBytes;
+}
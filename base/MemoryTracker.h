@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Byte counters per subsystem. CPU memory is reported by the owner (see TrackedAllocation),
+// GPU resources are registered through d3dUtil::TrackResource and released with the resource.
+class MemoryTracker
+{
+public:
+	enum class Category : int
+	{
+		// CPU
+		MeshGeometryCpu = 0,
+		FrameArena,
+		Pool,
+		TextureCacheCpu,
+
+		// GPU
+		DefaultBuffer,
+		UploadHeap,
+		UploadBuffer,
+		RenderTexture,
+		Texture,
+
+		Count
+	};
+
+	struct Stats
+	{
+		std::int64_t Current = 0;
+		std::int64_t Peak = 0;
+		std::int64_t Budget = 0;		// 0 means no budget
+		std::int64_t FrameDelta = 0;	// change during the last finished frame
+		std::uint64_t AllocationCount = 0;
+	};
+
+	using BudgetCallback = std::function<void(Category category, const Stats& stats)>;
+
+	static MemoryTracker& Get();
+
+	static const char* CategoryName(Category category);
+	static bool IsGpu(Category category);
+
+	void Allocate(Category category, std::size_t bytes);
+	void Free(Category category, std::size_t bytes);
+
+	void SetBudget(Category category, std::size_t bytes);
+	void SetBudgetCallback(BudgetCallback callback);
+
+	// Call once per frame, closes the delta of the previous frame.
+	void BeginFrame();
+
+	Stats GetStats(Category category)const;
+	std::int64_t TotalCurrent(bool gpu)const;
+
+	// Table of every category with current/peak/budget and the last frame delta.
+	std::string Report()const;
+
+	void Reset();
+
+private:
+	MemoryTracker() = default;
+
+	struct Counter
+	{
+		Stats Data;
+		std::int64_t FrameStart = 0;
+		bool OverBudget = false;
+	};
+
+	mutable std::mutex mMutex;
+	std::array<Counter, (int)Category::Count> mCounters;
+	BudgetCallback mBudgetCallback;
+};
+
+// Owns a tracked byte count and gives it back on destruction.
+class TrackedAllocation
+{
+public:
+	TrackedAllocation() = default;
+	TrackedAllocation(MemoryTracker::Category category, std::size_t bytes);
+	~TrackedAllocation();
+
+	TrackedAllocation(const TrackedAllocation& rhs) = delete;
+	TrackedAllocation& operator=(const TrackedAllocation& rhs) = delete;
+	TrackedAllocation(TrackedAllocation&& rhs) noexcept;
+	TrackedAllocation& operator=(TrackedAllocation&& rhs) noexcept;
+
+	void Reset(MemoryTracker::Category category, std::size_t bytes);
+	void Reset();
+
+	std::size_t Bytes()const;
+
+private:
+	MemoryTracker::Category mCategory = MemoryTracker::Category::Count;
+	std::size_t mBytes = 0;
+};
@@ -0,0 +1,391 @@
+#include "MeshCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define MESH_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Index stream: one code byte per triangle, then its payload.
+	//   bits 0-3  edge FIFO entry the triangle shares, FreeTriangle when none
+	//   bits 4-5  which edge of the triangle it is, the third vertex follows it
+	//   bits 6-7  how the third vertex is stored
+	// A free triangle has FreeTriangle in the low bits and AllNext or Explicit in the high ones,
+	// Explicit is followed by a byte with the kind of each vertex (2 bits each).
+	const std::uint8_t FreeTriangle = 0x0F;
+	const std::uint8_t AllNext = 0x00;
+	const std::uint8_t Explicit = 0x10;
+
+	const std::uint32_t EdgeFifoSize = 16;		// only 15 are addressable, 15 means none
+	const std::uint32_t VertexFifoSize = 16;
+
+	enum VertexKind : std::uint8_t
+	{
+		KindNext = 0,		// the next vertex never seen before, no payload
+		KindFifo = 1,		// one of the last vertices, payload is its FIFO position
+		KindDelta = 2		// zigzag varint of the difference to the last new vertex
+	};
+
+	struct Edge
+	{
+		std::uint32_t First = UINT32_MAX;
+		std::uint32_t Second = UINT32_MAX;
+	};
+
+	struct IndexState
+	{
+		Edge Edges[EdgeFifoSize];
+		std::uint32_t EdgeHead = 0;
+		std::uint32_t Vertices[VertexFifoSize];
+		std::uint32_t VertexHead = 0;
+		std::uint32_t Next = 0;
+		std::uint32_t Last = 0;
+
+		IndexState() { std::fill(std::begin(Vertices), std::end(Vertices), UINT32_MAX); }
+
+		const Edge& RecentEdge(std::uint32_t age)const { return Edges[(EdgeHead - 1 - age) % EdgeFifoSize]; }
+		std::uint32_t RecentVertex(std::uint32_t age)const { return Vertices[(VertexHead - 1 - age) % VertexFifoSize]; }
+
+		void PushTriangle(std::uint32_t a, std::uint32_t b, std::uint32_t c)
+		{
+			// the reverse of each edge is what a neighbour would share
+			Edges[EdgeHead++ % EdgeFifoSize] = { b, a };
+			Edges[EdgeHead++ % EdgeFifoSize] = { c, b };
+			Edges[EdgeHead++ % EdgeFifoSize] = { a, c };
+		}
+
+		void PushVertex(std::uint32_t index)
+		{
+			Vertices[VertexHead++ % VertexFifoSize] = index;
+			Last = index;
+		}
+	};
+
+	std::uint32_t ZigZag(std::int32_t v) { return ((std::uint32_t)v << 1) ^ (std::uint32_t)(v >> 31); }
+	std::int32_t UnZigZag(std::uint32_t v) { return (std::int32_t)(v >> 1) ^ -(std::int32_t)(v & 1); }
+
+	void WriteVarint(std::vector<std::uint8_t>& out, std::uint32_t v)
+	{
+		while (v >= 0x80) {
+			out.push_back((std::uint8_t)(v | 0x80));
+			v >>= 7;
+		}
+		out.push_back((std::uint8_t)v);
+	}
+
+	bool ReadVarint(const std::uint8_t*& data, const std::uint8_t* end, std::uint32_t& v)
+	{
+		v = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			if (data == end)
+				return false;
+			std::uint8_t byte = *data++;
+			v |= (std::uint32_t)(byte & 0x7F) << shift;
+			if (byte < 0x80)
+				return true;
+		}
+		return false;
+	}
+
+	// Picks the cheapest kind for index and appends its payload.
+	std::uint8_t EncodeVertex(IndexState& state, std::uint32_t index, std::vector<std::uint8_t>& payload)
+	{
+		if (index == state.Next) {
+			state.Next++;
+			state.PushVertex(index);
+			return KindNext;
+		}
+		for (std::uint32_t age = 0; age < VertexFifoSize; ++age) {
+			if (state.RecentVertex(age) == index) {
+				payload.push_back((std::uint8_t)age);
+				return KindFifo;
+			}
+		}
+		WriteVarint(payload, ZigZag((std::int32_t)(index - state.Last)));
+		state.Next = std::max(state.Next, index + 1);
+		state.PushVertex(index);
+		return KindDelta;
+	}
+
+	bool DecodeVertex(IndexState& state, std::uint8_t kind, const std::uint8_t*& data, const std::uint8_t* end, std::uint32_t& index)
+	{
+		switch (kind) {
+		case KindNext:
+			index = state.Next++;
+			state.PushVertex(index);
+			return true;
+		case KindFifo:
+			if (data == end || *data >= VertexFifoSize)
+				return false;
+			index = state.RecentVertex(*data++);
+			return index != UINT32_MAX;
+		case KindDelta: {
+			std::uint32_t zigzag;
+			if (!ReadVarint(data, end, zigzag))
+				return false;
+			index = state.Last + (std::uint32_t)UnZigZag(zigzag);
+			state.Next = std::max(state.Next, index + 1);
+			state.PushVertex(index);
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	// Vertex stream: blocks of BlockVertices vertices. Per block and byte of the vertex, a header with
+	// the bit width of each group of 16 deltas (2 bits per group) followed by the packed groups.
+	const std::size_t BlockVertices = 256;
+	const std::size_t GroupSize = 16;
+	const std::size_t GroupsPerBlock = BlockVertices / GroupSize;
+	const std::size_t HeaderBytes = GroupsPerBlock / 4;
+
+	// bytes taken by a group for each width code: 0, 2, 4 and 8 bits
+	const std::size_t GroupBytes[4] = { 0, 4, 8, 16 };
+
+	std::uint8_t ZigZag8(std::uint8_t v) { return (std::uint8_t)((v << 1) ^ (std::uint8_t)((std::int8_t)v >> 7)); }
+
+	void EncodeGroup(const std::uint8_t* zigzag, std::vector<std::uint8_t>& out, std::uint8_t& width)
+	{
+		std::uint8_t maxValue = *std::max_element(zigzag, zigzag + GroupSize);
+		width = maxValue == 0 ? 0 : maxValue < 4 ? 1 : maxValue < 16 ? 2 : 3;
+
+		switch (width) {
+		case 1:
+			for (std::size_t i = 0; i < GroupSize; i += 4)
+				out.push_back((std::uint8_t)(zigzag[i] | zigzag[i + 1] << 2 | zigzag[i + 2] << 4 | zigzag[i + 3] << 6));
+			break;
+		case 2:
+			for (std::size_t i = 0; i < GroupSize; i += 2)
+				out.push_back((std::uint8_t)(zigzag[i] | zigzag[i + 1] << 4));
+			break;
+		case 3:
+			out.insert(out.end(), zigzag, zigzag + GroupSize);
+			break;
+		}
+	}
+
+	// Unpacks a group, undoes the zigzag and the delta starting from last. Returns the 16 bytes in out.
+	void DecodeGroup(const std::uint8_t* data, std::uint8_t width, std::uint8_t& last, std::uint8_t* out)
+	{
+#ifdef MESH_CODEC_SSE2
+		__m128i z;
+		switch (width) {
+		case 0:
+			z = _mm_setzero_si128();
+			break;
+		case 1: {
+			std::int32_t packed;
+			std::memcpy(&packed, data, sizeof(packed));
+			__m128i b = _mm_cvtsi32_si128(packed);
+			__m128i mask = _mm_set1_epi8(3);
+			__m128i f0 = _mm_and_si128(b, mask);
+			__m128i f1 = _mm_and_si128(_mm_srli_epi16(b, 2), mask);
+			__m128i f2 = _mm_and_si128(_mm_srli_epi16(b, 4), mask);
+			__m128i f3 = _mm_and_si128(_mm_srli_epi16(b, 6), mask);
+			z = _mm_unpacklo_epi16(_mm_unpacklo_epi8(f0, f1), _mm_unpacklo_epi8(f2, f3));
+			break;
+		}
+		case 2: {
+			__m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+			__m128i mask = _mm_set1_epi8(15);
+			z = _mm_unpacklo_epi8(_mm_and_si128(b, mask), _mm_and_si128(_mm_srli_epi16(b, 4), mask));
+			break;
+		}
+		default:
+			z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+			break;
+		}
+
+		// (z >> 1) ^ -(z & 1) per byte
+		__m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(z, _mm_set1_epi8(1)));
+		__m128i d = _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(z, 1), _mm_set1_epi8(0x7F)), sign);
+
+		// inclusive prefix sum of the 16 deltas
+		d = _mm_add_epi8(d, _mm_slli_si128(d, 1));
+		d = _mm_add_epi8(d, _mm_slli_si128(d, 2));
+		d = _mm_add_epi8(d, _mm_slli_si128(d, 4));
+		d = _mm_add_epi8(d, _mm_slli_si128(d, 8));
+		d = _mm_add_epi8(d, _mm_set1_epi8((char)last));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), d);
+		last = out[GroupSize - 1];
+#else
+		for (std::size_t i = 0; i < GroupSize; ++i) {
+			std::uint8_t z = 0;
+			switch (width) {
+			case 1: z = (data[i / 4] >> (i % 4 * 2)) & 3; break;
+			case 2: z = (data[i / 2] >> (i % 2 * 4)) & 15; break;
+			case 3: z = data[i]; break;
+			}
+			last = (std::uint8_t)(last + ((z >> 1) ^ (std::uint8_t)-(z & 1)));
+			out[i] = last;
+		}
+#endif
+	}
+}
+
+std::vector<std::uint8_t> MeshCodec::EncodeIndices(const std::uint32_t* indices, std::size_t indexCount)
+{
+	std::vector<std::uint8_t> out;
+	out.reserve(indexCount);
+
+	IndexState state;
+	std::vector<std::uint8_t> payload;
+	for (std::size_t t = 0; t + 2 < indexCount; t += 3) {
+		const std::uint32_t* tri = indices + t;
+		payload.clear();
+
+		bool shared = false;
+		for (std::uint32_t age = 0; age < FreeTriangle && !shared; ++age) {
+			const Edge& edge = state.RecentEdge(age);
+			for (std::uint32_t r = 0; r < 3; ++r) {
+				if (edge.First == tri[r] && edge.Second == tri[(r + 1) % 3]) {
+					std::uint8_t kind = EncodeVertex(state, tri[(r + 2) % 3], payload);
+					out.push_back((std::uint8_t)(age | r << 4 | kind << 6));
+					shared = true;
+					break;
+				}
+			}
+		}
+
+		if (!shared) {
+			if (tri[0] == state.Next && tri[1] == state.Next + 1 && tri[2] == state.Next + 2) {
+				for (int k = 0; k < 3; ++k)
+					EncodeVertex(state, tri[k], payload);
+				out.push_back(FreeTriangle | AllNext);
+			}
+			else {
+				std::uint8_t kinds = 0;
+				for (int k = 0; k < 3; ++k)
+					kinds |= (std::uint8_t)(EncodeVertex(state, tri[k], payload) << (k * 2));
+				out.push_back(FreeTriangle | Explicit);
+				out.push_back(kinds);
+			}
+		}
+
+		out.insert(out.end(), payload.begin(), payload.end());
+		state.PushTriangle(tri[0], tri[1], tri[2]);
+	}
+	return out;
+}
+
+bool MeshCodec::DecodeIndices(const std::uint8_t* data, std::size_t size, std::uint32_t* indices, std::size_t indexCount)
+{
+	const std::uint8_t* end = data + size;
+	IndexState state;
+	for (std::size_t t = 0; t + 2 < indexCount; t += 3) {
+		std::uint32_t* tri = indices + t;
+		if (data == end)
+			return false;
+		std::uint8_t code = *data++;
+
+		if ((code & 0x0F) != FreeTriangle) {
+			const Edge& edge = state.RecentEdge(code & 0x0F);
+			std::uint32_t r = (code >> 4) & 3;
+			if (edge.First == UINT32_MAX || r > 2)
+				return false;
+			tri[r] = edge.First;
+			tri[(r + 1) % 3] = edge.Second;
+			if (!DecodeVertex(state, code >> 6, data, end, tri[(r + 2) % 3]))
+				return false;
+		}
+		else if ((code & 0xF0) == AllNext) {
+			for (int k = 0; k < 3; ++k)
+				DecodeVertex(state, KindNext, data, end, tri[k]);
+		}
+		else if ((code & 0xF0) == Explicit) {
+			if (data == end)
+				return false;
+			std::uint8_t kinds = *data++;
+			for (int k = 0; k < 3; ++k) {
+				if (!DecodeVertex(state, (kinds >> (k * 2)) & 3, data, end, tri[k]))
+					return false;
+			}
+		}
+		else {
+			return false;
+		}
+
+		state.PushTriangle(tri[0], tri[1], tri[2]);
+	}
+	return data == end;
+}
+
+std::vector<std::uint8_t> MeshCodec::EncodeVertices(const void* vertices, std::size_t vertexCount, std::size_t stride)
+{
+	std::vector<std::uint8_t> out;
+	if (stride == 0 || stride > MaxStride)
+		return out;
+
+	const std::uint8_t* bytes = static_cast<const std::uint8_t*>(vertices);
+	std::uint8_t last[MaxStride] = {};
+	std::uint8_t zigzag[BlockVertices];
+
+	for (std::size_t first = 0; first < vertexCount; first += BlockVertices) {
+		const std::size_t count = std::min(BlockVertices, vertexCount - first);
+		const std::size_t groups = (count + GroupSize - 1) / GroupSize;
+
+		for (std::size_t k = 0; k < stride; ++k) {
+			std::uint8_t previous = last[k];
+			for (std::size_t i = 0; i < groups * GroupSize; ++i) {
+				// padding past the end repeats the last byte, a zero delta
+				std::uint8_t value = i < count ? bytes[(first + i) * stride + k] : previous;
+				zigzag[i] = ZigZag8((std::uint8_t)(value - previous));
+				previous = value;
+			}
+			last[k] = previous;
+
+			const std::size_t header = out.size();
+			out.resize(out.size() + HeaderBytes, 0);
+			for (std::size_t g = 0; g < groups; ++g) {
+				std::uint8_t width;
+				EncodeGroup(zigzag + g * GroupSize, out, width);
+				out[header + g / 4] |= (std::uint8_t)(width << (g % 4 * 2));
+			}
+		}
+	}
+	return out;
+}
+
+bool MeshCodec::DecodeVertices(const std::uint8_t* data, std::size_t size, void* vertices, std::size_t vertexCount, std::size_t stride)
+{
+	if (stride == 0 || stride > MaxStride)
+		return false;
+
+	const std::uint8_t* end = data + size;
+	std::uint8_t* bytes = static_cast<std::uint8_t*>(vertices);
+	std::uint8_t last[MaxStride] = {};
+	std::uint8_t group[GroupSize];
+
+	for (std::size_t first = 0; first < vertexCount; first += BlockVertices) {
+		const std::size_t count = std::min(BlockVertices, vertexCount - first);
+		const std::size_t groups = (count + GroupSize - 1) / GroupSize;
+
+		for (std::size_t k = 0; k < stride; ++k) {
+			if ((std::size_t)(end - data) < HeaderBytes)
+				return false;
+			const std::uint8_t* header = data;
+			data += HeaderBytes;
+
+			for (std::size_t g = 0; g < groups; ++g) {
+				std::uint8_t width = (header[g / 4] >> (g % 4 * 2)) & 3;
+				if ((std::size_t)(end - data) < GroupBytes[width])
+					return false;
+
+				DecodeGroup(data, width, last[k], group);
+				data += GroupBytes[width];
+
+				std::uint8_t* column = bytes + (first + g * GroupSize) * stride + k;
+				const std::size_t n = std::min(GroupSize, count - g * GroupSize);
+				for (std::size_t i = 0; i < n; ++i)
+					column[i * stride] = group[i];
+			}
+		}
+	}
+	return data == end;
+}
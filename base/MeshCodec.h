@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Lossless compression of index and vertex buffers for meshes kept on disk, along the lines of
+// meshoptimizer's codecs. The output is byte aligned, so a general purpose compressor on top
+// still finds what is left. Decoding keeps no state between calls and can run on any thread.
+class MeshCodec
+{
+public:
+	// Triangle lists. A triangle sharing an edge with one of the last few and vertices used in order
+	// of first appearance cost the least, so meshes sorted for the vertex cache compress best.
+	static std::vector<std::uint8_t> EncodeIndices(const std::uint32_t* indices, std::size_t indexCount);
+	static bool DecodeIndices(const std::uint8_t* data, std::size_t size, std::uint32_t* indices, std::size_t indexCount);
+
+	// Any vertex layout up to MaxStride bytes. Each byte is delta coded against the same byte of the
+	// previous vertex and the deltas are bit packed in groups of 16. Decoding uses SSE2 where available.
+	static const std::size_t MaxStride = 256;
+
+	static std::vector<std::uint8_t> EncodeVertices(const void* vertices, std::size_t vertexCount, std::size_t stride);
+	static bool DecodeVertices(const std::uint8_t* data, std::size_t size, void* vertices, std::size_t vertexCount, std::size_t stride);
+
+private:
+	MeshCodec() = delete;
+	~MeshCodec() = delete;
+};
@@ -0,0 +1,343 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <unordered_map>
+
+namespace
+{
+	struct Vec3
+	{
+		double x, y, z;
+	};
+
+	Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+	Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+	double Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	double Length(const Vec3& a) { return std::sqrt(Dot(a, a)); }
+
+	// Symmetric 4x4 matrix stored as xx xy xz xw yy yz yw zz zw ww, plus the summed plane weights.
+	struct Quadric
+	{
+		double A[10] = {};
+		double Weight = 0.0;
+
+		void AddPlane(const Vec3& n, double d, double weight)
+		{
+			A[0] += weight * n.x * n.x; A[1] += weight * n.x * n.y; A[2] += weight * n.x * n.z; A[3] += weight * n.x * d;
+			A[4] += weight * n.y * n.y; A[5] += weight * n.y * n.z; A[6] += weight * n.y * d;
+			A[7] += weight * n.z * n.z; A[8] += weight * n.z * d;
+			A[9] += weight * d * d;
+			Weight += weight;
+		}
+
+		void Add(const Quadric& q)
+		{
+			for (int i = 0; i < 10; ++i)
+				A[i] += q.A[i];
+			Weight += q.Weight;
+		}
+
+		// Weighted sum of squared distances from p to the planes.
+		double Evaluate(const Vec3& p)const
+		{
+			double e =
+				A[0] * p.x * p.x + 2.0 * A[1] * p.x * p.y + 2.0 * A[2] * p.x * p.z + 2.0 * A[3] * p.x +
+				A[4] * p.y * p.y + 2.0 * A[5] * p.y * p.z + 2.0 * A[6] * p.y +
+				A[7] * p.z * p.z + 2.0 * A[8] * p.z +
+				A[9];
+			return e > 0.0 ? e : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		double Cost;
+		std::uint32_t From;
+		std::uint32_t To;
+		std::uint32_t FromVersion;
+		std::uint32_t ToVersion;
+
+		bool operator>(const Collapse& rhs)const { return Cost > rhs.Cost; }
+	};
+
+	struct PositionKey
+	{
+		float x, y, z;
+
+		bool operator==(const PositionKey& rhs)const { return std::memcmp(this, &rhs, sizeof(PositionKey)) == 0; }
+	};
+
+	struct PositionHash
+	{
+		size_t operator()(const PositionKey& key)const
+		{
+			std::uint32_t bits[3];
+			std::memcpy(bits, &key, sizeof(bits));
+			return (size_t)(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+		}
+	};
+
+	std::uint64_t EdgeKey(std::uint32_t a, std::uint32_t b)
+	{
+		if (a > b)
+			std::swap(a, b);
+		return ((std::uint64_t)a << 32) | b;
+	}
+
+	// Border planes weigh this much more than face planes, so open edges stay where they are.
+	const double gBoundaryWeight = 10.0;
+
+	// A collapse may turn a face by at most ~75 degrees.
+	const double gMinNormalCos = 0.25;
+}
+
+float MeshSimplifier::Simplify(
+	const std::vector<GeometryGenerator::Vertex>& vertices,
+	const std::vector<std::uint32_t>& indices,
+	std::size_t targetIndexCount,
+	float maxError,
+	std::vector<std::uint32_t>& destination)
+{
+	return Simplify(vertices.data(), vertices.size(), indices.data(), indices.size(), targetIndexCount, maxError, destination);
+}
+
+float MeshSimplifier::Simplify(
+	const GeometryGenerator::Vertex* vertices,
+	std::size_t vertexCount,
+	const std::uint32_t* indices,
+	std::size_t indexCount,
+	std::size_t targetIndexCount,
+	float maxError,
+	std::vector<std::uint32_t>& destination)
+{
+
+	// weld: every vertex points at the first vertex with the same position
+	std::vector<std::uint32_t> remap(vertexCount);
+	std::vector<Vec3> positions(vertexCount);
+	{
+		std::unordered_map<PositionKey, std::uint32_t, PositionHash> firstOf;
+		firstOf.reserve(vertexCount);
+		for (std::uint32_t i = 0; i < vertexCount; ++i) {
+			const auto& p = vertices[i].Position;
+			remap[i] = firstOf.emplace(PositionKey{ p.x, p.y, p.z }, i).first->second;
+			positions[i] = { p.x, p.y, p.z };
+		}
+	}
+
+	// ids are welded and drive the collapses, corners are what ends up in the index buffer
+	std::vector<std::uint32_t> ids, corners;
+	ids.reserve(indexCount);
+	corners.reserve(indexCount);
+	for (size_t i = 0; i + 2 < indexCount; i += 3) {
+		std::uint32_t a = remap[indices[i]], b = remap[indices[i + 1]], c = remap[indices[i + 2]];
+		if (a == b || b == c || a == c)
+			continue;
+
+		ids.insert(ids.end(), { a, b, c });
+		corners.insert(corners.end(), { indices[i], indices[i + 1], indices[i + 2] });
+	}
+	const std::uint32_t triangleCount = (std::uint32_t)ids.size() / 3;
+
+	auto faceNormal = [&](std::uint32_t a, std::uint32_t b, std::uint32_t c)
+	{
+		return Cross(Sub(positions[b], positions[a]), Sub(positions[c], positions[a]));
+	};
+
+	// every face adds its plane to its corners, weighted by area
+	std::vector<Quadric> quadrics(vertexCount);
+	std::vector<Vec3> normals(triangleCount, Vec3{ 0.0, 0.0, 0.0 });
+	for (std::uint32_t t = 0; t < triangleCount; ++t) {
+		const std::uint32_t* tri = &ids[t * 3];
+		Vec3 n = faceNormal(tri[0], tri[1], tri[2]);
+		double length = Length(n);
+		if (length == 0.0)
+			continue;
+
+		n = { n.x / length, n.y / length, n.z / length };
+		normals[t] = n;
+		for (int k = 0; k < 3; ++k)
+			quadrics[tri[k]].AddPlane(n, -Dot(n, positions[tri[0]]), length * 0.5);
+	}
+
+	// an edge used by one face only is a border, a plane through it perpendicular to the face holds it
+	std::unordered_map<std::uint64_t, std::uint32_t> edgeUse;
+	edgeUse.reserve(ids.size());
+	for (std::uint32_t t = 0; t < triangleCount; ++t) {
+		for (int k = 0; k < 3; ++k)
+			edgeUse[EdgeKey(ids[t * 3 + k], ids[t * 3 + (k + 1) % 3])]++;
+	}
+	for (std::uint32_t t = 0; t < triangleCount; ++t) {
+		for (int k = 0; k < 3; ++k) {
+			std::uint32_t a = ids[t * 3 + k], b = ids[t * 3 + (k + 1) % 3];
+			if (edgeUse[EdgeKey(a, b)] != 1)
+				continue;
+
+			Vec3 edge = Sub(positions[b], positions[a]);
+			Vec3 n = Cross(edge, normals[t]);
+			double length = Length(n);
+			if (length == 0.0)
+				continue;
+
+			n = { n.x / length, n.y / length, n.z / length };
+			double weight = Dot(edge, edge) * gBoundaryWeight;
+			quadrics[a].AddPlane(n, -Dot(n, positions[a]), weight);
+			quadrics[b].AddPlane(n, -Dot(n, positions[a]), weight);
+		}
+	}
+
+	std::vector<std::vector<std::uint32_t>> vertexTriangles(vertexCount);
+	for (std::uint32_t t = 0; t < triangleCount; ++t) {
+		for (int k = 0; k < 3; ++k)
+			vertexTriangles[ids[t * 3 + k]].push_back(t);
+	}
+
+	std::vector<std::uint8_t> triangleAlive(triangleCount, 1);
+	std::vector<std::uint8_t> vertexAlive(vertexCount, 1);
+	std::vector<std::uint32_t> versions(vertexCount, 0);
+
+	// Collapses onto existing vertices only, the cost is the merged quadric at the kept position.
+	auto collapseCost = [&](std::uint32_t from, std::uint32_t to)
+	{
+		Quadric q = quadrics[from];
+		q.Add(quadrics[to]);
+		return q.Weight > 0.0 ? q.Evaluate(positions[to]) / q.Weight : 0.0;
+	};
+
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+	auto pushEdge = [&](std::uint32_t a, std::uint32_t b)
+	{
+		double ab = collapseCost(a, b), ba = collapseCost(b, a);
+		if (ab <= ba)
+			heap.push({ ab, a, b, versions[a], versions[b] });
+		else
+			heap.push({ ba, b, a, versions[b], versions[a] });
+	};
+	for (const auto& edge : edgeUse)
+		pushEdge((std::uint32_t)(edge.first >> 32), (std::uint32_t)edge.first);
+
+	std::vector<std::uint32_t> fromNeighbours, toNeighbours, shared;
+	auto gatherNeighbours = [&](std::uint32_t v, std::vector<std::uint32_t>& neighbours)
+	{
+		neighbours.clear();
+		for (std::uint32_t t : vertexTriangles[v]) {
+			if (!triangleAlive[t])
+				continue;
+			for (int k = 0; k < 3; ++k) {
+				if (ids[t * 3 + k] != v)
+					neighbours.push_back(ids[t * 3 + k]);
+			}
+		}
+		std::sort(neighbours.begin(), neighbours.end());
+		neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+	};
+
+	auto contains = [&](std::uint32_t t, std::uint32_t v)
+	{
+		return ids[t * 3] == v || ids[t * 3 + 1] == v || ids[t * 3 + 2] == v;
+	};
+
+	const double maxCost = (double)maxError * maxError;
+	double error = 0.0;
+	std::uint32_t aliveCount = triangleCount;
+
+	while ((size_t)aliveCount * 3 > targetIndexCount && !heap.empty()) {
+		Collapse c = heap.top();
+		heap.pop();
+
+		// entries are never updated in place, anything touched since it was queued is skipped
+		if (!vertexAlive[c.From] || !vertexAlive[c.To] ||
+			versions[c.From] != c.FromVersion || versions[c.To] != c.ToVersion)
+			continue;
+
+		if (c.Cost > maxCost)
+			break;
+
+		// Link condition: the vertices both ends see have to be exactly the tips of the shared faces,
+		// otherwise the collapse pinches the surface.
+		std::uint32_t sharedFaces = 0;
+		for (std::uint32_t t : vertexTriangles[c.From]) {
+			if (triangleAlive[t] && contains(t, c.To))
+				sharedFaces++;
+		}
+		if (sharedFaces == 0)
+			continue;
+
+		gatherNeighbours(c.From, fromNeighbours);
+		gatherNeighbours(c.To, toNeighbours);
+		shared.clear();
+		std::set_intersection(fromNeighbours.begin(), fromNeighbours.end(),
+			toNeighbours.begin(), toNeighbours.end(), std::back_inserter(shared));
+		if (shared.size() != sharedFaces)
+			continue;
+
+		// no face around From may turn over
+		bool flips = false;
+		for (std::uint32_t t : vertexTriangles[c.From]) {
+			if (!triangleAlive[t] || contains(t, c.To))
+				continue;
+
+			std::uint32_t tri[3] = { ids[t * 3], ids[t * 3 + 1], ids[t * 3 + 2] };
+			Vec3 before = faceNormal(tri[0], tri[1], tri[2]);
+			for (int k = 0; k < 3; ++k) {
+				if (tri[k] == c.From)
+					tri[k] = c.To;
+			}
+			Vec3 after = faceNormal(tri[0], tri[1], tri[2]);
+
+			double lengths = Length(before) * Length(after);
+			if (lengths == 0.0 || Dot(before, after) < gMinNormalCos * lengths) {
+				flips = true;
+				break;
+			}
+		}
+		if (flips)
+			continue;
+
+		for (std::uint32_t t : vertexTriangles[c.From]) {
+			if (!triangleAlive[t])
+				continue;
+
+			if (contains(t, c.To)) {
+				triangleAlive[t] = 0;
+				aliveCount--;
+				continue;
+			}
+
+			for (int k = 0; k < 3; ++k) {
+				if (ids[t * 3 + k] == c.From) {
+					ids[t * 3 + k] = c.To;
+					corners[t * 3 + k] = c.To;
+				}
+			}
+			vertexTriangles[c.To].push_back(t);
+		}
+
+		vertexTriangles[c.From].clear();
+		vertexAlive[c.From] = 0;
+		quadrics[c.To].Add(quadrics[c.From]);
+		versions[c.To]++;
+		error = std::max(error, c.Cost);
+
+		auto& toTriangles = vertexTriangles[c.To];
+		toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(),
+			[&](std::uint32_t t) { return !triangleAlive[t]; }), toTriangles.end());
+
+		gatherNeighbours(c.To, toNeighbours);
+		for (std::uint32_t n : toNeighbours)
+			pushEdge(c.To, n);
+	}
+
+	destination.clear();
+	destination.reserve((size_t)aliveCount * 3);
+	for (std::uint32_t t = 0; t < triangleCount; ++t) {
+		if (triangleAlive[t])
+			destination.insert(destination.end(), { corners[t * 3], corners[t * 3 + 1], corners[t * 3 + 2] });
+	}
+
+	return (float)std::sqrt(error);
+}
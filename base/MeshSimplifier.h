@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Common/GeometryGenerator.h"
+
+// Quadric error metric edge collapse (Garland & Heckbert 97).
+// Vertices with the same position are welded first and every collapse moves a vertex onto one of
+// its neighbours, so the result indexes the input vertices and can share their vertex buffer.
+class MeshSimplifier
+{
+public:
+	// Collapses edges until at most targetIndexCount indices are left, or until the next collapse
+	// would cost more than maxError. Returns the error of the result as a distance in mesh units
+	// (root of the area weighted mean squared distance to the planes merged into a vertex).
+	static float Simplify(
+		const std::vector<GeometryGenerator::Vertex>& vertices,
+		const std::vector<std::uint32_t>& indices,
+		std::size_t targetIndexCount,
+		float maxError,
+		std::vector<std::uint32_t>& destination);
+
+	// The same over vertexCount vertices and indexCount indices into them, e.g. one mesh inside
+	// a merged vertex buffer.
+	static float Simplify(
+		const GeometryGenerator::Vertex* vertices,
+		std::size_t vertexCount,
+		const std::uint32_t* indices,
+		std::size_t indexCount,
+		std::size_t targetIndexCount,
+		float maxError,
+		std::vector<std::uint32_t>& destination);
+
+private:
+	MeshSimplifier() = delete;
+	~MeshSimplifier() = delete;
+};
@@ -0,0 +1,299 @@
+#include "Meshlets.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+using namespace DirectX;
+
+namespace
+{
+	struct PositionKey
+	{
+		float x, y, z;
+
+		bool operator==(const PositionKey& rhs)const { return std::memcmp(this, &rhs, sizeof(PositionKey)) == 0; }
+	};
+
+	struct PositionHash
+	{
+		size_t operator()(const PositionKey& key)const
+		{
+			std::uint32_t bits[3];
+			std::memcpy(bits, &key, sizeof(bits));
+			return (size_t)(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+		}
+	};
+
+	// Spread of the normals at which the cone stops being useful.
+	const float gMinConeDot = 0.1f;
+
+	void ComputeBounds(
+		const GeometryGenerator::Vertex* vertices,
+		const MeshletData& data,
+		const Meshlet& meshlet,
+		MeshletBounds& bounds)
+	{
+		XMFLOAT3 points[MeshletBuilder::MaxVertices];
+		for (std::uint32_t i = 0; i < meshlet.VertexCount; ++i)
+			points[i] = vertices[data.UniqueVertexIndices[meshlet.VertexOffset + i]].Position;
+
+		BoundingSphere sphere;
+		BoundingSphere::CreateFromPoints(sphere, meshlet.VertexCount, points, sizeof(XMFLOAT3));
+		bounds.Center = sphere.Center;
+		bounds.Radius = sphere.Radius;
+
+		// cone axis: average of the face normals
+		XMVECTOR normals[MeshletBuilder::MaxPrimitives];
+		XMVECTOR axis = XMVectorZero();
+		std::uint32_t normalCount = 0;
+		for (std::uint32_t i = 0; i < meshlet.PrimitiveCount; ++i) {
+			std::uint32_t i0, i1, i2;
+			MeshletBuilder::UnpackPrimitive(data.PrimitiveIndices[meshlet.PrimitiveOffset + i], i0, i1, i2);
+
+			XMVECTOR p0 = XMLoadFloat3(&points[i0]);
+			XMVECTOR n = XMVector3Cross(XMLoadFloat3(&points[i1]) - p0, XMLoadFloat3(&points[i2]) - p0);
+			if (XMVector3Equal(n, XMVectorZero()))
+				continue;
+
+			n = XMVector3Normalize(n);
+			normals[normalCount++] = n;
+			axis += n;
+		}
+
+		bounds.ConeAxis = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		bounds.ConeCutoff = 1.0f;
+		if (normalCount == 0 || XMVector3Equal(axis, XMVectorZero()))
+			return;
+
+		axis = XMVector3Normalize(axis);
+		float minDot = 1.0f;
+		for (std::uint32_t i = 0; i < normalCount; ++i)
+			minDot = std::min(minDot, XMVectorGetX(XMVector3Dot(normals[i], axis)));
+
+		if (minDot <= gMinConeDot)
+			return;
+
+		// The normals lie within acos(minDot) of the axis. The cluster is back facing when the view
+		// direction is more than 90 degrees beyond that, i.e. its cosine to the axis exceeds sin(acos(minDot)).
+		XMStoreFloat3(&bounds.ConeAxis, axis);
+		bounds.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+}
+
+std::uint32_t MeshletBuilder::PackPrimitive(std::uint32_t i0, std::uint32_t i1, std::uint32_t i2)
+{
+	return (i0 & 0x3FF) | ((i1 & 0x3FF) << 10) | ((i2 & 0x3FF) << 20);
+}
+
+void MeshletBuilder::UnpackPrimitive(std::uint32_t packed, std::uint32_t& i0, std::uint32_t& i1, std::uint32_t& i2)
+{
+	i0 = packed & 0x3FF;
+	i1 = (packed >> 10) & 0x3FF;
+	i2 = (packed >> 20) & 0x3FF;
+}
+
+void MeshletBuilder::Build(
+	const std::vector<GeometryGenerator::Vertex>& vertices,
+	const std::vector<std::uint32_t>& indices,
+	MeshletData& data)
+{
+	Build(vertices.data(), (std::uint32_t)vertices.size(), indices.data(), indices.size(), data);
+}
+
+void MeshletBuilder::Build(
+	const GeometryGenerator::Vertex* vertices,
+	std::uint32_t vertexCount,
+	const std::uint32_t* indices,
+	size_t indexCount,
+	MeshletData& data)
+{
+	data.Meshlets.clear();
+	data.Bounds.clear();
+	data.UniqueVertexIndices.clear();
+	data.PrimitiveIndices.clear();
+
+	const std::uint32_t triangleCount = (std::uint32_t)(indexCount / 3);
+
+	// triangles touching a position, for growing over unwelded seams
+	std::vector<std::uint32_t> positionIds(vertexCount);
+	std::uint32_t positionCount = 0;
+	{
+		std::unordered_map<PositionKey, std::uint32_t, PositionHash> idOf;
+		idOf.reserve(vertexCount);
+		for (std::uint32_t i = 0; i < vertexCount; ++i) {
+			const auto& p = vertices[i].Position;
+			auto inserted = idOf.emplace(PositionKey{ p.x, p.y, p.z }, positionCount);
+			positionIds[i] = inserted.first->second;
+			positionCount += inserted.second ? 1 : 0;
+		}
+	}
+
+	std::vector<std::uint32_t> trianglesOffset(positionCount + 1, 0), triangles(indexCount);
+	for (size_t i = 0; i < indexCount; ++i)
+		trianglesOffset[positionIds[indices[i]] + 1]++;
+	for (std::uint32_t i = 0; i < positionCount; ++i)
+		trianglesOffset[i + 1] += trianglesOffset[i];
+	{
+		std::vector<std::uint32_t> cursor(trianglesOffset.begin(), trianglesOffset.end() - 1);
+		for (std::uint32_t t = 0; t < triangleCount; ++t) {
+			for (int k = 0; k < 3; ++k)
+				triangles[cursor[positionIds[indices[t * 3 + k]]]++] = t;
+		}
+	}
+
+	std::vector<std::uint8_t> used(triangleCount, 0);
+	std::vector<std::int32_t> localIndex(vertexCount, -1);
+	std::vector<std::uint32_t> candidates;
+	std::uint32_t nextSeed = 0;
+
+	Meshlet meshlet;
+	auto newVertices = [&](std::uint32_t t)
+	{
+		std::uint32_t count = 0;
+		for (int k = 0; k < 3; ++k)
+			count += localIndex[indices[t * 3 + k]] < 0 ? 1 : 0;
+		return count;
+	};
+
+	auto flush = [&]()
+	{
+		for (std::uint32_t i = 0; i < meshlet.VertexCount; ++i)
+			localIndex[data.UniqueVertexIndices[meshlet.VertexOffset + i]] = -1;
+
+		data.Meshlets.push_back(meshlet);
+		data.Bounds.emplace_back();
+		ComputeBounds(vertices, data, meshlet, data.Bounds.back());
+
+		meshlet = Meshlet();
+		meshlet.VertexOffset = (std::uint32_t)data.UniqueVertexIndices.size();
+		meshlet.PrimitiveOffset = (std::uint32_t)data.PrimitiveIndices.size();
+		candidates.clear();
+	};
+
+	for (std::uint32_t added = 0; added < triangleCount; ++added) {
+		// best neighbour of the current meshlet, or the next unused triangle to start a new one
+		std::uint32_t best = UINT32_MAX, bestCost = UINT32_MAX;
+		for (std::uint32_t t : candidates) {
+			if (used[t])
+				continue;
+			std::uint32_t cost = newVertices(t);
+			if (cost < bestCost || (cost == bestCost && t < best)) {
+				best = t;
+				bestCost = cost;
+			}
+		}
+
+		if (best != UINT32_MAX &&
+			(meshlet.VertexCount + bestCost > MaxVertices || meshlet.PrimitiveCount + 1 > MaxPrimitives)) {
+			flush();
+			best = UINT32_MAX;
+		}
+
+		if (best == UINT32_MAX) {
+			if (meshlet.PrimitiveCount > 0)
+				flush();
+			while (used[nextSeed])
+				nextSeed++;
+			best = nextSeed;
+		}
+
+		std::uint32_t local[3];
+		for (int k = 0; k < 3; ++k) {
+			std::uint32_t index = indices[best * 3 + k];
+			if (localIndex[index] < 0) {
+				localIndex[index] = (std::int32_t)meshlet.VertexCount++;
+				data.UniqueVertexIndices.push_back(index);
+			}
+			local[k] = (std::uint32_t)localIndex[index];
+		}
+		data.PrimitiveIndices.push_back(PackPrimitive(local[0], local[1], local[2]));
+		meshlet.PrimitiveCount++;
+		used[best] = 1;
+
+		// everything sharing a position with the new triangle can join next
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+			[&](std::uint32_t t) { return used[t] != 0; }), candidates.end());
+		for (int k = 0; k < 3; ++k) {
+			std::uint32_t id = positionIds[indices[best * 3 + k]];
+			for (std::uint32_t i = trianglesOffset[id]; i < trianglesOffset[id + 1]; ++i) {
+				if (!used[triangles[i]])
+					candidates.push_back(triangles[i]);
+			}
+		}
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+
+	if (meshlet.PrimitiveCount > 0)
+		flush();
+}
+
+void XM_CALLCONV MeshletCuller::SetView(const BoundingFrustum& viewFrustum, FXMMATRIX invView)
+{
+	BoundingFrustum worldFrustum;
+	viewFrustum.Transform(worldFrustum, invView);
+
+	XMVECTOR planes[6];
+	worldFrustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+	for (int i = 0; i < 6; ++i)
+		XMStoreFloat4(&mPlanes[i], planes[i]);
+
+	XMStoreFloat3(&mEye, invView.r[3]);
+}
+
+std::uint32_t XM_CALLCONV MeshletCuller::Cull(
+	FXMMATRIX world,
+	const MeshletData& data,
+	std::uint32_t* visible,
+	Stats* stats)const
+{
+	// radius grows with the largest axis scale
+	float scale = std::sqrt(std::max(std::max(
+		XMVectorGetX(XMVector3LengthSq(world.r[0])),
+		XMVectorGetX(XMVector3LengthSq(world.r[1]))),
+		XMVectorGetX(XMVector3LengthSq(world.r[2]))));
+
+	XMVECTOR planes[6];
+	for (int i = 0; i < 6; ++i)
+		planes[i] = XMLoadFloat4(&mPlanes[i]);
+	XMVECTOR eye = XMLoadFloat3(&mEye);
+
+	std::uint32_t count = 0, frustumCulled = 0, coneCulled = 0;
+	const std::uint32_t size = (std::uint32_t)data.Bounds.size();
+	for (std::uint32_t i = 0; i < size; ++i) {
+		const MeshletBounds& bounds = data.Bounds[i];
+		XMVECTOR center = XMVector3Transform(XMLoadFloat3(&bounds.Center), world);
+		float radius = bounds.Radius * scale;
+
+		// planes point out of the frustum
+		bool outside = false;
+		for (int p = 0; p < 6 && !outside; ++p)
+			outside = XMVectorGetX(XMPlaneDotCoord(planes[p], center)) > radius;
+		if (outside) {
+			frustumCulled++;
+			continue;
+		}
+
+		if (bounds.ConeCutoff < 1.0f) {
+			XMVECTOR axis = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&bounds.ConeAxis), world));
+			XMVECTOR toCenter = center - eye;
+			if (XMVectorGetX(XMVector3Dot(toCenter, axis)) >=
+				bounds.ConeCutoff * XMVectorGetX(XMVector3Length(toCenter)) + radius) {
+				coneCulled++;
+				continue;
+			}
+		}
+
+		visible[count++] = i;
+	}
+
+	if (stats != nullptr) {
+		stats->Tested += size;
+		stats->FrustumCulled += frustumCulled;
+		stats->ConeCulled += coneCulled;
+	}
+	return count;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include "Common/GeometryGenerator.h"
+
+// Layout follows the D3D12 mesh shader samples, so the arrays can go to StructuredBuffers as they are.
+struct Meshlet
+{
+	std::uint32_t VertexCount = 0;
+	std::uint32_t VertexOffset = 0;		// into MeshletData::UniqueVertexIndices
+	std::uint32_t PrimitiveCount = 0;
+	std::uint32_t PrimitiveOffset = 0;	// into MeshletData::PrimitiveIndices
+};
+
+// Bounding sphere and normal cone of one meshlet, two float4s in HLSL.
+// The cluster faces away from the eye when dot(Center - eye, ConeAxis) >= ConeCutoff * |Center - eye| + Radius.
+struct MeshletBounds
+{
+	DirectX::XMFLOAT3 Center = { 0.0f, 0.0f, 0.0f };
+	float Radius = 0.0f;
+	DirectX::XMFLOAT3 ConeAxis = { 0.0f, 0.0f, 0.0f };
+	float ConeCutoff = 1.0f;			// 1 never culls, used when the normals spread too much
+};
+
+struct MeshletData
+{
+	std::vector<Meshlet> Meshlets;
+	std::vector<MeshletBounds> Bounds;
+
+	// Submesh vertex indices, VertexCount of them per meshlet.
+	std::vector<std::uint32_t> UniqueVertexIndices;
+
+	// One triangle per entry, three 10 bit indices into the meshlet's unique vertices.
+	std::vector<std::uint32_t> PrimitiveIndices;
+};
+
+class MeshletBuilder
+{
+public:
+	static const std::uint32_t MaxVertices = 64;
+	static const std::uint32_t MaxPrimitives = 124;
+
+	// Splits an indexed triangle list into meshlets. Each meshlet grows over the triangles touching it
+	// (by position, so unwelded meshes still give compact clusters), preferring those that add the fewest vertices.
+	static void Build(
+		const std::vector<GeometryGenerator::Vertex>& vertices,
+		const std::vector<std::uint32_t>& indices,
+		MeshletData& meshlets);
+
+	// Same over a range of a larger buffer, e.g. one submesh of ModelImporter's merged vertices.
+	static void Build(
+		const GeometryGenerator::Vertex* vertices,
+		std::uint32_t vertexCount,
+		const std::uint32_t* indices,
+		size_t indexCount,
+		MeshletData& meshlets);
+
+	static std::uint32_t PackPrimitive(std::uint32_t i0, std::uint32_t i1, std::uint32_t i2);
+	static void UnpackPrimitive(std::uint32_t packed, std::uint32_t& i0, std::uint32_t& i1, std::uint32_t& i2);
+
+private:
+	MeshletBuilder() = delete;
+	~MeshletBuilder() = delete;
+};
+
+// Per meshlet frustum and backface cone test for the CPU path.
+// The cone test assumes world matrices without non uniform scale.
+class MeshletCuller
+{
+public:
+	struct Stats
+	{
+		std::uint32_t Tested = 0;
+		std::uint32_t FrustumCulled = 0;
+		std::uint32_t ConeCulled = 0;
+	};
+
+	// viewFrustum in view space as used by Culling, invView moves it and the eye to world space.
+	void XM_CALLCONV SetView(const DirectX::BoundingFrustum& viewFrustum, DirectX::FXMMATRIX invView);
+
+	// Writes the indices of the meshlets that may be visible for an instance at world, returns the count.
+	std::uint32_t XM_CALLCONV Cull(
+		DirectX::FXMMATRIX world,
+		const MeshletData& meshlets,
+		std::uint32_t* visible,
+		Stats* stats = nullptr)const;
+
+private:
+	DirectX::XMFLOAT4 mPlanes[6];
+	DirectX::XMFLOAT3 mEye = { 0.0f, 0.0f, 0.0f };
+};
@@ -0,0 +1,311 @@
+#include "MipGenerator.h"
+#include "Parallel.h"
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+using namespace DirectX;
+
+namespace
+{
+	// rows handed to a worker at a time, and the level size below which threads cost more than they save
+	const std::size_t BandRows = 16;
+	const std::size_t MinParallelPixels = 64 * 1024;
+
+	const float KaiserLobes = 3.0f;
+	const float KaiserAlpha = 4.0f;
+
+	std::size_t AlignUp(std::size_t value, std::uint32_t alignment)
+	{
+		return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+	}
+
+	struct Tables
+	{
+		float ToUnorm[256];
+		float ToLinear[256];			// sRGB byte to linear
+		std::uint8_t ToSRGB[4096];		// linear quantized to 12 bits to sRGB, within one step of the exact curve
+	};
+
+	const Tables& GetTables()
+	{
+		static const Tables tables = []()
+		{
+			Tables t;
+			for (int i = 0; i < 256; ++i) {
+				float c = i / 255.0f;
+				t.ToUnorm[i] = c;
+				t.ToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			}
+			for (int i = 0; i < 4096; ++i) {
+				float c = i / 4095.0f;
+				float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+				t.ToSRGB[i] = (std::uint8_t)std::min(255.0f, s * 255.0f + 0.5f);
+			}
+			return t;
+		}();
+		return tables;
+	}
+
+	// modified Bessel function of the first kind, order 0
+	float BesselI0(float x)
+	{
+		float sum = 1.0f, term = 1.0f;
+		for (int k = 1; k < 32 && term > sum * 1e-7f; ++k) {
+			float f = x / (2.0f * k);
+			term *= f * f;
+			sum += term;
+		}
+		return sum;
+	}
+
+	float Sinc(float x)
+	{
+		if (std::abs(x) < 1e-5f)
+			return 1.0f;
+		x *= XM_PI;
+		return std::sin(x) / x;
+	}
+
+	// Source texels and weights of every output texel along one axis, clamped at the edges.
+	struct Kernel
+	{
+		struct Tap
+		{
+			std::uint32_t Index;
+			float Weight;
+		};
+
+		std::vector<Tap> Taps;
+		std::vector<std::size_t> First;		// taps of output i are [First[i], First[i + 1])
+	};
+
+	Kernel BuildKernel(std::uint32_t source, std::uint32_t target, MipGenerator::Filter filter)
+	{
+		Kernel kernel;
+		// the sinc is stretched over the larger texels, the output ones when shrinking
+		const float scale = (float)source / target;
+		const float stretch = std::max(scale, 1.0f);
+		const float radius = filter == MipGenerator::Filter::Box ? 0.5f * scale : KaiserLobes * stretch;
+
+		for (std::uint32_t i = 0; i < target; ++i) {
+			const std::size_t first = kernel.Taps.size();
+			kernel.First.push_back(first);
+
+			const float center = (i + 0.5f) * scale;
+			const int low = (int)std::floor(center - radius);
+			const int high = (int)std::ceil(center + radius);
+			float total = 0.0f;
+			for (int s = low; s < high; ++s) {
+				float weight;
+				if (filter == MipGenerator::Filter::Box) {
+					weight = std::min(center + radius, s + 1.0f) - std::max(center - radius, (float)s);
+				}
+				else {
+					float t = (s + 0.5f - center) / stretch;
+					float x = t / KaiserLobes;
+					weight = std::abs(x) >= 1.0f ? 0.0f :
+						Sinc(t) * BesselI0(KaiserAlpha * std::sqrt(1.0f - x * x)) / BesselI0(KaiserAlpha);
+				}
+				if (std::abs(weight) < 1e-6f)
+					continue;
+
+				std::uint32_t index = (std::uint32_t)std::min(std::max(s, 0), (int)source - 1);
+				kernel.Taps.push_back({ index, weight });
+				total += weight;
+			}
+
+			for (std::size_t tap = first; tap < kernel.Taps.size(); ++tap)
+				kernel.Taps[tap].Weight /= total;
+		}
+		kernel.First.push_back(kernel.Taps.size());
+		return kernel;
+	}
+
+	// fn(y) for every row, in bands on the workers when the level is big enough
+	void ForRows(std::uint32_t width, std::uint32_t height, unsigned threadCount, const std::function<void(std::size_t)>& fn)
+	{
+		if ((std::size_t)width * height < MinParallelPixels)
+			threadCount = 1;
+
+		const std::size_t bands = (height + BandRows - 1) / BandRows;
+		Parallel::For(bands, [&](std::size_t band) {
+			const std::size_t end = std::min<std::size_t>(height, (band + 1) * BandRows);
+			for (std::size_t y = band * BandRows; y < end; ++y)
+				fn(y);
+		}, threadCount);
+	}
+
+	void StorePixel(FXMVECTOR color, bool srgb, bool normalMap, const Tables& tables, std::uint8_t* pixel)
+	{
+		XMVECTOR c = color;
+		if (normalMap) {
+			XMVECTOR n = XMVectorMultiplyAdd(c, XMVectorReplicate(2.0f), XMVectorReplicate(-1.0f));
+			n = XMVectorGetX(XMVector3LengthSq(n)) > 1e-12f ? XMVector3Normalize(n) : XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+			n = XMVectorMultiplyAdd(n, XMVectorReplicate(0.5f), XMVectorReplicate(0.5f));
+			c = XMVectorSelect(c, n, g_XMSelect1110);
+		}
+
+		// rgb to a table index for sRGB, alpha always straight to a byte
+		const XMVECTOR scale = srgb ? XMVectorSet(4095.0f, 4095.0f, 4095.0f, 255.0f) : XMVectorReplicate(255.0f);
+		XMUINT4 q;
+		XMStoreUInt4(&q, XMConvertVectorFloatToUInt(XMVectorRound(XMVectorSaturate(c) * scale), 0));
+		if (srgb) {
+			pixel[0] = tables.ToSRGB[q.x];
+			pixel[1] = tables.ToSRGB[q.y];
+			pixel[2] = tables.ToSRGB[q.z];
+		}
+		else {
+			pixel[0] = (std::uint8_t)q.x;
+			pixel[1] = (std::uint8_t)q.y;
+			pixel[2] = (std::uint8_t)q.z;
+		}
+		pixel[3] = (std::uint8_t)q.w;
+	}
+
+	// Float copy of an image, linear for sRGB.
+	void LoadImage(
+		const std::uint8_t* source,
+		std::size_t rowPitch,
+		std::uint32_t width,
+		std::uint32_t height,
+		bool srgb,
+		unsigned threadCount,
+		std::vector<XMFLOAT4>& image)
+	{
+		const Tables& tables = GetTables();
+		const float* toFloat = srgb ? tables.ToLinear : tables.ToUnorm;
+
+		image.resize((std::size_t)width * height);
+		ForRows(width, height, threadCount, [&](std::size_t y) {
+			const std::uint8_t* in = source + y * rowPitch;
+			XMFLOAT4* out = &image[y * width];
+			for (std::uint32_t x = 0; x < width; ++x, in += 4)
+				out[x] = XMFLOAT4(toFloat[in[0]], toFloat[in[1]], toFloat[in[2]], tables.ToUnorm[in[3]]);
+		});
+	}
+
+	// Filters image from its size to width x height, into next and as RGBA8 into destination.
+	void Resample(
+		const std::vector<XMFLOAT4>& image,
+		std::uint32_t imageWidth,
+		std::uint32_t imageHeight,
+		std::uint32_t width,
+		std::uint32_t height,
+		const MipGenerator::Options& options,
+		std::vector<XMFLOAT4>& horizontal,
+		std::vector<XMFLOAT4>& next,
+		std::uint8_t* destination,
+		std::size_t rowPitch)
+	{
+		const Tables& tables = GetTables();
+		const bool srgb = options.SRGB && !options.NormalMap;
+		const Kernel columns = BuildKernel(imageWidth, width, options.Kernel);
+		const Kernel rows = BuildKernel(imageHeight, height, options.Kernel);
+
+		horizontal.resize((std::size_t)width * imageHeight);
+		ForRows(width, imageHeight, options.ThreadCount, [&](std::size_t y) {
+			const XMFLOAT4* in = &image[y * imageWidth];
+			XMFLOAT4* out = &horizontal[y * width];
+			for (std::uint32_t x = 0; x < width; ++x) {
+				XMVECTOR sum = XMVectorZero();
+				for (std::size_t tap = columns.First[x]; tap < columns.First[x + 1]; ++tap) {
+					const Kernel::Tap& t = columns.Taps[tap];
+					sum = XMVectorMultiplyAdd(XMLoadFloat4(&in[t.Index]), XMVectorReplicate(t.Weight), sum);
+				}
+				XMStoreFloat4(&out[x], sum);
+			}
+		});
+
+		// whole rows at a time, the source rows are read in order
+		next.resize((std::size_t)width * height);
+		ForRows(width, height, options.ThreadCount, [&](std::size_t y) {
+			XMFLOAT4* out = &next[y * width];
+			std::fill(out, out + width, XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f));
+			for (std::size_t tap = rows.First[y]; tap < rows.First[y + 1]; ++tap) {
+				const XMFLOAT4* in = &horizontal[(std::size_t)rows.Taps[tap].Index * width];
+				const XMVECTOR weight = XMVectorReplicate(rows.Taps[tap].Weight);
+				for (std::uint32_t x = 0; x < width; ++x)
+					XMStoreFloat4(&out[x], XMVectorMultiplyAdd(XMLoadFloat4(&in[x]), weight, XMLoadFloat4(&out[x])));
+			}
+
+			std::uint8_t* pixel = destination + y * rowPitch;
+			for (std::uint32_t x = 0; x < width; ++x, pixel += 4)
+				StorePixel(XMLoadFloat4(&out[x]), srgb, options.NormalMap, tables, pixel);
+		});
+	}
+}
+
+std::uint32_t MipGenerator::MipCount(std::uint32_t width, std::uint32_t height)
+{
+	std::uint32_t count = 1;
+	for (std::uint32_t size = std::max(width, height); size > 1; size /= 2)
+		count++;
+	return count;
+}
+
+std::size_t MipGenerator::Layout(std::uint32_t width, std::uint32_t height, const Options& options, std::vector<Level>& levels)
+{
+	levels.clear();
+	std::size_t size = 0;
+	const std::uint32_t count = MipCount(width, height);
+	for (std::uint32_t mip = 0; mip < count; ++mip) {
+		Level level;
+		level.Width = std::max(1u, width >> mip);
+		level.Height = std::max(1u, height >> mip);
+		level.RowPitch = AlignUp((std::size_t)level.Width * 4, options.RowAlignment);
+		level.Offset = AlignUp(size, options.PlacementAlignment);
+		size = level.Offset + level.RowPitch * level.Height;
+		levels.push_back(level);
+	}
+	return size;
+}
+
+void MipGenerator::Generate(
+	const std::uint8_t* source,
+	std::size_t sourceRowPitch,
+	const std::vector<Level>& levels,
+	const Options& options,
+	std::uint8_t* destination)
+{
+	if (levels.empty())
+		return;
+
+	const Level& top = levels[0];
+	for (std::uint32_t y = 0; y < top.Height; ++y)
+		std::memcpy(destination + top.Offset + y * top.RowPitch, source + y * sourceRowPitch, (std::size_t)top.Width * 4);
+
+	// every level is filtered from the float copy of the previous one
+	std::vector<XMFLOAT4> current, horizontal, next;
+	LoadImage(source, sourceRowPitch, top.Width, top.Height, options.SRGB && !options.NormalMap, options.ThreadCount, current);
+
+	for (std::size_t mip = 1; mip < levels.size(); ++mip) {
+		const Level& from = levels[mip - 1];
+		const Level& to = levels[mip];
+		Resample(current, from.Width, from.Height, to.Width, to.Height, options,
+			horizontal, next, destination + to.Offset, to.RowPitch);
+		current.swap(next);
+	}
+}
+
+void MipGenerator::Resize(
+	const std::uint8_t* source,
+	std::size_t sourceRowPitch,
+	std::uint32_t sourceWidth,
+	std::uint32_t sourceHeight,
+	std::uint8_t* destination,
+	std::size_t rowPitch,
+	std::uint32_t width,
+	std::uint32_t height,
+	const Options& options)
+{
+	if (sourceWidth == 0 || sourceHeight == 0 || width == 0 || height == 0)
+		return;
+
+	std::vector<XMFLOAT4> image, horizontal, next;
+	LoadImage(source, sourceRowPitch, sourceWidth, sourceHeight, options.SRGB && !options.NormalMap, options.ThreadCount, image);
+	Resample(image, sourceWidth, sourceHeight, width, height, options, horizontal, next, destination, rowPitch);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Full mip chains for RGBA8 images on the CPU, for textures that come without one (jpg, png...).
+// Pixels are filtered as one DirectXMath vector each, separably, on worker threads. The levels are
+// written straight into the layout of an upload buffer, ready for CopyTextureRegion.
+class MipGenerator
+{
+public:
+	enum class Filter
+	{
+		Box,		// average of the texels each output texel covers
+		Kaiser		// Kaiser windowed sinc, three lobes: sharper, may ring a little
+	};
+
+	struct Options
+	{
+		Filter Kernel = Filter::Kaiser;
+
+		// Color stored as sRGB: filtered in linear space and encoded again. Ignored for normal maps.
+		bool SRGB = false;
+
+		// Tangent space normals in xyz: renormalized after filtering. Alpha is filtered as it is.
+		bool NormalMap = false;
+
+		// 0: one per hardware thread
+		unsigned ThreadCount = 0;
+
+		// D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT,
+		// 1 for a tightly packed chain.
+		std::uint32_t RowAlignment = 256;
+		std::uint32_t PlacementAlignment = 512;
+	};
+
+	struct Level
+	{
+		std::size_t Offset = 0;
+		std::size_t RowPitch = 0;
+		std::uint32_t Width = 0;
+		std::uint32_t Height = 0;
+	};
+
+	// Levels down to 1x1.
+	static std::uint32_t MipCount(std::uint32_t width, std::uint32_t height);
+
+	// Where every level of a width x height chain goes, returns the size of the whole chain.
+	static std::size_t Layout(std::uint32_t width, std::uint32_t height, const Options& options, std::vector<Level>& levels);
+
+	// Writes the chain of levels (from Layout) into destination. Level 0 is source as it is.
+	static void Generate(
+		const std::uint8_t* source,
+		std::size_t sourceRowPitch,
+		const std::vector<Level>& levels,
+		const Options& options,
+		std::uint8_t* destination);
+
+	// Resamples an image to width x height with the same filter, up or down. The cooker uses it
+	// to bring block compressed textures to multiples of 4.
+	static void Resize(
+		const std::uint8_t* source,
+		std::size_t sourceRowPitch,
+		std::uint32_t sourceWidth,
+		std::uint32_t sourceHeight,
+		std::uint8_t* destination,
+		std::size_t rowPitch,
+		std::uint32_t width,
+		std::uint32_t height,
+		const Options& options);
+
+private:
+	MipGenerator() = delete;
+	~MipGenerator() = delete;
+};
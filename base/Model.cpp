@@ -1,179 +1,302 @@
 #pragma once
 #include "Model.h"
+#include "ImageDecoder.h"
+#include "MipGenerator.h"
 
 #include <iostream>
 
+namespace
+{
+	// GPU copies of TextureCache images, by resolved id. They live as long as a model uses them.
+	std::unordered_map<std::uint32_t, std::weak_ptr<Texture>> gTextures;
+
+	// DDS files go to CreateDDSTextureFromMemory12 as they are, the rest is decoded to pixels.
+	// Runs on the cache's worker threads.
+	bool DecodeForUpload(TextureCache::Image& image)
+	{
+		return ImageDecoder::IsDDS(image.File) || ImageDecoder::Decode(image);
+	}
+
+	// Records the upload on pCommandList, nullptr when the image has nothing the GPU can use.
+	// Decoded images get a full mip chain filtered as mipOptions says, DDS files keep their own.
+	std::shared_ptr<Texture> CreateTexture(
+		const TextureCache::Image& image,
+		const MipGenerator::Options& mipOptions,
+		ID3D12Device* pDevice,
+		ID3D12GraphicsCommandList* pCommandList)
+	{
+		auto texture = std::make_shared<Texture>();
+		texture->Name = image.Path.substr(image.Path.find_last_of('/') + 1);
+		texture->Filename = AnsiToWString(image.Path);
+
+		if (ImageDecoder::IsDDS(image.File)) {
+			if (FAILED(DirectX::CreateDDSTextureFromMemory12(pDevice, pCommandList,
+				image.File.data(), image.File.size(), texture->Resource, texture->UploadHeap)))
+				return nullptr;
+		}
+		else if (!image.Pixels.empty()) {
+			std::vector<MipGenerator::Level> levels;
+			const UINT64 uploadSize = MipGenerator::Layout(image.Width, image.Height, mipOptions, levels);
+
+			ThrowIfFailed(pDevice->CreateCommittedResource(
+				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+				D3D12_HEAP_FLAG_NONE,
+				&CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, image.Width, image.Height, 1, (UINT16)levels.size()),
+				D3D12_RESOURCE_STATE_COPY_DEST,
+				nullptr,
+				IID_PPV_ARGS(texture->Resource.GetAddressOf())));
+
+			ThrowIfFailed(pDevice->CreateCommittedResource(
+				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+				D3D12_HEAP_FLAG_NONE,
+				&CD3DX12_RESOURCE_DESC::Buffer(uploadSize),
+				D3D12_RESOURCE_STATE_GENERIC_READ,
+				nullptr,
+				IID_PPV_ARGS(texture->UploadHeap.GetAddressOf())));
+
+			// the chain is filtered straight into the upload heap
+			BYTE* mapped = nullptr;
+			ThrowIfFailed(texture->UploadHeap->Map(0, nullptr, reinterpret_cast<void**>(&mapped)));
+			MipGenerator::Generate(image.Pixels.data(), (size_t)image.Width * 4, levels, mipOptions, mapped);
+			texture->UploadHeap->Unmap(0, nullptr);
+
+			for (UINT mip = 0; mip < (UINT)levels.size(); ++mip) {
+				D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = {};
+				footprint.Offset = levels[mip].Offset;
+				footprint.Footprint.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+				footprint.Footprint.Width = levels[mip].Width;
+				footprint.Footprint.Height = levels[mip].Height;
+				footprint.Footprint.Depth = 1;
+				footprint.Footprint.RowPitch = (UINT)levels[mip].RowPitch;
+
+				CD3DX12_TEXTURE_COPY_LOCATION dst(texture->Resource.Get(), mip);
+				CD3DX12_TEXTURE_COPY_LOCATION src(texture->UploadHeap.Get(), footprint);
+				pCommandList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+			}
+			pCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(texture->Resource.Get(),
+				D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+		}
+		else {
+			return nullptr;
+		}
+
+		d3dUtil::TrackResource(texture->Resource.Get(), MemoryTracker::Category::Texture);
+		d3dUtil::TrackResource(texture->UploadHeap.Get(), MemoryTracker::Category::UploadHeap);
+		return texture;
+	}
+}
+
+std::vector<D3D12_INPUT_ELEMENT_DESC> Model::InputLayout(VertexFormat format)
+{
+	if (format == VertexFormat::Packed) {
+		return {
+			{"POSITION",0,DXGI_FORMAT_R16G16B16A16_UNORM,0,offsetof(PackedVertex, Position),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+			{"NORMAL",0,DXGI_FORMAT_R16G16_SNORM,0,offsetof(PackedVertex, Normal),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+			{"TANGENTU",0,DXGI_FORMAT_R16G16_SNORM,0,offsetof(PackedVertex, TangentU),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+			{"TEXC",0,DXGI_FORMAT_R16G16_FLOAT,0,offsetof(PackedVertex, TexC),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0}
+		};
+	}
+
+	return {
+		{"POSITION",0,DXGI_FORMAT_R32G32B32_FLOAT,0,offsetof(GeometryGenerator::Vertex, Position),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"NORMAL",0,DXGI_FORMAT_R32G32B32_FLOAT,0,offsetof(GeometryGenerator::Vertex, Normal),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"TANGENTU",0,DXGI_FORMAT_R32G32B32A32_FLOAT,0,offsetof(GeometryGenerator::Vertex, TangentU),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"TEXC",0,DXGI_FORMAT_R32G32_FLOAT,0,offsetof(GeometryGenerator::Vertex, TexC),D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0}
+	};
+}
+
 const MeshGeometry* Model::Geo()
 {
 	return &mGeo;
 }
 
+Model::VertexFormat Model::Format()const
+{
+	return mFormat;
+}
+
+TransformHierarchy& Model::Hierarchy()
+{
+	return mHierarchy;
+}
+
+std::uint32_t Model::SubmeshNode(const string& name)const
+{
+	return mSubmeshNodes.at(name);
+}
+
+const DirectX::XMFLOAT4X4& Model::SubmeshTransform(const string& name)const
+{
+	return mHierarchy.World(SubmeshNode(name));
+}
+
+const vector<Material>& Model::Materials()const
+{
+	return mMaterials;
+}
+
+std::uint32_t Model::SubmeshMaterial(const string& name)const
+{
+	return mSubmeshMaterials.at(name);
+}
+
+const MeshletData& Model::SubmeshMeshlets(const string& name)const
+{
+	return mSubmeshMeshlets.at(name);
+}
+
+const vector<std::shared_ptr<Texture>>& Model::Textures()const
+{
+	return mTextures;
+}
+
 void Model::LoadModel(
 	string path,
+	UINT lodCount,
 	ID3D12Device* pDevice,
 	ID3D12GraphicsCommandList* pCommandList)
 {
-	Assimp::Importer import;
-	const aiScene* scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+	ModelImporter importer(path);
+	if (lodCount > 1)
+		importer.GenerateLods(lodCount);
+	importer.GenerateMeshlets();
 
-	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
-	{
-		string err = (string)"ERROR::ASSIMP::" + import.GetErrorString() + "\n";
-		throw std::invalid_argument(err);
-	}
+	mDirectory = importer.Directory();
 
-	mDirectory = path.substr(0, path.find_last_of('/'));
+	// reads and decodes the files new to the cache on worker threads
+	TextureCache::Get().LoadPending(DecodeForUpload);
 
-	ProcessNode(scene->mRootNode, scene);
+	ProcessGeo(importer, pDevice, pCommandList);
+	ProcessMaterials(importer, pDevice, pCommandList);
 
-	ProcessGeo(pDevice, pCommandList);
+	mHierarchy = std::move(importer.Hierarchy());
 }
 
 void Model::ProcessGeo(
+	ModelImporter& importer,
 	ID3D12Device* pDevice,
 	ID3D12GraphicsCommandList* pCommandList)
 {
-	int totalVertexCount = 0;
-	for (auto& meshData : mMeshes) {
-		totalVertexCount += meshData.Vertices.size();
-	}
-
-	std::vector<GeometryGenerator::Vertex> vertices(totalVertexCount);
 	std::vector<std::uint16_t> indices;
-	UINT k = 0;
-	UINT meshId = 0;
-	UINT indexOffset = 0, vertexOffset = 0;
-	for (auto& meshData : mMeshes) {
-
-		float x[2] = { 0 };
-		float y[2] = { 0 };
-		float z[2] = { 0 };
-
-		if (meshData.Vertices.size() > 0) {
-			x[0] = x[1] = meshData.Vertices[0].Position.x;
-			y[0] = y[1] = meshData.Vertices[0].Position.y;
-			z[0] = z[1] = meshData.Vertices[0].Position.z;
+	std::vector<ModelImporter::Submesh> submeshes;
+	importer.Merge(indices, submeshes);
+	const std::vector<GeometryGenerator::Vertex>& vertices = importer.Vertices();
+
+	for (UINT meshId = 0; meshId < submeshes.size(); ++meshId) {
+		SubmeshGeometry submesh;
+		submesh.IndexCount = submeshes[meshId].IndexCount;
+		submesh.StartIndexLocation = submeshes[meshId].StartIndexLocation;
+		submesh.BaseVertexLocation = submeshes[meshId].BaseVertexLocation;
+		submesh.Bounds = submeshes[meshId].Bounds;
+		if (submeshes[meshId].Lods.size() > 1) {
+			for (const auto& lod : submeshes[meshId].Lods)
+				submesh.Lods.push_back({ lod.IndexCount, lod.StartIndexLocation, lod.Error });
 		}
+		mGeo.DrawArgs[std::to_string(meshId)] = submesh;
+		mSubmeshNodes[std::to_string(meshId)] = submeshes[meshId].Node;
+		mSubmeshMaterials[std::to_string(meshId)] = submeshes[meshId].Material;
+		mSubmeshMeshlets[std::to_string(meshId)] = std::move(submeshes[meshId].Meshlets);
+	}
 
-		for (size_t i = 0; i < meshData.Vertices.size(); ++i, ++k)
-		{
-			vertices[k] = meshData.Vertices[i];
+	const void* vertexData = vertices.data();
+	UINT vertexByteStride = sizeof(GeometryGenerator::Vertex);
 
-			x[0] = min(x[0], vertices[k].Position.x);
-			x[1] = max(x[1], vertices[k].Position.x);
-			y[0] = min(y[0], vertices[k].Position.y);
-			y[1] = max(y[1], vertices[k].Position.y);
-			z[0] = min(z[0], vertices[k].Position.z);
-			z[1] = max(z[1], vertices[k].Position.z);
+	// each submesh is quantized over its own bounds, its vertices run up to the next one's base
+	std::vector<PackedVertex> packedVertices;
+	if (mFormat == VertexFormat::Packed) {
+		packedVertices.resize(vertices.size());
+		for (size_t meshId = 0; meshId < submeshes.size(); ++meshId) {
+			size_t first = (size_t)submeshes[meshId].BaseVertexLocation;
+			size_t last = meshId + 1 < submeshes.size() ? (size_t)submeshes[meshId + 1].BaseVertexLocation : vertices.size();
+			VertexQuantizer::Encode(vertices.data() + first, last - first, submeshes[meshId].Bounds, packedVertices.data() + first);
 		}
-		
-		indices.insert(indices.end(), std::begin(meshData.GetIndices16()), std::end(meshData.GetIndices16()));
-
-		SubmeshGeometry submesh;
-		submesh.IndexCount = (UINT)meshData.Indices32.size();
-		submesh.StartIndexLocation = indexOffset;
-		submesh.BaseVertexLocation = vertexOffset;
-		submesh.Bounds.Center = DirectX::XMFLOAT3((x[1] + x[0]) * 0.5f, (y[1] + y[0]) * 0.5f, (z[1] + z[0]) * 0.5f);
-		submesh.Bounds.Extents = DirectX::XMFLOAT3((x[1] - x[0]) * 0.5f, (y[1] - y[0]) * 0.5f, (z[1] - z[0]) * 0.5f);
-		mGeo.DrawArgs[std::to_string(meshId++)] = submesh;
-
-		indexOffset += meshData.Indices32.size();
-		vertexOffset += meshData.Vertices.size();
+		vertexData = packedVertices.data();
+		vertexByteStride = sizeof(PackedVertex);
 	}
 
-
-	const UINT vbByteSize = (UINT)vertices.size() * sizeof(GeometryGenerator::Vertex);
+	const UINT vbByteSize = (UINT)vertices.size() * vertexByteStride;
 	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint16_t);
 
 	D3DCreateBlob(vbByteSize, &mGeo.VertexBufferCPU);
-	CopyMemory(mGeo.VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
+	CopyMemory(mGeo.VertexBufferCPU->GetBufferPointer(), vertexData, vbByteSize);
 
 	D3DCreateBlob(ibByteSize, &mGeo.IndexBufferCPU);
 	CopyMemory(mGeo.IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+	mGeo.TrackCpuMemory();
 
 	mGeo.VertexBufferGPU = d3dUtil::CreateDefaultBuffer(pDevice,
-		pCommandList, vertices.data(), vbByteSize, mGeo.VertexBufferUploader);
+		pCommandList, vertexData, vbByteSize, mGeo.VertexBufferUploader);
 
 	mGeo.IndexBufferGPU = d3dUtil::CreateDefaultBuffer(pDevice,
 		pCommandList, indices.data(), ibByteSize, mGeo.IndexBufferUploader);
 
-	mGeo.VertexByteStride = sizeof(GeometryGenerator::Vertex);
+	mGeo.VertexByteStride = vertexByteStride;
 	mGeo.VertexBufferByteSize = vbByteSize;
 	mGeo.IndexFormat = DXGI_FORMAT_R16_UINT;
 	mGeo.IndexBufferByteSize = ibByteSize;
 }
 
-void Model::ProcessNode(aiNode* node, const aiScene* scene)
+void Model::ProcessMaterials(
+	ModelImporter& importer,
+	ID3D12Device* pDevice,
+	ID3D12GraphicsCommandList* pCommandList)
 {
-	// ڵееĻ
-	for (unsigned int i = 0; i < node->mNumMeshes; i++)
-	{
-		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		mMeshes.push_back(ProcessMesh(mesh, scene));
-	}
-	// ӽڵظһ
-	for (unsigned int i = 0; i < node->mNumChildren; i++)
-	{
-		ProcessNode(node->mChildren[i], scene);
-	}
-}
+	TextureCache& cache = TextureCache::Get();
 
-GeometryGenerator::MeshData Model::ProcessMesh(aiMesh* mesh, const aiScene* scene)
-{
-	using namespace DirectX;
+	// resolved id to index in mTextures, -1 when it couldn't be created
+	std::unordered_map<std::uint32_t, int> textureIndices;
+	auto textureIndex = [&](std::uint32_t id, const MipGenerator::Options& mipOptions)
+	{
+		if (id == TextureCache::InvalidId || !cache.GetImage(id).Loaded)
+			return -1;
 
-	GeometryGenerator::MeshData meshData;
+		std::uint32_t resolved = cache.Resolve(id);
+		auto found = textureIndices.find(resolved);
+		if (found != textureIndices.end())
+			return found->second;
 
-	for (unsigned int i = 0; i < mesh->mNumVertices; i++)
-	{
-		GeometryGenerator::Vertex vertex;
-		// λáߺ
-		XMFLOAT3 vector;
-		vector.x = mesh->mVertices[i].x;
-		vector.y = mesh->mVertices[i].y;
-		vector.z = mesh->mVertices[i].z;
-		vertex.Position = vector;
-
-		if (mesh->mNormals) {
-			vector.x = mesh->mNormals[i].x;
-			vector.y = mesh->mNormals[i].y;
-			vector.z = mesh->mNormals[i].z;
-		}
-		vertex.Normal = vector;
-
-		if (mesh->mTextureCoords[0]) // Ƿꣿ
-		{
-			XMFLOAT2 vec;
-			vec.x = mesh->mTextureCoords[0][i].x;
-			vec.y = mesh->mTextureCoords[0][i].y;
-			vertex.TexC = vec;
-		}
-		else {
-			vertex.TexC = XMFLOAT2(0.0f, 0.0f);
+		std::shared_ptr<Texture> texture = gTextures[resolved].lock();
+		if (!texture) {
+			// an earlier model may have uploaded the file, freed it and dropped its texture since
+			if (cache.Reload(resolved, DecodeForUpload))
+				texture = CreateTexture(cache.GetImage(resolved), mipOptions, pDevice, pCommandList);
+			gTextures[resolved] = texture;
 		}
+		// the upload heap holds its own copy now, the cache keeps the hash
+		cache.Release(resolved);
 
-		meshData.Vertices.push_back(vertex);
-	}
-	// 
-	for (unsigned int i = 0; i < mesh->mNumFaces; i++)
-	{
-		aiFace face = mesh->mFaces[i];
-		for (unsigned int j = 0; j < face.mNumIndices; j++) {
-			meshData.Indices32.push_back(face.mIndices[j]);
+		int index = -1;
+		if (texture) {
+			index = (int)mTextures.size();
+			mTextures.push_back(texture);
 		}
-	}
+		textureIndices[resolved] = index;
+		return index;
+	};
 
-	// 
-	if (mesh->mMaterialIndex >= 0)
-	{
-		//aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-		//vector<Texture> diffuseMaps = loadMaterialTextures(material,
-		//	aiTextureType_DIFFUSE, "texture_diffuse");
-		//textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-		//vector<Texture> specularMaps = loadMaterialTextures(material,
-		//	aiTextureType_SPECULAR, "texture_specular");
-		//textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
-	}
+	// Albedo is sRGB, normal maps need their normals renormalized. A file used in two slots keeps
+	// the mips of the first one.
+	MipGenerator::Options colorMips;
+	colorMips.RowAlignment = D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
+	colorMips.PlacementAlignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+	MipGenerator::Options albedoMips = colorMips;
+	albedoMips.SRGB = true;
+	MipGenerator::Options normalMips = colorMips;
+	normalMips.NormalMap = true;
 
-	return meshData;
+	const auto& materials = importer.Materials();
+	for (size_t i = 0; i < materials.size(); ++i) {
+		const auto& desc = materials[i];
+
+		Material material;
+		material.Name = desc.Name.empty() ? mGeo.Name + std::to_string(i) : desc.Name;
+		material.MatCBIndex = (int)i;
+		material.DiffuseAlbedo = desc.DiffuseAlbedo;
+		material.FresnelR0 = desc.FresnelR0;
+		material.Roughness = desc.Roughness;
+		material.DiffuseSrvHeapIndex = textureIndex(desc.DiffuseMap, albedoMips);
+		material.NormalSrvHeapIndex = textureIndex(desc.NormalMap, normalMips);
+		material.SpecularSrvHeapIndex = textureIndex(desc.SpecularMap, colorMips);
+		mMaterials.push_back(material);
+	}
 }
@@ -1,14 +1,14 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
 
 #include "Common/d3dApp.h"
 #include "Common/GeometryGenerator.h"
 #include "Common/MathHelper.h"
+#include "ModelImporter.h"
+#include "VertexQuantizer.h"
 
 using std::vector;
 using std::string;
@@ -16,33 +16,77 @@ using std::string;
 class Model
 {
 public:
+    enum class VertexFormat
+    {
+        Full,       // GeometryGenerator::Vertex
+        Packed      // PackedVertex, positions relative to SubmeshGeometry::Bounds
+    };
+
+    // lodCount > 1 adds a simplified LOD chain to every submesh, see SubmeshGeometry::Lods.
     Model(
         string name, 
         string path,
         ID3D12Device* pDevice,
-        ID3D12GraphicsCommandList* pCommandList)
+        ID3D12GraphicsCommandList* pCommandList,
+        UINT lodCount = 1,
+        VertexFormat format = VertexFormat::Full)
     {
         mGeo.Name = name;
-        LoadModel(path, pDevice, pCommandList);
+        mFormat = format;
+        LoadModel(path, lodCount, pDevice, pCommandList);
     }
 
+    // Input layout matching the vertex buffer of a model loaded with format.
+    static std::vector<D3D12_INPUT_ELEMENT_DESC> InputLayout(VertexFormat format);
+
     const MeshGeometry* Geo();
+    VertexFormat Format()const;
+
+    // Node hierarchy of the file. Each DrawArgs entry hangs off SubmeshNode(name).
+    TransformHierarchy& Hierarchy();
+    std::uint32_t SubmeshNode(const string& name)const;
+
+    // World matrix of the submesh's node, i.e. submesh space to model space.
+    const DirectX::XMFLOAT4X4& SubmeshTransform(const string& name)const;
+
+    // Materials of the file, MatCBIndex is the position in this list and the
+    // SrvHeapIndex fields index Textures() (-1 without a texture).
+    const vector<Material>& Materials()const;
+    std::uint32_t SubmeshMaterial(const string& name)const;
+
+    // Meshlets of the submesh's full index range (not its LODs), built while loading.
+    // Their unique vertex indices are relative to the submesh's BaseVertexLocation.
+    const MeshletData& SubmeshMeshlets(const string& name)const;
+
+    // Textures of the materials. Models using the same files share them,
+    // each file is read and decoded once per process (see TextureCache).
+    const vector<std::shared_ptr<Texture>>& Textures()const;
 
 private:
     /*  ģ  */
     MeshGeometry mGeo;
-    vector<GeometryGenerator::MeshData> mMeshes;
+    VertexFormat mFormat = VertexFormat::Full;
+    TransformHierarchy mHierarchy;
+    std::unordered_map<string, std::uint32_t> mSubmeshNodes;
+    std::unordered_map<string, std::uint32_t> mSubmeshMaterials;
+    std::unordered_map<string, MeshletData> mSubmeshMeshlets;
+    vector<Material> mMaterials;
+    vector<std::shared_ptr<Texture>> mTextures;
     string mDirectory;
 
     void LoadModel(
         string path,
+        UINT lodCount,
         ID3D12Device* pDevice,
         ID3D12GraphicsCommandList* pCommandList);
 
     void ProcessGeo(
+        ModelImporter& importer,
         ID3D12Device* pDevice,
         ID3D12GraphicsCommandList* pCommandList);
 
-    void ProcessNode(aiNode* node, const aiScene* scene);
-    GeometryGenerator::MeshData ProcessMesh(aiMesh* mesh, const aiScene* scene);
+    void ProcessMaterials(
+        ModelImporter& importer,
+        ID3D12Device* pDevice,
+        ID3D12GraphicsCommandList* pCommandList);
 };
\ No newline at end of file
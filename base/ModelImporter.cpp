@@ -0,0 +1,337 @@
+#include "ModelImporter.h"
+#include "MeshSimplifier.h"
+#include "Parallel.h"
+#include "TangentSpace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+	std::uint32_t RequestTexture(
+		const aiMaterial* material,
+		aiTextureType type,
+		const std::string& directory,
+		TextureCache& textures)
+	{
+		aiString path;
+		if (material->GetTextureCount(type) == 0 || material->GetTexture(type, 0, &path) != AI_SUCCESS)
+			return TextureCache::InvalidId;
+		return textures.Request(directory, path.C_Str());
+	}
+}
+
+ModelImporter::ModelImporter(const std::string& path, unsigned threadCount, TextureCache* textures) :
+	mThreadCount(threadCount)
+{
+	Assimp::Importer import;
+	const aiScene* scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+
+	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+	{
+		std::string err = (std::string)"ERROR::ASSIMP::" + import.GetErrorString() + "\n";
+		throw std::invalid_argument(err);
+	}
+
+	size_t slash = path.find_last_of("/\\");
+	mDirectory = slash == std::string::npos ? "." : path.substr(0, slash);
+
+	BuildHierarchy(scene->mRootNode);
+	ProcessMaterials(scene, textures != nullptr ? *textures : TextureCache::Get());
+
+	// the walk only fixes the order, the conversion runs per mesh
+	std::vector<const aiMesh*> meshes;
+	ProcessNode(scene->mRootNode, scene, meshes);
+
+	// prefix sums of the counts give every mesh its place in the merged buffers
+	mRanges.resize(meshes.size());
+	std::uint32_t vertexCount = 0, indexCount = 0;
+	for (size_t meshId = 0; meshId < meshes.size(); ++meshId) {
+		MeshRange& range = mRanges[meshId];
+		range.FirstVertex = vertexCount;
+		range.VertexCount = meshes[meshId]->mNumVertices;
+		range.FirstIndex = indexCount;
+		for (unsigned int i = 0; i < meshes[meshId]->mNumFaces; i++)
+			range.IndexCount += meshes[meshId]->mFaces[i].mNumIndices;
+		vertexCount += range.VertexCount;
+		indexCount += range.IndexCount;
+	}
+
+	mVertices.resize(vertexCount);
+	mIndices.resize(indexCount);
+	Parallel::For(meshes.size(), [&](size_t i) { ProcessMesh(meshes[i], mRanges[i]); }, mThreadCount);
+}
+
+const std::string& ModelImporter::Directory()const
+{
+	return mDirectory;
+}
+
+const std::vector<ModelImporter::MaterialDesc>& ModelImporter::Materials()const
+{
+	return mMaterials;
+}
+
+const std::vector<GeometryGenerator::Vertex>& ModelImporter::Vertices()const
+{
+	return mVertices;
+}
+
+std::uint32_t ModelImporter::MeshCount()const
+{
+	return (std::uint32_t)mRanges.size();
+}
+
+GeometryGenerator::MeshData ModelImporter::Mesh(std::uint32_t mesh)const
+{
+	const MeshRange& range = mRanges[mesh];
+	GeometryGenerator::MeshData meshData;
+	meshData.Vertices.assign(mVertices.begin() + range.FirstVertex, mVertices.begin() + range.FirstVertex + range.VertexCount);
+	meshData.Indices32.assign(mIndices.begin() + range.FirstIndex, mIndices.begin() + range.FirstIndex + range.IndexCount);
+	return meshData;
+}
+
+TransformHierarchy& ModelImporter::Hierarchy()
+{
+	return mHierarchy;
+}
+
+void ModelImporter::GenerateLods(std::uint32_t lodCount, float reduction, float maxError)
+{
+	mLods.clear();
+	mLods.resize(mRanges.size());
+
+	// meshes are simplified independently
+	Parallel::For(mRanges.size(), [&](size_t meshId) {
+		const MeshRange& range = mRanges[meshId];
+		const DirectX::XMFLOAT3& extents = range.Bounds.Extents;
+		float radius = std::sqrt(extents.x * extents.x + extents.y * extents.y + extents.z * extents.z);
+		if (range.VertexCount == 0 || radius == 0.0f)
+			return;
+
+		const GeometryGenerator::Vertex* vertices = mVertices.data() + range.FirstVertex;
+		const std::uint32_t* indices = mIndices.data() + range.FirstIndex;
+
+		// every level starts from the full mesh, so the errors don't pile up along the chain
+		size_t previousCount = range.IndexCount;
+		for (std::uint32_t level = 1; level < lodCount; ++level) {
+			size_t target = (size_t)(range.IndexCount * std::pow(reduction, (float)level));
+
+			MeshLod lod;
+			float error = MeshSimplifier::Simplify(vertices, range.VertexCount, indices, range.IndexCount, target, maxError * radius, lod.Indices);
+			if (lod.Indices.empty() || lod.Indices.size() > previousCount * 9 / 10)
+				break;
+
+			lod.Error = error / radius;
+			previousCount = lod.Indices.size();
+			mLods[meshId].push_back(std::move(lod));
+		}
+	}, mThreadCount);
+}
+
+void ModelImporter::GenerateMeshlets()
+{
+	mMeshlets.clear();
+	mMeshlets.resize(mRanges.size());
+
+	Parallel::For(mRanges.size(), [&](size_t meshId) {
+		const MeshRange& range = mRanges[meshId];
+		MeshletBuilder::Build(mVertices.data() + range.FirstVertex, range.VertexCount,
+			mIndices.data() + range.FirstIndex, range.IndexCount, mMeshlets[meshId]);
+	}, mThreadCount);
+}
+
+void ModelImporter::Merge(std::vector<std::uint16_t>& indices, std::vector<Submesh>& submeshes)
+{
+	const size_t meshCount = mRanges.size();
+
+	// the vertices are merged already, each mesh's indices get its levels of detail behind them
+	std::vector<std::uint32_t> indexOffsets(meshCount + 1, 0);
+	for (size_t meshId = 0; meshId < meshCount; ++meshId) {
+		size_t indexCount = mRanges[meshId].IndexCount;
+		if (meshId < mLods.size()) {
+			for (const auto& lod : mLods[meshId])
+				indexCount += lod.Indices.size();
+		}
+		indexOffsets[meshId + 1] = indexOffsets[meshId] + (std::uint32_t)indexCount;
+	}
+
+	indices.resize(indexOffsets[meshCount]);
+	submeshes.assign(meshCount, Submesh());
+
+	Parallel::For(meshCount, [&](size_t meshId) {
+		const MeshRange& range = mRanges[meshId];
+
+		std::uint16_t* indexOut = indices.data() + indexOffsets[meshId];
+		for (std::uint32_t i = 0; i < range.IndexCount; ++i)
+			*indexOut++ = (std::uint16_t)mIndices[range.FirstIndex + i];
+
+		Submesh& submesh = submeshes[meshId];
+		submesh.IndexCount = range.IndexCount;
+		submesh.StartIndexLocation = indexOffsets[meshId];
+		submesh.BaseVertexLocation = (std::int32_t)range.FirstVertex;
+		submesh.Bounds = range.Bounds;
+		submesh.Node = mMeshNodes[meshId];
+		submesh.Material = mMeshMaterials[meshId];
+		submesh.Lods.push_back({ submesh.IndexCount, submesh.StartIndexLocation, 0.0f });
+
+		if (meshId < mLods.size()) {
+			for (const auto& lod : mLods[meshId]) {
+				submesh.Lods.push_back({ (std::uint32_t)lod.Indices.size(), (std::uint32_t)(indexOut - indices.data()), lod.Error });
+				for (std::uint32_t index : lod.Indices)
+					*indexOut++ = (std::uint16_t)index;
+			}
+		}
+
+		if (meshId < mMeshlets.size())
+			submesh.Meshlets = mMeshlets[meshId];
+	}, mThreadCount);
+}
+
+void ModelImporter::BuildHierarchy(const aiNode* root)
+{
+	std::queue<std::pair<const aiNode*, std::uint32_t>> nodes;
+	nodes.push({ root, TransformHierarchy::InvalidNode });
+
+	while (!nodes.empty()) {
+		const aiNode* node = nodes.front().first;
+		std::uint32_t parent = nodes.front().second;
+		nodes.pop();
+
+		// assimp stores column vector matrices, DirectXMath uses row vectors
+		const aiMatrix4x4& m = node->mTransformation;
+		DirectX::XMFLOAT4X4 local(
+			m.a1, m.b1, m.c1, m.d1,
+			m.a2, m.b2, m.c2, m.d2,
+			m.a3, m.b3, m.c3, m.d3,
+			m.a4, m.b4, m.c4, m.d4);
+
+		std::uint32_t index = mHierarchy.AddNode(parent, local, node->mName.C_Str());
+		mNodeIndices[node] = index;
+
+		for (unsigned int i = 0; i < node->mNumChildren; i++)
+			nodes.push({ node->mChildren[i], index });
+	}
+
+	mHierarchy.Update();
+}
+
+void ModelImporter::ProcessMaterials(const aiScene* scene, TextureCache& textures)
+{
+	mMaterials.resize(scene->mNumMaterials);
+	for (unsigned int i = 0; i < scene->mNumMaterials; i++)
+	{
+		const aiMaterial* material = scene->mMaterials[i];
+		MaterialDesc& desc = mMaterials[i];
+
+		aiString name;
+		if (material->Get(AI_MATKEY_NAME, name) == AI_SUCCESS)
+			desc.Name = name.C_Str();
+
+		aiColor3D diffuse;
+		if (material->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse) == AI_SUCCESS)
+			desc.DiffuseAlbedo = DirectX::XMFLOAT4(diffuse.r, diffuse.g, diffuse.b, 1.0f);
+		float opacity = 1.0f;
+		if (material->Get(AI_MATKEY_OPACITY, opacity) == AI_SUCCESS)
+			desc.DiffuseAlbedo.w = opacity;
+
+		// the lighting takes the exponent as (1 - Roughness) * 256
+		float shininess = 0.0f;
+		if (material->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS && shininess > 0.0f)
+			desc.Roughness = 1.0f - std::min(shininess / 256.0f, 1.0f);
+
+		desc.DiffuseMap = RequestTexture(material, aiTextureType_DIFFUSE, mDirectory, textures);
+		desc.SpecularMap = RequestTexture(material, aiTextureType_SPECULAR, mDirectory, textures);
+		desc.NormalMap = RequestTexture(material, aiTextureType_NORMALS, mDirectory, textures);
+		// OBJ files list normal maps as bump maps
+		if (desc.NormalMap == TextureCache::InvalidId)
+			desc.NormalMap = RequestTexture(material, aiTextureType_HEIGHT, mDirectory, textures);
+	}
+}
+
+void ModelImporter::ProcessNode(const aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& meshes)
+{
+	// ڵееĻ
+	for (unsigned int i = 0; i < node->mNumMeshes; i++)
+	{
+		meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
+		mMeshNodes.push_back(mNodeIndices[node]);
+		mMeshMaterials.push_back(scene->mMeshes[node->mMeshes[i]]->mMaterialIndex);
+	}
+	// ӽڵظһ
+	for (unsigned int i = 0; i < node->mNumChildren; i++)
+	{
+		ProcessNode(node->mChildren[i], scene, meshes);
+	}
+}
+
+void ModelImporter::ProcessMesh(const aiMesh* mesh, MeshRange& range)
+{
+	using namespace DirectX;
+
+	// the merged buffers are sized already, every vertex and index is written in place
+	GeometryGenerator::Vertex* vertices = mVertices.data() + range.FirstVertex;
+	std::uint32_t* indices = mIndices.data() + range.FirstIndex;
+
+	XMFLOAT3 minPos(0.0f, 0.0f, 0.0f), maxPos(0.0f, 0.0f, 0.0f);
+	if (mesh->mNumVertices > 0)
+		minPos = maxPos = XMFLOAT3(mesh->mVertices[0].x, mesh->mVertices[0].y, mesh->mVertices[0].z);
+
+	for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+	{
+		GeometryGenerator::Vertex& vertex = vertices[i];
+		// λáߺ
+		XMFLOAT3 vector;
+		vector.x = mesh->mVertices[i].x;
+		vector.y = mesh->mVertices[i].y;
+		vector.z = mesh->mVertices[i].z;
+		vertex.Position = vector;
+		minPos.x = std::min(minPos.x, vector.x);
+		minPos.y = std::min(minPos.y, vector.y);
+		minPos.z = std::min(minPos.z, vector.z);
+		maxPos.x = std::max(maxPos.x, vector.x);
+		maxPos.y = std::max(maxPos.y, vector.y);
+		maxPos.z = std::max(maxPos.z, vector.z);
+
+		if (mesh->mNormals) {
+			vector.x = mesh->mNormals[i].x;
+			vector.y = mesh->mNormals[i].y;
+			vector.z = mesh->mNormals[i].z;
+		}
+		else {
+			// generated from the faces below
+			vector = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		}
+		vertex.Normal = vector;
+
+		if (mesh->mTextureCoords[0]) // Ƿꣿ
+		{
+			XMFLOAT2 vec;
+			vec.x = mesh->mTextureCoords[0][i].x;
+			vec.y = mesh->mTextureCoords[0][i].y;
+			vertex.TexC = vec;
+		}
+		else {
+			vertex.TexC = XMFLOAT2(0.0f, 0.0f);
+		}
+	}
+	// 
+	std::uint32_t* indexOut = indices;
+	for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+	{
+		const aiFace& face = mesh->mFaces[i];
+		for (unsigned int j = 0; j < face.mNumIndices; j++) {
+			*indexOut++ = face.mIndices[j];
+		}
+	}
+
+	range.Bounds.Center = XMFLOAT3((maxPos.x + minPos.x) * 0.5f, (maxPos.y + minPos.y) * 0.5f, (maxPos.z + minPos.z) * 0.5f);
+	range.Bounds.Extents = XMFLOAT3((maxPos.x - minPos.x) * 0.5f, (maxPos.y - minPos.y) * 0.5f, (maxPos.z - minPos.z) * 0.5f);
+
+	// runs on the thread converting this mesh
+	if (!mesh->mNormals)
+		TangentSpace::GenerateNormals(vertices, range.VertexCount, indices, range.IndexCount);
+	TangentSpace::GenerateTangents(vertices, range.VertexCount, indices, range.IndexCount);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <DirectXCollision.h>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include "Common/GeometryGenerator.h"
+#include "Meshlets.h"
+#include "TextureCache.h"
+#include "TransformHierarchy.h"
+
+// CPU side of Model: reads the file through assimp and merges the meshes into one
+// vertex/index stream. It doesn't touch D3D, so it also runs headless.
+class ModelImporter
+{
+public:
+	// Material of the file, the maps are TextureCache ids (InvalidId when unused).
+	struct MaterialDesc
+	{
+		std::string Name;
+		DirectX::XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
+		DirectX::XMFLOAT3 FresnelR0 = { 0.01f, 0.01f, 0.01f };
+		float Roughness = 0.25f;
+
+		std::uint32_t DiffuseMap = TextureCache::InvalidId;
+		std::uint32_t NormalMap = TextureCache::InvalidId;
+		std::uint32_t SpecularMap = TextureCache::InvalidId;
+	};
+
+	// One level of detail, an index range into the merged index buffer over the submesh's vertices.
+	struct Lod
+	{
+		std::uint32_t IndexCount = 0;
+		std::uint32_t StartIndexLocation = 0;
+
+		// MeshSimplifier error divided by the radius of the submesh bounds.
+		float Error = 0.0f;
+	};
+
+	struct Submesh
+	{
+		std::uint32_t IndexCount = 0;
+		std::uint32_t StartIndexLocation = 0;
+		std::int32_t BaseVertexLocation = 0;
+
+		DirectX::BoundingBox Bounds;
+
+		// Node of Hierarchy() the mesh hangs off, its world matrix places the submesh in model space.
+		std::uint32_t Node = 0;
+
+		// Index into Materials().
+		std::uint32_t Material = 0;
+
+		// Lods[0] is the full mesh (same range as above), the rest come from GenerateLods().
+		std::vector<Lod> Lods;
+
+		// Meshlets of the full mesh from GenerateMeshlets(), empty without. The unique vertex
+		// indices are relative to BaseVertexLocation like the index buffer.
+		MeshletData Meshlets;
+	};
+
+	// Meshes are converted in parallel on up to threadCount threads (0: one per hardware thread),
+	// each straight to its place in Vertices(); Merge() uses the same count. The material textures
+	// are only requested from textures (nullptr: TextureCache::Get()), its LoadPending() reads them.
+	explicit ModelImporter(const std::string& path, unsigned threadCount = 0, TextureCache* textures = nullptr);
+
+	const std::string& Directory()const;
+	const std::vector<MaterialDesc>& Materials()const;
+
+	// The vertices of every mesh one after the other, the vertex buffer of the merged submeshes.
+	const std::vector<GeometryGenerator::Vertex>& Vertices()const;
+
+	// A copy of one mesh with its own vertices and indices, for tools that work mesh by mesh.
+	std::uint32_t MeshCount()const;
+	GeometryGenerator::MeshData Mesh(std::uint32_t mesh)const;
+
+	// The aiNode tree with its mTransformation, already updated.
+	TransformHierarchy& Hierarchy();
+
+	// Simplifies every mesh into up to lodCount - 1 coarser levels, each with about reduction
+	// times the triangles of the one before. The chain stops early once a level would be off
+	// by more than maxError (relative to the mesh radius) or stops getting smaller.
+	void GenerateLods(std::uint32_t lodCount, float reduction = 0.5f, float maxError = 0.1f);
+
+	// Splits every mesh into meshlets (see MeshletBuilder), one mesh per task.
+	void GenerateMeshlets();
+
+	// Every mesh becomes one submesh over Vertices(), its levels of detail follow its indices.
+	// The index buffer is sized up front and each mesh writes its indices to its offset in parallel.
+	void Merge(std::vector<std::uint16_t>& indices, std::vector<Submesh>& submeshes);
+
+private:
+	struct MeshLod
+	{
+		std::vector<std::uint32_t> Indices;
+		float Error = 0.0f;
+	};
+
+	// A mesh's part of mVertices and mIndices.
+	struct MeshRange
+	{
+		std::uint32_t FirstVertex = 0;
+		std::uint32_t VertexCount = 0;
+		std::uint32_t FirstIndex = 0;
+		std::uint32_t IndexCount = 0;
+		DirectX::BoundingBox Bounds;
+	};
+
+	std::vector<GeometryGenerator::Vertex> mVertices;
+	std::vector<std::uint32_t> mIndices;		// relative to the mesh's first vertex
+	std::vector<MeshRange> mRanges;
+	std::vector<MaterialDesc> mMaterials;
+	std::vector<std::vector<MeshLod>> mLods;	// per mesh, without level 0
+	std::vector<MeshletData> mMeshlets;		// per mesh
+	std::string mDirectory;
+	unsigned mThreadCount = 0;
+
+	TransformHierarchy mHierarchy;
+	std::unordered_map<const aiNode*, std::uint32_t> mNodeIndices;
+	std::vector<std::uint32_t> mMeshNodes;
+	std::vector<std::uint32_t> mMeshMaterials;
+
+	void BuildHierarchy(const aiNode* root);
+	void ProcessMaterials(const aiScene* scene, TextureCache& textures);
+	void ProcessNode(const aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& meshes);
+	void ProcessMesh(const aiMesh* mesh, MeshRange& range);
+};
@@ -5,6 +5,19 @@
 MyApp::MyApp(HINSTANCE hInstance):
 	D3DApp(hInstance)
 {
+	// Well above what these samples load, an alert points at a leak rather than at a big scene.
+	using Category = MemoryTracker::Category;
+	const std::size_t MB = 1024 * 1024;
+	mMemoryBudgets.fill(0);
+	mMemoryBudgets[(int)Category::MeshGeometryCpu] = 256 * MB;
+	mMemoryBudgets[(int)Category::FrameArena] = 16 * MB;
+	mMemoryBudgets[(int)Category::Pool] = 64 * MB;
+	mMemoryBudgets[(int)Category::TextureCacheCpu] = 256 * MB;
+	mMemoryBudgets[(int)Category::DefaultBuffer] = 512 * MB;
+	mMemoryBudgets[(int)Category::UploadHeap] = 256 * MB;
+	mMemoryBudgets[(int)Category::UploadBuffer] = 64 * MB;
+	mMemoryBudgets[(int)Category::RenderTexture] = 512 * MB;
+	mMemoryBudgets[(int)Category::Texture] = 1024 * MB;
 
 #if defined _DEBUG
 	if (GetModuleHandle(L"WinPixGpuCapturer.dll") == 0)
@@ -21,6 +34,15 @@ bool MyApp::Initialize()
 
 	mCamera.SetPosition(XMFLOAT3(0, 0, -5));
 
+	MemoryTracker::Get().SetBudgetCallback([](MemoryTracker::Category category, const MemoryTracker::Stats& stats)
+		{
+			std::string msg = "Memory budget exceeded: " + std::string(MemoryTracker::CategoryName(category)) +
+				" " + std::to_string(stats.Current) + " / " + std::to_string(stats.Budget) + " bytes\n";
+			OutputDebugStringA(msg.c_str());
+		});
+	for (int i = 0; i < (int)MemoryTracker::Category::Count; ++i)
+		MemoryTracker::Get().SetBudget((MemoryTracker::Category)i, mMemoryBudgets[i]);
+
 	return ret;
 }
 
@@ -81,11 +103,18 @@ void MyApp::OnKeyboardInput(const GameTimer& gt)
 	if (GetAsyncKeyState('1') & 0x8000) { mIsWireframe = true; }
 	else { mIsWireframe = false; }
 
+	// Dump the memory report to the debugger output.
+	if (GetAsyncKeyState('M') & 1)
+		OutputDebugStringA(MemoryTracker::Get().Report().c_str());
+
 	mCamera.UpdateViewMatrix();
 }
 
 void MyApp::Update(const GameTimer& gt)
 {
+	MemoryTracker::Get().BeginFrame();
+	mFrameArena.BeginFrame();
+
 	OnKeyboardInput(gt);
 
 	mEyePos = mCamera.GetPosition3f();
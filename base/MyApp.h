@@ -2,6 +2,7 @@
 
 #include "Common/d3dApp.h"
 #include "Common/Camera.h"
+#include "Allocators.h"
 using namespace DirectX;
 
 class MyApp :public D3DApp
@@ -31,6 +32,13 @@ protected:
 	XMFLOAT4X4 mView = MathHelper::Identity4x4();
 	XMFLOAT4X4 mProj = MathHelper::Identity4x4();
 
+	// Transient CPU data for the current frame, reset at the start of every Update.
+	FrameArena mFrameArena;
+
+	// Per category budgets in bytes, 0 for none. Initialize() hands them to MemoryTracker, an app
+	// with bigger scenes raises them in its constructor.
+	std::array<std::size_t, (int)MemoryTracker::Category::Count> mMemoryBudgets;
+
 private:
 	static std::wstring GetLatestWinPixGpuCapturerPath_Cpp17();
 };
\ No newline at end of file
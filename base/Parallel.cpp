@@ -0,0 +1,56 @@
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+unsigned Parallel::HardwareThreads()
+{
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void Parallel::For(std::size_t count, const std::function<void(std::size_t)>& fn, unsigned threadCount)
+{
+	if (threadCount == 0)
+		threadCount = HardwareThreads();
+	threadCount = (unsigned)std::min<std::size_t>(threadCount, count);
+
+	if (threadCount <= 1) {
+		for (std::size_t i = 0; i < count; ++i)
+			fn(i);
+		return;
+	}
+
+	std::atomic<std::size_t> next(0);
+	std::exception_ptr error;
+	std::mutex errorMutex;
+
+	auto work = [&]()
+	{
+		for (std::size_t i = next++; i < count; i = next++) {
+			try {
+				fn(i);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!error)
+					error = std::current_exception();
+				next = count;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (unsigned i = 1; i < threadCount; ++i)
+		threads.emplace_back(work);
+	work();
+	for (auto& thread : threads)
+		thread.join();
+
+	if (error)
+		std::rethrow_exception(error);
+}
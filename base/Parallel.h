@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Minimal fork/join loop for CPU side loading work.
+class Parallel
+{
+public:
+	// Runs fn(i) for every i in [0, count) on up to threadCount threads, the caller being one of them
+	// (0 means one per hardware thread). Items are handed out one at a time, so they may differ in cost.
+	// The first exception thrown by fn stops the loop and is rethrown once every thread has finished.
+	static void For(std::size_t count, const std::function<void(std::size_t)>& fn, unsigned threadCount = 0);
+
+	static unsigned HardwareThreads();
+
+private:
+	Parallel() = delete;
+	~Parallel() = delete;
+};
@@ -5,7 +5,8 @@ RenderTexture::RenderTexture(
 	UINT width, 
 	UINT height, 
 	DXGI_FORMAT format,
-	D3D12_RESOURCE_FLAGS flag)
+	D3D12_RESOURCE_FLAGS flag,
+	UINT mipLevels)
 {
 	md3dDevice = device;
 	mWidth = width;
@@ -13,6 +14,7 @@ RenderTexture::RenderTexture(
 	mFormat = format;
 	mSrvFormat = format;
 	mFlag = flag;
+	mMipLevels = mipLevels;
 
 	mViewport = { 0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f };
 	mScissorRect = { 0, 0, (int)width, (int)height };
@@ -121,6 +123,15 @@ D3D12_RESOURCE_FLAGS RenderTexture::Flag() const
 	return mFlag;
 }
 
+UINT RenderTexture::MipLevels() const
+{
+	// no more than the chain of the current size has
+	UINT fullChain = 1;
+	for (UINT size = MathHelper::Max(mWidth, mHeight); size > 1; size /= 2)
+		fullChain++;
+	return MathHelper::Min(MathHelper::Max(mMipLevels, 1u), fullChain);
+}
+
 void RenderTexture::BuildResources()
 {
 	// Note, compressed formats cannot be used for UAV.  We get error like:
@@ -136,7 +147,7 @@ void RenderTexture::BuildResources()
 	texDesc.Width = mWidth;
 	texDesc.Height = mHeight;
 	texDesc.DepthOrArraySize = 1;
-	texDesc.MipLevels = 1;
+	texDesc.MipLevels = (UINT16)MipLevels();
 	texDesc.Format = mFormat;
 	texDesc.SampleDesc.Count = 1;
 	texDesc.SampleDesc.Quality = 0;
@@ -186,4 +197,6 @@ void RenderTexture::BuildResources()
 			IID_PPV_ARGS(&mRenderTex)
 		));
 	}
+
+	d3dUtil::TrackResource(mRenderTex.Get(), MemoryTracker::Category::RenderTexture);
 }
@@ -5,10 +5,13 @@
 class RenderTexture
 {
 public:
+	// mipLevels: length of the mip chain, at most down to 1x1. The descriptors built here view
+	// level 0, views of the other levels are up to the owner.
 	RenderTexture(ID3D12Device* device,
 		UINT width, UINT height,
 		DXGI_FORMAT format,
-		D3D12_RESOURCE_FLAGS flag = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+		D3D12_RESOURCE_FLAGS flag = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+		UINT mipLevels = 1);
 
 	RenderTexture(const RenderTexture& rhs) = delete;
 
@@ -46,6 +49,7 @@ public:
 	DXGI_FORMAT DsvFormat()const;
 	DXGI_FORMAT SrvFormat()const;
 	D3D12_RESOURCE_FLAGS Flag()const;
+	UINT MipLevels()const;
 
 protected:
 	virtual void BuildDescriptors() = 0;
@@ -54,6 +58,7 @@ protected:
 
 	UINT mWidth = 0;
 	UINT mHeight = 0;
+	UINT mMipLevels = 1;
 
 	D3D12_VIEWPORT mViewport;
 	D3D12_RECT mScissorRect;
@@ -0,0 +1,194 @@
+#include "SceneDatabase.h"
+#include "Culling.h"
+
+#include <cassert>
+
+using namespace DirectX;
+
+SceneDatabase::SceneDatabase(int numFramesDirty) :
+	mNumFramesDirtyInit(numFramesDirty)
+{
+	assert(numFramesDirty > 0 && numFramesDirty <= UINT8_MAX);
+}
+
+void SceneDatabase::Reserve(std::uint32_t count)
+{
+	mWorlds.reserve(count);
+	mLocalBounds.reserve(count);
+	mWorldBounds.reserve(count);
+	mDraws.reserve(count);
+	mObjCBIndices.reserve(count);
+	mNumFramesDirty.reserve(count);
+	mLodLevels.reserve(count);
+	mSlotOfItem.reserve(count);
+	mItemOfSlot.reserve(count);
+	mGenerations.reserve(count);
+}
+
+SceneDatabase::Handle SceneDatabase::Add(const XMFLOAT4X4& world, const BoundingBox& localBounds, const DrawArgs& drawArgs)
+{
+	std::uint32_t slot;
+	if (!mFreeSlots.empty()) {
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else {
+		slot = (std::uint32_t)mItemOfSlot.size();
+		mItemOfSlot.push_back(0);
+		mGenerations.push_back(0);
+	}
+
+	std::uint32_t objCBIndex;
+	if (!mFreeObjCBIndices.empty()) {
+		objCBIndex = mFreeObjCBIndices.back();
+		mFreeObjCBIndices.pop_back();
+	}
+	else {
+		objCBIndex = mNextObjCBIndex++;
+	}
+
+	const std::uint32_t index = Size();
+	mWorlds.push_back(world);
+	mLocalBounds.push_back(localBounds);
+	mWorldBounds.emplace_back();
+	mDraws.push_back(drawArgs);
+	mObjCBIndices.push_back(objCBIndex);
+	mNumFramesDirty.push_back((std::uint8_t)mNumFramesDirtyInit);
+	mLodLevels.push_back(0);
+	mSlotOfItem.push_back(slot);
+
+	mItemOfSlot[slot] = index;
+	UpdateWorldBounds(index);
+
+	return { slot, mGenerations[slot] };
+}
+
+void SceneDatabase::Remove(Handle handle)
+{
+	if (!IsValid(handle))
+		return;
+
+	const std::uint32_t index = mItemOfSlot[handle.Slot];
+	const std::uint32_t last = Size() - 1;
+
+	mFreeObjCBIndices.push_back(mObjCBIndices[index]);
+
+	// keep the columns dense: the last item takes the hole
+	if (index != last) {
+		mWorlds[index] = mWorlds[last];
+		mLocalBounds[index] = mLocalBounds[last];
+		mWorldBounds[index] = mWorldBounds[last];
+		mDraws[index] = mDraws[last];
+		mObjCBIndices[index] = mObjCBIndices[last];
+		mNumFramesDirty[index] = mNumFramesDirty[last];
+		mLodLevels[index] = mLodLevels[last];
+		mSlotOfItem[index] = mSlotOfItem[last];
+		mItemOfSlot[mSlotOfItem[index]] = index;
+	}
+
+	mWorlds.pop_back();
+	mLocalBounds.pop_back();
+	mWorldBounds.pop_back();
+	mDraws.pop_back();
+	mObjCBIndices.pop_back();
+	mNumFramesDirty.pop_back();
+	mLodLevels.pop_back();
+	mSlotOfItem.pop_back();
+
+	mGenerations[handle.Slot]++;
+	mFreeSlots.push_back(handle.Slot);
+}
+
+bool SceneDatabase::IsValid(Handle handle)const
+{
+	return handle.Slot < mGenerations.size() && mGenerations[handle.Slot] == handle.Generation;
+}
+
+void SceneDatabase::SetWorld(Handle handle, const XMFLOAT4X4& world)
+{
+	assert(IsValid(handle));
+
+	const std::uint32_t index = mItemOfSlot[handle.Slot];
+	mWorlds[index] = world;
+	mNumFramesDirty[index] = (std::uint8_t)mNumFramesDirtyInit;
+	UpdateWorldBounds(index);
+}
+
+std::uint32_t SceneDatabase::Size()const
+{
+	return (std::uint32_t)mWorlds.size();
+}
+
+std::uint32_t SceneDatabase::IndexOf(Handle handle)const
+{
+	assert(IsValid(handle));
+	return mItemOfSlot[handle.Slot];
+}
+
+const XMFLOAT4X4* SceneDatabase::Worlds()const
+{
+	return mWorlds.data();
+}
+
+const BoundingBox* SceneDatabase::LocalBounds()const
+{
+	return mLocalBounds.data();
+}
+
+const BoundingBox* SceneDatabase::WorldBounds()const
+{
+	return mWorldBounds.data();
+}
+
+const SceneDatabase::DrawArgs* SceneDatabase::Draws()const
+{
+	return mDraws.data();
+}
+
+const std::uint32_t* SceneDatabase::ObjCBIndices()const
+{
+	return mObjCBIndices.data();
+}
+
+const std::uint8_t* SceneDatabase::NumFramesDirty()const
+{
+	return mNumFramesDirty.data();
+}
+
+std::uint8_t* SceneDatabase::LodLevels()
+{
+	return mLodLevels.data();
+}
+
+std::uint32_t XM_CALLCONV SceneDatabase::Cull(
+	const BoundingFrustum& viewFrustum,
+	FXMMATRIX invView,
+	std::uint32_t* visible)const
+{
+	BoundingFrustum worldFrustum;
+	viewFrustum.Transform(worldFrustum, invView);
+
+	XMVECTOR planes[6];
+	worldFrustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+
+	std::uint32_t count = 0;
+	const std::uint32_t size = Size();
+	for (std::uint32_t i = 0; i < size; ++i) {
+		const ContainmentType coarse = mWorldBounds[i].ContainedBy(planes[0], planes[1], planes[2], planes[3], planes[4], planes[5]);
+		if (coarse == DISJOINT)
+			continue;
+
+		// the world box of a rotated item is looser than its oriented one, where it crosses a plane
+		// only the oriented test can tell
+		if (coarse == CONTAINS || Culling::IsVisible(viewFrustum, invView, XMLoadFloat4x4(&mWorlds[i]), mLocalBounds[i]))
+			visible[count++] = i;
+	}
+
+	return count;
+}
+
+void SceneDatabase::UpdateWorldBounds(std::uint32_t index)
+{
+	XMMATRIX world = XMLoadFloat4x4(&mWorlds[index]);
+	mLocalBounds[index].Transform(mWorldBounds[index], world);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+// Render items stored as parallel arrays. Items are packed densely (removal swaps the last item in),
+// and outside code refers to them through handles that stay valid until the item is removed.
+// Geometry is an index into a table owned by the app, so the database has no D3D dependency.
+class SceneDatabase
+{
+public:
+	struct Handle
+	{
+		std::uint32_t Slot = UINT32_MAX;
+		std::uint32_t Generation = 0;
+	};
+
+	static const std::uint32_t NoLodChain = UINT32_MAX;
+
+	struct DrawArgs
+	{
+		std::uint32_t Geometry = 0;
+		std::uint32_t PrimitiveType = 0;
+		std::uint32_t IndexCount = 0;
+		std::uint32_t StartIndexLocation = 0;
+		std::int32_t BaseVertexLocation = 0;
+
+		// Index into a table of LOD chains owned by the app, like Geometry.
+		std::uint32_t LodChain = NoLodChain;
+	};
+
+	// numFramesDirty: how many frame resources have to see a change, as RenderItem::NumFramesDirty.
+	explicit SceneDatabase(int numFramesDirty);
+
+	void Reserve(std::uint32_t count);
+
+	Handle Add(const DirectX::XMFLOAT4X4& world, const DirectX::BoundingBox& localBounds, const DrawArgs& drawArgs);
+	void Remove(Handle handle);
+	bool IsValid(Handle handle)const;
+
+	void SetWorld(Handle handle, const DirectX::XMFLOAT4X4& world);
+
+	std::uint32_t Size()const;
+	std::uint32_t IndexOf(Handle handle)const;
+
+	// Dense columns, all Size() long.
+	const DirectX::XMFLOAT4X4* Worlds()const;
+	const DirectX::BoundingBox* LocalBounds()const;
+	const DirectX::BoundingBox* WorldBounds()const;
+	const DrawArgs* Draws()const;
+	const std::uint32_t* ObjCBIndices()const;
+	const std::uint8_t* NumFramesDirty()const;
+
+	// Level of detail each item was drawn with, the app writes it back after selection.
+	std::uint8_t* LodLevels();
+
+	// Calls fn(index) for every item whose constants still have to reach a frame resource
+	// and counts its dirty frames down.
+	template<typename Fn>
+	void ForEachDirty(Fn fn)
+	{
+		const std::uint32_t size = Size();
+		for (std::uint32_t i = 0; i < size; ++i) {
+			if (mNumFramesDirty[i] > 0) {
+				fn(i);
+				mNumFramesDirty[i]--;
+			}
+		}
+	}
+
+	// Writes the indices of items Culling::IsVisible keeps, returns the count. The frustum is moved
+	// to world space once and the world space boxes are streamed through it; those outside a plane
+	// or inside all of them are decided there, the few crossing a plane get the oriented test.
+	std::uint32_t XM_CALLCONV Cull(
+		const DirectX::BoundingFrustum& viewFrustum,
+		DirectX::FXMMATRIX invView,
+		std::uint32_t* visible)const;
+
+private:
+	void UpdateWorldBounds(std::uint32_t index);
+
+	int mNumFramesDirtyInit;
+
+	// dense, indexed by item
+	std::vector<DirectX::XMFLOAT4X4> mWorlds;
+	std::vector<DirectX::BoundingBox> mLocalBounds;
+	std::vector<DirectX::BoundingBox> mWorldBounds;
+	std::vector<DrawArgs> mDraws;
+	std::vector<std::uint32_t> mObjCBIndices;
+	std::vector<std::uint8_t> mNumFramesDirty;
+	std::vector<std::uint8_t> mLodLevels;
+	std::vector<std::uint32_t> mSlotOfItem;
+
+	// sparse, indexed by handle slot
+	std::vector<std::uint32_t> mItemOfSlot;
+	std::vector<std::uint32_t> mGenerations;
+	std::vector<std::uint32_t> mFreeSlots;
+
+	// a removed item gives its constant buffer slot back
+	std::vector<std::uint32_t> mFreeObjCBIndices;
+	std::uint32_t mNextObjCBIndex = 0;
+};
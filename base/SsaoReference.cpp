@@ -0,0 +1,222 @@
+#include "SsaoReference.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Parallel.h"
+
+using namespace DirectX;
+
+namespace
+{
+	// gSamDepthMap: bilinear, opaque white border. x and y in texels, 0 the center of the first one.
+	float SampleDepth(const SsaoReference::GBuffer& gbuffer, float x, float y)
+	{
+		x = std::min(std::max(x, -1.0f), (float)gbuffer.Width);
+		y = std::min(std::max(y, -1.0f), (float)gbuffer.Height);
+		const float fx = std::floor(x), fy = std::floor(y);
+		const int x0 = (int)fx, y0 = (int)fy;
+
+		auto texel = [&](int px, int py) {
+			if (px < 0 || py < 0 || px >= (int)gbuffer.Width || py >= (int)gbuffer.Height)
+				return 1.0f;
+			return gbuffer.Depths[(std::size_t)py * gbuffer.Width + px];
+		};
+		const float tx = x - fx, ty = y - fy;
+		const float top = texel(x0, y0) + (texel(x0 + 1, y0) - texel(x0, y0)) * tx;
+		const float bottom = texel(x0, y0 + 1) + (texel(x0 + 1, y0 + 1) - texel(x0, y0 + 1)) * tx;
+		return top + (bottom - top) * ty;
+	}
+
+	float Unorm8(std::uint32_t texel, int channel)
+	{
+		return ((texel >> (8 * channel)) & 0xff) / 255.0f;
+	}
+
+	// One direction of blur_cs.hlsl: every line (row for the horizontal pass, column for the
+	// vertical one) loads view depth and normal once, as the thread group does into groupshared.
+	void BlurPass(
+		const SsaoReference::GBuffer& gbuffer,
+		const SsaoReference::Constants& constants,
+		std::uint32_t width,
+		std::uint32_t height,
+		bool horizontal,
+		const std::vector<float>& input,
+		std::vector<float>& output,
+		unsigned threadCount)
+	{
+		const int radius = std::min((int)constants.BlurWeights.size() / 2, SsaoReference::MaxBlurRadius);
+		const int step = (int)constants.Downsample;
+		const int length = horizontal ? (int)width : (int)height;
+		const std::size_t stride = horizontal ? 1 : width;
+		output.resize(input.size());
+
+		Parallel::For(horizontal ? height : width, [&](std::size_t line) {
+			const std::size_t first = horizontal ? line * width : line;
+			std::vector<float> depths(length), values(length);
+			std::vector<XMFLOAT3> normals(length);
+			std::vector<std::uint8_t> background(length);
+			for (int i = 0; i < length; ++i) {
+				const int x = horizontal ? i : (int)line, y = horizontal ? (int)line : i;
+				const std::size_t g = (std::size_t)std::min(y * step + step / 2, (int)gbuffer.Height - 1) * gbuffer.Width +
+					std::min(x * step + step / 2, (int)gbuffer.Width - 1);
+				depths[i] = SsaoReference::NdcDepthToViewDepth(gbuffer.Depths[g], constants.Proj);
+				normals[i] = gbuffer.Normals[g];
+				background[i] = gbuffer.Depths[g] >= 1.0f;
+				values[i] = input[first + i * stride];
+			}
+
+			for (int i = 0; i < length; ++i) {
+				float& result = output[first + i * stride];
+				if (background[i]) {
+					result = values[i];
+					continue;
+				}
+
+				// taps past the edge repeat the edge texel, the cache is loaded with clamped coordinates
+				const XMVECTOR centerNormal = XMLoadFloat3(&normals[i]);
+				float sum = constants.BlurWeights[radius] * values[i];
+				float totalWeight = constants.BlurWeights[radius];
+				for (int k = -radius; k <= radius; ++k) {
+					const int tap = std::min(std::max(i + k, 0), length - 1);
+					if (k == 0 ||
+						XMVectorGetX(XMVector3Dot(XMLoadFloat3(&normals[tap]), centerNormal)) < 0.8f ||
+						std::abs(depths[tap] - depths[i]) > 0.2f)
+						continue;
+					const float weight = constants.BlurWeights[k + radius];
+					sum += weight * values[tap];
+					totalWeight += weight;
+				}
+				result = std::min(std::max(sum / totalWeight, 0.0f), 1.0f);
+			}
+		}, threadCount);
+	}
+}
+
+std::uint32_t SsaoReference::MapWidth(const GBuffer& gbuffer, const Constants& constants)
+{
+	return std::max(gbuffer.Width / std::max(constants.Downsample, 1u), 1u);
+}
+
+std::uint32_t SsaoReference::MapHeight(const GBuffer& gbuffer, const Constants& constants)
+{
+	return std::max(gbuffer.Height / std::max(constants.Downsample, 1u), 1u);
+}
+
+void SsaoReference::Occlusion(const GBuffer& gbuffer, const Constants& constants, std::vector<float>& ssaoMap, unsigned threadCount)
+{
+	const std::uint32_t width = MapWidth(gbuffer, constants), height = MapHeight(gbuffer, constants);
+	ssaoMap.resize((std::size_t)width * height);
+
+	// NDC to texture space, as App_SSAO builds gProjTex
+	const XMMATRIX proj = XMLoadFloat4x4(&constants.Proj);
+	const XMMATRIX toTexture(
+		0.5f, 0.0f, 0.0f, 0.0f,
+		0.0f, -0.5f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.5f, 0.5f, 0.0f, 1.0f);
+	const XMMATRIX projTex = proj * toTexture;
+	const XMMATRIX invProj = XMMatrixInverse(nullptr, proj);
+	const std::size_t offsetCount = constants.OffsetVectors.size();
+	const float scaleX = (float)gbuffer.Width / width, scaleY = (float)gbuffer.Height / height;
+
+	Parallel::For(height, [&](std::size_t y) {
+		for (std::uint32_t x = 0; x < width; ++x) {
+			const std::size_t index = y * width + x;
+			const float u = (x + 0.5f) / width, v = (y + 0.5f) / height;
+
+			// The G-buffer at the pixel center: normal point sampled, depth filtered. At full
+			// resolution both are the texel under the pixel.
+			const float gx = (x + 0.5f) * scaleX, gy = (y + 0.5f) * scaleY;
+			const std::size_t g = (std::size_t)std::min((std::uint32_t)gy, gbuffer.Height - 1) * gbuffer.Width + std::min((std::uint32_t)gx, gbuffer.Width - 1);
+			const float depth = constants.Downsample > 1 ? SampleDepth(gbuffer, gx - 0.5f, gy - 0.5f) : gbuffer.Depths[g];
+
+			// the pixel on the near plane, then along its ray to the depth in the G-buffer
+			const XMVECTOR posVNear = XMVector4Transform(XMVectorSet(2.0f * u - 1.0f, 1.0f - 2.0f * v, 0.0f, 1.0f), invProj);
+			const float pz = NdcDepthToViewDepth(depth, constants.Proj);
+			const XMVECTOR p = XMVectorScale(posVNear, pz / XMVectorGetZ(posVNear));
+			const XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&gbuffer.Normals[g]));
+			XMFLOAT3 normal;
+			XMStoreFloat3(&normal, n);
+
+			// the basis around the normal, turned by the noise texel (point wrap, one texel per pixel)
+			float cosine = 1.0f, sine = 0.0f;
+			if (constants.NoiseSize > 0) {
+				const std::uint32_t texel = constants.Noise[(y % constants.NoiseSize) * constants.NoiseSize + x % constants.NoiseSize];
+				cosine = 2.0f * Unorm8(texel, 0) - 1.0f;
+				sine = 2.0f * Unorm8(texel, 1) - 1.0f;
+			}
+			const float sz = normal.z >= 0.0f ? 1.0f : -1.0f;
+			const float a = -1.0f / (sz + normal.z);
+			const float bxy = normal.x * normal.y * a;
+			const XMVECTOR t0 = XMVectorSet(1.0f + sz * normal.x * normal.x * a, sz * bxy, -sz * normal.x, 0.0f);
+			const XMVECTOR b0 = XMVectorSet(bxy, sz + normal.y * normal.y * a, -normal.y, 0.0f);
+			const XMVECTOR t = XMVectorAdd(XMVectorScale(t0, cosine), XMVectorScale(b0, sine));
+			const XMVECTOR b = XMVector3Cross(n, t);
+
+			float occlusionSum = 0.0f;
+			for (std::size_t i = 0; i < offsetCount; ++i) {
+				const XMFLOAT4& k = constants.OffsetVectors[i];
+				XMVECTOR offset = XMVectorScale(t, k.x);
+				offset = XMVectorMultiplyAdd(XMVectorReplicate(k.y), b, offset);
+				offset = XMVectorMultiplyAdd(XMVectorReplicate(k.z), n, offset);
+				const XMVECTOR q = XMVectorSetW(XMVectorMultiplyAdd(XMVectorReplicate(constants.OcclusionRadius), offset, p), 1.0f);
+
+				// the closest surface along the ray to q
+				const XMVECTOR projQ = XMVector4Transform(q, projTex);
+				const float w = XMVectorGetW(projQ);
+				const float qx = XMVectorGetX(projQ) / w * gbuffer.Width - 0.5f, qy = XMVectorGetY(projQ) / w * gbuffer.Height - 0.5f;
+				const float rz = NdcDepthToViewDepth(SampleDepth(gbuffer, qx, qy), constants.Proj);
+				const XMVECTOR r = XMVectorScale(q, rz / XMVectorGetZ(q));
+
+				// a zero length direction is NaN on the GPU, and max() drops it
+				const float disZ = XMVectorGetZ(p) - XMVectorGetZ(r);
+				const XMVECTOR toR = XMVectorSubtract(r, p);
+				const float length = XMVectorGetX(XMVector3Length(toR));
+				const float dp = length > 0.0f ? std::max(XMVectorGetX(XMVector3Dot(n, toR)) / length, 0.0f) : 0.0f;
+				occlusionSum += dp * OcclusionFunction(disZ, constants);
+			}
+
+			const float access = offsetCount ? 1.0f - occlusionSum / offsetCount : 1.0f;
+			ssaoMap[index] = std::min(std::max(access * access, 0.0f), 1.0f);
+		}
+	}, threadCount);
+}
+
+void SsaoReference::Blur(
+	const GBuffer& gbuffer,
+	const Constants& constants,
+	const std::vector<float>& ssaoMap,
+	std::vector<float>& blurred,
+	unsigned threadCount)
+{
+	const std::uint32_t width = MapWidth(gbuffer, constants), height = MapHeight(gbuffer, constants);
+	std::vector<float> horizontal;
+	BlurPass(gbuffer, constants, width, height, true, ssaoMap, horizontal, threadCount);
+	BlurPass(gbuffer, constants, width, height, false, horizontal, blurred, threadCount);
+}
+
+float SsaoReference::NdcDepthToViewDepth(float zNdc, const XMFLOAT4X4& proj)
+{
+	// gProj[3][2] / (zNdc - gProj[2][2]), the shader sees the transposed matrix
+	return proj._43 / (zNdc - proj._33);
+}
+
+float SsaoReference::OcclusionFunction(float distZ, const Constants& constants)
+{
+	if (distZ <= constants.SurfaceEpsilon)
+		return 0.0f;
+	const float fadeLength = constants.OcclusionFadeEnd - constants.OcclusionFadeStart;
+	return std::min(std::max((constants.OcclusionFadeEnd - distZ) / fadeLength, 0.0f), 1.0f);
+}
+
+void SsaoReference::RotationNoise(const std::vector<std::uint16_t>& ranks, std::vector<std::uint32_t>& texels)
+{
+	texels.resize(ranks.size());
+	for (std::size_t i = 0; i < ranks.size(); ++i) {
+		const float angle = XM_2PI * (ranks[i] + 0.5f) / ranks.size();
+		const std::uint32_t r = (std::uint32_t)std::lround((0.5f * std::cos(angle) + 0.5f) * 255.0f);
+		const std::uint32_t g = (std::uint32_t)std::lround((0.5f * std::sin(angle) + 0.5f) * 255.0f);
+		texels[i] = r | g << 8 | 128u << 16;
+	}
+}
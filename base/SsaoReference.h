@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// The SSAO passes of App_SSAO (Shaders/SSAO/ssaoMap.hlsl and blur_cs.hlsl) on the CPU: the same math
+// on the same inputs, a pixel's vector work in DirectXMath and rows spread over threads. A reference
+// to check changes to the shaders against without a GPU, and a headless way to time them.
+// The GPU keeps the SSAO map and the half blurred one as R16_FLOAT and the result as R8G8B8A8_UNORM,
+// so the two agree to about 1/255; everything here stays in float.
+class SsaoReference
+{
+public:
+	// What the G-buffer pass leaves, Width x Height with rows from the top.
+	struct GBuffer
+	{
+		std::uint32_t Width = 0;
+		std::uint32_t Height = 0;
+		std::vector<DirectX::XMFLOAT3> Normals;	// view space, gGbuffer[0]
+		std::vector<float> Depths;				// NDC z, gGbuffer[1], 1 where nothing was drawn
+	};
+
+	// The pass constants with App_SSAO's values.
+	struct Constants
+	{
+		DirectX::XMFLOAT4X4 Proj;				// as the camera gives it, not transposed
+		std::vector<DirectX::XMFLOAT4> OffsetVectors;
+		float OcclusionRadius = 0.5f;
+		float SurfaceEpsilon = 0.05f;
+		float OcclusionFadeStart = 0.2f;
+		float OcclusionFadeEnd = 1.0f;
+
+		// RandomVectorMap: NoiseSize x NoiseSize RGBA8 texels, red in the low byte
+		std::uint32_t NoiseSize = 0;
+		std::vector<std::uint32_t> Noise;
+
+		// gBlurWeights, 2 * radius + 1 of them, radius up to MaxBlurRadius
+		std::vector<float> BlurWeights;
+
+		// 1: the SSAO map has the size of the G-buffer. 2: half of it in both directions, the blur
+		// reading the G-buffer texel at 2 * xy + 1 for each of its pixels.
+		std::uint32_t Downsample = 1;
+	};
+
+	// The groupshared cache of blur_cs.hlsl holds this many texels on either side of a row.
+	static const int MaxBlurRadius = 8;
+
+	// Size of the SSAO map for a G-buffer.
+	static std::uint32_t MapWidth(const GBuffer& gbuffer, const Constants& constants);
+	static std::uint32_t MapHeight(const GBuffer& gbuffer, const Constants& constants);
+
+	// ssaoMap.hlsl: the ambient access of every pixel of the map.
+	static void Occlusion(const GBuffer& gbuffer, const Constants& constants, std::vector<float>& ssaoMap, unsigned threadCount = 0);
+
+	// blur_cs.hlsl: ssaoMap blurred along rows, then columns, where normal and depth say the
+	// neighbours lie on the same surface. Taps past the edge repeat the edge pixel.
+	static void Blur(
+		const GBuffer& gbuffer,
+		const Constants& constants,
+		const std::vector<float>& ssaoMap,
+		std::vector<float>& blurred,
+		unsigned threadCount = 0);
+
+	static float NdcDepthToViewDepth(float zNdc, const DirectX::XMFLOAT4X4& proj);
+	static float OcclusionFunction(float distZ, const Constants& constants);
+
+	// The RandomVectorMap texels for blue noise ranks (BlueNoise::Generate): a rotation angle around
+	// the normal each, as (cos, sin) in red and green.
+	static void RotationNoise(const std::vector<std::uint16_t>& ranks, std::vector<std::uint32_t>& texels);
+
+private:
+	SsaoReference() = delete;
+	~SsaoReference() = delete;
+};
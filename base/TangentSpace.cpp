@@ -0,0 +1,229 @@
+#include "TangentSpace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	// Angle of the corner at a between the edges to b and c.
+	float CornerAngle(FXMVECTOR a, FXMVECTOR b, FXMVECTOR c)
+	{
+		XMVECTOR e1 = XMVector3Normalize(b - a), e2 = XMVector3Normalize(c - a);
+		float cosAngle = XMVectorGetX(XMVector3Dot(e1, e2));
+		return std::acos(std::min(1.0f, std::max(-1.0f, cosAngle)));
+	}
+
+	// Any unit vector perpendicular to n, from the axis n is least aligned with.
+	XMVECTOR Perpendicular(FXMVECTOR n)
+	{
+		XMFLOAT3 a;
+		XMStoreFloat3(&a, XMVectorAbs(n));
+		XMVECTOR axis = a.x <= a.y && a.x <= a.z ? XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) :
+			a.y <= a.z ? XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f) : XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+		return XMVector3Normalize(XMVector3Cross(axis, n));
+	}
+
+	bool IsZero(FXMVECTOR v)
+	{
+		return XMVectorGetX(XMVector3LengthSq(v)) < 1e-20f;
+	}
+
+	// Corners of a vertex whose tangents are further apart than this get vertices of their own.
+	const float gMinTangentDot = 0.5f;
+
+	// Unit dP/du and the unnormalized dP/dv of a triangle, false where the UVs don't define them.
+	bool FaceFrame(const GeometryGenerator::Vertex* vertices, const std::uint32_t corner[3], XMVECTOR& tangent, XMVECTOR& bitangent)
+	{
+		XMVECTOR p0 = XMLoadFloat3(&vertices[corner[0]].Position);
+		XMVECTOR e1 = XMLoadFloat3(&vertices[corner[1]].Position) - p0;
+		XMVECTOR e2 = XMLoadFloat3(&vertices[corner[2]].Position) - p0;
+		const XMFLOAT2& uv0 = vertices[corner[0]].TexC;
+		const XMFLOAT2& uv1 = vertices[corner[1]].TexC;
+		const XMFLOAT2& uv2 = vertices[corner[2]].TexC;
+
+		// solve e1 = du1 * T + dv1 * B, e2 = du2 * T + dv2 * B for T and B
+		float du1 = uv1.x - uv0.x, dv1 = uv1.y - uv0.y;
+		float du2 = uv2.x - uv0.x, dv2 = uv2.y - uv0.y;
+		float det = du1 * dv2 - du2 * dv1;
+		if (std::fabs(det) < 1e-12f)
+			return false;
+
+		tangent = (e1 * dv2 - e2 * dv1) * (1.0f / det);
+		bitangent = (e2 * du1 - e1 * du2) * (1.0f / det);
+		if (IsZero(tangent))
+			return false;
+		tangent = XMVector3Normalize(tangent);
+		return true;
+	}
+
+	// The face tangent projected onto the normal plane of a corner, and -1 where B points away
+	// from cross(N, T), i.e. the UVs are mirrored. False where the tangent runs along the normal.
+	bool CornerTangent(FXMVECTOR n, FXMVECTOR faceTangent, FXMVECTOR faceBitangent, XMVECTOR& tangent, float& side)
+	{
+		tangent = faceTangent - n * XMVector3Dot(n, faceTangent);
+		if (IsZero(tangent))
+			return false;
+		tangent = XMVector3Normalize(tangent);
+		side = XMVectorGetX(XMVector3Dot(XMVector3Cross(n, faceTangent), faceBitangent)) < 0.0f ? -1.0f : 1.0f;
+		return true;
+	}
+
+	// Writes TangentU from the summed corner tangents and the summed handedness of each vertex.
+	void StoreTangents(GeometryGenerator::Vertex* vertices, size_t vertexCount, const std::vector<XMFLOAT3>& sums, const std::vector<float>& handedness)
+	{
+		for (size_t i = 0; i < vertexCount; ++i) {
+			XMVECTOR n = XMLoadFloat3(&vertices[i].Normal);
+			XMVECTOR tangent = XMLoadFloat3(&sums[i]);
+
+			// the sum of projections can still lean off the plane once normalized, project again
+			tangent = tangent - n * XMVector3Dot(n, tangent);
+			tangent = IsZero(tangent) ? Perpendicular(n) : XMVector3Normalize(tangent);
+			XMStoreFloat4(&vertices[i].TangentU, XMVectorSetW(tangent, handedness[i] < 0.0f ? -1.0f : 1.0f));
+		}
+	}
+
+	// Gives the corners of a vertex that disagree on the handedness or lean more than
+	// acos(gMinTangentDot) apart copies of the vertex, so each copy gets one consistent frame,
+	// and fills in the tangents. Corners without a tangent stay on the original vertex.
+	void GenerateSplitTangents(GeometryGenerator::MeshData& mesh)
+	{
+		struct Group
+		{
+			std::uint32_t Vertex;
+			float Side;
+			XMFLOAT3 Tangent;		// weighted sum of the corner tangents
+			std::uint32_t Next;
+		};
+
+		std::vector<GeometryGenerator::Vertex>& vertices = mesh.Vertices;
+		std::vector<std::uint32_t>& indices = mesh.Indices32;
+		std::vector<std::uint32_t> firstGroup(vertices.size(), UINT32_MAX);
+		std::vector<Group> groups;
+		groups.reserve(vertices.size());
+
+		for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+			const std::uint32_t corner[3] = { indices[t], indices[t + 1], indices[t + 2] };
+			XMVECTOR faceTangent, faceBitangent;
+			if (!FaceFrame(vertices.data(), corner, faceTangent, faceBitangent))
+				continue;
+
+			XMVECTOR p[3];
+			for (int k = 0; k < 3; ++k)
+				p[k] = XMLoadFloat3(&vertices[corner[k]].Position);
+
+			for (int k = 0; k < 3; ++k) {
+				XMVECTOR tangent;
+				float side;
+				if (!CornerTangent(XMLoadFloat3(&vertices[corner[k]].Normal), faceTangent, faceBitangent, tangent, side))
+					continue;
+
+				// dot(normalize(sum), tangent) >= gMinTangentDot without the square root
+				std::uint32_t g = firstGroup[corner[k]], last = UINT32_MAX;
+				for (; g != UINT32_MAX; last = g, g = groups[g].Next) {
+					if (groups[g].Side != side)
+						continue;
+					XMVECTOR sum = XMLoadFloat3(&groups[g].Tangent);
+					float d = XMVectorGetX(XMVector3Dot(sum, tangent));
+					if (d >= 0.0f && d * d >= gMinTangentDot * gMinTangentDot * XMVectorGetX(XMVector3LengthSq(sum)))
+						break;
+				}
+
+				if (g == UINT32_MAX) {
+					Group group = { corner[k], side, XMFLOAT3(0.0f, 0.0f, 0.0f), UINT32_MAX };
+					if (last == UINT32_MAX) {
+						firstGroup[corner[k]] = (std::uint32_t)groups.size();
+					}
+					else {
+						group.Vertex = (std::uint32_t)vertices.size();
+						groups[last].Next = (std::uint32_t)groups.size();
+						const GeometryGenerator::Vertex copy = vertices[corner[k]];
+						vertices.push_back(copy);
+					}
+					g = (std::uint32_t)groups.size();
+					groups.push_back(group);
+				}
+
+				float angle = CornerAngle(p[k], p[(k + 1) % 3], p[(k + 2) % 3]);
+				XMStoreFloat3(&groups[g].Tangent, XMLoadFloat3(&groups[g].Tangent) + tangent * angle);
+				indices[t + k] = groups[g].Vertex;
+			}
+		}
+
+		// each vertex is one group now, its corners agree on the side
+		std::vector<XMFLOAT3> sums(vertices.size(), XMFLOAT3(0.0f, 0.0f, 0.0f));
+		std::vector<float> handedness(vertices.size(), 0.0f);
+		for (const Group& group : groups) {
+			sums[group.Vertex] = group.Tangent;
+			handedness[group.Vertex] = group.Side;
+		}
+		StoreTangents(vertices.data(), vertices.size(), sums, handedness);
+	}
+}
+
+void TangentSpace::GenerateNormals(GeometryGenerator::MeshData& mesh)
+{
+	GenerateNormals(mesh.Vertices.data(), mesh.Vertices.size(), mesh.Indices32.data(), mesh.Indices32.size());
+}
+
+void TangentSpace::GenerateNormals(GeometryGenerator::Vertex* vertices, std::size_t vertexCount, const std::uint32_t* indices, std::size_t indexCount)
+{
+	std::vector<XMFLOAT3> sums(vertexCount, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	for (size_t t = 0; t + 2 < indexCount; t += 3) {
+		const std::uint32_t corner[3] = { indices[t], indices[t + 1], indices[t + 2] };
+		XMVECTOR p[3];
+		for (int k = 0; k < 3; ++k)
+			p[k] = XMLoadFloat3(&vertices[corner[k]].Position);
+
+		XMVECTOR faceNormal = XMVector3Cross(p[1] - p[0], p[2] - p[0]);
+		if (IsZero(faceNormal))
+			continue;
+		faceNormal = XMVector3Normalize(faceNormal);
+
+		for (int k = 0; k < 3; ++k) {
+			float angle = CornerAngle(p[k], p[(k + 1) % 3], p[(k + 2) % 3]);
+			XMStoreFloat3(&sums[corner[k]], XMLoadFloat3(&sums[corner[k]]) + faceNormal * angle);
+		}
+	}
+
+	for (size_t i = 0; i < vertexCount; ++i) {
+		XMVECTOR n = XMLoadFloat3(&sums[i]);
+		XMStoreFloat3(&vertices[i].Normal, IsZero(n) ? XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f) : XMVector3Normalize(n));
+	}
+}
+
+void TangentSpace::GenerateTangents(GeometryGenerator::MeshData& mesh)
+{
+	GenerateSplitTangents(mesh);
+}
+
+void TangentSpace::GenerateTangents(GeometryGenerator::Vertex* vertices, std::size_t vertexCount, const std::uint32_t* indices, std::size_t indexCount)
+{
+	std::vector<XMFLOAT3> sums(vertexCount, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	std::vector<float> handedness(vertexCount, 0.0f);
+	for (size_t t = 0; t + 2 < indexCount; t += 3) {
+		const std::uint32_t corner[3] = { indices[t], indices[t + 1], indices[t + 2] };
+		XMVECTOR faceTangent, faceBitangent;
+		if (!FaceFrame(vertices, corner, faceTangent, faceBitangent))
+			continue;
+
+		XMVECTOR p[3];
+		for (int k = 0; k < 3; ++k)
+			p[k] = XMLoadFloat3(&vertices[corner[k]].Position);
+
+		for (int k = 0; k < 3; ++k) {
+			XMVECTOR tangent;
+			float side;
+			if (!CornerTangent(XMLoadFloat3(&vertices[corner[k]].Normal), faceTangent, faceBitangent, tangent, side))
+				continue;
+
+			float angle = CornerAngle(p[k], p[(k + 1) % 3], p[(k + 2) % 3]);
+			XMStoreFloat3(&sums[corner[k]], XMLoadFloat3(&sums[corner[k]]) + tangent * angle);
+			handedness[corner[k]] += side * angle;
+		}
+	}
+
+	StoreTangents(vertices, vertexCount, sums, handedness);
+}
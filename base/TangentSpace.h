@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Common/GeometryGenerator.h"
+
+// Vertex normals and tangents for imported meshes. The per triangle dP/du is projected onto each
+// corner's normal plane and summed weighted by the corner angle, as MikkTSpace does, but the result
+// isn't bit exact with it: normal maps baked against MikkTSpace can show small differences.
+// TangentU.w is the handedness, shaders rebuild the bitangent as cross(N, T) * w so mirrored UVs
+// get theirs flipped.
+class TangentSpace
+{
+public:
+	// Angle weighted average of the normals of the triangles using each vertex.
+	// Vertices not used by any triangle get +y.
+	static void GenerateNormals(GeometryGenerator::MeshData& mesh);
+
+	// Fills TangentU from Normal and TexC. Where the UVs don't define a direction (no texture
+	// coordinates, degenerate mapping) the tangent is some unit vector perpendicular to the normal.
+	// w is -1 where the UVs are mirrored. A vertex whose triangles disagree on the handedness or
+	// on the tangent by more than 60 degrees is split, each copy appended to the vertices and
+	// taking the indices of the triangles that agree with it.
+	static void GenerateTangents(GeometryGenerator::MeshData& mesh);
+
+	// The same over vertexCount vertices and indexCount indices into them, e.g. one mesh inside
+	// a merged vertex buffer. These can't grow, so nothing is split: a shared vertex takes the
+	// side with the larger corner angles and the average of the tangents.
+	static void GenerateNormals(GeometryGenerator::Vertex* vertices, std::size_t vertexCount, const std::uint32_t* indices, std::size_t indexCount);
+	static void GenerateTangents(GeometryGenerator::Vertex* vertices, std::size_t vertexCount, const std::uint32_t* indices, std::size_t indexCount);
+
+private:
+	TangentSpace() = delete;
+	~TangentSpace() = delete;
+};
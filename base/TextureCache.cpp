@@ -0,0 +1,234 @@
+#include "TextureCache.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	std::string ForwardSlashes(std::string path)
+	{
+		std::replace(path.begin(), path.end(), '\\', '/');
+		return path;
+	}
+
+	bool ReadFile(const std::string& path, std::vector<std::uint8_t>& data)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+			return false;
+
+		std::streamoff size = file.tellg();
+		if (size < 0)
+			return false;
+
+		data.resize((size_t)size);
+		file.seekg(0);
+		return (bool)file.read((char*)data.data(), size);
+	}
+
+	void Free(std::vector<std::uint8_t>& data)
+	{
+		std::vector<std::uint8_t>().swap(data);
+	}
+
+	// Whether two loaded images hold the same texture. The hash only narrows it down, decoded
+	// images then compare their pixels and the rest their files. A released image only has its
+	// hash and size left.
+	bool SameContents(const TextureCache::Image& a, const TextureCache::Image& b)
+	{
+		if (a.Hash != b.Hash || a.FileSize != b.FileSize)
+			return false;
+		if (a.Released || b.Released)
+			return true;
+		if (!a.Pixels.empty() || !b.Pixels.empty())
+			return a.Width == b.Width && a.Height == b.Height && a.Pixels == b.Pixels;
+		return a.File == b.File;
+	}
+}
+
+TextureCache& TextureCache::Get()
+{
+	static TextureCache cache;
+	return cache;
+}
+
+std::string TextureCache::CanonicalPath(const std::string& directory, const std::string& path)
+{
+	std::filesystem::path result(ForwardSlashes(path));
+	if (result.is_relative())
+		result = std::filesystem::path(ForwardSlashes(directory)) / result;
+
+	std::error_code error;
+	std::filesystem::path canonical = std::filesystem::weakly_canonical(result, error);
+	return (error ? result.lexically_normal() : canonical).generic_string();
+}
+
+std::uint64_t TextureCache::HashBytes(const void* data, std::size_t size)
+{
+	// FNV-1a
+	const std::uint8_t* bytes = (const std::uint8_t*)data;
+	std::uint64_t hash = 14695981039346656037ull;
+	for (std::size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::uint32_t TextureCache::Request(const std::string& directory, const std::string& path)
+{
+	// no file, or a texture embedded in the model ("*0")
+	if (path.empty() || path[0] == '*')
+		return InvalidId;
+
+	std::string canonical = CanonicalPath(directory, path);
+	std::error_code error;
+	if (!std::filesystem::exists(canonical, error)) {
+		std::string name = std::filesystem::path(ForwardSlashes(path)).filename().string();
+		std::string local = CanonicalPath(directory, name);
+		if (std::filesystem::exists(local, error))
+			canonical = local;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStats.Requests++;
+
+	auto found = mPaths.find(canonical);
+	if (found != mPaths.end()) {
+		mStats.PathHits++;
+		return found->second;
+	}
+
+	std::uint32_t id = (std::uint32_t)mImages.size();
+	mImages.push_back(std::make_unique<Image>());
+	mImages.back()->Path = canonical;
+	mResolved.push_back(id);
+	mPaths.emplace(canonical, id);
+	mPending.push_back(id);
+	return id;
+}
+
+void TextureCache::LoadPending(const Decoder& decoder, unsigned threadCount)
+{
+	std::vector<std::uint32_t> pending;
+	std::vector<Image*> images;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		pending.swap(mPending);
+		for (std::uint32_t id : pending)
+			images.push_back(mImages[id].get());
+	}
+
+	// the images are not shared until they are resolved below
+	Parallel::For(images.size(), [&](size_t i) {
+		Load(*images[i], decoder);
+	}, threadCount);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (std::uint32_t id : pending) {
+		Image& image = *mImages[id];
+		if (!image.Loaded) {
+			mStats.Failed++;
+			continue;
+		}
+
+		bool duplicate = false;
+		auto range = mHashes.equal_range(image.Hash);
+		for (auto it = range.first; it != range.second && !duplicate; ++it) {
+			if (SameContents(*mImages[it->second], image)) {
+				mResolved[id] = it->second;
+				duplicate = true;
+			}
+		}
+
+		if (duplicate) {
+			mStats.ContentHits++;
+			Free(image.File);
+			Free(image.Pixels);
+		}
+		else {
+			mHashes.emplace(image.Hash, id);
+			image.Memory.Reset(MemoryTracker::Category::TextureCacheCpu, image.File.size() + image.Pixels.size());
+		}
+	}
+}
+
+void TextureCache::Load(Image& image, const Decoder& decoder)
+{
+	image.Released = false;
+	if (!ReadFile(image.Path, image.File))
+		return;
+
+	image.FileSize = image.File.size();
+	image.Hash = HashBytes(image.File.data(), image.File.size());
+	image.Loaded = !decoder || decoder(image);
+
+	// what the GPU needs is in Pixels once there are any
+	if (!image.Loaded)
+		Free(image.Pixels);
+	if (!image.Loaded || !image.Pixels.empty())
+		Free(image.File);
+}
+
+std::uint32_t TextureCache::Resolve(std::uint32_t id)const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mResolved.at(id);
+}
+
+const TextureCache::Image& TextureCache::GetImage(std::uint32_t id)const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return *mImages[mResolved.at(id)];
+}
+
+void TextureCache::Release(std::uint32_t id)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	Image& image = *mImages[mResolved.at(id)];
+	if (!image.Loaded)
+		return;
+
+	Free(image.File);
+	Free(image.Pixels);
+	image.Memory.Reset();
+	image.Released = true;
+}
+
+bool TextureCache::Reload(std::uint32_t id, const Decoder& decoder)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	Image& image = *mImages[mResolved.at(id)];
+	if (!image.Released)
+		return image.Loaded;
+
+	Load(image, decoder);
+	if (image.Loaded)
+		image.Memory.Reset(MemoryTracker::Category::TextureCacheCpu, image.File.size() + image.Pixels.size());
+	return image.Loaded;
+}
+
+std::uint32_t TextureCache::Size()const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return (std::uint32_t)mImages.size();
+}
+
+TextureCache::Stats TextureCache::GetStats()const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStats;
+}
+
+void TextureCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mImages.clear();
+	mResolved.clear();
+	mPaths.clear();
+	mHashes.clear();
+	mPending.clear();
+	mStats = Stats();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryTracker.h"
+
+// Image files referenced by models, loaded once per process. Request() deduplicates by canonical
+// path right away, LoadPending() reads and decodes the new files on worker threads and then folds
+// files with the same contents into one image. It doesn't touch D3D, Model uploads the results
+// and then Release()s the data, only the hash stays behind to fold later copies of the file.
+class TextureCache
+{
+public:
+	static const std::uint32_t InvalidId = UINT32_MAX;
+
+	struct Image
+	{
+		std::string Path;					// canonical, '/' separated
+		std::uint64_t Hash = 0;				// of the file contents
+		std::uint64_t FileSize = 0;
+		bool Loaded = false;				// false until LoadPending() or when the file can't be read
+		bool Released = false;				// File and Pixels freed by Release()
+
+		// Dropped once the decoder has written Pixels.
+		std::vector<std::uint8_t> File;
+
+		// RGBA8 rows written by the decoder. Empty without one, or for formats the
+		// GPU loader takes as they are (DDS).
+		std::uint32_t Width = 0;
+		std::uint32_t Height = 0;
+		std::vector<std::uint8_t> Pixels;
+
+		// File and Pixels, as MemoryTracker::Category::TextureCacheCpu
+		TrackedAllocation Memory;
+	};
+
+	// Turns Image::File into Pixels, called on the worker threads. Returns false if the file can't be decoded.
+	using Decoder = std::function<bool(Image& image)>;
+
+	struct Stats
+	{
+		std::uint32_t Requests = 0;
+		std::uint32_t PathHits = 0;		// requests answered by an earlier one for the same file
+		std::uint32_t ContentHits = 0;	// loaded files identical to an earlier one
+		std::uint32_t Failed = 0;		// unreadable or not decodable
+	};
+
+	// Cache shared by every Model of the process.
+	static TextureCache& Get();
+
+	// Id of the image at path, relative paths start at directory. When the file isn't there the
+	// name is tried inside directory, exporters often keep paths from the artist's machine.
+	std::uint32_t Request(const std::string& directory, const std::string& path);
+
+	// Loads everything requested since the last call on up to threadCount threads (0: one per hardware thread).
+	void LoadPending(const Decoder& decoder = nullptr, unsigned threadCount = 0);
+
+	// The id that holds the data, another one than id when an earlier file had the same contents.
+	std::uint32_t Resolve(std::uint32_t id)const;
+
+	// Image of Resolve(id). The reference stays valid until Clear().
+	const Image& GetImage(std::uint32_t id)const;
+
+	// Frees File and Pixels of Resolve(id), e.g. once the upload is recorded. The image stays
+	// loaded and later files with its contents are still folded into it by hash and size.
+	void Release(std::uint32_t id);
+
+	// Reads and decodes Resolve(id) again if Release() freed it. Returns whether the image is loaded.
+	bool Reload(std::uint32_t id, const Decoder& decoder = nullptr);
+
+	// Ids handed out, including the ones folded into others.
+	std::uint32_t Size()const;
+	Stats GetStats()const;
+
+	// Drops every image. Ids from before are invalid afterwards.
+	void Clear();
+
+	static std::string CanonicalPath(const std::string& directory, const std::string& path);
+	static std::uint64_t HashBytes(const void* data, std::size_t size);
+
+private:
+	static void Load(Image& image, const Decoder& decoder);
+
+	mutable std::mutex mMutex;
+
+	// unique_ptr, so GetImage() references survive new requests
+	std::vector<std::unique_ptr<Image>> mImages;
+	std::vector<std::uint32_t> mResolved;
+	std::unordered_map<std::string, std::uint32_t> mPaths;
+	std::unordered_multimap<std::uint64_t, std::uint32_t> mHashes;
+	std::vector<std::uint32_t> mPending;
+	Stats mStats;
+};
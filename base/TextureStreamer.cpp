@@ -0,0 +1,363 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+using namespace DirectX;
+
+TextureStreamer::TextureStreamer(Backend& backend, const Options& options) :
+	mBackend(backend),
+	mOptions(options)
+{
+	mOptions.Latency = std::max(mOptions.Latency, 1u);
+	for (unsigned i = 0; i < mOptions.ThreadCount; ++i)
+		mWorkers.emplace_back([this]() { WorkerLoop(); });
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mWork.notify_all();
+	for (auto& worker : mWorkers)
+		worker.join();
+}
+
+std::uint32_t TextureStreamer::Register(DDSFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t mipCount)
+{
+	if (DDSParser::BitsPerPixel(format) == 0 || width == 0 || height == 0 || mipCount == 0)
+		return InvalidId;
+
+	Texture texture;
+	texture.Width = width;
+	texture.Height = height;
+	texture.MipCount = std::min(mipCount, (std::uint32_t)std::log2((double)std::max(width, height)) + 1u);
+
+	texture.TailMip = texture.MipCount - 1;
+	for (std::uint32_t mip = 0; mip < texture.MipCount; ++mip) {
+		const std::uint32_t w = std::max(1u, width >> mip), h = std::max(1u, height >> mip);
+		std::size_t rowPitch, slicePitch;
+		std::uint32_t rowCount;
+		DDSParser::SurfaceInfo(w, h, format, rowPitch, rowCount, slicePitch);
+		texture.MipBytes.push_back(slicePitch);
+
+		if (std::max(w, h) <= mOptions.TailSize)
+			texture.TailMip = std::min(texture.TailMip, mip);
+	}
+	texture.Resident = texture.MipCount;
+	texture.Desired = texture.TailMip;
+	texture.Requested = (float)texture.MipCount;
+
+	const std::uint32_t id = (std::uint32_t)mTextures.size();
+	mTextures.push_back(std::move(texture));
+	Issue(id, mTextures[id].TailMip, mTextures[id].MipCount - 1);
+	return id;
+}
+
+void XM_CALLCONV TextureStreamer::SetProjection(FXMMATRIX proj, float viewportHeight)
+{
+	XMFLOAT4X4 p;
+	XMStoreFloat4x4(&p, proj);
+
+	// _22 = 1 / tan(fovY / 2)
+	mScale = p._22 * 0.5f * viewportHeight;
+}
+
+float TextureStreamer::MipFor(std::uint32_t texture, float uvDensity, float distance)const
+{
+	const Texture& t = mTextures[texture];
+	if (distance <= 0.0f || uvDensity <= 0.0f)
+		return 0.0f;
+
+	// texels per world unit against pixels per world unit at that distance
+	const float texels = std::max(t.Width, t.Height) * uvDensity;
+	const float pixels = mScale / distance;
+	return std::log2(texels / pixels) + mOptions.MipBias;
+}
+
+void TextureStreamer::Request(std::uint32_t texture, float uvDensity, float distance)
+{
+	Texture& t = mTextures[texture];
+	t.Requested = std::min(t.Requested, std::max(0.0f, MipFor(texture, uvDensity, distance)));
+	t.LastUsed = mFrame;
+}
+
+void TextureStreamer::Update()
+{
+	// the reads issued Latency frames ago, whether the workers are done with them or not
+	auto due = [this](std::uint64_t frame) { return frame + mOptions.Latency <= mFrame; };
+	std::uint32_t dueCount = 0;
+	for (const Texture& t : mTextures) {
+		if (t.Loading != NoMip && due(t.LoadingFrame))
+			dueCount++;
+	}
+
+	std::vector<Load> finished;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		auto ready = [&]() {
+			return (std::uint32_t)std::count_if(mFinished.begin(), mFinished.end(), [&](const Load& load) { return due(load.Frame); }) == dueCount;
+		};
+		if (!ready()) {
+			mStats.Stalls++;
+			mDone.wait(lock, ready);
+		}
+
+		auto split = std::stable_partition(mFinished.begin(), mFinished.end(), [&](const Load& load) { return !due(load.Frame); });
+		finished.assign(std::make_move_iterator(split), std::make_move_iterator(mFinished.end()));
+		mFinished.erase(split, mFinished.end());
+	}
+	Apply(finished);
+
+	// unrequested textures only need their tail
+	for (Texture& t : mTextures)
+		t.Desired = std::min((std::uint32_t)t.Requested, t.TailMip);
+
+	// the next mip of every texture short of its desired one, the ones missing the most levels first
+	std::vector<std::uint32_t> candidates;
+	for (std::uint32_t id = 0; id < (std::uint32_t)mTextures.size(); ++id) {
+		const Texture& t = mTextures[id];
+		if (t.Loading == NoMip && t.Resident > t.Desired)
+			candidates.push_back(id);
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](std::uint32_t a, std::uint32_t b) {
+		const Texture& ta = mTextures[a];
+		const Texture& tb = mTextures[b];
+		const std::uint32_t missingA = ta.Resident - ta.Desired, missingB = tb.Resident - tb.Desired;
+		if (missingA != missingB)
+			return missingA > missingB;
+		return a < b;
+	});
+
+	mStats.Starved = 0;
+	for (std::uint32_t id : candidates) {
+		Texture& t = mTextures[id];
+
+		// a tail that failed before goes again, whatever the budget
+		if (t.Resident == t.MipCount) {
+			Issue(id, t.TailMip, t.MipCount - 1);
+			continue;
+		}
+
+		if (mStats.LoadsInFlight >= mOptions.MaxLoadsInFlight)
+			continue;
+		if (!MakeRoom(t.MipBytes[t.Resident - 1])) {
+			mStats.Starved++;
+			continue;
+		}
+		Issue(id, t.Resident - 1, t.Resident - 1);
+	}
+
+	for (Texture& t : mTextures)
+		t.Requested = (float)t.MipCount;
+	mFrame++;
+}
+
+void TextureStreamer::Flush()
+{
+	std::vector<Load> finished;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mDone.wait(lock, [this]() { return mQueue.empty() && mBusy == 0; });
+		finished.swap(mFinished);
+	}
+	Apply(finished);
+}
+
+std::uint32_t TextureStreamer::ResidentMip(std::uint32_t texture)const
+{
+	return mTextures[texture].Resident;
+}
+
+std::uint32_t TextureStreamer::DesiredMip(std::uint32_t texture)const
+{
+	return mTextures[texture].Desired;
+}
+
+std::uint32_t TextureStreamer::MipCount(std::uint32_t texture)const
+{
+	return mTextures[texture].MipCount;
+}
+
+std::uint32_t TextureStreamer::Size()const
+{
+	return (std::uint32_t)mTextures.size();
+}
+
+TextureStreamer::Stats TextureStreamer::GetStats()const
+{
+	return mStats;
+}
+
+float TextureStreamer::UVDensity(
+	const XMFLOAT3* positions,
+	std::size_t positionStride,
+	const XMFLOAT2* uvs,
+	std::size_t uvStride,
+	const std::uint32_t* indices,
+	std::size_t indexCount)
+{
+	auto position = [&](std::uint32_t i)
+	{
+		return XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const std::uint8_t*>(positions) + i * positionStride));
+	};
+	auto uv = [&](std::uint32_t i)
+	{
+		return XMLoadFloat2(reinterpret_cast<const XMFLOAT2*>(reinterpret_cast<const std::uint8_t*>(uvs) + i * uvStride));
+	};
+
+	// both areas doubled, it cancels out
+	float worldArea = 0.0f, uvArea = 0.0f;
+	for (std::size_t i = 0; i + 2 < indexCount; i += 3) {
+		const std::uint32_t i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+		XMVECTOR p0 = position(i0);
+		worldArea += XMVectorGetX(XMVector3Length(XMVector3Cross(position(i1) - p0, position(i2) - p0)));
+
+		XMVECTOR t0 = uv(i0);
+		uvArea += std::abs(XMVectorGetX(XMVector2Cross(uv(i1) - t0, uv(i2) - t0)));
+	}
+	return worldArea > 0.0f ? std::sqrt(uvArea / worldArea) : 0.0f;
+}
+
+void TextureStreamer::Issue(std::uint32_t texture, std::uint32_t first, std::uint32_t last)
+{
+	Texture& t = mTextures[texture];
+	t.Loading = first;
+	t.LoadingFrame = mFrame;
+	for (std::uint32_t mip = first; mip <= last; ++mip)
+		mStats.ResidentBytes += t.MipBytes[mip];
+	mStats.LoadsInFlight++;
+
+	Load load;
+	load.Texture = texture;
+	load.First = first;
+	load.Last = last;
+	load.Frame = mFrame;
+
+	if (mWorkers.empty()) {
+		Read(mBackend, load);
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFinished.push_back(std::move(load));
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQueue.push_back(std::move(load));
+	}
+	mWork.notify_one();
+}
+
+void TextureStreamer::Apply(std::vector<Load>& finished)
+{
+	// in a fixed order, whichever worker was first
+	std::sort(finished.begin(), finished.end(), [](const Load& a, const Load& b) {
+		return a.Texture != b.Texture ? a.Texture < b.Texture : a.First < b.First;
+	});
+
+	for (Load& load : finished) {
+		Texture& t = mTextures[load.Texture];
+		t.Loading = NoMip;
+		mStats.LoadsInFlight--;
+
+		if (!load.Succeeded) {
+			for (std::uint32_t mip = load.First; mip <= load.Last; ++mip)
+				mStats.ResidentBytes -= t.MipBytes[mip];
+			mStats.Failed++;
+			continue;
+		}
+
+		for (std::uint32_t mip = load.Last + 1; mip-- > load.First; )
+			mBackend.Upload(load.Texture, mip, load.Data[mip - load.First]);
+		mStats.Loads += load.Last - load.First + 1;
+		t.Resident = load.First;
+	}
+}
+
+bool TextureStreamer::MakeRoom(std::size_t bytes)
+{
+	if (mStats.ResidentBytes + bytes <= mOptions.Budget)
+		return true;
+
+	// Least recently used first. Textures requested this frame only give what they don't need,
+	// the others go down to their tail.
+	struct Victim
+	{
+		std::uint32_t Texture;
+		std::uint32_t Floor;
+	};
+	std::vector<Victim> victims;
+	std::size_t available = 0;
+	for (std::uint32_t id = 0; id < (std::uint32_t)mTextures.size(); ++id) {
+		const Texture& t = mTextures[id];
+		if (t.Loading != NoMip || t.Resident >= t.TailMip)
+			continue;
+
+		const std::uint32_t floor = t.LastUsed == mFrame ? t.Desired : t.TailMip;
+		if (t.Resident >= floor)
+			continue;
+
+		victims.push_back({ id, floor });
+		for (std::uint32_t mip = t.Resident; mip < floor; ++mip)
+			available += t.MipBytes[mip];
+	}
+
+	// nothing is dropped for a load that wouldn't fit anyway
+	if (mStats.ResidentBytes - available + bytes > mOptions.Budget)
+		return false;
+
+	std::sort(victims.begin(), victims.end(), [this](const Victim& a, const Victim& b) {
+		const std::uint64_t usedA = mTextures[a.Texture].LastUsed, usedB = mTextures[b.Texture].LastUsed;
+		return usedA != usedB ? usedA < usedB : a.Texture < b.Texture;
+	});
+
+	for (const Victim& victim : victims) {
+		Texture& t = mTextures[victim.Texture];
+		while (t.Resident < victim.Floor && mStats.ResidentBytes + bytes > mOptions.Budget) {
+			mStats.ResidentBytes -= t.MipBytes[t.Resident];
+			mStats.Evictions++;
+			t.Resident++;
+		}
+		mBackend.Evict(victim.Texture, t.Resident);
+
+		if (mStats.ResidentBytes + bytes <= mOptions.Budget)
+			break;
+	}
+	return true;
+}
+
+void TextureStreamer::WorkerLoop()
+{
+	for (;;) {
+		Load load;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWork.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+			if (mStopping)
+				return;
+			load = std::move(mQueue.front());
+			mQueue.pop_front();
+			mBusy++;
+		}
+
+		Read(mBackend, load);
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mFinished.push_back(std::move(load));
+			mBusy--;
+		}
+		mDone.notify_all();
+	}
+}
+
+void TextureStreamer::Read(Backend& backend, Load& load)
+{
+	load.Data.resize(load.Last - load.First + 1);
+	load.Succeeded = true;
+	for (std::uint32_t mip = load.First; mip <= load.Last && load.Succeeded; ++mip)
+		load.Succeeded = backend.Read(load.Texture, mip, load.Data[mip - load.First]);
+}
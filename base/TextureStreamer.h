@@ -0,0 +1,171 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "DDSParser.h"
+
+// Mip residency of streamed textures. Every texture starts with its small mips (the tail), finer
+// mips are read on worker threads one level at a time, coarse to fine, as the visible items ask
+// for them. Loads are issued and evictions chosen on the thread calling Update(), in a fixed order,
+// and a read lands Options::Latency updates after the one issuing it, waiting for the workers if
+// they're late. The same requests so give the same residency on every frame, however many
+// threads there are and however fast they read.
+// The Backend does the actual reading and the GPU side (DDSStreamBackend on D3D12), so the logic
+// runs without D3D.
+class TextureStreamer
+{
+public:
+	static const std::uint32_t InvalidId = UINT32_MAX;
+
+	// Where the mips come from and where they go.
+	class Backend
+	{
+	public:
+		virtual ~Backend() = default;
+
+		// Bytes of one mip, called on the worker threads (for different textures at the same time).
+		virtual bool Read(std::uint32_t texture, std::uint32_t mip, std::vector<std::uint8_t>& data) = 0;
+
+		// Called in Update(), coarse to fine: mip and the ones below it are usable from now on.
+		virtual void Upload(std::uint32_t texture, std::uint32_t mip, const std::vector<std::uint8_t>& data) = 0;
+
+		// Called in Update(): mips finer than mip can go. The GPU may still read them this frame.
+		virtual void Evict(std::uint32_t texture, std::uint32_t mip) = 0;
+	};
+
+	struct Options
+	{
+		// Bytes of every resident and loading mip together. The tails are always loaded, even over it.
+		std::size_t Budget = 256u << 20;
+
+		// Mips this size and below form the tail, loaded together on Register().
+		std::uint32_t TailSize = 64;
+
+		// Added to every desired mip, > 0 to stream less detail.
+		float MipBias = 0.0f;
+
+		std::uint32_t MaxLoadsInFlight = 16;
+
+		// Updates from issuing a read to applying it, at least 1. Reads issued by Register()
+		// count from the next Update().
+		std::uint32_t Latency = 2;
+
+		// Worker threads reading mips. 0: the reads run inside Update().
+		unsigned ThreadCount = 2;
+	};
+
+	struct Stats
+	{
+		std::size_t ResidentBytes = 0;		// including the loading mips
+		std::uint32_t LoadsInFlight = 0;
+		std::uint64_t Loads = 0;			// mips read
+		std::uint64_t Evictions = 0;		// mips dropped
+		std::uint64_t Failed = 0;			// reads that failed
+		std::uint32_t Starved = 0;			// textures short of their desired mip at the last Update() for lack of budget
+		std::uint64_t Stalls = 0;			// updates that waited for a read past its latency
+	};
+
+	TextureStreamer(Backend& backend, const Options& options);
+	~TextureStreamer();
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	// A texture in a format DDSParser knows, InvalidId otherwise. Its tail is queued right away.
+	std::uint32_t Register(DDSFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t mipCount);
+
+	// proj as returned by Camera::GetProj(). Call again whenever the lens or the viewport changes.
+	void XM_CALLCONV SetProjection(DirectX::FXMMATRIX proj, float viewportHeight);
+
+	// Mip whose texels come out about one per pixel on an item with uvDensity UV units per world
+	// unit (see UVDensity()), distance away from the eye. Fractional, before clamping to the chain.
+	float MipFor(std::uint32_t texture, float uvDensity, float distance)const;
+
+	// Demand of one visible item this frame, the finest request of the frame wins.
+	void Request(std::uint32_t texture, float uvDensity, float distance);
+
+	// Applies the reads that are due, then evicts and issues reads against this frame's requests,
+	// and starts the next frame.
+	void Update();
+
+	// Waits for every read in flight and applies it now, ahead of its latency.
+	void Flush();
+
+	// Finest mip the GPU can use, as told to the backend.
+	std::uint32_t ResidentMip(std::uint32_t texture)const;
+	std::uint32_t DesiredMip(std::uint32_t texture)const;
+	std::uint32_t MipCount(std::uint32_t texture)const;
+	std::uint32_t Size()const;
+	Stats GetStats()const;
+
+	// sqrt(uv area / world area) over a triangle list: UV units per world unit on average.
+	static float UVDensity(
+		const DirectX::XMFLOAT3* positions,
+		std::size_t positionStride,
+		const DirectX::XMFLOAT2* uvs,
+		std::size_t uvStride,
+		const std::uint32_t* indices,
+		std::size_t indexCount);
+
+private:
+	static const std::uint32_t NoMip = UINT32_MAX;
+
+	struct Texture
+	{
+		std::uint32_t Width = 0;
+		std::uint32_t Height = 0;
+		std::uint32_t MipCount = 0;
+		std::uint32_t TailMip = 0;					// first mip of the tail
+		std::vector<std::size_t> MipBytes;
+
+		std::uint32_t Resident = 0;					// MipCount until the tail is in
+		std::uint32_t Loading = NoMip;				// finest mip of the read in flight
+		std::uint64_t LoadingFrame = 0;				// frame that issued it
+		std::uint32_t Desired = 0;					// of the last Update()
+		float Requested = 0.0f;						// finest desired mip of this frame, MipCount when none
+		std::uint64_t LastUsed = 0;					// frame of the last request
+	};
+
+	struct Load
+	{
+		std::uint32_t Texture = 0;
+		std::uint32_t First = 0;					// mips [First, Last], uploaded coarse to fine
+		std::uint32_t Last = 0;
+		std::uint64_t Frame = 0;
+		std::vector<std::vector<std::uint8_t>> Data;
+		bool Succeeded = false;
+	};
+
+	void Issue(std::uint32_t texture, std::uint32_t first, std::uint32_t last);
+	void Apply(std::vector<Load>& finished);
+	bool MakeRoom(std::size_t bytes);
+	void WorkerLoop();
+	static void Read(Backend& backend, Load& load);
+
+	Backend& mBackend;
+	Options mOptions;
+
+	std::vector<Texture> mTextures;
+	std::uint64_t mFrame = 1;
+	Stats mStats;
+
+	// proj._22 * viewportHeight / 2, pixels per unit at distance 1
+	float mScale = 1.0f;
+
+	// reads, shared with the workers
+	std::mutex mMutex;
+	std::condition_variable mWork;
+	std::condition_variable mDone;
+	std::deque<Load> mQueue;
+	std::vector<Load> mFinished;
+	std::uint32_t mBusy = 0;
+	bool mStopping = false;
+	std::vector<std::thread> mWorkers;
+};
@@ -1,4 +1,99 @@
 #include "Toolkit.h"
+#include "Parallel.h"
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+
+using namespace DirectX;
+
+namespace
+{
+    // rows handed to a worker at a time
+    const std::size_t BandRows = 16;
+
+    XMVECTOR LoadPixel(const std::uint8_t* pixel)
+    {
+        return XMVectorScale(XMVectorSet(pixel[0], pixel[1], pixel[2], pixel[3]), 1.0f / 255.0f);
+    }
+
+    void StorePixel(FXMVECTOR color, std::uint8_t* pixel)
+    {
+        XMUINT4 q;
+        XMStoreUInt4(&q, XMConvertVectorFloatToUInt(XMVectorRound(XMVectorSaturate(color) * XMVectorReplicate(255.0f)), 0));
+        pixel[0] = (std::uint8_t)q.x;
+        pixel[1] = (std::uint8_t)q.y;
+        pixel[2] = (std::uint8_t)q.z;
+        pixel[3] = (std::uint8_t)q.w;
+    }
+
+    void ForBands(std::uint32_t height, unsigned threadCount, const std::function<void(std::size_t)>& fn)
+    {
+        const std::size_t bands = (height + BandRows - 1) / BandRows;
+        Parallel::For(bands, [&](std::size_t band) {
+            const std::size_t end = std::min<std::size_t>(height, (band + 1) * BandRows);
+            for (std::size_t y = band * BandRows; y < end; ++y)
+                fn(y);
+        }, threadCount);
+    }
+
+    struct Image
+    {
+        std::uint32_t Width = 0;
+        std::uint32_t Height = 0;
+        std::vector<XMFLOAT4> Pixels;
+    };
+
+    // gSamLinearClamp at (u, v)
+    XMVECTOR SampleBilinear(const Image& image, float u, float v)
+    {
+        const float x = std::min(std::max(u * image.Width - 0.5f, 0.0f), (float)(image.Width - 1));
+        const float y = std::min(std::max(v * image.Height - 0.5f, 0.0f), (float)(image.Height - 1));
+        const std::uint32_t x0 = (std::uint32_t)x, y0 = (std::uint32_t)y;
+        const std::uint32_t x1 = std::min(x0 + 1, image.Width - 1), y1 = std::min(y0 + 1, image.Height - 1);
+        const XMFLOAT4* row0 = &image.Pixels[(std::size_t)y0 * image.Width];
+        const XMFLOAT4* row1 = &image.Pixels[(std::size_t)y1 * image.Width];
+        const XMVECTOR tx = XMVectorReplicate(x - x0);
+        const XMVECTOR top = XMVectorLerpV(XMLoadFloat4(&row0[x0]), XMLoadFloat4(&row0[x1]), tx);
+        const XMVECTOR bottom = XMVectorLerpV(XMLoadFloat4(&row1[x0]), XMLoadFloat4(&row1[x1]), tx);
+        return XMVectorLerp(top, bottom, y - y0);
+    }
+
+    // DownCS and UpCS: offsets in texels of the input, around the center of each output texel
+    void KawasePass(const Image& input, Image& output, bool down, unsigned threadCount)
+    {
+        const float tu = 1.0f / input.Width, tv = 1.0f / input.Height;
+        ForBands(output.Height, threadCount, [&](std::size_t y) {
+            const float v = (y + 0.5f) / output.Height;
+            for (std::uint32_t x = 0; x < output.Width; ++x) {
+                const float u = (x + 0.5f) / output.Width;
+                XMVECTOR sum;
+                if (down) {
+                    sum = XMVectorScale(SampleBilinear(input, u, v), 4.0f);
+                    sum += SampleBilinear(input, u - tu, v - tv);
+                    sum += SampleBilinear(input, u + tu, v - tv);
+                    sum += SampleBilinear(input, u - tu, v + tv);
+                    sum += SampleBilinear(input, u + tu, v + tv);
+                    sum = XMVectorScale(sum, 1.0f / 8.0f);
+                }
+                else {
+                    sum = SampleBilinear(input, u - tu, v);
+                    sum += SampleBilinear(input, u + tu, v);
+                    sum += SampleBilinear(input, u, v - tv);
+                    sum += SampleBilinear(input, u, v + tv);
+                    sum += XMVectorScale(SampleBilinear(input, u - 0.5f * tu, v - 0.5f * tv), 2.0f);
+                    sum += XMVectorScale(SampleBilinear(input, u + 0.5f * tu, v - 0.5f * tv), 2.0f);
+                    sum += XMVectorScale(SampleBilinear(input, u - 0.5f * tu, v + 0.5f * tv), 2.0f);
+                    sum += XMVectorScale(SampleBilinear(input, u + 0.5f * tu, v + 0.5f * tv), 2.0f);
+                    sum = XMVectorScale(sum, 1.0f / 12.0f);
+                }
+                XMStoreFloat4(&output.Pixels[y * output.Width + x], sum);
+            }
+        });
+    }
+}
 
 std::vector<float> Toolkit::CalcGaussWeights(float sigma)
 {
@@ -27,3 +122,93 @@ std::vector<float> Toolkit::CalcGaussWeights(float sigma)
 
     return weights;
 }
+
+void Toolkit::GaussianBlur(
+    const std::uint8_t* source,
+    std::size_t sourceRowPitch,
+    std::uint32_t width,
+    std::uint32_t height,
+    const std::vector<float>& weights,
+    std::uint8_t* destination,
+    std::size_t rowPitch,
+    unsigned threadCount)
+{
+    const int radius = (int)weights.size() / 2;
+    assert(weights.size() % 2 == 1 && radius <= MaxBlurRadius);
+    if (width == 0 || height == 0)
+        return;
+
+    // HorzBlurCS: the row with its apron, as the thread group caches it, then the taps
+    std::vector<std::uint8_t> rows((std::size_t)width * height * 4);
+    ForBands(height, threadCount, [&](std::size_t y) {
+        const std::uint8_t* in = source + y * sourceRowPitch;
+        std::vector<XMFLOAT4> line(width + 2 * radius);
+        for (int i = 0; i < (int)line.size(); ++i)
+            XMStoreFloat4(&line[i], LoadPixel(in + 4 * std::min(std::max(i - radius, 0), (int)width - 1)));
+
+        std::uint8_t* out = rows.data() + y * width * 4;
+        for (std::uint32_t x = 0; x < width; ++x) {
+            XMVECTOR sum = XMVectorZero();
+            for (int k = 0; k <= 2 * radius; ++k)
+                sum = XMVectorMultiplyAdd(XMVectorReplicate(weights[k]), XMLoadFloat4(&line[x + k]), sum);
+            StorePixel(sum, out + 4 * x);
+        }
+    });
+
+    // VertBlurCS: a whole output row at a time, so every tap reads a row of the intermediate in order
+    ForBands(height, threadCount, [&](std::size_t y) {
+        std::vector<XMFLOAT4> sums(width, XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f));
+        for (int k = -radius; k <= radius; ++k) {
+            const std::size_t tapY = (std::size_t)std::min(std::max((int)y + k, 0), (int)height - 1);
+            const std::uint8_t* in = rows.data() + tapY * width * 4;
+            const XMVECTOR weight = XMVectorReplicate(weights[k + radius]);
+            for (std::uint32_t x = 0; x < width; ++x)
+                XMStoreFloat4(&sums[x], XMVectorMultiplyAdd(weight, LoadPixel(in + 4 * x), XMLoadFloat4(&sums[x])));
+        }
+
+        std::uint8_t* out = destination + y * rowPitch;
+        for (std::uint32_t x = 0; x < width; ++x)
+            StorePixel(XMLoadFloat4(&sums[x]), out + 4 * x);
+    });
+}
+
+void Toolkit::DualKawaseBlur(
+    const std::uint8_t* source,
+    std::size_t sourceRowPitch,
+    std::uint32_t width,
+    std::uint32_t height,
+    std::uint32_t levels,
+    std::uint8_t* destination,
+    std::size_t rowPitch,
+    unsigned threadCount)
+{
+    if (width == 0 || height == 0)
+        return;
+    levels = std::min(std::max(levels, 1u), (std::uint32_t)MaxKawaseLevels);
+
+    Image full;
+    full.Width = width;
+    full.Height = height;
+    full.Pixels.resize((std::size_t)width * height);
+    ForBands(height, threadCount, [&](std::size_t y) {
+        for (std::uint32_t x = 0; x < width; ++x)
+            XMStoreFloat4(&full.Pixels[y * width + x], LoadPixel(source + y * sourceRowPitch + 4 * x));
+    });
+
+    // level i is the mip i of the pyramid texture, half the size of the image at level 0
+    std::vector<Image> pyramid(levels);
+    for (std::uint32_t i = 0; i < levels; ++i) {
+        pyramid[i].Width = std::max(width >> (i + 1), 1u);
+        pyramid[i].Height = std::max(height >> (i + 1), 1u);
+        pyramid[i].Pixels.resize((std::size_t)pyramid[i].Width * pyramid[i].Height);
+        KawasePass(i == 0 ? full : pyramid[i - 1], pyramid[i], true, threadCount);
+    }
+    for (std::uint32_t i = levels - 1; i > 0; --i)
+        KawasePass(pyramid[i], pyramid[i - 1], false, threadCount);
+    KawasePass(pyramid[0], full, false, threadCount);
+
+    ForBands(height, threadCount, [&](std::size_t y) {
+        for (std::uint32_t x = 0; x < width; ++x)
+            StorePixel(XMLoadFloat4(&full.Pixels[y * width + x]), destination + y * rowPitch + 4 * x);
+    });
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 class Toolkit
@@ -6,7 +8,42 @@ class Toolkit
 public:
 	static std::vector<float> CalcGaussWeights(float sigma);
 
+	// The apron of the groupshared tile in Shaders/Blur/blur_cs.hlsl: weights with a larger radius
+	// (sigma above 8) don't fit.
+	static const int MaxBlurRadius = 16;
+
+	// blur_cs.hlsl on the CPU for RGBA8 images: weights (from CalcGaussWeights) along the rows, then
+	// the columns, taps past the edge repeating the edge texel. The rows are rounded to 8 bits in
+	// between, as the GPU keeps them in an R8G8B8A8 texture. A pixel is one DirectXMath vector and
+	// rows go to worker threads (0: one per hardware thread). source and destination may not overlap.
+	static void GaussianBlur(
+		const std::uint8_t* source,
+		std::size_t sourceRowPitch,
+		std::uint32_t width,
+		std::uint32_t height,
+		const std::vector<float>& weights,
+		std::uint8_t* destination,
+		std::size_t rowPitch,
+		unsigned threadCount = 0);
+
+	// Levels of the pyramid of Shaders/Blur/kawase_cs.hlsl, each half the size of the one above.
+	static const int MaxKawaseLevels = 6;
+
+	// kawase_cs.hlsl on the CPU (dual filter, Bjorge 2015): levels bilinear downsamples of five taps,
+	// then as many upsamples of eight back to width x height. Every level doubles the radius for
+	// about a quarter more work, so wide blurs cost about the same as narrow ones. The pyramid stays
+	// in float, as the GPU keeps it in R16G16B16A16_FLOAT. Threads and overlap as GaussianBlur.
+	static void DualKawaseBlur(
+		const std::uint8_t* source,
+		std::size_t sourceRowPitch,
+		std::uint32_t width,
+		std::uint32_t height,
+		std::uint32_t levels,
+		std::uint8_t* destination,
+		std::size_t rowPitch,
+		unsigned threadCount = 0);
+
 private:
 	Toolkit() = delete;
 	~Toolkit() = delete;
-};
\ No newline at end of file
+};
@@ -0,0 +1,128 @@
+#include "TransformHierarchy.h"
+
+#include <cassert>
+
+using namespace DirectX;
+
+void TransformHierarchy::Reserve(std::uint32_t count)
+{
+	mParents.reserve(count);
+	mLocals.reserve(count);
+	mWorlds.reserve(count);
+	mDirty.reserve(count);
+	mNames.reserve(count);
+	mUpdated.reserve(count);
+}
+
+void TransformHierarchy::Clear()
+{
+	mParents.clear();
+	mLocals.clear();
+	mWorlds.clear();
+	mDirty.clear();
+	mNames.clear();
+	mUpdated.clear();
+	mAnyDirty = false;
+}
+
+std::uint32_t TransformHierarchy::AddNode(std::uint32_t parent, const XMFLOAT4X4& local, const std::string& name)
+{
+	assert(parent == InvalidNode || parent < Size());
+
+	XMFLOAT4X4A localA;
+	static_cast<XMFLOAT4X4&>(localA) = local;
+
+	mParents.push_back(parent);
+	mLocals.push_back(localA);
+	mWorlds.push_back(localA);
+	mDirty.push_back(1);
+	mNames.push_back(name);
+	mAnyDirty = true;
+
+	return Size() - 1;
+}
+
+void TransformHierarchy::SetLocal(std::uint32_t node, const XMFLOAT4X4& local)
+{
+	static_cast<XMFLOAT4X4&>(mLocals[node]) = local;
+	mDirty[node] = 1;
+	mAnyDirty = true;
+}
+
+std::uint32_t TransformHierarchy::Update()
+{
+	mUpdated.clear();
+	if (!mAnyDirty)
+		return 0;
+
+	// Parents come first, so by the time a node is reached its parent's flag is final.
+	// This pass only touches the parent and flag arrays.
+	const std::uint32_t size = Size();
+	for (std::uint32_t i = 0; i < size; ++i) {
+		std::uint32_t parent = mParents[i];
+		if (parent != InvalidNode && mDirty[parent])
+			mDirty[i] = 1;
+
+		if (mDirty[i])
+			mUpdated.push_back(i);
+	}
+
+	// The matrix work runs over the compacted list only.
+	for (std::uint32_t node : mUpdated) {
+		XMMATRIX local = XMLoadFloat4x4A(&mLocals[node]);
+
+		std::uint32_t parent = mParents[node];
+		if (parent == InvalidNode) {
+			XMStoreFloat4x4A(&mWorlds[node], local);
+		}
+		else {
+			XMMATRIX parentWorld = XMLoadFloat4x4A(&mWorlds[parent]);
+			XMStoreFloat4x4A(&mWorlds[node], XMMatrixMultiply(local, parentWorld));
+		}
+	}
+
+	for (std::uint32_t node : mUpdated)
+		mDirty[node] = 0;
+	mAnyDirty = false;
+
+	return (std::uint32_t)mUpdated.size();
+}
+
+std::uint32_t TransformHierarchy::Size()const
+{
+	return (std::uint32_t)mParents.size();
+}
+
+std::uint32_t TransformHierarchy::Parent(std::uint32_t node)const
+{
+	return mParents[node];
+}
+
+const std::string& TransformHierarchy::Name(std::uint32_t node)const
+{
+	return mNames[node];
+}
+
+std::uint32_t TransformHierarchy::Find(const std::string& name)const
+{
+	for (std::uint32_t i = 0; i < Size(); ++i) {
+		if (mNames[i] == name)
+			return i;
+	}
+	return InvalidNode;
+}
+
+const XMFLOAT4X4& TransformHierarchy::Local(std::uint32_t node)const
+{
+	return mLocals[node];
+}
+
+const XMFLOAT4X4& TransformHierarchy::World(std::uint32_t node)const
+{
+	return mWorlds[node];
+}
+
+const std::vector<std::uint32_t>& TransformHierarchy::Updated()const
+{
+	return mUpdated;
+}
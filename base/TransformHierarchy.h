@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+// Parent/child transforms stored breadth first, so every parent comes before its children and
+// one linear pass is enough to rebuild the world matrices.
+// Only dirty nodes and the subtrees below them are recomputed in Update().
+class TransformHierarchy
+{
+public:
+	static const std::uint32_t InvalidNode = UINT32_MAX;
+
+	void Reserve(std::uint32_t count);
+	void Clear();
+
+	// parent has to be InvalidNode or an already added node.
+	std::uint32_t AddNode(std::uint32_t parent, const DirectX::XMFLOAT4X4& local, const std::string& name = "");
+
+	void SetLocal(std::uint32_t node, const DirectX::XMFLOAT4X4& local);
+
+	// Recomputes World() for the dirty subtrees. Returns how many nodes changed.
+	std::uint32_t Update();
+
+	std::uint32_t Size()const;
+	std::uint32_t Parent(std::uint32_t node)const;
+	const std::string& Name(std::uint32_t node)const;
+	std::uint32_t Find(const std::string& name)const;
+
+	const DirectX::XMFLOAT4X4& Local(std::uint32_t node)const;
+	const DirectX::XMFLOAT4X4& World(std::uint32_t node)const;
+
+	// Nodes whose world matrix changed in the last Update(), in hierarchy order.
+	const std::vector<std::uint32_t>& Updated()const;
+
+private:
+	std::vector<std::uint32_t> mParents;
+	std::vector<DirectX::XMFLOAT4X4A> mLocals;
+	std::vector<DirectX::XMFLOAT4X4A> mWorlds;
+	std::vector<std::uint8_t> mDirty;
+	std::vector<std::string> mNames;
+
+	std::vector<std::uint32_t> mUpdated;
+	bool mAnyDirty = false;
+};
@@ -0,0 +1,77 @@
+#include "VertexQuantizer.h"
+
+#include <cmath>
+
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+XMVECTOR XM_CALLCONV VertexQuantizer::OctEncode(FXMVECTOR n)
+{
+	XMFLOAT3 v;
+	XMStoreFloat3(&v, n);
+
+	float l1 = std::fabs(v.x) + std::fabs(v.y) + std::fabs(v.z);
+	if (l1 == 0.0f)
+		return XMVectorZero();
+
+	float x = v.x / l1, y = v.y / l1;
+	if (v.z < 0.0f) {
+		// fold the lower half over the diagonals
+		float foldX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float foldY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldX;
+		y = foldY;
+	}
+	return XMVectorSet(x, y, 0.0f, 0.0f);
+}
+
+XMVECTOR XM_CALLCONV VertexQuantizer::OctDecode(FXMVECTOR e)
+{
+	float x = XMVectorGetX(e), y = XMVectorGetY(e);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+	if (z < 0.0f) {
+		float t = -z;
+		x += x >= 0.0f ? -t : t;
+		y += y >= 0.0f ? -t : t;
+	}
+	return XMVector3Normalize(XMVectorSet(x, y, z, 0.0f));
+}
+
+void VertexQuantizer::Encode(
+	const GeometryGenerator::Vertex* vertices,
+	std::size_t count,
+	const BoundingBox& bounds,
+	PackedVertex* packed)
+{
+	// p -> (p - center) / extents * 0.5 + 0.5, flat axes end up in the middle
+	XMVECTOR extents = XMLoadFloat3(&bounds.Extents);
+	XMVECTOR flat = XMVectorEqual(extents, XMVectorZero());
+	XMVECTOR scale = XMVectorSelect(XMVectorReplicate(0.5f) / extents, XMVectorZero(), flat);
+	XMVECTOR offset = XMVectorReplicate(0.5f) - XMLoadFloat3(&bounds.Center) * scale;
+
+	for (std::size_t i = 0; i < count; ++i) {
+		const GeometryGenerator::Vertex& vertex = vertices[i];
+		PackedVertex& out = packed[i];
+
+		XMVECTOR position = XMVectorMultiplyAdd(XMLoadFloat3(&vertex.Position), scale, offset);
+		XMStoreUShortN4(&out.Position, XMVectorSetW(position, vertex.TangentU.w < 0.0f ? 1.0f : 0.0f));
+		XMStoreShortN2(&out.Normal, OctEncode(XMLoadFloat3(&vertex.Normal)));
+		XMStoreShortN2(&out.TangentU, OctEncode(XMLoadFloat4(&vertex.TangentU)));
+		XMStoreHalf2(&out.TexC, XMLoadFloat2(&vertex.TexC));
+	}
+}
+
+GeometryGenerator::Vertex VertexQuantizer::Decode(const PackedVertex& packed, const BoundingBox& bounds)
+{
+	GeometryGenerator::Vertex vertex;
+
+	XMVECTOR unorm = XMLoadUShortN4(&packed.Position);
+	XMVECTOR position = XMVectorMultiplyAdd(
+		XMVectorMultiplyAdd(unorm, XMVectorReplicate(2.0f), XMVectorReplicate(-1.0f)),
+		XMLoadFloat3(&bounds.Extents), XMLoadFloat3(&bounds.Center));
+	XMStoreFloat3(&vertex.Position, position);
+	XMStoreFloat3(&vertex.Normal, OctDecode(XMLoadShortN2(&packed.Normal)));
+	XMStoreFloat4(&vertex.TangentU, XMVectorSetW(OctDecode(XMLoadShortN2(&packed.TangentU)), packed.Position.w != 0 ? -1.0f : 1.0f));
+	XMStoreFloat2(&vertex.TexC, XMLoadHalf2(&packed.TexC));
+	return vertex;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+#include <DirectXCollision.h>
+
+#include "Common/GeometryGenerator.h"
+
+// 20 byte form of GeometryGenerator::Vertex (48 bytes). The formats are picked so the input
+// assembler expands everything but the position and the octahedral vectors, see common.hlsl.
+struct PackedVertex
+{
+	DirectX::PackedVector::XMUSHORTN4 Position;	// R16G16B16A16_UNORM over the submesh bounds, w is 1 for mirrored tangents
+	DirectX::PackedVector::XMSHORTN2 Normal;	// R16G16_SNORM, octahedral
+	DirectX::PackedVector::XMSHORTN2 TangentU;	// R16G16_SNORM, octahedral
+	DirectX::PackedVector::XMHALF2 TexC;		// R16G16_FLOAT
+};
+
+class VertexQuantizer
+{
+public:
+	// Positions are stored relative to bounds, which has to contain them (Submesh::Bounds does).
+	static void Encode(
+		const GeometryGenerator::Vertex* vertices,
+		std::size_t count,
+		const DirectX::BoundingBox& bounds,
+		PackedVertex* packed);
+
+	static GeometryGenerator::Vertex Decode(const PackedVertex& packed, const DirectX::BoundingBox& bounds);
+
+	// Unit vector to the [-1, 1]^2 square, zero vectors map to +z.
+	static DirectX::XMVECTOR XM_CALLCONV OctEncode(DirectX::FXMVECTOR n);
+	static DirectX::XMVECTOR XM_CALLCONV OctDecode(DirectX::FXMVECTOR e);
+
+private:
+	VertexQuantizer() = delete;
+	~VertexQuantizer() = delete;
+};
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "Allocators.h"
+
+// The culling list and caption of a ComputeCull frame built in the arena, as in BM_FrameArena.
+TEST(FrameArena, Frame)
+{
+	std::vector<int> items(8000);
+	FrameArena frameArena;
+	FrameVector<int*> visible;
+	std::wstring caption;
+
+	for (int frame = 0; frame < 4; ++frame) {
+		frameArena.BeginFrame();
+		LinearArena& arena = frameArena.Current();
+
+		visible = FrameVector<int*>(arena);
+		visible.reserve(items.size());
+		for (size_t i = 0; i < items.size(); i += 2)
+			visible.push_back(&items[i]);
+
+		const wchar_t* text = arena.FormatW(L"Culling using CPU.    %zu objects visible out of %zu",
+			visible.size(), items.size());
+		caption.assign(arena.FormatW(L"Compute Culling:     %ls", text));
+	}
+
+	EXPECT_EQ(visible.size(), items.size() / 2);
+	EXPECT_EQ(visible.back(), &items[items.size() - 2]);
+	EXPECT_NE(caption.find(L"4000 objects visible out of 8000"), std::wstring::npos);
+}
+
+TEST(FixedPool, ListReleasesEveryNode)
+{
+	// a list node is two links and the value
+	FixedPool pool(4 * sizeof(void*), 1024);
+	for (int round = 0; round < 3; ++round) {
+		std::list<int, PoolAllocator<int>> nodes{ PoolAllocator<int>(pool) };
+		for (int i = 0; i < 4096; ++i)
+			nodes.push_back(i);
+		EXPECT_GE(pool.LiveCount(), 4096u);
+		EXPECT_EQ(nodes.back(), 4095);
+	}
+	EXPECT_EQ(pool.LiveCount(), 0u);
+}
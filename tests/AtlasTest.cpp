@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "BenchAtlas.h"
+#include "MipGenerator.h"
+
+namespace
+{
+	// Padded rectangles inside their page, on the cell grid and apart from each other.
+	void CheckPlacements(
+		const std::vector<AtlasPacker::Size>& sizes,
+		const std::vector<AtlasPacker::Placement>& placements,
+		std::uint32_t pageCount,
+		const AtlasPacker::Options& options)
+	{
+		const std::uint32_t cell = 1u << options.SafeMips;
+		const std::uint32_t pageCells = options.PageSize / cell;
+		std::vector<std::uint32_t> owner((size_t)pageCount * pageCells * pageCells, UINT32_MAX);
+
+		ASSERT_EQ(placements.size(), sizes.size());
+		for (std::uint32_t i = 0; i < (std::uint32_t)placements.size(); ++i) {
+			const AtlasPacker::Placement& p = placements[i];
+			ASSERT_TRUE(p.Placed) << "texture " << i;
+			ASSERT_EQ(p.Width, sizes[i].Width);
+			ASSERT_EQ(p.Height, sizes[i].Height);
+			ASSERT_LT(p.Page, pageCount);
+			ASSERT_EQ((p.X - options.Gutter) % cell, 0u) << "texture " << i << " off the cell grid";
+			ASSERT_EQ((p.Y - options.Gutter) % cell, 0u) << "texture " << i << " off the cell grid";
+
+			const std::uint32_t x0 = (p.X - options.Gutter) / cell, y0 = (p.Y - options.Gutter) / cell;
+			const std::uint32_t w = (p.Width + 2 * options.Gutter + cell - 1) / cell, h = (p.Height + 2 * options.Gutter + cell - 1) / cell;
+			ASSERT_LE(x0 + w, pageCells) << "texture " << i << " outside the page";
+			ASSERT_LE(y0 + h, pageCells) << "texture " << i << " outside the page";
+
+			for (std::uint32_t y = y0; y < y0 + h; ++y) {
+				for (std::uint32_t x = x0; x < x0 + w; ++x) {
+					std::uint32_t& o = owner[((size_t)p.Page * pageCells + y) * pageCells + x];
+					ASSERT_EQ(o, UINT32_MAX) << "textures " << o << " and " << i << " overlap";
+					o = i;
+				}
+			}
+		}
+	}
+
+	// Every texture a flat color: after box filtered mips down to SafeMips, the texels over each
+	// texture must still have exactly its color.
+	void CheckMips(const std::vector<AtlasPacker::Placement>& placements, const AtlasPacker::Options& options)
+	{
+		std::vector<std::vector<std::uint8_t>> textures(placements.size());
+		std::vector<const std::uint8_t*> pointers(placements.size());
+		for (std::size_t i = 0; i < placements.size(); ++i) {
+			const std::uint8_t color[4] = { (std::uint8_t)(i * 37), (std::uint8_t)(i * 91), (std::uint8_t)(i * 53), 255 };
+			textures[i].resize((size_t)placements[i].Width * placements[i].Height * 4);
+			for (std::size_t t = 0; t < textures[i].size(); t += 4)
+				std::memcpy(&textures[i][t], color, 4);
+			pointers[i] = textures[i].data();
+		}
+
+		const std::uint32_t size = options.PageSize;
+		std::vector<std::uint8_t> page((size_t)size * size * 4, 0);
+		AtlasPacker::Compose(pointers, placements, 0, options, page.data(), (size_t)size * 4);
+
+		MipGenerator::Options mipOptions;
+		mipOptions.Kernel = MipGenerator::Filter::Box;
+		mipOptions.RowAlignment = 1;
+		mipOptions.PlacementAlignment = 1;
+		std::vector<MipGenerator::Level> levels;
+		std::vector<std::uint8_t> chain(MipGenerator::Layout(size, size, mipOptions, levels));
+		levels.resize(options.SafeMips + 1);
+		MipGenerator::Generate(page.data(), (size_t)size * 4, levels, mipOptions, chain.data());
+
+		for (std::uint32_t mip = 0; mip <= options.SafeMips; ++mip) {
+			const MipGenerator::Level& level = levels[mip];
+			for (std::size_t i = 0; i < placements.size(); ++i) {
+				const AtlasPacker::Placement& p = placements[i];
+				if (p.Page != 0)
+					continue;
+				for (std::uint32_t y = p.Y >> mip; y < (p.Y + p.Height + (1u << mip) - 1) >> mip; ++y) {
+					for (std::uint32_t x = p.X >> mip; x < (p.X + p.Width + (1u << mip) - 1) >> mip; ++x) {
+						ASSERT_EQ(std::memcmp(&chain[level.Offset + y * level.RowPitch + x * 4], &textures[i][0], 4), 0)
+							<< "mip " << mip << " mixes texture " << i << " with its neighbours";
+					}
+				}
+			}
+		}
+	}
+
+	struct PackCase
+	{
+		AtlasPacker::Method Heuristic;
+		std::uint32_t Gutter;
+		std::uint32_t SafeMips;
+	};
+}
+
+// The configurations of BM_PackAtlas.
+TEST(AtlasPacker, PlacementsAndMips)
+{
+	const PackCase cases[] = {
+		{ AtlasPacker::Method::Skyline, 0, 0 },
+		{ AtlasPacker::Method::MaxRects, 0, 0 },
+		{ AtlasPacker::Method::Skyline, 4, 2 },
+		{ AtlasPacker::Method::MaxRects, 4, 2 },
+		{ AtlasPacker::Method::MaxRects, 8, 3 },
+	};
+
+	const std::vector<AtlasPacker::Size> sizes = MakeAtlasSizes(1000);
+	for (const PackCase& c : cases) {
+		SCOPED_TRACE(testing::Message() << "maxrects " << (c.Heuristic == AtlasPacker::Method::MaxRects)
+			<< " gutter " << c.Gutter << " safeMips " << c.SafeMips);
+
+		AtlasPacker::Options options;
+		options.Heuristic = c.Heuristic;
+		options.Gutter = c.Gutter;
+		options.SafeMips = c.SafeMips;
+
+		std::vector<AtlasPacker::Placement> placements;
+		const std::uint32_t pageCount = AtlasPacker::Pack(sizes, options, placements);
+		ASSERT_NO_FATAL_FAILURE(CheckPlacements(sizes, placements, pageCount, options));
+		ASSERT_NO_FATAL_FAILURE(CheckMips(placements, options));
+	}
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "BenchBC.h"
+#include "DDSParser.h"
+#include "DDSWriter.h"
+
+namespace
+{
+	const std::uint32_t gImageSize = 1024;
+
+	DDSFormat FormatOf(BCEncoder::Format format)
+	{
+		switch (format) {
+		case BCEncoder::Format::BC1: return DDSFormat::BC1_UNORM;
+		case BCEncoder::Format::BC3: return DDSFormat::BC3_UNORM;
+		case BCEncoder::Format::BC5: return DDSFormat::BC5_UNORM;
+		case BCEncoder::Format::BC7: return DDSFormat::BC7_UNORM;
+		}
+		return DDSFormat::UNKNOWN;
+	}
+
+	// Lowest PSNR accepted for Fast, Normal and High.
+	const double gMinPSNR[4][3] = {
+		{ 40.0, 41.0, 42.0 },	// BC1
+		{ 41.0, 42.0, 42.0 },	// BC3
+		{ 51.0, 51.0, 53.0 },	// BC5
+		{ 47.0, 48.0, 48.0 }	// BC7
+	};
+
+	std::vector<std::uint8_t> Encode(const std::vector<std::uint8_t>& image, BCEncoder::Format format, BCEncoder::Quality quality, unsigned threads)
+	{
+		BCEncoder::Options options;
+		options.Level = quality;
+		options.ThreadCount = threads;
+		std::vector<std::uint8_t> blocks(BCEncoder::SurfaceSize(gImageSize, gImageSize, format));
+		BCEncoder::Encode(image.data(), (size_t)gImageSize * 4, gImageSize, gImageSize, format, options, blocks.data());
+		return blocks;
+	}
+}
+
+// Every format and quality of BM_EncodeBC: the decoded blocks stay above the PSNR limit and
+// survive DDSWriter and DDSParser.
+TEST(BCEncoder, QualityAndDDSRoundTrip)
+{
+	for (int f = 0; f < 4; ++f) {
+		const BCEncoder::Format format = (BCEncoder::Format)f;
+		const std::vector<std::uint8_t> image = MakeBCImage(gImageSize, format == BCEncoder::Format::BC5);
+		for (int q = 0; q < 3; ++q) {
+			SCOPED_TRACE(testing::Message() << "format " << f << " quality " << q);
+
+			const std::vector<std::uint8_t> blocks = Encode(image, format, (BCEncoder::Quality)q, 0);
+			std::vector<std::uint8_t> decoded(image.size());
+			BCEncoder::Decode(blocks.data(), gImageSize, gImageSize, format, decoded.data(), (size_t)gImageSize * 4);
+			EXPECT_GE(BCPSNR(image, decoded, format), gMinPSNR[f][q]);
+
+			std::vector<std::uint8_t> file;
+			DDSTexture texture;
+			ASSERT_TRUE(DDSWriter::Write(FormatOf(format), gImageSize, gImageSize, 1, blocks.data(), blocks.size(), file));
+			ASSERT_EQ(DDSParser::Parse(file.data(), file.size(), texture), DDSResult::Ok);
+			EXPECT_EQ(texture.Format, FormatOf(format));
+			EXPECT_EQ(texture.DataSize, blocks.size());
+		}
+	}
+}
+
+TEST(BCEncoder, ThreadCountDoesNotChangeBlocks)
+{
+	const std::vector<std::uint8_t> image = MakeBCImage(gImageSize, false);
+	EXPECT_EQ(Encode(image, BCEncoder::Format::BC7, BCEncoder::Quality::Fast, 1),
+		Encode(image, BCEncoder::Format::BC7, BCEncoder::Quality::Fast, 0));
+}
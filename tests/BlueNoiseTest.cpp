@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "BenchBlueNoise.h"
+#include "BlueNoise.h"
+
+// The ranks are a permutation, come out the same on a second run and through the cache, and the
+// 50% pattern has far less power near DC than white noise.
+TEST(BlueNoise, Generate)
+{
+	for (std::uint32_t size : { 32u, 64u }) {
+		SCOPED_TRACE(testing::Message() << "size " << size);
+
+		std::vector<std::uint16_t> ranks;
+		BlueNoise::Generate(size, 1, ranks);
+		ASSERT_EQ(ranks.size(), (size_t)size * size);
+
+		std::vector<std::uint8_t> seen(ranks.size(), 0);
+		for (std::uint16_t rank : ranks) {
+			ASSERT_LT(rank, seen.size());
+			ASSERT_EQ(seen[rank]++, 0) << "rank " << rank << " used twice";
+		}
+
+		std::vector<std::uint16_t> again;
+		BlueNoise::Generate(size, 1, again);
+		EXPECT_EQ(again, ranks);
+
+		EXPECT_LT(LowFrequencyPower(ranks, size), 0.2);
+	}
+}
+
+TEST(BlueNoise, CacheRoundTrip)
+{
+	const std::string path = "bluenoise_test.bin";
+	std::remove(path.c_str());
+
+	std::vector<std::uint16_t> ranks, cached, again;
+	BlueNoise::Generate(32, 1, ranks);
+	EXPECT_TRUE(BlueNoise::LoadOrGenerate(path, 32, 1, cached));
+	EXPECT_TRUE(BlueNoise::LoadOrGenerate(path, 32, 1, again));
+	std::remove(path.c_str());
+
+	EXPECT_EQ(cached, ranks);
+	EXPECT_EQ(again, ranks);
+}
+
+// Every offset of the SSAO kernel in the +z hemisphere with a length in [0.25, 1].
+TEST(BlueNoise, HemisphereKernel)
+{
+	for (std::uint32_t count : { 8u, 16u }) {
+		std::vector<DirectX::XMFLOAT4> kernel;
+		BlueNoise::HemisphereKernel(count, 0.25f, kernel);
+		ASSERT_EQ(kernel.size(), count);
+		for (const auto& k : kernel) {
+			const float length = std::sqrt(k.x * k.x + k.y * k.y + k.z * k.z);
+			EXPECT_GT(k.z, 0.0f);
+			EXPECT_GE(length, 0.25f - 1e-5f);
+			EXPECT_LE(length, 1.0f + 1e-5f);
+		}
+	}
+}
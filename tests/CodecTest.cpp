@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "BenchCodec.h"
+#include "MeshCodec.h"
+
+namespace
+{
+	void CheckIndices(const std::vector<std::uint32_t>& indices)
+	{
+		std::vector<std::uint8_t> encoded = MeshCodec::EncodeIndices(indices.data(), indices.size());
+		std::vector<std::uint32_t> decoded(indices.size());
+		ASSERT_TRUE(MeshCodec::DecodeIndices(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+		EXPECT_EQ(decoded, indices);
+	}
+
+	template<typename Vertex>
+	void CheckVertices(const std::vector<Vertex>& vertices)
+	{
+		std::vector<std::uint8_t> encoded = MeshCodec::EncodeVertices(vertices.data(), vertices.size(), sizeof(Vertex));
+		std::vector<Vertex> decoded(vertices.size());
+		ASSERT_TRUE(MeshCodec::DecodeVertices(encoded.data(), encoded.size(), decoded.data(), decoded.size(), sizeof(Vertex)));
+		EXPECT_EQ(std::memcmp(decoded.data(), vertices.data(), vertices.size() * sizeof(Vertex)), 0);
+	}
+
+	const std::uint32_t Guard = 0xDEADBEEF;
+
+	// Decodes from a copy of exactly size bytes (so reading past it shows up under a memory checker)
+	// into a buffer with guard values behind the indexCount indices, which must stay untouched.
+	bool DecodeIndicesGuarded(const std::vector<std::uint8_t>& encoded, std::size_t size, std::size_t indexCount)
+	{
+		std::unique_ptr<std::uint8_t[]> data(new std::uint8_t[size]);
+		std::memcpy(data.get(), encoded.data(), size);
+
+		std::vector<std::uint32_t> decoded(indexCount + 16, Guard);
+		bool result = MeshCodec::DecodeIndices(data.get(), size, decoded.data(), indexCount);
+		for (std::size_t i = indexCount; i < decoded.size(); ++i)
+			EXPECT_EQ(decoded[i], Guard);
+		return result;
+	}
+
+	bool DecodeVerticesGuarded(const std::vector<std::uint8_t>& encoded, std::size_t size, std::size_t vertexCount, std::size_t stride)
+	{
+		std::unique_ptr<std::uint8_t[]> data(new std::uint8_t[size]);
+		std::memcpy(data.get(), encoded.data(), size);
+
+		std::vector<std::uint8_t> decoded(vertexCount * stride + 64, 0xCD);
+		bool result = MeshCodec::DecodeVertices(data.get(), size, decoded.data(), vertexCount, stride);
+		for (std::size_t i = vertexCount * stride; i < decoded.size(); ++i)
+			EXPECT_EQ(decoded[i], 0xCD);
+		return result;
+	}
+
+	GeometryGenerator::MeshData TestMesh()
+	{
+		GeometryGenerator generator;
+		return generator.CreateSphere(1.0f, 20, 20);
+	}
+}
+
+// The codec is lossless: both index orders and both vertex formats of every model come back bit for bit.
+TEST(MeshCodec, RoundTrip)
+{
+	for (const char* file : { "pacman/Pacman.stl", "box/box.stl", "box/Box.fbx" }) {
+		SCOPED_TRACE(file);
+
+		CookedMesh mesh = CookMesh(file);
+		ASSERT_FALSE(mesh.Indices.empty());
+		CheckIndices(mesh.Indices);
+		CheckIndices(mesh.WeldedIndices);
+		CheckVertices(mesh.Vertices);
+		CheckVertices(mesh.PackedVertices);
+	}
+}
+
+// Every cut of the streams is rejected without reading past it or writing past the output.
+TEST(MeshCodec, RejectsTruncated)
+{
+	GeometryGenerator::MeshData mesh = TestMesh();
+	const std::size_t stride = sizeof(GeometryGenerator::Vertex);
+	std::vector<std::uint8_t> indices = MeshCodec::EncodeIndices(mesh.Indices32.data(), mesh.Indices32.size());
+	std::vector<std::uint8_t> vertices = MeshCodec::EncodeVertices(mesh.Vertices.data(), mesh.Vertices.size(), stride);
+	ASSERT_TRUE(DecodeIndicesGuarded(indices, indices.size(), mesh.Indices32.size()));
+	ASSERT_TRUE(DecodeVerticesGuarded(vertices, vertices.size(), mesh.Vertices.size(), stride));
+
+	for (std::size_t size = 0; size < indices.size(); ++size) {
+		EXPECT_FALSE(DecodeIndicesGuarded(indices, size, mesh.Indices32.size())) << size;
+	}
+	for (std::size_t size = 0; size < vertices.size(); size += 7) {
+		EXPECT_FALSE(DecodeVerticesGuarded(vertices, size, mesh.Vertices.size(), stride)) << size;
+	}
+	EXPECT_FALSE(DecodeVerticesGuarded(vertices, vertices.size() - 1, mesh.Vertices.size(), stride));
+}
+
+// Damage the decoder can tell is rejected: codes that don't exist, edges that were never sent,
+// group widths that need more data than there is and bytes left over. Any other flipped byte
+// may decode to different values, but never outside the buffers.
+TEST(MeshCodec, RejectsCorrupted)
+{
+	GeometryGenerator::MeshData mesh = TestMesh();
+	const std::size_t stride = sizeof(GeometryGenerator::Vertex);
+	const std::vector<std::uint8_t> indices = MeshCodec::EncodeIndices(mesh.Indices32.data(), mesh.Indices32.size());
+	const std::vector<std::uint8_t> vertices = MeshCodec::EncodeVertices(mesh.Vertices.data(), mesh.Vertices.size(), stride);
+
+	std::vector<std::uint8_t> damaged = indices;
+	damaged[0] = 0x3F;
+	EXPECT_FALSE(DecodeIndicesGuarded(damaged, damaged.size(), mesh.Indices32.size()));
+	damaged[0] = 0x00;
+	EXPECT_FALSE(DecodeIndicesGuarded(damaged, damaged.size(), mesh.Indices32.size()));
+	damaged = indices;
+	damaged.push_back(0);
+	EXPECT_FALSE(DecodeIndicesGuarded(damaged, damaged.size(), mesh.Indices32.size()));
+
+	// the low byte of a counter packs into 2 bit groups, as 8 bit groups they run past the end
+	std::vector<std::uint32_t> counter(256);
+	for (std::uint32_t i = 0; i < counter.size(); ++i)
+		counter[i] = i;
+	damaged = MeshCodec::EncodeVertices(counter.data(), counter.size(), sizeof(std::uint32_t));
+	std::fill(damaged.begin(), damaged.begin() + 4, 0xFF);
+	EXPECT_FALSE(DecodeVerticesGuarded(damaged, damaged.size(), counter.size(), sizeof(std::uint32_t)));
+	damaged = vertices;
+	damaged.push_back(0);
+	EXPECT_FALSE(DecodeVerticesGuarded(damaged, damaged.size(), mesh.Vertices.size(), stride));
+
+	for (std::size_t i = 0; i < indices.size(); ++i) {
+		damaged = indices;
+		damaged[i] ^= 0xFF;
+		DecodeIndicesGuarded(damaged, damaged.size(), mesh.Indices32.size());
+	}
+	for (std::size_t i = 0; i < vertices.size(); i += 7) {
+		damaged = vertices;
+		damaged[i] ^= 0xFF;
+		DecodeVerticesGuarded(damaged, damaged.size(), mesh.Vertices.size(), stride);
+	}
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "BenchScene.h"
+#include "DDSParser.h"
+#include "MappedFile.h"
+
+// teapot512.dds: 512x512 BC1 with a full mip chain, parsed in place from the mapped file.
+TEST(DDSParser, Teapot)
+{
+	MappedFile file(ResourcePath("teapot512.dds"));
+	ASSERT_TRUE(file.IsOpen());
+
+	DDSTexture texture;
+	ASSERT_EQ(DDSParser::Parse(file.Data(), file.Size(), texture), DDSResult::Ok);
+	EXPECT_EQ(texture.Width, 512u);
+	EXPECT_EQ(texture.Height, 512u);
+	EXPECT_EQ(texture.Format, DDSFormat::BC1_UNORM);
+	EXPECT_EQ(texture.MipCount, 10u);
+	ASSERT_EQ(texture.Subresources.size(), 10u);
+
+	const DDSSubresource& last = texture.Subresources.back();
+	EXPECT_EQ(last.Offset + last.SlicePitch, texture.DataSize) << "subresources don't cover the pixel data";
+}
+
+// A cut off or damaged file must be refused, not read past its end.
+TEST(DDSParser, RejectsDamagedFiles)
+{
+	MappedFile file(ResourcePath("teapot512.dds"));
+	ASSERT_TRUE(file.IsOpen());
+
+	std::vector<std::uint8_t> copy(file.Data(), file.Data() + file.Size());
+	DDSTexture texture;
+	EXPECT_EQ(DDSParser::Parse(copy.data(), copy.size() - 1, texture), DDSResult::Truncated);
+	copy[4] = 0;
+	EXPECT_EQ(DDSParser::Parse(copy.data(), copy.size(), texture), DDSResult::BadHeader);
+}
+
+// A file that can't be mapped reports why, whatever the thread's last error is by then.
+TEST(MappedFile, KeepsError)
+{
+	MappedFile missing(ResourcePath("no_such_file.dds"));
+	EXPECT_FALSE(missing.IsOpen());
+	EXPECT_NE(missing.Error(), 0);
+
+	MappedFile directory(ResourcePath(""));
+	EXPECT_FALSE(directory.IsOpen());
+	EXPECT_NE(directory.Error(), 0);
+
+	MappedFile file(ResourcePath("teapot512.dds"));
+	EXPECT_TRUE(file.IsOpen());
+	EXPECT_EQ(file.Error(), 0);
+}
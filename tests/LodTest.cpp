@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+
+#include "BenchLod.h"
+#include "BenchScene.h"
+#include "LodSelector.h"
+#include "MeshSimplifier.h"
+#include "ModelImporter.h"
+
+// Every Pacman submesh simplified to 50%, 25% and 12.5% of its triangles: the target is reached
+// and no original vertex ends up more than 10% of the radius away from the simplified surface.
+TEST(MeshSimplifier, Pacman)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<GeometryGenerator::MeshData> meshes;
+	for (std::uint32_t i = 0; i < importer.MeshCount(); ++i)
+		meshes.push_back(importer.Mesh(i));
+	ASSERT_FALSE(meshes.empty());
+
+	for (double fraction : { 0.5, 0.25, 0.125 }) {
+		SCOPED_TRACE(testing::Message() << "fraction " << fraction);
+
+		size_t sourceIndices = 0, resultIndices = 0;
+		for (const auto& mesh : meshes) {
+			std::vector<std::uint32_t> result;
+			MeshSimplifier::Simplify(mesh.Vertices, mesh.Indices32, (size_t)(mesh.Indices32.size() * fraction), FLT_MAX, result);
+			sourceIndices += mesh.Indices32.size();
+			resultIndices += result.size();
+			EXPECT_LE(MaxDeviation(mesh, result), 0.1f * Radius(mesh));
+		}
+		EXPECT_LE((double)resultIndices / sourceIndices, fraction * 1.05);
+	}
+}
+
+// The LOD chain inside the merged index buffer: fewer indices and a larger error at every level.
+TEST(ModelImporter, LodChain)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+	importer.GenerateLods(4);
+	importer.Merge(indices, submeshes);
+
+	ASSERT_FALSE(submeshes.empty());
+	for (const auto& submesh : submeshes) {
+		ASSERT_GE(submesh.Lods.size(), 2u) << "no LOD generated";
+		for (size_t i = 1; i < submesh.Lods.size(); ++i) {
+			const auto& lod = submesh.Lods[i];
+			EXPECT_LT(lod.IndexCount, submesh.Lods[i - 1].IndexCount);
+			EXPECT_GE(lod.Error, submesh.Lods[i - 1].Error);
+			EXPECT_LE(lod.StartIndexLocation + lod.IndexCount, indices.size());
+		}
+	}
+}
+
+// An item moving back and forth across the distance where level 1 gets accurate enough. Between
+// there and where level 1 also has the hysteresis margin it keeps the level it arrived with,
+// past either end it switches.
+TEST(LodSelector, Hysteresis)
+{
+	LodSelector selector(1.0f, 0.25f);
+	selector.SetProjection(DirectX::XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, 800.0f / 600.0f, 1.0f, 1000.0f), 600.0f);
+
+	// level 1 is off by 1% of the radius: 1 pixel at distance fine, 0.75 pixels at distance coarse
+	const float errors[2] = { 0.0f, 0.01f };
+	const float radius = 1.0f;
+	const float pixelsAtOne = 2.0f * selector.ProjectedSize(radius, 2.0f);
+	const float fine = errors[1] * pixelsAtOne, coarse = fine / 0.75f;
+
+	std::uint32_t level = 0;
+	auto select = [&](float distance) {
+		level = selector.Select(errors, 2, sizeof(float), selector.ProjectedSize(radius, distance), level);
+		return level;
+	};
+
+	for (std::uint32_t start : { 0u, 1u }) {
+		SCOPED_TRACE(start);
+		level = start;
+		for (int frame = 0; frame < 100; ++frame) {
+			const float t = 0.5f + 0.45f * std::sin(0.7f * frame);
+			ASSERT_EQ(select(fine + t * (coarse - fine)), start) << "frame " << frame;
+		}
+	}
+
+	level = 0;
+	EXPECT_EQ(select(1.01f * coarse), 1u);
+	EXPECT_EQ(select(0.5f * (fine + coarse)), 1u);
+	EXPECT_EQ(select(0.99f * fine), 0u);
+	EXPECT_EQ(select(0.5f * (fine + coarse)), 0u);
+	EXPECT_EQ(select(1.01f * coarse), 1u);
+}
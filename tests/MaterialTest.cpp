@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <set>
+
+#include "BenchMaterial.h"
+#include "BenchScene.h"
+#include "MemoryTracker.h"
+#include "ModelImporter.h"
+
+// The box FBX references its wood texture by a path from the exporting machine,
+// the importer has to find it next to the model.
+TEST(ModelImporter, BoxMaterials)
+{
+	TextureCache cache;
+	ModelImporter importer(ResourcePath("box/Box.fbx"), 0, &cache);
+	cache.LoadPending();
+
+	std::uint32_t diffuseMap = TextureCache::InvalidId;
+	for (const auto& material : importer.Materials()) {
+		if (material.DiffuseMap != TextureCache::InvalidId)
+			diffuseMap = material.DiffuseMap;
+	}
+	ASSERT_NE(diffuseMap, std::uint32_t(TextureCache::InvalidId)) << "no diffuse map imported";
+
+	const TextureCache::Image& image = cache.GetImage(diffuseMap);
+	EXPECT_TRUE(image.Loaded);
+	EXPECT_NE(image.Path.find("WoodPlanksBare0102_6_L.jpg"), std::string::npos);
+}
+
+// Every file requested under two spellings of its path, and every file's contents twice under
+// different names: half the requests are answered by path, half the loaded files by content.
+TEST(TextureCache, Deduplicates)
+{
+	const std::string& directory = TextureDirectory();
+	for (unsigned threads : { 1u, 4u }) {
+		SCOPED_TRACE(testing::Message() << "threads " << threads);
+
+		TextureCache cache;
+		for (int file = 0; file < gDistinctFiles; ++file) {
+			for (const char* prefix : { "texture", "copy" }) {
+				std::string name = prefix + std::to_string(file) + ".bin";
+				EXPECT_EQ(cache.Request(directory, name), cache.Request(directory + "/sub/..", "./" + name));
+			}
+		}
+		cache.LoadPending(ChecksumDecoder, threads);
+
+		std::set<std::uint32_t> unique;
+		for (std::uint32_t id = 0; id < cache.Size(); ++id)
+			unique.insert(cache.Resolve(id));
+
+		const TextureCache::Stats stats = cache.GetStats();
+		EXPECT_EQ(cache.Size(), 2u * gDistinctFiles);
+		EXPECT_EQ(stats.PathHits, 2u * gDistinctFiles);
+		EXPECT_EQ(unique.size(), (size_t)gDistinctFiles);
+		EXPECT_EQ(stats.ContentHits, (std::uint32_t)gDistinctFiles);
+		EXPECT_EQ(stats.Failed, 0u);
+	}
+}
+
+// Decoded images keep only their pixels, and Release() gives those back to MemoryTracker. The
+// copies loaded afterwards still fold into the released files by hash, Reload() brings the
+// pixels back.
+TEST(TextureCache, ReleaseKeepsHash)
+{
+	const std::string& directory = TextureDirectory();
+	const MemoryTracker::Category category = MemoryTracker::Category::TextureCacheCpu;
+	const std::int64_t before = MemoryTracker::Get().GetStats(category).Current;
+
+	TextureCache cache;
+	std::vector<std::uint32_t> ids;
+	for (int file = 0; file < gDistinctFiles; ++file)
+		ids.push_back(cache.Request(directory, "texture" + std::to_string(file) + ".bin"));
+	cache.LoadPending(ChecksumDecoder);
+
+	for (std::uint32_t id : ids) {
+		const TextureCache::Image& image = cache.GetImage(id);
+		EXPECT_TRUE(image.File.empty());
+		EXPECT_EQ(image.Pixels.size(), sizeof(std::uint32_t));
+	}
+	EXPECT_EQ(MemoryTracker::Get().GetStats(category).Current - before, (std::int64_t)(gDistinctFiles * sizeof(std::uint32_t)));
+
+	for (std::uint32_t id : ids)
+		cache.Release(id);
+	EXPECT_EQ(MemoryTracker::Get().GetStats(category).Current, before);
+
+	for (int file = 0; file < gDistinctFiles; ++file)
+		cache.Request(directory, "copy" + std::to_string(file) + ".bin");
+	cache.LoadPending(ChecksumDecoder);
+	EXPECT_EQ(cache.GetStats().ContentHits, (std::uint32_t)gDistinctFiles);
+
+	for (int file = 0; file < gDistinctFiles; ++file) {
+		const std::uint32_t copy = cache.Request(directory, "copy" + std::to_string(file) + ".bin");
+		EXPECT_EQ(cache.Resolve(copy), ids[file]);
+		EXPECT_TRUE(cache.GetImage(copy).Released);
+	}
+
+	EXPECT_TRUE(cache.Reload(ids[0], ChecksumDecoder));
+	EXPECT_FALSE(cache.GetImage(ids[0]).Released);
+	EXPECT_EQ(cache.GetImage(ids[0]).Pixels.size(), sizeof(std::uint32_t));
+
+	cache.Clear();
+	EXPECT_EQ(MemoryTracker::Get().GetStats(category).Current, before);
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include "MemoryTracker.h"
+
+TEST(MemoryTracker, TrackedAllocationBalances)
+{
+	auto& tracker = MemoryTracker::Get();
+	tracker.Reset();
+
+	for (int i = 0; i < 16; ++i) {
+		TrackedAllocation allocation(MemoryTracker::Category::MeshGeometryCpu, 1 << 20);
+		EXPECT_EQ(allocation.Bytes(), (size_t)1 << 20);
+	}
+
+	auto stats = tracker.GetStats(MemoryTracker::Category::MeshGeometryCpu);
+	EXPECT_EQ(stats.Current, 0);
+	EXPECT_EQ(stats.Peak, 1 << 20);
+	tracker.Reset();
+}
+
+// A budget crossed every frame raises one alert per frame, one under it none.
+TEST(MemoryTracker, BudgetAlerts)
+{
+	auto& tracker = MemoryTracker::Get();
+	tracker.Reset();
+
+	size_t alerts = 0;
+	tracker.SetBudget(MemoryTracker::Category::UploadBuffer, 1024);
+	tracker.SetBudgetCallback([&alerts](MemoryTracker::Category, const MemoryTracker::Stats&) { ++alerts; });
+
+	for (int allocationsPerFrame : { 2, 16 }) {
+		alerts = 0;
+		for (int frame = 0; frame < 10; ++frame) {
+			tracker.BeginFrame();
+			for (int i = 0; i < allocationsPerFrame; ++i)
+				tracker.Allocate(MemoryTracker::Category::UploadBuffer, 256);
+			for (int i = 0; i < allocationsPerFrame; ++i)
+				tracker.Free(MemoryTracker::Category::UploadBuffer, 256);
+		}
+		EXPECT_EQ(alerts, allocationsPerFrame * 256 > 1024 ? 10u : 0u) << allocationsPerFrame << " allocations per frame";
+	}
+
+	tracker.SetBudgetCallback(nullptr);
+	tracker.Reset();
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cfloat>
+#include <tuple>
+
+#include "BenchScene.h"
+#include "Culling.h"
+#include "Meshlets.h"
+#include "ModelImporter.h"
+
+using namespace DirectX;
+
+namespace
+{
+	typedef std::tuple<std::uint32_t, std::uint32_t, std::uint32_t> Triangle;
+
+	// Rotated so the smallest index comes first, winding kept.
+	Triangle MakeTriangle(std::uint32_t a, std::uint32_t b, std::uint32_t c)
+	{
+		if (b < a && b < c) return Triangle(b, c, a);
+		if (c < a && c < b) return Triangle(c, a, b);
+		return Triangle(a, b, c);
+	}
+
+	std::vector<std::uint32_t> CullMeshlets(const BenchCamera& camera, const MeshletData& data, MeshletCuller::Stats& stats)
+	{
+		MeshletCuller culler;
+		culler.SetView(camera.Frustum, XMLoadFloat4x4(&camera.InvView));
+
+		std::vector<std::uint32_t> visible(data.Meshlets.size());
+		visible.resize(culler.Cull(XMMatrixIdentity(), data, visible.data(), &stats));
+		return visible;
+	}
+
+	bool Contains(const std::vector<std::uint32_t>& visible, std::uint32_t meshlet)
+	{
+		return std::find(visible.begin(), visible.end(), meshlet) != visible.end();
+	}
+}
+
+// Every input triangle lands in exactly one meshlet of its submesh and the limits hold.
+TEST(MeshletBuilder, CoversPacman)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	ASSERT_GT(importer.MeshCount(), 0u);
+
+	importer.GenerateMeshlets();
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+	importer.Merge(indices, submeshes);
+	ASSERT_EQ(submeshes.size(), importer.MeshCount());
+
+	for (std::uint32_t meshId = 0; meshId < importer.MeshCount(); ++meshId) {
+		const GeometryGenerator::MeshData mesh = importer.Mesh(meshId);
+		const MeshletData& data = submeshes[meshId].Meshlets;
+		ASSERT_FALSE(data.Meshlets.empty());
+		ASSERT_EQ(data.Bounds.size(), data.Meshlets.size());
+
+		std::vector<Triangle> source, built;
+		for (size_t i = 0; i + 2 < mesh.Indices32.size(); i += 3)
+			source.push_back(MakeTriangle(mesh.Indices32[i], mesh.Indices32[i + 1], mesh.Indices32[i + 2]));
+
+		for (const auto& meshlet : data.Meshlets) {
+			// by value, the limits have no definition outside the class
+			ASSERT_LE(meshlet.VertexCount, std::uint32_t(MeshletBuilder::MaxVertices));
+			ASSERT_LE(meshlet.PrimitiveCount, std::uint32_t(MeshletBuilder::MaxPrimitives));
+			for (std::uint32_t p = 0; p < meshlet.PrimitiveCount; ++p) {
+				std::uint32_t i0, i1, i2;
+				MeshletBuilder::UnpackPrimitive(data.PrimitiveIndices[meshlet.PrimitiveOffset + p], i0, i1, i2);
+				ASSERT_LT(std::max(i0, std::max(i1, i2)), meshlet.VertexCount);
+				const std::uint32_t* unique = &data.UniqueVertexIndices[meshlet.VertexOffset];
+				built.push_back(MakeTriangle(unique[i0], unique[i1], unique[i2]));
+			}
+		}
+
+		std::sort(source.begin(), source.end());
+		std::sort(built.begin(), built.end());
+		EXPECT_EQ(source, built);
+	}
+}
+
+// A closed sphere in front of the camera: the clusters on its far side are cone culled,
+// every cluster with a triangle facing the eye is kept.
+TEST(MeshletCuller, ConeCullsOnlyBackFacing)
+{
+	GeometryGenerator generator;
+	GeometryGenerator::MeshData sphere = generator.CreateGeosphere(1.0f, 5);
+	MeshletData data;
+	MeshletBuilder::Build(sphere.Vertices, sphere.Indices32, data);
+	ASSERT_GT(data.Meshlets.size(), 8u);
+
+	BenchCamera camera(XMFLOAT3(0.0f, 0.0f, -10.0f), XM_PIDIV4, 1.0f, 1.0f, 100.0f);
+	MeshletCuller::Stats stats;
+	std::vector<std::uint32_t> visible = CullMeshlets(camera, data, stats);
+	EXPECT_EQ(stats.FrustumCulled, 0u);
+	EXPECT_GT(stats.ConeCulled, 0u);
+
+	XMVECTOR eye = XMVectorSet(0.0f, 0.0f, -10.0f, 1.0f);
+	std::uint32_t farthest = 0;
+	for (std::uint32_t m = 0; m < (std::uint32_t)data.Meshlets.size(); ++m) {
+		if (data.Bounds[m].Center.z > data.Bounds[farthest].Center.z)
+			farthest = m;
+
+		const Meshlet& meshlet = data.Meshlets[m];
+		bool frontFacing = false;
+		for (std::uint32_t p = 0; p < meshlet.PrimitiveCount && !frontFacing; ++p) {
+			std::uint32_t i0, i1, i2;
+			MeshletBuilder::UnpackPrimitive(data.PrimitiveIndices[meshlet.PrimitiveOffset + p], i0, i1, i2);
+			const std::uint32_t* unique = &data.UniqueVertexIndices[meshlet.VertexOffset];
+			XMVECTOR p0 = XMLoadFloat3(&sphere.Vertices[unique[i0]].Position);
+			XMVECTOR n = XMVector3Cross(
+				XMLoadFloat3(&sphere.Vertices[unique[i1]].Position) - p0,
+				XMLoadFloat3(&sphere.Vertices[unique[i2]].Position) - p0);
+			frontFacing = XMVectorGetX(XMVector3Dot(n, eye - p0)) > 0.0f;
+		}
+		if (frontFacing) {
+			EXPECT_TRUE(Contains(visible, m)) << "meshlet " << m;
+		}
+	}
+
+	// the cluster straight behind the sphere's center faces away
+	EXPECT_FALSE(Contains(visible, farthest));
+}
+
+// A ground grid reaching behind the camera: its box is visible as a whole, the clusters
+// entirely behind the eye are frustum culled, the one under the view direction stays.
+TEST(MeshletCuller, FrustumCullsInsideVisibleObject)
+{
+	GeometryGenerator generator;
+	GeometryGenerator::MeshData grid = generator.CreateGrid(200.0f, 200.0f, 101, 101);
+	MeshletData data;
+	MeshletBuilder::Build(grid.Vertices, grid.Indices32, data);
+
+	BoundingBox bounds;
+	BoundingBox::CreateFromPoints(bounds, grid.Vertices.size(), &grid.Vertices[0].Position, sizeof(GeometryGenerator::Vertex));
+
+	BenchCamera camera(XMFLOAT3(0.0f, 5.0f, -50.0f), XM_PIDIV4, 1.0f, 1.0f, 1000.0f);
+	ASSERT_TRUE(Culling::IsVisible(camera.Frustum, XMLoadFloat4x4(&camera.InvView), XMMatrixIdentity(), bounds));
+
+	MeshletCuller::Stats stats;
+	std::vector<std::uint32_t> visible = CullMeshlets(camera, data, stats);
+	EXPECT_GT(stats.FrustumCulled, 0u);
+	EXPECT_EQ(stats.ConeCulled, 0u);
+	EXPECT_LT(visible.size(), data.Meshlets.size());
+
+	std::uint32_t behindCount = 0, ahead = UINT32_MAX;
+	for (std::uint32_t m = 0; m < (std::uint32_t)data.Meshlets.size(); ++m) {
+		const Meshlet& meshlet = data.Meshlets[m];
+		float minZ = FLT_MAX, maxZ = -FLT_MAX, minX = FLT_MAX, maxX = -FLT_MAX;
+		for (std::uint32_t v = 0; v < meshlet.VertexCount; ++v) {
+			const XMFLOAT3& p = grid.Vertices[data.UniqueVertexIndices[meshlet.VertexOffset + v]].Position;
+			minZ = std::min(minZ, p.z);
+			maxZ = std::max(maxZ, p.z);
+			minX = std::min(minX, p.x);
+			maxX = std::max(maxX, p.x);
+		}
+
+		// behind the near plane by more than the cluster is wide
+		if (maxZ + (maxZ - minZ) + (maxX - minX) < -50.0f) {
+			behindCount++;
+			EXPECT_FALSE(Contains(visible, m)) << "meshlet " << m;
+		}
+		if (minX <= 0.0f && maxX >= 0.0f && minZ <= 0.0f && maxZ >= 0.0f)
+			ahead = m;
+	}
+
+	EXPECT_GT(behindCount, 0u);
+	ASSERT_NE(ahead, UINT32_MAX);
+	EXPECT_TRUE(Contains(visible, ahead));
+}
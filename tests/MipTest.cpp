@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "BenchMip.h"
+#include "MipGenerator.h"
+
+namespace
+{
+	const std::uint32_t gImageSize = 512;
+
+	std::vector<std::uint8_t> Generate(const std::vector<std::uint8_t>& image, const MipGenerator::Options& options, std::vector<MipGenerator::Level>& levels)
+	{
+		std::vector<std::uint8_t> chain(MipGenerator::Layout(gImageSize, gImageSize, options, levels));
+		MipGenerator::Generate(image.data(), (size_t)gImageSize * 4, levels, options, chain.data());
+		return chain;
+	}
+}
+
+// Level 0 is the image, the chain ends at 1x1, normal maps stay unit length at every level and the
+// thread count doesn't change the result. The configurations of BM_GenerateMips.
+TEST(MipGenerator, Chain)
+{
+	const struct
+	{
+		bool Kaiser;
+		MipImage Mode;
+	} cases[] = { { false, MipColor }, { true, MipColor }, { true, MipSRGB }, { true, MipNormalMap } };
+
+	for (const auto& c : cases) {
+		SCOPED_TRACE(testing::Message() << "kaiser " << c.Kaiser << " mode " << c.Mode);
+
+		MipGenerator::Options options;
+		options.Kernel = c.Kaiser ? MipGenerator::Filter::Kaiser : MipGenerator::Filter::Box;
+		options.SRGB = c.Mode == MipSRGB;
+		options.NormalMap = c.Mode == MipNormalMap;
+		options.ThreadCount = 0;
+
+		const std::vector<std::uint8_t> image = MakeMipImage(gImageSize, c.Mode);
+		std::vector<MipGenerator::Level> levels;
+		const std::vector<std::uint8_t> chain = Generate(image, options, levels);
+
+		const MipGenerator::Level& top = levels[0];
+		for (std::uint32_t y = 0; y < top.Height; ++y)
+			ASSERT_EQ(std::memcmp(&chain[top.Offset + y * top.RowPitch], &image[(size_t)y * top.Width * 4], top.Width * 4), 0) << "row " << y;
+		EXPECT_EQ(levels.back().Width, 1u);
+		EXPECT_EQ(levels.back().Height, 1u);
+
+		options.ThreadCount = 1;
+		EXPECT_EQ(Generate(image, options, levels), chain);
+
+		if (c.Mode != MipNormalMap)
+			continue;
+		for (const auto& level : levels) {
+			for (std::uint32_t y = 0; y < level.Height; ++y) {
+				for (std::uint32_t x = 0; x < level.Width; ++x) {
+					const std::uint8_t* pixel = &chain[level.Offset + y * level.RowPitch + x * 4];
+					float nx = pixel[0] / 127.5f - 1.0f, ny = pixel[1] / 127.5f - 1.0f, nz = pixel[2] / 127.5f - 1.0f;
+					ASSERT_NEAR(std::sqrt(nx * nx + ny * ny + nz * nz), 1.0f, 0.02f) << "level " << level.Width << "x" << level.Height;
+				}
+			}
+		}
+	}
+}
+
+// A flat color stays flat at every level with both kernels, in linear and sRGB, also when the
+// levels don't halve evenly: the filter weights sum to one everywhere, borders included.
+TEST(MipGenerator, ConstantImage)
+{
+	const std::uint32_t width = 37, height = 23;
+	const std::uint8_t color[4] = { 200, 100, 37, 255 };
+	std::vector<std::uint8_t> image((size_t)width * height * 4);
+	for (size_t i = 0; i < image.size(); ++i)
+		image[i] = color[i % 4];
+
+	for (MipGenerator::Filter kernel : { MipGenerator::Filter::Box, MipGenerator::Filter::Kaiser }) {
+		for (bool srgb : { false, true }) {
+			SCOPED_TRACE(testing::Message() << "kaiser " << (kernel == MipGenerator::Filter::Kaiser) << " srgb " << srgb);
+
+			MipGenerator::Options options;
+			options.Kernel = kernel;
+			options.SRGB = srgb;
+			std::vector<MipGenerator::Level> levels;
+			std::vector<std::uint8_t> chain(MipGenerator::Layout(width, height, options, levels));
+			MipGenerator::Generate(image.data(), (size_t)width * 4, levels, options, chain.data());
+
+			for (const auto& level : levels) {
+				for (std::uint32_t y = 0; y < level.Height; ++y) {
+					for (std::uint32_t x = 0; x < level.Width; ++x) {
+						const std::uint8_t* pixel = &chain[level.Offset + y * level.RowPitch + x * 4];
+						for (int c = 0; c < 4; ++c)
+							ASSERT_NEAR(pixel[c], color[c], 1) << "level " << level.Width << "x" << level.Height << " at " << x << "," << y;
+					}
+				}
+			}
+		}
+	}
+}
+
+// A one texel black and white checker averages to half the light: 188 when filtered in linear
+// space and encoded as sRGB, not the 128 of averaging the encoded values. The Kaiser kernel reaches
+// over the clamped border, so there only the texels it doesn't reach are checked.
+TEST(MipGenerator, SRGBAverage)
+{
+	const std::uint32_t size = 64;
+	std::vector<std::uint8_t> image((size_t)size * size * 4);
+	for (std::uint32_t y = 0; y < size; ++y) {
+		for (std::uint32_t x = 0; x < size; ++x) {
+			std::uint8_t value = (x + y) % 2 ? 255 : 0;
+			std::uint8_t* pixel = &image[((size_t)y * size + x) * 4];
+			pixel[0] = pixel[1] = pixel[2] = value;
+			pixel[3] = 255;
+		}
+	}
+
+	for (MipGenerator::Filter kernel : { MipGenerator::Filter::Box, MipGenerator::Filter::Kaiser }) {
+		for (bool srgb : { false, true }) {
+			SCOPED_TRACE(testing::Message() << "kaiser " << (kernel == MipGenerator::Filter::Kaiser) << " srgb " << srgb);
+
+			MipGenerator::Options options;
+			options.Kernel = kernel;
+			options.SRGB = srgb;
+			std::vector<MipGenerator::Level> levels;
+			std::vector<std::uint8_t> chain(MipGenerator::Layout(size, size, options, levels));
+			MipGenerator::Generate(image.data(), (size_t)size * 4, levels, options, chain.data());
+
+			const int expected = srgb ? 188 : 128;
+			const std::uint32_t border = kernel == MipGenerator::Filter::Kaiser ? 2 : 0;
+			for (size_t l = 1; l < levels.size() && levels[l].Width > 2 * border; ++l) {
+				const MipGenerator::Level& level = levels[l];
+				for (std::uint32_t y = border; y < level.Height - border; ++y) {
+					for (std::uint32_t x = border; x < level.Width - border; ++x) {
+						const std::uint8_t* pixel = &chain[level.Offset + y * level.RowPitch + x * 4];
+						for (int c = 0; c < 3; ++c)
+							ASSERT_NEAR(pixel[c], expected, 1) << "level " << level.Width << "x" << level.Height << " at " << x << "," << y;
+						ASSERT_EQ(pixel[3], 255);
+					}
+				}
+			}
+		}
+	}
+}
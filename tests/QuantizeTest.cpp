@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "BenchQuantize.h"
+#include "BenchScene.h"
+#include "ModelImporter.h"
+
+// Every Pacman submesh over its own bounds, as Model(..., VertexFormat::Packed) does: positions
+// come back within one quantization step.
+TEST(VertexQuantizer, Pacman)
+{
+	ModelImporter importer(ResourcePath("pacman/Pacman.stl"));
+	std::vector<std::uint16_t> indices;
+	std::vector<ModelImporter::Submesh> submeshes;
+	importer.Merge(indices, submeshes);
+	const std::vector<GeometryGenerator::Vertex>& vertices = importer.Vertices();
+	ASSERT_FALSE(vertices.empty());
+
+	std::vector<QuantizeRange> ranges(submeshes.size());
+	for (size_t i = 0; i < submeshes.size(); ++i) {
+		ranges[i].First = (size_t)submeshes[i].BaseVertexLocation;
+		ranges[i].Count = (i + 1 < submeshes.size() ? (size_t)submeshes[i + 1].BaseVertexLocation : vertices.size()) - ranges[i].First;
+		ranges[i].Bounds = submeshes[i].Bounds;
+	}
+
+	std::vector<PackedVertex> packed(vertices.size());
+	EncodeRanges(vertices, ranges, packed);
+	EXPECT_LE(MeasureErrors(vertices, ranges, packed).Position, 1.0f / 65535.0f);
+}
+
+TEST(VertexQuantizer, Sphere)
+{
+	GeometryGenerator geoGen;
+	GeometryGenerator::MeshData sphere = geoGen.CreateSphere(1.0f, 256, 256);
+
+	std::vector<QuantizeRange> ranges(1);
+	ranges[0].Count = sphere.Vertices.size();
+	DirectX::BoundingBox::CreateFromPoints(ranges[0].Bounds, sphere.Vertices.size(), &sphere.Vertices[0].Position, sizeof(GeometryGenerator::Vertex));
+
+	std::vector<PackedVertex> packed(sphere.Vertices.size());
+	EncodeRanges(sphere.Vertices, ranges, packed);
+	EXPECT_LE(MeasureErrors(sphere.Vertices, ranges, packed).Position, 1.0f / 65535.0f);
+}
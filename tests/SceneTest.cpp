@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include "BenchScene.h"
+#include "Common/MathHelper.h"
+#include "Culling.h"
+#include "SceneDatabase.h"
+
+using namespace DirectX;
+
+// SceneDatabase::Cull keeps the same items as Culling::IsVisible on every item, in order, for an
+// axis aligned grid and for one whose items are all turned. Turned items exist whose world box
+// touches the frustum while the oriented test rejects them.
+TEST(SceneDatabase, CullMatchesPerItemTest)
+{
+	BenchCamera camera(XMFLOAT3(0.0f, 0.0f, -5.0f), 0.25f * XM_PI, 800.0f / 600.0f, 1.0f, 1000.0f);
+	XMMATRIX invView = XMLoadFloat4x4(&camera.InvView);
+	BoundingBox bounds(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+	BoundingFrustum worldFrustum;
+	camera.Frustum.Transform(worldFrustum, invView);
+
+	for (bool rotated : { false, true }) {
+		SCOPED_TRACE(rotated ? "rotated" : "axis aligned");
+		std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(8 * 10 * 10 * 10, 10.0f, false);
+		if (rotated)
+			RotateInstances(worlds);
+
+		SceneDatabase scene(1);
+		std::vector<std::uint32_t> expected;
+		std::size_t looseOnly = 0;
+		for (size_t i = 0; i < worlds.size(); i++) {
+			scene.Add(worlds[i], bounds, SceneDatabase::DrawArgs());
+			const bool kept = Culling::IsVisible(camera.Frustum, invView, XMLoadFloat4x4(&worlds[i]), bounds);
+			if (kept)
+				expected.push_back((std::uint32_t)i);
+
+			BoundingBox worldBounds;
+			bounds.Transform(worldBounds, XMLoadFloat4x4(&worlds[i]));
+			if (!kept && worldFrustum.Contains(worldBounds) != DISJOINT)
+				looseOnly++;
+		}
+		if (rotated) {
+			EXPECT_GT(looseOnly, 0u);
+		}
+
+		std::vector<std::uint32_t> visible(scene.Size());
+		visible.resize(scene.Cull(camera.Frustum, invView, visible.data()));
+		EXPECT_FALSE(expected.empty());
+		EXPECT_EQ(visible, expected);
+	}
+}
+
+// Removing and re-adding 1% of the items every frame keeps the handles valid and the size fixed.
+TEST(SceneDatabase, HandleChurn)
+{
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(8 * 10 * 10 * 10, 10.0f, false);
+	BoundingBox bounds(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+	SceneDatabase scene(1);
+	std::vector<SceneDatabase::Handle> handles;
+	for (const XMFLOAT4X4& world : worlds)
+		handles.push_back(scene.Add(world, bounds, SceneDatabase::DrawArgs()));
+
+	const XMFLOAT4X4 world = MathHelper::Identity4x4();
+	for (size_t frame = 0; frame < 200; ++frame) {
+		for (size_t i = frame % 100; i < handles.size(); i += 100) {
+			const SceneDatabase::Handle old = handles[i];
+			scene.Remove(old);
+			EXPECT_FALSE(scene.IsValid(old));
+			handles[i] = scene.Add(world, bounds, SceneDatabase::DrawArgs());
+		}
+	}
+
+	ASSERT_EQ(scene.Size(), handles.size());
+	for (const SceneDatabase::Handle& handle : handles) {
+		ASSERT_TRUE(scene.IsValid(handle));
+		ASSERT_LT(scene.IndexOf(handle), scene.Size());
+	}
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+#include "BenchShadow.h"
+
+using namespace DirectX;
+
+namespace
+{
+	const std::uint32_t Resolution = 2048;
+	const float ShadowDistance = 120.0f;
+
+	struct SplitCase
+	{
+		int Count;
+		float Lambda;
+	};
+
+	// The configurations of BM_CascadeBuild.
+	const SplitCase SplitCases[] = { { 1, 0.5f }, { 4, 0.0f }, { 4, 0.5f }, { 4, 0.8f }, { 4, 1.0f } };
+}
+
+// The splits cover [near, shadow distance] without gaps and every corner of a slice lands inside
+// its cascade with the 1.5 texels (3 / Resolution in NDC) the PCF footprint needs.
+TEST(CascadedShadows, SlicesInsideCascades)
+{
+	const BoundingBox scene = ShadowSceneBounds(MakeShadowBoxes(1024));
+	const float inside = 1.0f - 3.0f / Resolution + 1e-4f;
+
+	for (const SplitCase& c : SplitCases) {
+		for (const ShadowView& view : ShadowViews) {
+			for (const XMFLOAT3& light : ShadowLights) {
+				SCOPED_TRACE(testing::Message() << c.Count << " cascades, lambda " << c.Lambda << ", camera at ("
+					<< view.Position.x << ", " << view.Position.y << ", " << view.Position.z << "), light y " << light.y);
+
+				const Camera camera = MakeShadowCamera(view);
+				CascadedShadows::Cascade cascades[CascadedShadows::MaxCascades];
+				CascadedShadows::Build(camera, XMLoadFloat3(&light), ShadowDistance, c.Count, c.Lambda, Resolution, scene, cascades);
+				EXPECT_EQ(cascades[0].SplitNear, camera.GetNearZ());
+				EXPECT_EQ(cascades[c.Count - 1].SplitFar, ShadowDistance);
+
+				for (int i = 0; i < c.Count; ++i) {
+					const CascadedShadows::Cascade& cascade = cascades[i];
+					EXPECT_GT(cascade.SplitFar, cascade.SplitNear);
+					if (i > 0) {
+						EXPECT_EQ(cascade.SplitNear, cascades[i - 1].SplitFar);
+					}
+
+					XMFLOAT3 corners[8];
+					CascadedShadows::SliceCorners(camera, cascade.SplitNear, cascade.SplitFar, corners);
+					for (const XMFLOAT3& corner : corners) {
+						const XMFLOAT3 ndc = ToCascadeNdc(cascade, corner);
+						EXPECT_LE(std::abs(ndc.x), inside) << "cascade " << i;
+						EXPECT_LE(std::abs(ndc.y), inside) << "cascade " << i;
+						EXPECT_GE(ndc.z, 0.0f) << "cascade " << i;
+						EXPECT_LE(ndc.z, 1.0f) << "cascade " << i;
+					}
+				}
+			}
+		}
+	}
+}
+
+// Walking and turning: the texel size stays bit for bit, the box moves in whole texels.
+TEST(CascadedShadows, TexelsStayInPlace)
+{
+	const BoundingBox scene = ShadowSceneBounds(MakeShadowBoxes(1024));
+	const XMVECTOR light = XMLoadFloat3(&ShadowLights[0]);
+
+	for (const SplitCase& c : SplitCases) {
+		for (const ShadowView& view : ShadowViews) {
+			Camera camera = MakeShadowCamera(view);
+			CascadedShadows::Cascade first[CascadedShadows::MaxCascades], cascades[CascadedShadows::MaxCascades];
+			CascadedShadows::Build(camera, light, ShadowDistance, c.Count, c.Lambda, Resolution, scene, first);
+			for (int frame = 0; frame < 60; ++frame) {
+				camera.Walk(0.13f);
+				camera.Strafe(0.07f);
+				camera.RotateY(0.01f);
+				camera.Pitch(0.002f);
+				camera.UpdateViewMatrix();
+				CascadedShadows::Build(camera, light, ShadowDistance, c.Count, c.Lambda, Resolution, scene, cascades);
+				for (int i = 0; i < c.Count; ++i) {
+					const CascadedShadows::Cascade& cascade = cascades[i];
+					const float x = (cascade.Bounds.Center.x - first[i].Bounds.Center.x) / cascade.TexelSize;
+					const float y = (cascade.Bounds.Center.y - first[i].Bounds.Center.y) / cascade.TexelSize;
+					ASSERT_EQ(cascade.TexelSize, first[i].TexelSize) << "frame " << frame << ", cascade " << i;
+					ASSERT_NEAR(x, std::round(x), 1e-2f) << "frame " << frame << ", cascade " << i;
+					ASSERT_NEAR(y, std::round(y), 1e-2f) << "frame " << frame << ", cascade " << i;
+				}
+			}
+		}
+	}
+}
+
+// Points spread through every slice look toward the light; each box such a ray hits can shadow the
+// point and has to be kept by IsCaster. Most of the scene still has to go.
+TEST(CascadedShadows, CasterCulling)
+{
+	const int count = 4;
+	const std::vector<ShadowBox> boxes = MakeShadowBoxes(4096);
+	const Camera camera = MakeShadowCamera(ShadowViews[0]);
+	const XMFLOAT3 light = ShadowLights[0];
+	CascadedShadows::Cascade cascades[count];
+	CascadedShadows::Build(camera, XMLoadFloat3(&light), ShadowDistance, count, 0.5f, Resolution, ShadowSceneBounds(boxes), cascades);
+
+	XMFLOAT3 toLight;
+	XMStoreFloat3(&toLight, XMVectorNegate(XMVector3Normalize(XMLoadFloat3(&light))));
+	std::size_t keptCount = 0;
+	for (int i = 0; i < count; ++i) {
+		const CascadedShadows::Cascade& cascade = cascades[i];
+		std::vector<std::uint8_t> kept(boxes.size());
+		for (std::size_t b = 0; b < boxes.size(); ++b) {
+			kept[b] = CascadedShadows::IsCaster(cascade, ToBounds(boxes[b]));
+			keptCount += kept[b];
+		}
+
+		XMFLOAT3 corners[8];
+		CascadedShadows::SliceCorners(camera, cascade.SplitNear, cascade.SplitFar, corners);
+		// a 5 x 5 x 5 lattice through the slice, the corners included
+		for (int w = 0; w <= 4; ++w)
+			for (int v = 0; v <= 4; ++v)
+				for (int u = 0; u <= 4; ++u) {
+					const XMVECTOR nearPoint = XMVectorLerp(
+						XMVectorLerp(XMLoadFloat3(&corners[0]), XMLoadFloat3(&corners[1]), u / 4.0f),
+						XMVectorLerp(XMLoadFloat3(&corners[3]), XMLoadFloat3(&corners[2]), u / 4.0f), v / 4.0f);
+					const XMVECTOR farPoint = XMVectorLerp(
+						XMVectorLerp(XMLoadFloat3(&corners[4]), XMLoadFloat3(&corners[5]), u / 4.0f),
+						XMVectorLerp(XMLoadFloat3(&corners[7]), XMLoadFloat3(&corners[6]), u / 4.0f), v / 4.0f);
+					XMFLOAT3 point;
+					XMStoreFloat3(&point, XMVectorLerp(nearPoint, farPoint, w / 4.0f));
+					for (std::size_t b = 0; b < boxes.size(); ++b)
+						ASSERT_TRUE(kept[b] || !RayHits(point, toLight, boxes[b])) << "box " << b << " shadows cascade " << i << " but was culled";
+				}
+	}
+	EXPECT_LT((double)keptCount / (count * boxes.size()), 0.5);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "BenchSsao.h"
+
+namespace
+{
+	const std::uint32_t gWidth = 1280, gHeight = 720;
+
+	// The blur as one 2D kernel at full resolution, the way the shader did it before it was split
+	// into passes: every tap of the square weighted by its row weight times its column weight and
+	// kept where normal and depth match the center. Taps past the edge repeat the edge pixel.
+	std::vector<float> Blur2D(const SsaoReference::GBuffer& gbuffer, const SsaoReference::Constants& constants, const std::vector<float>& ssaoMap)
+	{
+		const int width = (int)gbuffer.Width, height = (int)gbuffer.Height;
+		const int radius = std::min((int)constants.BlurWeights.size() / 2, SsaoReference::MaxBlurRadius);
+		std::vector<float> depths(ssaoMap.size());
+		for (std::size_t i = 0; i < depths.size(); ++i)
+			depths[i] = SsaoReference::NdcDepthToViewDepth(gbuffer.Depths[i], constants.Proj);
+
+		std::vector<float> blurred(ssaoMap.size());
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				const std::size_t center = (std::size_t)y * width + x;
+				if (gbuffer.Depths[center] >= 1.0f) {
+					blurred[center] = ssaoMap[center];
+					continue;
+				}
+
+				const DirectX::XMFLOAT3& n = gbuffer.Normals[center];
+				float sum = 0.0f, totalWeight = 0.0f;
+				for (int j = -radius; j <= radius; ++j) {
+					for (int i = -radius; i <= radius; ++i) {
+						const std::size_t tap = (std::size_t)std::min(std::max(y + j, 0), height - 1) * width + std::min(std::max(x + i, 0), width - 1);
+						const DirectX::XMFLOAT3& t = gbuffer.Normals[tap];
+						if ((i != 0 || j != 0) && (n.x * t.x + n.y * t.y + n.z * t.z < 0.8f || std::abs(depths[tap] - depths[center]) > 0.2f))
+							continue;
+						const float weight = constants.BlurWeights[i + radius] * constants.BlurWeights[j + radius];
+						sum += weight * ssaoMap[tap];
+						totalWeight += weight;
+					}
+				}
+				blurred[center] = std::min(std::max(sum / totalWeight, 0.0f), 1.0f);
+			}
+		}
+		return blurred;
+	}
+}
+
+// At full and half resolution: the result doesn't depend on the thread count, open floor comes
+// out lit (about 1) and the creases under the spheres are darker.
+TEST(SsaoReference, OcclusionFollowsTheGeometry)
+{
+	const SsaoScene scene = MakeSsaoScene(gWidth, gHeight);
+	for (std::uint32_t downsample : { 1u, 2u }) {
+		SCOPED_TRACE(testing::Message() << "downsample " << downsample);
+
+		const SsaoReference::Constants constants = MakeSsaoConstants(scene, 8, downsample);
+		const std::vector<SsaoSurface> surfaces = MapSurfaces(scene, downsample);
+
+		std::vector<float> ssaoMap, single;
+		SsaoReference::Occlusion(scene.GBuffer, constants, ssaoMap, 0);
+		SsaoReference::Occlusion(scene.GBuffer, constants, single, 1);
+		EXPECT_EQ(single, ssaoMap);
+
+		const double open = SurfaceMean(ssaoMap, surfaces, SsaoSurface::OpenFloor);
+		const double crease = SurfaceMean(ssaoMap, surfaces, SsaoSurface::Crease);
+		EXPECT_GE(open, 0.9);
+		EXPECT_LE(crease, open - 0.2);
+	}
+}
+
+// Both passes of the blur: sky pixels stay as they are, surfaces get smoother and the thread
+// count doesn't change the result.
+TEST(SsaoReference, Blur)
+{
+	const SsaoScene scene = MakeSsaoScene(gWidth, gHeight);
+	for (std::uint32_t downsample : { 1u, 2u }) {
+		SCOPED_TRACE(testing::Message() << "downsample " << downsample);
+
+		const SsaoReference::Constants constants = MakeSsaoConstants(scene, 8, downsample);
+		const std::vector<SsaoSurface> surfaces = MapSurfaces(scene, downsample);
+		std::vector<float> ssaoMap, blurred, single;
+		SsaoReference::Occlusion(scene.GBuffer, constants, ssaoMap);
+		SsaoReference::Blur(scene.GBuffer, constants, ssaoMap, blurred, 0);
+		SsaoReference::Blur(scene.GBuffer, constants, ssaoMap, single, 1);
+		EXPECT_EQ(single, blurred);
+
+		for (std::size_t i = 0; i < blurred.size(); ++i) {
+			if (surfaces[i] == SsaoSurface::Sky) {
+				ASSERT_EQ(blurred[i], ssaoMap[i]) << "sky pixel " << i << " blurred";
+			}
+		}
+		EXPECT_LE(SurfaceVariance(blurred, surfaces, SsaoSurface::Other), SurfaceVariance(ssaoMap, surfaces, SsaoSurface::Other));
+	}
+}
+
+// The separable blur against the 2D kernel it replaced. The two only differ where a pass lets a
+// tap through that the square would reject, next to where surfaces meet: on open floor they stay
+// within two steps of the UNORM target and on average well under one.
+TEST(SsaoReference, SeparableBlurMatches2D)
+{
+	const SsaoScene scene = MakeSsaoScene(gWidth, gHeight);
+	const SsaoReference::Constants constants = MakeSsaoConstants(scene, 8, 1);
+	const std::vector<SsaoSurface> surfaces = MapSurfaces(scene, 1);
+	std::vector<float> ssaoMap, separable;
+	SsaoReference::Occlusion(scene.GBuffer, constants, ssaoMap);
+	SsaoReference::Blur(scene.GBuffer, constants, ssaoMap, separable);
+	const std::vector<float> square = Blur2D(scene.GBuffer, constants, ssaoMap);
+
+	double sum = 0.0, openMax = 0.0;
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < square.size(); ++i) {
+		if (surfaces[i] == SsaoSurface::Sky) {
+			ASSERT_EQ(separable[i], square[i]) << "sky pixel " << i;
+			continue;
+		}
+		const double difference = std::abs(separable[i] - square[i]);
+		sum += difference;
+		count++;
+		if (surfaces[i] == SsaoSurface::OpenFloor)
+			openMax = std::max(openMax, difference);
+	}
+	EXPECT_LE(sum / count, 0.25 / 255);
+	EXPECT_LE(openMax, 2.0 / 255);
+}
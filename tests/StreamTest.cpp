@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <utility>
+
+#include "BenchStream.h"
+
+namespace
+{
+	const std::size_t gBudgets[] = { 0, 64, 16 };
+
+	TextureStreamer::Options MakeOptions(std::size_t budgetMB, std::uint32_t threads)
+	{
+		TextureStreamer::Options options;
+		options.Budget = budgetMB > 0 ? budgetMB << 20 : SIZE_MAX / 2;
+		options.ThreadCount = threads;
+		return options;
+	}
+}
+
+// The flight of BM_StreamTextures with two workers: the backend gets every mip coarse to fine, the
+// budget holds on every frame and no read is lost.
+TEST(TextureStreamer, Flight)
+{
+	for (std::size_t budget : gBudgets) {
+		SCOPED_TRACE(budget);
+		const StreamRun run = StreamFlight(MakeOptions(budget, 2), [](TextureStreamer& streamer) { streamer.Update(); });
+		EXPECT_EQ(run.Errors, 0u);
+		EXPECT_EQ(run.OverBudget, 0u);
+		EXPECT_EQ(run.Stats.LoadsInFlight, 0u);
+		EXPECT_EQ(run.Stats.Failed, 0u);
+		EXPECT_GT(run.Stats.Loads, 0u);
+	}
+}
+
+// Reads done inside Update() and reads on one or four workers, however late they finish, give
+// the same calls to the backend on every frame. Without a budget every visible texture reaches
+// its desired mip.
+TEST(TextureStreamer, ResidencyDoesNotDependOnThreads)
+{
+	for (std::size_t budget : gBudgets) {
+		SCOPED_TRACE(budget);
+		const StreamRun inline0 = StreamFlight(MakeOptions(budget, 0), [](TextureStreamer& streamer) { streamer.Update(); });
+		EXPECT_EQ(inline0.Errors, 0u);
+		if (budget == 0) {
+			EXPECT_EQ(inline0.Unconverged, 0u);
+		}
+
+		for (std::uint32_t threads : { 1u, 4u }) {
+			SCOPED_TRACE(threads);
+			const StreamRun workers = StreamFlight(MakeOptions(budget, threads), [](TextureStreamer& streamer) { streamer.Update(); });
+			EXPECT_EQ(workers.Hash, inline0.Hash);
+			EXPECT_EQ(workers.Unconverged, inline0.Unconverged);
+		}
+	}
+}
+
+namespace
+{
+	// Records the evictions in the order the streamer makes them.
+	class EvictionLog : public TextureStreamer::Backend
+	{
+	public:
+		bool Read(std::uint32_t, std::uint32_t, std::vector<std::uint8_t>& data) override
+		{
+			data.assign(1, 0);
+			return true;
+		}
+
+		void Upload(std::uint32_t, std::uint32_t, const std::vector<std::uint8_t>&) override {}
+
+		void Evict(std::uint32_t texture, std::uint32_t mip) override
+		{
+			Evictions.emplace_back(texture, mip);
+		}
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> Evictions;
+	};
+}
+
+// Four 256x256 BC1 textures and room for two beyond the tails. Each is asked for in full in turn,
+// 1, 0, 2, 3: texture 2 takes the mips of 1, used longest ago, finest first, then 3 takes those
+// of 0. The textures asked for this frame keep theirs.
+TEST(TextureStreamer, EvictsLeastRecentlyUsed)
+{
+	// BC1 bytes of 256x256: mips 0 and 1, and the tail from 64x64 down
+	const std::size_t fullBytes = 64 * 64 * 8 + 32 * 32 * 8;
+	const std::size_t tailBytes = 16 * 16 * 8 + 8 * 8 * 8 + 4 * 4 * 8 + 2 * 2 * 8 + 3 * 8;
+
+	TextureStreamer::Options options;
+	options.Budget = 4 * tailBytes + 2 * fullBytes;
+	options.TailSize = 64;
+	options.Latency = 1;
+	options.ThreadCount = 0;
+
+	EvictionLog backend;
+	TextureStreamer streamer(backend, options);
+	streamer.SetProjection(DirectX::XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, 1.0f, 1.0f, 100.0f), 1080.0f);
+	for (std::uint32_t i = 0; i < 4; ++i)
+		ASSERT_EQ(streamer.Register(DDSFormat::BC1_UNORM, 256, 256, 9), i);
+	streamer.Flush();
+	ASSERT_EQ(streamer.GetStats().ResidentBytes, 4 * tailBytes);
+
+	for (std::uint32_t texture : { 1u, 0u, 2u, 3u }) {
+		SCOPED_TRACE(texture);
+		for (int frame = 0; frame < 4; ++frame) {
+			streamer.Request(texture, 1.0f, 0.1f);
+			streamer.Update();
+			ASSERT_LE(streamer.GetStats().ResidentBytes, options.Budget);
+		}
+		EXPECT_EQ(streamer.ResidentMip(texture), 0u);
+	}
+
+	const std::vector<std::pair<std::uint32_t, std::uint32_t>> expected = { { 1, 1 }, { 1, 2 }, { 0, 1 }, { 0, 2 } };
+	EXPECT_EQ(backend.Evictions, expected);
+	EXPECT_EQ(streamer.ResidentMip(0), 2u);
+	EXPECT_EQ(streamer.ResidentMip(1), 2u);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+
+#include "Common/GeometryGenerator.h"
+#include "TangentSpace.h"
+#include "VertexQuantizer.h"
+
+using namespace DirectX;
+
+namespace
+{
+	float XM_CALLCONV AngleBetween(FXMVECTOR a, FXMVECTOR b)
+	{
+		return XMConvertToDegrees(XMVectorGetX(XMVector3AngleBetweenVectors(a, b)));
+	}
+
+	// The sphere of TangentBench, about 1M triangles.
+	GeometryGenerator::MeshData MakeSphere()
+	{
+		GeometryGenerator geoGen;
+		return geoGen.CreateSphere(1.0f, 708, 708);
+	}
+
+	// The tangent is unit length and perpendicular to the normal.
+	void CheckTangentFrame(const GeometryGenerator::Vertex& vertex)
+	{
+		XMVECTOR t = XMLoadFloat4(&vertex.TangentU), n = XMLoadFloat3(&vertex.Normal);
+		EXPECT_NEAR(XMVectorGetX(XMVector3Dot(t, n)), 0.0f, 1e-3f);
+		EXPECT_NEAR(XMVectorGetX(XMVector3Length(t)), 1.0f, 1e-3f);
+	}
+}
+
+// Normals rebuilt from the faces of a sphere stay within a degree of the analytic ones.
+TEST(TangentSpace, SphereNormals)
+{
+	const GeometryGenerator::MeshData reference = MakeSphere();
+	GeometryGenerator::MeshData mesh = reference;
+	TangentSpace::GenerateNormals(mesh);
+
+	for (size_t i = 0; i < mesh.Vertices.size(); ++i)
+		ASSERT_LT(AngleBetween(XMLoadFloat3(&mesh.Vertices[i].Normal), XMLoadFloat3(&reference.Vertices[i].Normal)), 1.0f) << "vertex " << i;
+}
+
+// Tangents of a sphere against GeometryGenerator's dP/du, away from the poles where u is undefined.
+// The pole fans get split, the copies follow the original vertices.
+TEST(TangentSpace, SphereTangents)
+{
+	const GeometryGenerator::MeshData reference = MakeSphere();
+	GeometryGenerator::MeshData mesh = reference;
+	TangentSpace::GenerateTangents(mesh);
+
+	for (size_t i = reference.Vertices.size(); i < mesh.Vertices.size(); ++i) {
+		ASSERT_NO_FATAL_FAILURE(CheckTangentFrame(mesh.Vertices[i]));
+		ASSERT_GE(std::fabs(mesh.Vertices[i].Position.y), 0.99f);
+	}
+
+	for (size_t i = 0; i < reference.Vertices.size(); ++i) {
+		SCOPED_TRACE(i);
+		const auto& vertex = mesh.Vertices[i];
+		ASSERT_NO_FATAL_FAILURE(CheckTangentFrame(vertex));
+		ASSERT_EQ(vertex.TangentU.w, reference.Vertices[i].TangentU.w);
+		if (std::fabs(vertex.Position.y) < 0.99f) {
+			ASSERT_LT(AngleBetween(XMLoadFloat4(&vertex.TangentU), XMLoadFloat4(&reference.Vertices[i].TangentU)), 1.0f);
+		}
+	}
+}
+
+// A box without texture coordinates: no UV direction anywhere, the tangents still have to be usable.
+TEST(TangentSpace, NoUVFallback)
+{
+	GeometryGenerator geoGen;
+	GeometryGenerator::MeshData mesh = geoGen.CreateBox(1.0f, 2.0f, 3.0f, 6);
+	for (auto& vertex : mesh.Vertices)
+		vertex.TexC = XMFLOAT2(0.0f, 0.0f);
+	TangentSpace::GenerateTangents(mesh);
+
+	for (const auto& vertex : mesh.Vertices)
+		CheckTangentFrame(vertex);
+}
+
+// A quad facing +y with its u running along -x instead of +x: the tangent follows u and w flips,
+// so cross(N, T) * w is still dP/dv, here -z as for the unmirrored quad. The sign has to survive
+// VertexQuantizer as well.
+TEST(TangentSpace, MirroredUV)
+{
+	for (bool mirrored : { false, true }) {
+		SCOPED_TRACE(mirrored);
+		GeometryGenerator::MeshData mesh;
+		for (int i = 0; i < 4; ++i) {
+			const float x = i % 2 ? 1.0f : -1.0f, z = i / 2 ? -1.0f : 1.0f;
+			const float u = 0.5f * (x + 1.0f), v = 0.5f * (1.0f - z);
+			mesh.Vertices.push_back(GeometryGenerator::Vertex(x, 0.0f, z, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, mirrored ? 1.0f - u : u, v));
+		}
+		mesh.Indices32 = { 0, 1, 2, 2, 1, 3 };
+		TangentSpace::GenerateTangents(mesh);
+
+		const BoundingBox bounds(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 1.0f));
+		PackedVertex packed[4];
+		VertexQuantizer::Encode(mesh.Vertices.data(), mesh.Vertices.size(), bounds, packed);
+
+		for (int i = 0; i < 4; ++i) {
+			const GeometryGenerator::Vertex& vertex = mesh.Vertices[i];
+			CheckTangentFrame(vertex);
+			EXPECT_EQ(vertex.TangentU.w, mirrored ? -1.0f : 1.0f);
+			EXPECT_LT(AngleBetween(XMLoadFloat4(&vertex.TangentU), XMVectorSet(mirrored ? -1.0f : 1.0f, 0.0f, 0.0f, 0.0f)), 1e-3f);
+
+			const XMVECTOR bitangent = XMVector3Cross(XMLoadFloat3(&vertex.Normal), XMLoadFloat4(&vertex.TangentU)) * vertex.TangentU.w;
+			EXPECT_LT(AngleBetween(bitangent, XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f)), 1e-3f);
+
+			EXPECT_EQ(VertexQuantizer::Decode(packed[i], bounds).TangentU.w, vertex.TangentU.w);
+		}
+	}
+}
+
+// Two quads facing +y sharing the edge at x = 0, the UVs mirrored across it as on a symmetric
+// character: u runs along -x on the left and +x on the right. The two seam vertices are split,
+// each side keeps its own tangent and handedness and the bitangent stays -z on both.
+TEST(TangentSpace, SplitsMirroredSeam)
+{
+	GeometryGenerator::MeshData mesh;
+	for (int i = 0; i < 6; ++i) {
+		const float x = (float)(i % 3) - 1.0f, z = i / 3 ? -1.0f : 1.0f;
+		mesh.Vertices.push_back(GeometryGenerator::Vertex(x, 0.0f, z, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, std::fabs(x), 0.5f * (1.0f - z)));
+	}
+	mesh.Indices32 = { 0, 1, 3, 3, 1, 4, 1, 2, 4, 4, 2, 5 };
+	const GeometryGenerator::MeshData original = mesh;
+	TangentSpace::GenerateTangents(mesh);
+
+	ASSERT_EQ(mesh.Vertices.size(), 8u);
+	ASSERT_EQ(mesh.Indices32.size(), original.Indices32.size());
+	for (size_t c = 0; c < mesh.Indices32.size(); ++c) {
+		SCOPED_TRACE(c);
+		const GeometryGenerator::Vertex& vertex = mesh.Vertices[mesh.Indices32[c]];
+		const GeometryGenerator::Vertex& source = original.Vertices[original.Indices32[c]];
+		EXPECT_EQ(std::memcmp(&vertex.Position, &source.Position, sizeof(XMFLOAT3)), 0);
+		EXPECT_EQ(std::memcmp(&vertex.TexC, &source.TexC, sizeof(XMFLOAT2)), 0);
+
+		const bool left = c < 6;
+		CheckTangentFrame(vertex);
+		EXPECT_EQ(vertex.TangentU.w, left ? -1.0f : 1.0f);
+		EXPECT_LT(AngleBetween(XMLoadFloat4(&vertex.TangentU), XMVectorSet(left ? -1.0f : 1.0f, 0.0f, 0.0f, 0.0f)), 1e-3f);
+
+		const XMVECTOR bitangent = XMVector3Cross(XMLoadFloat3(&vertex.Normal), XMLoadFloat4(&vertex.TangentU)) * vertex.TangentU.w;
+		EXPECT_LT(AngleBetween(bitangent, XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f)), 1e-3f);
+	}
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+
+#include "BenchBlur.h"
+#include "Toolkit.h"
+
+namespace
+{
+	const std::uint32_t gWidth = 320, gHeight = 180;
+}
+
+// Toolkit::GaussianBlur against a plain scalar blur (within one step), for one and all threads.
+// A flat image stays flat.
+TEST(Toolkit, GaussianBlur)
+{
+	const std::vector<std::uint8_t> image = MakeBlurImage(gWidth, gHeight);
+	const std::vector<std::uint8_t> flat(image.size(), 77);
+	for (int sigma10 : { 10, 25, 80 }) {
+		SCOPED_TRACE(sigma10);
+		const std::vector<float> weights = Toolkit::CalcGaussWeights(sigma10 / 10.0f);
+
+		std::vector<std::uint8_t> single(image.size()), threaded(image.size());
+		Toolkit::GaussianBlur(image.data(), gWidth * 4, gWidth, gHeight, weights, single.data(), gWidth * 4, 1);
+		Toolkit::GaussianBlur(image.data(), gWidth * 4, gWidth, gHeight, weights, threaded.data(), gWidth * 4, 0);
+		EXPECT_EQ(single, threaded);
+
+		const std::vector<std::uint8_t> expected = ScalarBlur(image, gWidth, gHeight, weights);
+		int maxError = 0;
+		for (std::size_t i = 0; i < single.size(); ++i)
+			maxError = std::max(maxError, std::abs((int)single[i] - (int)expected[i]));
+		EXPECT_LE(maxError, 1);
+
+		Toolkit::GaussianBlur(flat.data(), gWidth * 4, gWidth, gHeight, weights, single.data(), gWidth * 4);
+		EXPECT_EQ(single, flat);
+	}
+}
+
+// Toolkit::DualKawaseBlur: every level widens the blur by at least half, the result doesn't depend
+// on the thread count and a flat image stays flat.
+TEST(Toolkit, DualKawaseBlur)
+{
+	const std::vector<std::uint8_t> image = MakeBlurImage(gWidth, gHeight);
+	const std::vector<std::uint8_t> flat(image.size(), 77);
+	auto sigma = [](std::uint32_t levels) {
+		return EffectiveSigma([&](const std::uint8_t* in, std::uint8_t* out, std::uint32_t w, std::uint32_t h) {
+			Toolkit::DualKawaseBlur(in, w * 4, w, h, levels, out, w * 4);
+		});
+	};
+
+	double previous = 0.0;
+	for (std::uint32_t levels = 1; levels <= 6; ++levels) {
+		SCOPED_TRACE(levels);
+		std::vector<std::uint8_t> single(image.size()), threaded(image.size());
+		Toolkit::DualKawaseBlur(image.data(), gWidth * 4, gWidth, gHeight, levels, single.data(), gWidth * 4, 1);
+		Toolkit::DualKawaseBlur(image.data(), gWidth * 4, gWidth, gHeight, levels, threaded.data(), gWidth * 4, 0);
+		EXPECT_EQ(single, threaded);
+
+		const double current = sigma(levels);
+		if (levels > 1) {
+			EXPECT_GE(current, 1.5 * previous);
+		}
+		previous = current;
+
+		Toolkit::DualKawaseBlur(flat.data(), gWidth * 4, gWidth, gHeight, levels, single.data(), gWidth * 4);
+		EXPECT_EQ(single, flat);
+	}
+}
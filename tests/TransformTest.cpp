@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "TransformHierarchy.h"
+
+using namespace DirectX;
+
+// After moving a few nodes, the deepest node's world matrix matches a straight walk up the parents.
+TEST(TransformHierarchy, WorldMatchesParentChain)
+{
+	const int count = 1000;
+
+	// complete 4-ary tree in breadth first order, as in TransformBench
+	TransformHierarchy hierarchy;
+	hierarchy.Reserve(count);
+	for (int i = 0; i < count; ++i) {
+		XMFLOAT4X4 local;
+		XMStoreFloat4x4(&local, XMMatrixRotationY(0.01f * (i % 7)) * XMMatrixTranslation(1.0f, 0.5f, 0.0f));
+		hierarchy.AddNode(i == 0 ? TransformHierarchy::InvalidNode : (std::uint32_t)(i - 1) / 4, local);
+	}
+	hierarchy.Update();
+
+	for (std::uint32_t node : { 0u, 3u, 17u, 250u }) {
+		XMFLOAT4X4 local = hierarchy.Local(node);
+		local._41 += 0.5f;
+		hierarchy.SetLocal(node, local);
+	}
+	hierarchy.Update();
+
+	const std::uint32_t node = count - 1;
+	XMMATRIX expected = XMMatrixIdentity();
+	for (std::uint32_t i = node; i != TransformHierarchy::InvalidNode; i = hierarchy.Parent(i))
+		expected = expected * XMLoadFloat4x4(&hierarchy.Local(i));
+
+	XMFLOAT4X4 e;
+	XMStoreFloat4x4(&e, expected);
+	const XMFLOAT4X4& w = hierarchy.World(node);
+	for (int r = 0; r < 4; ++r)
+		for (int c = 0; c < 4; ++c)
+			EXPECT_NEAR(w.m[r][c], e.m[r][c], 1e-3f * (1.0f + std::fabs(e.m[r][c]))) << r << "," << c;
+}
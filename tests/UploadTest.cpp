@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <cstring>
+
+#include "BenchScene.h"
+#include "DirtyRanges.h"
+
+using namespace DirectX;
+
+// Objects moved on some frames only: once every frame resource caught up, all of them hold the
+// latest constants of every object.
+TEST(ConstantBufferMirror, FrameResourcesCatchUp)
+{
+	const int frameResources = 3;
+	std::vector<XMFLOAT4X4> worlds = BuildInstanceGrid(1000, 800.0f, true);
+
+	ConstantBufferMirror<ObjectConstants> mirror((std::uint32_t)worlds.size(), frameResources, true);
+	for (size_t i = 0; i < worlds.size(); i++) {
+		ObjectConstants objConstants;
+		XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(XMLoadFloat4x4(&worlds[i])));
+		mirror.Set((std::uint32_t)i, objConstants);
+	}
+
+	std::vector<StagingBuffer<ObjectConstants>> frameCBs;
+	for (int f = 0; f < frameResources; f++)
+		frameCBs.emplace_back(worlds.size(), true);
+
+	for (int frame = 0; frame < 10; frame++) {
+		for (std::uint32_t index = frame * 37 % 100; index < worlds.size(); index += 100 + frame) {
+			worlds[index]._41 += 0.001f;
+			ObjectConstants objConstants;
+			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(XMLoadFloat4x4(&worlds[index])));
+			mirror.Set(index, objConstants);
+		}
+		auto& currObjectCB = frameCBs[frame % frameResources];
+		mirror.Upload(frame % frameResources, currObjectCB.MappedData(), currObjectCB.ElementByteSize());
+	}
+
+	for (int f = 0; f < frameResources; f++)
+		mirror.Upload(f, frameCBs[f].MappedData(), frameCBs[f].ElementByteSize());
+
+	for (int f = 0; f < frameResources; f++) {
+		SCOPED_TRACE(f);
+		for (std::uint32_t i = 0; i < (std::uint32_t)worlds.size(); i++) {
+			const std::uint8_t* mapped = frameCBs[f].Data() + (size_t)i * frameCBs[f].ElementByteSize();
+			ASSERT_EQ(std::memcmp(mapped, &mirror.Get(i), sizeof(ObjectConstants)), 0) << "object " << i;
+		}
+	}
+}